@@ -15,14 +15,8 @@
 
 // ---- Grade Array Manipulation ---------------------------------------------------------------------------------------
 
-int GradeArray_sum(grade gradePtr[], size nGrades) {
-    int accumulator = 0;
-
-    for(size idx = 0; idx < nGrades; ++idx){
-        accumulator += *gradePtr++;
-    }
-
-    return accumulator;
+long GradeArray_sum(grade gradePtr[], size nGrades) {
+    return GradeKernels_select()->sum(gradePtr, nGrades);
 }
 
 float GradeArray_average(grade gradePtr[], size nGrades) {
@@ -30,50 +24,26 @@ float GradeArray_average(grade gradePtr[], size nGrades) {
 }
 
 
-float Student_averageGrade(Student* student) {
+float Student_averageGrade(GradeBook* book, Student* student) {
     size nCourses = Student_coursesCount(student);
-    float gradeAccum = 0;
-    for(size courseIdx = 0; courseIdx < nCourses; ++courseIdx) {
-        gradeAccum += GradeArray_average(student->courses[courseIdx].grades, student->courses[courseIdx].gradeCount);
-    }
-    return nCourses > 0 ? gradeAccum / nCourses : 0;
+    return nCourses > 0 ? (float) (student->aggregate.averagesSum / nCourses) : 0;
 }
 
-float Course_averageGrade(Course* course) {
-    size nStudents      = Course_studentsCount(course);
-    float gradeAccum    = 0;
-    for(size idx = 0; idx < nStudents; ++idx) {
-        Student* student = course->students[idx];
-        long indexInStudent = Student_courseIndex(student, course);
-        if(indexInStudent < 0) {
-            // Should we log an error?
-            continue;
-        }
-
-        gradeAccum += GradeArray_average(student->courses[indexInStudent].grades, student->courses[indexInStudent].gradeCount);
-    }
-
-    return nStudents > 0 ? gradeAccum / nStudents : 0;
+float Course_averageGrade(GradeBook* book, Course* course) {
+    size nStudents = Course_studentsCount(course);
+    return nStudents > 0 ? (float) (course->aggregate.averagesSum / nStudents) : 0;
 }
 
 grade GradeArray_smallest(grade gradePtr[], size nGrades) {
-    grade cache = MAX_GRADE;
-
-    for(size idx = 0; idx < nGrades; ++idx) {
-        cache = (cache > *gradePtr++) ? *gradePtr : cache;
-    }
-
-    return cache;
+    return GradeKernels_select()->smallest(gradePtr, nGrades);
 }
 
 grade GradeArray_largest(grade gradePtr[], size nGrades) {
-    grade cache = 0;
-
-    for(size idx = 0; idx < nGrades; ++idx) {
-        cache = (cache < *gradePtr++) ? *gradePtr : cache;
-    }
+    return GradeKernels_select()->largest(gradePtr, nGrades);
+}
 
-    return cache;
+GradeSummary GradeArray_summarize(grade gradePtr[], size nGrades) {
+    return GradeKernels_select()->summarize(gradePtr, nGrades);
 }
 
 bool GradeArray_remove(grade gradePtr[], size nGrades, size index) {
@@ -93,60 +63,82 @@ bool GradeArray_remove(grade gradePtr[], size nGrades, size index) {
 
 // ---- Enrollment Manipulation ----------------------------------------------------------------------------------------
 
-grade Enrollment_addGrade(StudentEnrollment* enrollment, grade newGrade) {
+void Enrollment_addGrade(GradeBook* book, StudentEnrollment* enrollment, grade newGrade) {
+
+    d_printf("Add grade %u to enrollment in course slot %u\n", newGrade, enrollment->course.slot);
+
+    GradeBook_addGrade(book, enrollment, newGrade);
 
-    d_printf("Add grade %u to enrollment in %u\n", newGrade, enrollment->course->courseId);
-    d_printf("gradeCount = %lu\n", enrollment->gradeCount);
+    d_printf("done. gradeCount = %lu\n", enrollment->grades.count);
+}
+
+bool Enrollment_removeGrade(GradeBook* book, StudentEnrollment* enrollment, size index) {
+    return GradeBook_removeGrade(book, enrollment, index);
+}
 
-    if(enrollment->gradeCount >= NMEMBERS(enrollment->grades, grade)) {
-        size memberCount = NMEMBERS(enrollment->grades, grade);
+size Enrollment_copyGrades(GradeBook* book, StudentEnrollment* enrollment, grade* destination) {
+    return GradeLog_copy(&book->gradeChunks, &enrollment->grades, destination);
+}
 
-        d_printf("Performing right-shift grade update\n");
+float Enrollment_average(GradeBook* book, StudentEnrollment* enrollment) {
+    size nGrades = enrollment->summary.count;
+    return nGrades > 0 ? (float) enrollment->summary.sum / (float) nGrades : 0;
+}
 
-        grade removed = enrollment->grades[enrollment->gradeCount -1];
+GradeSummary Enrollment_summarize(GradeBook* book, StudentEnrollment* enrollment) {
+    return enrollment->summary;
+}
 
-        d_printf("memmove(0x%x, 0x%x, %lu)\n",
-                enrollment->grades + sizeof(grade), enrollment->grades, (memberCount - 1) * sizeof(grade));
+// ---- Grading Policies -----------------------------------------------------------------------------------------------
 
-        memmove(enrollment->grades + 1, enrollment->grades, (memberCount - 1) * sizeof(grade));
+float Enrollment_policyScore(GradeBook* book, StudentEnrollment* enrollment) {
+    const GradingPlan* plan = Course_policy(book, GradeBook_resolveCourse(book, enrollment->course));
 
-        enrollment->grades[0] = newGrade;
+    if(!plan) return Enrollment_average(book, enrollment);
 
-        return removed;
-    } else {
-        d_printf("Performing insertion grade update\n");
+    grade grades[GradingPlan_MAX_WIDTH];
+    size nGrades = GradeLog_copyFirst(&book->gradeChunks, &enrollment->grades, grades, plan->width);
 
-        enrollment->grades[enrollment->gradeCount++] = newGrade;
+    return GradingPlan_score(plan, grades, nGrades);
+}
 
-        d_printf("done. gradeCount = %lu. grades[%lu] = %u\n", enrollment->gradeCount, enrollment->gradeCount - 1, enrollment->grades[enrollment->gradeCount -1]);
+size Course_policyScores(GradeBook* book, Course* course, float* scores) {
+    const GradingPlan* plan = Course_policy(book, course);
+    size nStudents          = Course_studentsCount(course);
 
-        return 0;
+    if(!plan) {
+        for(size idx = 0; idx < nStudents; ++idx) {
+            scores[idx] = Enrollment_average(book, Course_enrollmentAt(book, course, idx));
+        }
+        return nStudents;
     }
-}
 
-bool Enrollment_removeGrade(StudentEnrollment* enrollment, size index) {
+    size columnsSize    = plan->width * GradingPlan_TILE_ROWS * sizeof(uint16_t);
+    uint16_t* columns   = Pool_alloc(&book->pool, columnsSize);
 
-    if(index >= enrollment->gradeCount || enrollment->gradeCount == 0) return false;
+    if(!columns) {
+        fprintf(stderr, "GradeBook: unable to score course %u\n", course->courseId);
+        abort();
+    }
 
+    for(size start = 0; start < nStudents; start += GradingPlan_TILE_ROWS) {
+        size tileRows = nStudents - start < GradingPlan_TILE_ROWS ? nStudents - start : GradingPlan_TILE_ROWS;
 
-    if(index == (enrollment->gradeCount - 1)) {
-        enrollment->grades[index] = 0;
-    } else {
-        // Shift left from idx + 1 by 1, overwriting idx
-        memmove(enrollment->grades + index, enrollment->grades + index + 1, enrollment->gradeCount - index - 1);
+        for(size row = 0; row < tileRows; ++row) {
+            StudentEnrollment* enrollment = Course_enrollmentAt(book, course, start + row);
 
-        --enrollment->gradeCount;
+            grade grades[GradingPlan_MAX_WIDTH];
+            size nGrades = GradeLog_copyFirst(&book->gradeChunks, &enrollment->grades, grades, plan->width);
 
-        // Zero out the tail end of the array from the first unused element to the end of the array.
-        memset(enrollment->grades + enrollment->gradeCount, 0x00,
-                sizeof(grade) * (NMEMBERS(enrollment->grades, grade) - enrollment->gradeCount));
+            for(size position = 0; position < plan->width; ++position) {
+                columns[position * tileRows + row] = position < nGrades ? grades[position] : GradingPlan_MISSING;
+            }
+        }
+
+        GradingPlan_evaluate(plan, columns, tileRows, &scores[start]);
     }
 
-    --enrollment->gradeCount;
+    Pool_release(&book->pool, columns, columnsSize);
 
-    return true;
+    return nStudents;
 }
-
-float Enrollment_average(StudentEnrollment* enrollment) {
-    return GradeArray_average(enrollment->grades, enrollment->gradeCount);
-}
\ No newline at end of file
@@ -16,9 +16,11 @@
 // ---- List Applications ----------------------------------------------------------------------------------------------
 
 /*
- * Apply a grading function to a grade array.
+ * Sum of the grades in a grade array.
+ *
+ * The GradeArray_ functions run on the fastest grade kernels the CPU supports (see grade_kernels.h).
  */
-int GradeArray_sum(grade[], size);
+long GradeArray_sum(grade[], size);
 
 /*
  * Calculate the average grade in a grade array
@@ -26,15 +28,15 @@ int GradeArray_sum(grade[], size);
 float GradeArray_average(grade[], size);
 
 /*
- * Helper method that flattens the grade matrix of a student and averages that student's grades
+ * Average of a student's course averages, a course with no grades counting as 0.
+ * Read from the student's running totals, without walking any grades.
  */
-float Student_averageGrade(Student* student);
+float Student_averageGrade(GradeBook* book, Student* student);
 
 /*
- * Helper method that collects the course grades for every enrolled student and performs an average
- * across the flattened arrays.
+ * Average of the averages of every student enrolled in a course, from the course's running totals.
  */
-float Course_averageGrade(Course* course);
+float Course_averageGrade(GradeBook* book, Course* course);
 
 /*
  * Find the smallest grade in a grade array
@@ -46,13 +48,52 @@ grade GradeArray_smallest(grade[], size);
  */
 grade GradeArray_largest(grade[], size);
 
+/*
+ * Sum, smallest, largest and count of a grade array, in a single pass
+ */
+GradeSummary GradeArray_summarize(grade[], size);
+
 // ---- Enrollment Records ---------------------------------------------------------------------------------------------
 
-grade Enrollment_addGrade(StudentEnrollment* enrollment, grade newGrade);
+/*
+ * Append a grade to the enrollment's grade log. Grades are never dropped to make room.
+ */
+void Enrollment_addGrade(GradeBook* book, StudentEnrollment* enrollment, grade newGrade);
+
+/*
+ * Remove the grade at index, keeping the order of the others. Returns false if there is no such grade.
+ */
+bool Enrollment_removeGrade(GradeBook* book, StudentEnrollment* enrollment, size index);
+
+/*
+ * Copy the enrollment's grades, oldest first, to destination, which must hold enrollment->grades.count grades
+ */
+size Enrollment_copyGrades(GradeBook* book, StudentEnrollment* enrollment, grade* destination);
+
+float Enrollment_average(GradeBook* book, StudentEnrollment* enrollment);
+
+/*
+ * Sum, smallest, largest and count of the enrollment's grades, as kept up to date by GradeBook_addGrade
+ */
+GradeSummary Enrollment_summarize(GradeBook* book, StudentEnrollment* enrollment);
 
-bool Enrollment_removeGrade(StudentEnrollment* enrollment, size index);
+// ---- Grading Policies -----------------------------------------------------------------------------------------------
 
-float Enrollment_average(StudentEnrollment* enrollment);
+/*
+ * Score of the enrollment by its course's grading policy (see Course_setPolicy), or its plain average if the course has
+ * no policy
+ */
+float Enrollment_policyScore(GradeBook* book, StudentEnrollment* enrollment);
+
+/*
+ * Score every enrollment of a course by the course's grading policy, in roster order (see Course_enrollmentAt), in to
+ * `scores`, which must have room for Course_studentsCount(course) scores. Returns the number written.
+ *
+ * The enrollments are scored GradingPlan_TILE_ROWS at a time: the first grades of each are gathered in to columns, and
+ * the whole tile is scored by GradingPlan_evaluate. A course with no policy scores each enrollment by its plain
+ * average.
+ */
+size Course_policyScores(GradeBook* book, Course* course, float* scores);
 
 // End Header "grading.h" ----------------------------------------------------------------------------------------------
 
@@ -0,0 +1,186 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * Arena Definitions:
+ *
+ * Implements the chunked record arena described in arena.h
+ */
+
+#include <string.h>
+#include "arena.h"
+
+static const size _ARENA_INITIAL_CHUNKS = 4;
+
+void Arena_init(Arena* arena, Pool* pool, size memberSize, size chunkShift) {
+    memset(arena, 0, sizeof(Arena));
+    arena->pool         = pool;
+    arena->memberSize   = memberSize;
+    arena->chunkShift   = chunkShift;
+}
+
+static inline size Arena_chunkBytes(const Arena* arena) {
+    return ((size) 1 << arena->chunkShift) * arena->memberSize;
+}
+
+/*
+ * Generations are kept for every slot of every chunk the chunk table has room for, so they grow with the table
+ */
+static inline size Arena_generationsBytes(const Arena* arena, size chunksCapacity) {
+    return (chunksCapacity << arena->chunkShift) * sizeof(uint32_t);
+}
+
+void Arena_free(Arena* arena) {
+    for(size idx = 0; idx < arena->chunksCount; ++idx) {
+        Pool_release(arena->pool, arena->chunks[idx], Arena_chunkBytes(arena));
+    }
+
+    Pool_release(arena->pool, arena->chunks, arena->chunksCapacity * sizeof(byte*));
+    Pool_release(arena->pool, arena->freeSlots, arena->freeCapacity * sizeof(size));
+    Pool_release(arena->pool, arena->generations, Arena_generationsBytes(arena, arena->chunksCapacity));
+
+    Arena_init(arena, arena->pool, arena->memberSize, arena->chunkShift);
+}
+
+/*
+ * Allocate one more chunk. Only the chunk table is ever reallocated; existing chunks stay where they are.
+ */
+static bool Arena_grow(Arena* arena) {
+
+    if(arena->chunksCount >= arena->chunksCapacity) {
+        size capacity           = arena->chunksCapacity ? arena->chunksCapacity * 2 : _ARENA_INITIAL_CHUNKS;
+        byte** chunks           = Pool_alloc(arena->pool, capacity * sizeof(byte*));
+        uint32_t* generations   = Pool_alloc(arena->pool, Arena_generationsBytes(arena, capacity));
+
+        // Both grow together, or neither does
+        if(!chunks || !generations) {
+            Pool_release(arena->pool, chunks, capacity * sizeof(byte*));
+            Pool_release(arena->pool, generations, Arena_generationsBytes(arena, capacity));
+            return false;
+        }
+
+        size oldSlots = arena->chunksCapacity << arena->chunkShift;
+
+        if(arena->chunksCapacity) {
+            memcpy(chunks, arena->chunks, arena->chunksCount * sizeof(byte*));
+            memcpy(generations, arena->generations, oldSlots * sizeof(uint32_t));
+        }
+
+        // Start every new slot at generation 1, leaving 0 for null handles
+        for(size slot = oldSlots; slot < (capacity << arena->chunkShift); ++slot) {
+            generations[slot] = 1;
+        }
+
+        Pool_release(arena->pool, arena->chunks, arena->chunksCapacity * sizeof(byte*));
+        Pool_release(arena->pool, arena->generations, Arena_generationsBytes(arena, arena->chunksCapacity));
+
+        arena->chunks           = chunks;
+        arena->generations      = generations;
+        arena->chunksCapacity   = capacity;
+    }
+
+    byte* chunk = Pool_alloc(arena->pool, Arena_chunkBytes(arena));
+
+    if(!chunk) return false;
+
+    memset(chunk, 0, Arena_chunkBytes(arena));
+    arena->chunks[arena->chunksCount++] = chunk;
+
+    return true;
+}
+
+size Arena_push(Arena* arena, const void* member) {
+
+    size slot;
+
+    if(arena->freeCount > 0) {
+        slot = arena->freeSlots[--arena->freeCount];
+    } else {
+        if((arena->slotsCount >> arena->chunkShift) >= arena->chunksCount && !Arena_grow(arena)) {
+            fprintf(stderr, "Arena_push: unable to allocate a chunk of %lu bytes\n", Arena_chunkBytes(arena));
+            abort();
+        }
+        slot = arena->slotsCount++;
+    }
+
+    memcpy(Arena_at(arena, slot), member, arena->memberSize);
+
+    return slot;
+}
+
+void Arena_release(Arena* arena, size slot) {
+
+    memset(Arena_at(arena, slot), 0, arena->memberSize);
+
+    if(++arena->generations[slot] == 0) arena->generations[slot] = 1;
+
+    if(arena->freeCount >= arena->freeCapacity) {
+        size capacity   = arena->freeCapacity ? arena->freeCapacity * 2 : ((size) 1 << arena->chunkShift);
+        size* freeSlots = Pool_resize(arena->pool, arena->freeSlots,
+                                      arena->freeCapacity * sizeof(size), capacity * sizeof(size));
+
+        // Losing track of a slot only wastes it, so there is no need to fail loudly here
+        if(!freeSlots) return;
+
+        arena->freeSlots    = freeSlots;
+        arena->freeCapacity = capacity;
+    }
+
+    arena->freeSlots[arena->freeCount++] = slot;
+}
+
+bool Arena_clone(Arena* destination, const Arena* source) {
+
+    Pool* pool = destination->pool;
+
+    Arena_init(destination, pool, source->memberSize, source->chunkShift);
+
+    destination->chunks         = Pool_alloc(pool, source->chunksCapacity * sizeof(byte*));
+    destination->chunksCapacity = source->chunksCapacity;
+    destination->freeSlots      = Pool_alloc(pool, source->freeCapacity * sizeof(size));
+    destination->freeCapacity   = source->freeCapacity;
+
+    if(!destination->chunks || !destination->freeSlots) {
+        Arena_free(destination);
+        return false;
+    }
+
+    for(size idx = 0; idx < source->chunksCount; ++idx) {
+        byte* chunk = Pool_alloc(pool, Arena_chunkBytes(source));
+
+        if(!chunk) {
+            Arena_free(destination);
+            return false;
+        }
+
+        memcpy(chunk, source->chunks[idx], Arena_chunkBytes(source));
+        destination->chunks[destination->chunksCount++] = chunk;
+    }
+
+    destination->generations = Pool_alloc(pool, Arena_generationsBytes(source, source->chunksCapacity));
+
+    if(!destination->generations) {
+        Arena_free(destination);
+        return false;
+    }
+
+    if(source->chunksCapacity) {
+        memcpy(destination->generations, source->generations, Arena_generationsBytes(source, source->chunksCapacity));
+    }
+
+    if(source->freeCount) {
+        memcpy(destination->freeSlots, source->freeSlots, source->freeCount * sizeof(size));
+    }
+
+    destination->slotsCount = source->slotsCount;
+    destination->freeCount  = source->freeCount;
+
+    return true;
+}
+
+void* Arena_resolve(const Arena* arena, Handle handle) {
+    if(handle.generation == 0 || handle.slot >= arena->slotsCount) return NULL;
+    if(arena->generations[handle.slot] != handle.generation) return NULL;
+
+    return Arena_at(arena, handle.slot);
+}
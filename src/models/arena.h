@@ -0,0 +1,147 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * Arena Header:
+ *
+ * Describes a chunked arena that stores fixed-size records (Courses, Students, ...).
+ *
+ * Records are handed out in chunks of (1 << chunkShift) members. Once a chunk has been allocated it is never moved,
+ * which means that a pointer to a record stays valid for as long as the record lives. Growing the arena only ever
+ * reallocates the chunk table, which is one pointer per chunk, so adding the hundred-thousandth student costs the same
+ * as adding the first.
+ *
+ * Each record is addressed by its slot, the zero-based position at which it was allocated. Released slots are kept on a
+ * free stack and handed out again before the arena grows.
+ *
+ * Records refer to each other by Handle, a (slot, generation) pair, rather than by pointer. Every slot carries a
+ * generation that is bumped when the slot is released, so a handle to a removed record no longer resolves, even once
+ * its slot has been reused. Since records do not point at each other, the contents of an arena may be copied byte for
+ * byte.
+ */
+
+#ifndef _H_ARENA
+    #define _H_ARENA
+    #include <stdint.h>
+    #include "../util.h"
+    #include "pool.h"
+
+// Begin Header "arena" ------------------------------------------------------------------------------------------------
+
+/*
+ * Reference to a record in an arena. A zeroed handle refers to nothing, as live slots never have generation 0.
+ */
+typedef struct S_Handle {
+
+    uint32_t slot;
+
+    uint32_t generation;
+
+} Handle;
+
+typedef struct S_Arena {
+
+    /*
+     * Pool that chunks and bookkeeping are allocated from
+     */
+    Pool* pool;
+
+    /*
+     * Table of chunks, each of which holds (1 << chunkShift) records
+     */
+    byte** chunks;
+
+    size chunksCount;
+
+    size chunksCapacity;
+
+    /*
+     * Size of one record, in bytes
+     */
+    size memberSize;
+
+    /*
+     * log2 of the number of records per chunk
+     */
+    size chunkShift;
+
+    /*
+     * Number of slots that have ever been handed out (live or released)
+     */
+    size slotsCount;
+
+    /*
+     * Current generation of each slot, one entry per slot of every allocated chunk
+     */
+    uint32_t* generations;
+
+    /*
+     * Stack of released slots that may be handed out again
+     */
+    size* freeSlots;
+
+    size freeCount;
+
+    size freeCapacity;
+
+} Arena;
+
+/*
+ * Prepare an empty arena for records of memberSize bytes, allocating from `pool`. No memory is allocated until the
+ * first push.
+ */
+void Arena_init(Arena* arena, Pool* pool, size memberSize, size chunkShift);
+
+/*
+ * Return every chunk held by the arena to its pool, leaving the arena empty.
+ */
+void Arena_free(Arena* arena);
+
+/*
+ * Copy member in to a free slot (growing the arena by one chunk if necessary) and return that slot.
+ */
+size Arena_push(Arena* arena, const void* member);
+
+/*
+ * Zero the record at slot, invalidate any handle to it, and make the slot available to the next push.
+ */
+void Arena_release(Arena* arena, size slot);
+
+/*
+ * Make `destination`, which must be initialized and empty, an independent copy of `source`, allocated from the pool of
+ * `destination`. Chunks are copied with memcpy. Returns false, leaving `destination` empty, if memory could not be
+ * allocated.
+ */
+bool Arena_clone(Arena* destination, const Arena* source);
+
+/*
+ * Return the record referred to by handle, or NULL if the handle is null or its record has been released.
+ */
+void* Arena_resolve(const Arena* arena, Handle handle);
+
+/*
+ * Return a pointer to the record at slot. The slot must have been returned by Arena_push.
+ */
+static inline void* Arena_at(const Arena* arena, size slot) {
+    return arena->chunks[slot >> arena->chunkShift]
+           + ((slot & (((size) 1 << arena->chunkShift) - 1)) * arena->memberSize);
+}
+
+/*
+ * Return a handle to the live record at slot
+ */
+static inline Handle Arena_handle(const Arena* arena, size slot) {
+    return (Handle){ .slot = (uint32_t) slot, .generation = arena->generations[slot] };
+}
+
+static inline bool Handle_isNull(Handle handle) {
+    return handle.generation == 0;
+}
+
+static inline bool Handle_equals(Handle a, Handle b) {
+    return a.slot == b.slot && a.generation == b.generation;
+}
+
+// End Header "arena" --------------------------------------------------------------------------------------------------
+
+#endif
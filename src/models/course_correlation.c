@@ -0,0 +1,580 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * Course Correlation Definitions:
+ *
+ * Implements the tiled correlation matrix, and its scalar and AVX2 panel kernels, described in course_correlation.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include "course_correlation.h"
+#include "../debug.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+    #define _CORRELATION_X86
+    #include <immintrin.h>
+#endif
+
+/*
+ * Columns of a panel multiplied against each column before moving on to the next group, which together stay in cache
+ */
+static const size _CORRELATION_BLOCK_COLUMNS = 32;
+
+/*
+ * A tile is summed as a dense panel when its students' pairs of courses outnumber its pairs of columns by at least
+ * this much. A panel pair costs a pass over every row, a few rows per instruction; a student's pair costs a scattered
+ * update of the book's sums.
+ */
+static const size _CORRELATION_DENSE_RATIO = 4;
+
+/*
+ * Variances this small, relative to the mean square they come from, are rounding, and the averages all the same
+ */
+static const double _CORRELATION_EPSILON = 1e-6;
+
+/*
+ * Sums over the students shared by a pair of courses a <= b, for the whole book
+ */
+typedef struct S_PairMoments {
+
+    double shared;
+
+    double products;
+
+    double sumsA;
+
+    double sumsB;
+
+    double squaresA;
+
+    double squaresB;
+
+} PairMoments;
+
+// -- Scalar -----------------------------------------------------------------------------------------------------------
+
+static void CorrelationKernels_panelScalar(const float* averages, const float* present, size columns,
+                                           float* shared, float* sums, float* squares, float* products) {
+
+    for(size a = 0; a < columns; ++a) {
+        const float* averagesA  = &averages[a * CourseCorrelation_TILE_ROWS];
+        const float* presentA   = &present[a * CourseCorrelation_TILE_ROWS];
+
+        for(size b = 0; b < columns; ++b) {
+            const float* averagesB  = &averages[b * CourseCorrelation_TILE_ROWS];
+            const float* presentB   = &present[b * CourseCorrelation_TILE_ROWS];
+            float both = 0, sum = 0, square = 0, product = 0;
+
+            for(size row = 0; row < CourseCorrelation_TILE_ROWS; ++row) {
+                float weighed   = averagesA[row] * presentB[row];
+
+                both           += presentA[row] * presentB[row];
+                sum            += weighed;
+                square         += averagesA[row] * weighed;
+                product        += averagesA[row] * averagesB[row];
+            }
+
+            shared[a * columns + b]     = both;
+            sums[a * columns + b]       = sum;
+            squares[a * columns + b]    = square;
+            products[a * columns + b]   = product;
+        }
+    }
+}
+
+static const CorrelationKernels _CORRELATION_KERNELS_SCALAR = {
+        .name   = "scalar",
+        .panel  = &CorrelationKernels_panelScalar
+};
+
+#ifdef _CORRELATION_X86
+
+// -- AVX2 -------------------------------------------------------------------------------------------------------------
+
+/*
+ * Columns are taken in blocks of _CORRELATION_BLOCK_COLUMNS, and every column of the panel is multiplied against the
+ * block while it is in cache. Two columns are multiplied against each column of the block at once, so that each load
+ * of the block's column serves both, keeping eight sums of 8 rows each in registers. These kernels are only called
+ * once CorrelationKernels_select has found that the CPU supports AVX2.
+ */
+#define _CORRELATION_AVX2 __attribute__((target("avx2")))
+
+_CORRELATION_AVX2
+static inline float CorrelationKernels_reduceAvx2(__m256 lanes) {
+    __m128 quads = _mm_add_ps(_mm256_castps256_ps128(lanes), _mm256_extractf128_ps(lanes, 1));
+    __m128 pairs = _mm_add_ps(quads, _mm_movehl_ps(quads, quads));
+    return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+}
+
+/*
+ * Sums of `pair` columns, one or two, from `a`, against column `b`
+ */
+_CORRELATION_AVX2
+static inline void CorrelationKernels_columnsAvx2(const float* averages, const float* present, size columns, size a,
+                                                  size pair, size b, float* shared, float* sums, float* squares,
+                                                  float* products) {
+
+    const float* averagesB  = &averages[b * CourseCorrelation_TILE_ROWS];
+    const float* presentB   = &present[b * CourseCorrelation_TILE_ROWS];
+
+    __m256 both[2], sum[2], square[2], product[2];
+
+    for(size idx = 0; idx < 2; ++idx) both[idx] = sum[idx] = square[idx] = product[idx] = _mm256_setzero_ps();
+
+    for(size row = 0; row < CourseCorrelation_TILE_ROWS; row += 8) {
+        __m256 averageB = _mm256_loadu_ps(&averagesB[row]);
+        __m256 inB      = _mm256_loadu_ps(&presentB[row]);
+
+        for(size idx = 0; idx < pair; ++idx) {
+            __m256 averageA = _mm256_loadu_ps(&averages[(a + idx) * CourseCorrelation_TILE_ROWS + row]);
+            __m256 inA      = _mm256_loadu_ps(&present[(a + idx) * CourseCorrelation_TILE_ROWS + row]);
+            __m256 weighed  = _mm256_mul_ps(averageA, inB);
+
+            both[idx]       = _mm256_add_ps(both[idx], _mm256_mul_ps(inA, inB));
+            sum[idx]        = _mm256_add_ps(sum[idx], weighed);
+            square[idx]     = _mm256_add_ps(square[idx], _mm256_mul_ps(averageA, weighed));
+            product[idx]    = _mm256_add_ps(product[idx], _mm256_mul_ps(averageA, averageB));
+        }
+    }
+
+    for(size idx = 0; idx < pair; ++idx) {
+        size out = (a + idx) * columns + b;
+
+        shared[out]     = CorrelationKernels_reduceAvx2(both[idx]);
+        sums[out]       = CorrelationKernels_reduceAvx2(sum[idx]);
+        squares[out]    = CorrelationKernels_reduceAvx2(square[idx]);
+        products[out]   = CorrelationKernels_reduceAvx2(product[idx]);
+    }
+}
+
+_CORRELATION_AVX2
+static void CorrelationKernels_panelAvx2(const float* averages, const float* present, size columns,
+                                         float* shared, float* sums, float* squares, float* products) {
+
+    for(size block = 0; block < columns; block += _CORRELATION_BLOCK_COLUMNS) {
+        size blockEnd = block + _CORRELATION_BLOCK_COLUMNS < columns ? block + _CORRELATION_BLOCK_COLUMNS : columns;
+
+        for(size a = 0; a < columns; a += 2) {
+            size pair = a + 1 < columns ? 2 : 1;
+
+            for(size b = block; b < blockEnd; ++b) {
+                CorrelationKernels_columnsAvx2(averages, present, columns, a, pair, b,
+                                               shared, sums, squares, products);
+            }
+        }
+    }
+}
+
+static const CorrelationKernels _CORRELATION_KERNELS_AVX2 = {
+        .name   = "avx2",
+        .panel  = &CorrelationKernels_panelAvx2
+};
+
+#endif
+
+// -- Dispatch ---------------------------------------------------------------------------------------------------------
+
+size CorrelationKernels_supported(const CorrelationKernels** sets) {
+    size count = 0;
+
+    sets[count++] = &_CORRELATION_KERNELS_SCALAR;
+
+#ifdef _CORRELATION_X86
+    __builtin_cpu_init();
+
+    if(__builtin_cpu_supports("avx2")) sets[count++] = &_CORRELATION_KERNELS_AVX2;
+#endif
+
+    return count;
+}
+
+/*
+ * The set chosen by CorrelationKernels_select, once, under pthread_once, as it may first be asked for on a worker
+ * thread
+ */
+static pthread_once_t _CORRELATION_KERNELS_ONCE = PTHREAD_ONCE_INIT;
+
+static const CorrelationKernels* _CORRELATION_KERNELS_SELECTED = NULL;
+
+static void CorrelationKernels_choose(void) {
+    const CorrelationKernels* sets[CorrelationKernels_MAX_SETS];
+    _CORRELATION_KERNELS_SELECTED = sets[CorrelationKernels_supported(sets) - 1];
+}
+
+const CorrelationKernels* CorrelationKernels_select(void) {
+    pthread_once(&_CORRELATION_KERNELS_ONCE, &CorrelationKernels_choose);
+    return _CORRELATION_KERNELS_SELECTED;
+}
+
+// -- Tiles ------------------------------------------------------------------------------------------------------------
+
+/*
+ * Scratch space for the tile being summed, reused by every tile
+ */
+typedef struct S_CorrelationTile {
+
+    /*
+     * Course position, and average less its course's mean grade, of each enrollment with grades in the tile, student
+     * by student, each student's in course order
+     */
+    uint32_t* courses;
+
+    float* averages;
+
+    size entriesCapacity;
+
+    /*
+     * Where each student's entries start, and end
+     */
+    size rows[CourseCorrelation_TILE_ROWS + 1];
+
+    size rowsCount;
+
+    /*
+     * Panel column of each course position, or -1 for a course the tile does not touch
+     */
+    long* columnOf;
+
+    /*
+     * Course position of each panel column
+     */
+    uint32_t* columns;
+
+    size columnsCount;
+
+    /*
+     * Dense panel and its sums, grown to fit the widest tile summed as one
+     */
+    float* panel;
+
+    float* sums;
+
+    size panelColumns;
+
+} CorrelationTile;
+
+static void CorrelationTile_growEntries(CorrelationTile* tile, size count) {
+    if(count <= tile->entriesCapacity) return;
+
+    size capacity       = tile->entriesCapacity ? tile->entriesCapacity * 2 : 256;
+    while(capacity < count) capacity *= 2;
+
+    uint32_t* courses   = realloc(tile->courses, capacity * sizeof(uint32_t));
+    tile->courses       = courses ? courses : tile->courses;
+    float* averages     = realloc(tile->averages, capacity * sizeof(float));
+    tile->averages      = averages ? averages : tile->averages;
+
+    if(!courses || !averages) {
+        fprintf(stderr, "CourseCorrelation: unable to allocate %lu entries\n", capacity);
+        abort();
+    }
+
+    tile->entriesCapacity = capacity;
+}
+
+/*
+ * Make room for a panel of `columns` columns: averages and presence, and the four sums of every pair of columns
+ */
+static void CorrelationTile_growPanel(CorrelationTile* tile, size columns) {
+    if(columns <= tile->panelColumns) return;
+
+    float* panel    = realloc(tile->panel, 2 * columns * CourseCorrelation_TILE_ROWS * sizeof(float));
+    tile->panel     = panel ? panel : tile->panel;
+    float* sums     = realloc(tile->sums, 4 * columns * columns * sizeof(float));
+    tile->sums      = sums ? sums : tile->sums;
+
+    if(!panel || !sums) {
+        fprintf(stderr, "CourseCorrelation: unable to allocate a panel of %lu courses\n", columns);
+        abort();
+    }
+
+    tile->panelColumns = columns;
+}
+
+/*
+ * Read the averages of up to CourseCorrelation_TILE_ROWS students, from the `first`th in studentId order. Returns the
+ * number of pairs of courses the tile's students have between them.
+ */
+static size CorrelationTile_gather(CorrelationTile* tile, GradeBook* book, size first, const uint32_t* positionOf,
+                                   const float* means) {
+    size entries = 0, pairs = 0;
+
+    tile->rowsCount     = 0;
+    tile->columnsCount  = 0;
+
+    for(size idx = first; idx < book->studentsCount && tile->rowsCount < CourseCorrelation_TILE_ROWS; ++idx) {
+        Student* student    = GradeBook_studentAt(book, idx);
+        size nCourses       = Student_coursesCount(student);
+        size start          = entries;
+
+        CorrelationTile_growEntries(tile, entries + nCourses);
+
+        for(size course = 0; course < nCourses; ++course) {
+            StudentEnrollment* enrollment = Student_enrollmentAt(book, student, course);
+            if(enrollment->summary.count == 0) continue;
+
+            uint32_t position = positionOf[enrollment->course.slot];
+
+            if(tile->columnOf[position] < 0) {
+                tile->columnOf[position] = (long) tile->columnsCount;
+                tile->columns[tile->columnsCount++] = position;
+            }
+
+            tile->courses[entries]      = position;
+            tile->averages[entries++]   = (float) (GradeSummary_average(enrollment->summary) - means[position]);
+        }
+
+        tile->rows[tile->rowsCount++]   = start;
+        pairs                          += (entries - start) * (entries - start + 1) / 2;
+    }
+
+    tile->rows[tile->rowsCount] = entries;
+
+    return pairs;
+}
+
+/*
+ * Add every student's own pairs of courses to the book's sums
+ */
+static void CorrelationTile_sumSparse(const CorrelationTile* tile, PairMoments* moments, size nCourses) {
+    for(size row = 0; row < tile->rowsCount; ++row) {
+        for(size entryA = tile->rows[row]; entryA < tile->rows[row + 1]; ++entryA) {
+            size a          = tile->courses[entryA];
+            double averageA = tile->averages[entryA];
+            size rowStart   = CourseCorrelation_index(nCourses, a, a) - a;
+
+            for(size entryB = entryA; entryB < tile->rows[row + 1]; ++entryB) {
+                double averageB     = tile->averages[entryB];
+                PairMoments* pair   = &moments[rowStart + tile->courses[entryB]];
+
+                pair->shared       += 1;
+                pair->products     += averageA * averageB;
+                pair->sumsA        += averageA;
+                pair->sumsB        += averageB;
+                pair->squaresA     += averageA * averageA;
+                pair->squaresB     += averageB * averageB;
+            }
+        }
+    }
+}
+
+/*
+ * Lay the tile out as a panel of the courses it touches, sum every pair of its columns, and add the sums to the book's
+ */
+static void CorrelationTile_sumDense(CorrelationTile* tile, const CorrelationKernels* kernels, PairMoments* moments,
+                                     size nCourses) {
+    size nColumns = tile->columnsCount;
+
+    CorrelationTile_growPanel(tile, nColumns);
+
+    float* averages = tile->panel;
+    float* present  = &tile->panel[nColumns * CourseCorrelation_TILE_ROWS];
+
+    memset(tile->panel, 0, 2 * nColumns * CourseCorrelation_TILE_ROWS * sizeof(float));
+
+    for(size row = 0; row < tile->rowsCount; ++row) {
+        for(size entry = tile->rows[row]; entry < tile->rows[row + 1]; ++entry) {
+            size cell = (size) tile->columnOf[tile->courses[entry]] * CourseCorrelation_TILE_ROWS + row;
+
+            averages[cell]  = tile->averages[entry];
+            present[cell]   = 1;
+        }
+    }
+
+    size nSums      = nColumns * nColumns;
+    float* shared   = tile->sums;
+    float* sums     = &tile->sums[nSums];
+    float* squares  = &tile->sums[2 * nSums];
+    float* products = &tile->sums[3 * nSums];
+
+    kernels->panel(averages, present, nColumns, shared, sums, squares, products);
+
+    for(size columnA = 0; columnA < nColumns; ++columnA) {
+        for(size columnB = 0; columnB < nColumns; ++columnB) {
+            size a = tile->columns[columnA], b = tile->columns[columnB];
+            if(a > b) continue;
+
+            PairMoments* pair   = &moments[CourseCorrelation_index(nCourses, a, b)];
+            size ab             = columnA * nColumns + columnB;
+            size ba             = columnB * nColumns + columnA;
+
+            pair->shared       += shared[ab];
+            pair->products     += products[ab];
+            pair->sumsA        += sums[ab];
+            pair->sumsB        += sums[ba];
+            pair->squaresA     += squares[ab];
+            pair->squaresB     += squares[ba];
+        }
+    }
+}
+
+// -- Matrix -----------------------------------------------------------------------------------------------------------
+
+/*
+ * Turn the sums over the students shared by a pair of courses in to their figures
+ */
+static CoursePair CourseCorrelation_figures(const PairMoments* moments, bool diagonal) {
+    CoursePair pair = { .shared = (uint32_t) moments->shared, .covariance = 0, .correlation = NAN };
+    double count    = moments->shared;
+
+    if(pair.shared < 2) return pair;
+
+    double varianceA    = (moments->squaresA - moments->sumsA * moments->sumsA / count) / (count - 1);
+    double varianceB    = (moments->squaresB - moments->sumsB * moments->sumsB / count) / (count - 1);
+    pair.covariance     = (moments->products - moments->sumsA * moments->sumsB / count) / (count - 1);
+
+    if(varianceA <= _CORRELATION_EPSILON * moments->squaresA / count
+       || varianceB <= _CORRELATION_EPSILON * moments->squaresB / count) {
+        return pair;
+    }
+
+    double correlation  = diagonal ? 1 : pair.covariance / sqrt(varianceA * varianceB);
+    pair.correlation    = correlation > 1 ? 1 : (correlation < -1 ? -1 : correlation);
+
+    return pair;
+}
+
+bool CourseCorrelation_build(CourseCorrelation* matrix, GradeBook* book) {
+    size nCourses   = book->coursesCount;
+    size nPairs     = nCourses * (nCourses + 1) / 2;
+
+    *matrix = (CourseCorrelation){};
+
+    identifier* courseIds   = malloc((nCourses ? nCourses : 1) * sizeof(identifier));
+    CoursePair* pairs       = malloc((nPairs ? nPairs : 1) * sizeof(CoursePair));
+    PairMoments* moments    = calloc(nPairs ? nPairs : 1, sizeof(PairMoments));
+    uint32_t* positionOf    = malloc((book->courses.slotsCount ? book->courses.slotsCount : 1) * sizeof(uint32_t));
+    float* means            = malloc((nCourses ? nCourses : 1) * sizeof(float));
+
+    CorrelationTile tile = {};
+    tile.columnOf   = malloc((nCourses ? nCourses : 1) * sizeof(long));
+    tile.columns    = malloc((nCourses ? nCourses : 1) * sizeof(uint32_t));
+
+    if(!courseIds || !pairs || !moments || !positionOf || !means || !tile.columnOf || !tile.columns) {
+        free(courseIds);
+        free(pairs);
+        free(moments);
+        free(positionOf);
+        free(means);
+        free(tile.columnOf);
+        free(tile.columns);
+        return false;
+    }
+
+    for(size position = 0; position < nCourses; ++position) {
+        Course* course                  = GradeBook_courseAt(book, position);
+        courseIds[position]             = course->courseId;
+        positionOf[course->self.slot]   = (uint32_t) position;
+        means[position]                 = (float) GradeSummary_average(course->aggregate.grades);
+        tile.columnOf[position]         = -1;
+    }
+
+    const CorrelationKernels* kernels = CorrelationKernels_select();
+    size nDense = 0, nSparse = 0;
+
+    for(size first = 0; first < book->studentsCount; first += CourseCorrelation_TILE_ROWS) {
+        size studentPairs = CorrelationTile_gather(&tile, book, first, positionOf, means);
+
+        if(studentPairs >= _CORRELATION_DENSE_RATIO * tile.columnsCount * tile.columnsCount) {
+            CorrelationTile_sumDense(&tile, kernels, moments, nCourses);
+            ++nDense;
+        } else {
+            CorrelationTile_sumSparse(&tile, moments, nCourses);
+            ++nSparse;
+        }
+
+        for(size column = 0; column < tile.columnsCount; ++column) tile.columnOf[tile.columns[column]] = -1;
+    }
+
+    d_printf("CourseCorrelation: %lu courses, %lu tiles summed as panels, %lu a student at a time\n", nCourses, nDense,
+             nSparse);
+
+    for(size a = 0; a < nCourses; ++a) {
+        for(size b = a; b < nCourses; ++b) {
+            size index      = CourseCorrelation_index(nCourses, a, b);
+            pairs[index]    = CourseCorrelation_figures(&moments[index], a == b);
+        }
+    }
+
+    matrix->coursesCount    = nCourses;
+    matrix->courseIds       = courseIds;
+    matrix->pairs           = pairs;
+
+    free(tile.courses);
+    free(tile.averages);
+    free(tile.columnOf);
+    free(tile.columns);
+    free(tile.panel);
+    free(tile.sums);
+    free(means);
+    free(positionOf);
+    free(moments);
+
+    return true;
+}
+
+void CourseCorrelation_free(CourseCorrelation* matrix) {
+    free(matrix->courseIds);
+    free(matrix->pairs);
+    *matrix = (CourseCorrelation){};
+}
+
+// -- Queries ----------------------------------------------------------------------------------------------------------
+
+typedef struct S_RankedPair {
+
+    double strength;
+
+    CoursePairPosition position;
+
+} RankedPair;
+
+/*
+ * Strongest first, then in course order
+ */
+static int CourseCorrelation_compareRanked(const void* a, const void* b) {
+    const RankedPair* pairA = a;
+    const RankedPair* pairB = b;
+
+    if(pairA->strength != pairB->strength) return pairA->strength > pairB->strength ? -1 : 1;
+    if(pairA->position.first != pairB->position.first) return pairA->position.first < pairB->position.first ? -1 : 1;
+    if(pairA->position.second != pairB->position.second) return pairA->position.second < pairB->position.second ? -1 : 1;
+
+    return 0;
+}
+
+size CourseCorrelation_strongest(const CourseCorrelation* matrix, size k, CoursePairPosition* destination) {
+    size nCourses   = matrix->coursesCount;
+    size nRanked    = 0;
+
+    RankedPair* ranked = malloc((nCourses * nCourses / 2 + 1) * sizeof(RankedPair));
+
+    if(!ranked) {
+        fprintf(stderr, "CourseCorrelation: unable to rank %lu courses\n", nCourses);
+        abort();
+    }
+
+    for(size a = 0; a < nCourses; ++a) {
+        for(size b = a + 1; b < nCourses; ++b) {
+            double correlation = CourseCorrelation_pair(matrix, a, b)->correlation;
+            if(isnan(correlation)) continue;
+
+            ranked[nRanked++] = (RankedPair){ .strength = fabs(correlation), .position = { .first = a, .second = b } };
+        }
+    }
+
+    qsort(ranked, nRanked, sizeof(RankedPair), &CourseCorrelation_compareRanked);
+
+    size count = k < nRanked ? k : nRanked;
+
+    for(size idx = 0; idx < count; ++idx) destination[idx] = ranked[idx].position;
+
+    free(ranked);
+
+    return count;
+}
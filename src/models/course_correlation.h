@@ -0,0 +1,161 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * Course Correlation Header:
+ *
+ * Describes the course-to-course covariance and correlation matrix of a GradeBook.
+ *
+ * Each student is a row of averages, one per course, with a gap wherever they are not enrolled or have no grades yet.
+ * Courses a and b are compared over the students who have an average in both, and in no other: their covariance, and
+ * their correlation (Pearson's r), are those of the pairs of averages of those students alone.
+ *
+ * Every figure for a pair follows from six sums over its shared students: how many there are, and the sum and sum of
+ * squares of each course's averages, and of their products. Students are taken in tiles of CourseCorrelation_TILE_ROWS,
+ * and the sums of each tile added to those of the whole book, one of two ways:
+ * - where a tile's students share many courses, its averages are laid out as a dense panel, one column per course the
+ *   tile touches, with a presence mask beside it, and a kernel multiplies every pair of columns; a gap is a 0 in both,
+ *   so it drops out of every product by itself
+ * - where they share few, as in a large book where each student takes a handful of courses out of thousands, the panel
+ *   would be almost all gaps, so each student's own pairs of courses are added up directly
+ * Whichever would do less work is chosen for each tile. The dense kernel comes in a scalar version, and one that takes
+ * 8 rows per instruction with AVX2; the fastest the CPU supports is chosen by CorrelationKernels_select.
+ *
+ * Sums are taken of averages less the mean grade of their course, which leaves every figure the same, but keeps them
+ * small, so that the variances do not come from the difference of two large, nearly equal numbers.
+ */
+
+#ifndef _H_COURSE_CORRELATION
+    #define _H_COURSE_CORRELATION
+    #include <stdint.h>
+    #include "../util.h"
+    #include "models.h"
+
+// Begin Header "course correlation" -----------------------------------------------------------------------------------
+
+/*
+ * Students summed together
+ */
+#define CourseCorrelation_TILE_ROWS 64
+
+/*
+ * Figures for one pair of courses
+ */
+typedef struct S_CoursePair {
+
+    /*
+     * Students with an average in both courses
+     */
+    uint32_t shared;
+
+    /*
+     * Sample covariance of the shared students' averages, or 0 for fewer than two
+     */
+    double covariance;
+
+    /*
+     * Pearson's r of the shared students' averages, or NAN for fewer than two, or where either course's averages
+     * are all the same
+     */
+    double correlation;
+
+} CoursePair;
+
+typedef struct S_CourseCorrelation {
+
+    size coursesCount;
+
+    /*
+     * Course IDs, in courseId order, which is the order of the rows and columns of the matrix
+     */
+    identifier* courseIds;
+
+    /*
+     * The upper triangle of the matrix, diagonal included, row by row (see CourseCorrelation_pair). The diagonal holds
+     * each course's own variance, and a correlation of 1.
+     */
+    CoursePair* pairs;
+
+} CourseCorrelation;
+
+/*
+ * Sums of one tile of a dense panel, for every pair of its `columns` columns. Columns are CourseCorrelation_TILE_ROWS
+ * rows long; `averages` has a 0 wherever `present` has, and `present` is 1 or 0. For columns a and b, each output
+ * holds at [a * columns + b]:
+ * - shared: sum of present[a] * present[b]
+ * - sums: sum of averages[a] * present[b]
+ * - squares: sum of averages[a] ^ 2 * present[b]
+ * - products: sum of averages[a] * averages[b]
+ */
+typedef struct S_CorrelationKernels {
+
+    /*
+     * Instruction set the kernels are written for, such as "avx2"
+     */
+    const char* name;
+
+    void (*panel)(const float* averages, const float* present, size columns,
+                  float* shared, float* sums, float* squares, float* products);
+
+} CorrelationKernels;
+
+#define CorrelationKernels_MAX_SETS 2
+
+/*
+ * Return the fastest set of kernels that the CPU supports
+ */
+const CorrelationKernels* CorrelationKernels_select(void);
+
+/*
+ * Fill `sets` with every set of kernels that the CPU supports, scalar first, and return how many there are.
+ * `sets` must have room for CorrelationKernels_MAX_SETS sets. Sets add up in different orders, so they agree only to
+ * within rounding.
+ */
+size CorrelationKernels_supported(const CorrelationKernels** sets);
+
+/*
+ * Build the matrix of every pair of courses of `book`. Returns false, leaving `matrix` empty, if memory for it could
+ * not be allocated: the matrix keeps about 12 bytes for every course squared, and needs three times that while it is
+ * built.
+ */
+bool CourseCorrelation_build(CourseCorrelation* matrix, GradeBook* book);
+
+void CourseCorrelation_free(CourseCorrelation* matrix);
+
+/*
+ * Position in matrix->pairs of the pair of courses at positions `a` <= `b`
+ */
+static inline size CourseCorrelation_index(size coursesCount, size a, size b) {
+    // Row a of the triangle starts past the a rows before it, of coursesCount, coursesCount - 1, ... entries
+    return a * coursesCount - a * (a - 1) / 2 + (b - a);
+}
+
+/*
+ * Figures for the courses at positions `a` and `b` of matrix->courseIds, in either order
+ */
+static inline const CoursePair* CourseCorrelation_pair(const CourseCorrelation* matrix, size a, size b) {
+    return &matrix->pairs[a <= b ? CourseCorrelation_index(matrix->coursesCount, a, b)
+                                 : CourseCorrelation_index(matrix->coursesCount, b, a)];
+}
+
+/*
+ * Positions in matrix->courseIds of two courses
+ */
+typedef struct S_CoursePairPosition {
+
+    size first;
+
+    size second;
+
+} CoursePairPosition;
+
+/*
+ * Write the positions of the (at most) `k` pairs of different courses whose averages are most strongly correlated,
+ * either way, to `destination`, strongest first, and return how many were written. Pairs with no correlation are
+ * left out. Aborts if memory could not be allocated.
+ */
+size CourseCorrelation_strongest(const CourseCorrelation* matrix, size k, CoursePairPosition* destination);
+
+// End Header "course correlation" -------------------------------------------------------------------------------------
+
+#endif
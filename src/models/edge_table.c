@@ -0,0 +1,209 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * Edge Table Definitions:
+ *
+ * Implements the edge indexes described in edge_table.h
+ */
+
+#include <string.h>
+#include "edge_table.h"
+
+const uint32_t EdgeIndex_EMPTY = UINT32_MAX;
+
+static const size _EDGE_INDEX_INITIAL_CAPACITY = 16;
+
+// Edge Index ----------------------------------------------------------------------------------------------------------
+
+static inline uint64_t EdgeIndex_key(uint32_t left, uint32_t right) {
+    return ((uint64_t) left << 32) | right;
+}
+
+/*
+ * Fibonacci hashing, as in IdIndex, on the 64-bit key
+ */
+static inline size EdgeIndex_home(const EdgeIndex* index, uint64_t key) {
+    uint64_t hash = key * 11400714819323198485u;
+    return (size) (hash ^ (hash >> 32)) & (index->capacity - 1);
+}
+
+void EdgeIndex_init(EdgeIndex* index, Pool* pool) {
+    memset(index, 0, sizeof(EdgeIndex));
+    index->pool = pool;
+}
+
+void EdgeIndex_free(EdgeIndex* index) {
+    Pool_release(index->pool, index->entries, index->capacity * sizeof(EdgeIndexEntry));
+    EdgeIndex_init(index, index->pool);
+}
+
+bool EdgeIndex_clone(EdgeIndex* destination, const EdgeIndex* source) {
+
+    EdgeIndex_init(destination, destination->pool);
+
+    if(source->capacity == 0) return true;
+
+    destination->entries = Pool_alloc(destination->pool, source->capacity * sizeof(EdgeIndexEntry));
+
+    if(!destination->entries) return false;
+
+    memcpy(destination->entries, source->entries, source->capacity * sizeof(EdgeIndexEntry));
+    destination->capacity   = source->capacity;
+    destination->count      = source->count;
+
+    return true;
+}
+
+static bool EdgeIndex_insertKey(EdgeIndex* index, uint64_t key, size edge);
+
+static bool EdgeIndex_resize(EdgeIndex* index, size capacity) {
+
+    EdgeIndexEntry* entries = Pool_alloc(index->pool, capacity * sizeof(EdgeIndexEntry));
+
+    if(!entries) return false;
+
+    for(size idx = 0; idx < capacity; ++idx) {
+        entries[idx].edge = EdgeIndex_EMPTY;
+    }
+
+    EdgeIndex old = *index;
+
+    index->entries  = entries;
+    index->capacity = capacity;
+    index->count    = 0;
+
+    for(size idx = 0; idx < old.capacity; ++idx) {
+        if(old.entries[idx].edge != EdgeIndex_EMPTY) {
+            EdgeIndex_insertKey(index, old.entries[idx].key, old.entries[idx].edge);
+        }
+    }
+
+    Pool_release(index->pool, old.entries, old.capacity * sizeof(EdgeIndexEntry));
+
+    return true;
+}
+
+static bool EdgeIndex_insertKey(EdgeIndex* index, uint64_t key, size edge) {
+
+    // Keep the load factor at or below 1/2, which keeps linear probe sequences short
+    if((index->count + 1) * 2 > index->capacity) {
+        size capacity = index->capacity ? index->capacity * 2 : _EDGE_INDEX_INITIAL_CAPACITY;
+
+        if(!EdgeIndex_resize(index, capacity)) {
+            fprintf(stderr, "EdgeIndex: unable to grow to %lu entries\n", capacity);
+            abort();
+        }
+    }
+
+    size mask = index->capacity - 1;
+
+    for(size pos = EdgeIndex_home(index, key); ; pos = (pos + 1) & mask) {
+        EdgeIndexEntry* entry = &index->entries[pos];
+
+        if(entry->edge == EdgeIndex_EMPTY) {
+            entry->key  = key;
+            entry->edge = (uint32_t) edge;
+            ++index->count;
+            return true;
+        }
+
+        if(entry->key == key) return false;
+    }
+}
+
+bool EdgeIndex_insert(EdgeIndex* index, uint32_t left, uint32_t right, size edge) {
+    return EdgeIndex_insertKey(index, EdgeIndex_key(left, right), edge);
+}
+
+long EdgeIndex_find(const EdgeIndex* index, uint32_t left, uint32_t right) {
+
+    if(index->count == 0) return -1;
+
+    uint64_t key    = EdgeIndex_key(left, right);
+    size mask       = index->capacity - 1;
+
+    for(size pos = EdgeIndex_home(index, key); ; pos = (pos + 1) & mask) {
+        const EdgeIndexEntry* entry = &index->entries[pos];
+
+        if(entry->edge == EdgeIndex_EMPTY) return -1;
+        if(entry->key == key) return (long) entry->edge;
+    }
+}
+
+bool EdgeIndex_remove(EdgeIndex* index, uint32_t left, uint32_t right) {
+
+    if(index->count == 0) return false;
+
+    uint64_t key    = EdgeIndex_key(left, right);
+    size mask       = index->capacity - 1;
+    size pos        = EdgeIndex_home(index, key);
+
+    while(index->entries[pos].edge != EdgeIndex_EMPTY && index->entries[pos].key != key) {
+        pos = (pos + 1) & mask;
+    }
+
+    if(index->entries[pos].edge == EdgeIndex_EMPTY) return false;
+
+    // Backward-shift deletion, see IdIndex_remove
+    size hole = pos;
+
+    for(size next = (hole + 1) & mask; index->entries[next].edge != EdgeIndex_EMPTY; next = (next + 1) & mask) {
+        size home = EdgeIndex_home(index, index->entries[next].key);
+
+        if(((next - home) & mask) >= ((next - hole) & mask)) {
+            index->entries[hole] = index->entries[next];
+            hole = next;
+        }
+    }
+
+    index->entries[hole].edge = EdgeIndex_EMPTY;
+    --index->count;
+
+    return true;
+}
+
+// Edge Rows -----------------------------------------------------------------------------------------------------------
+
+void EdgeRows_init(EdgeRows* rows, Pool* pool) {
+    memset(rows, 0, sizeof(EdgeRows));
+    rows->pool = pool;
+}
+
+void EdgeRows_free(EdgeRows* rows) {
+    Pool_release(rows->pool, rows->offsets, rows->rowsCapacity * sizeof(uint32_t));
+    Pool_release(rows->pool, rows->edges, rows->edgesCapacity * sizeof(uint32_t));
+    EdgeRows_init(rows, rows->pool);
+}
+
+void EdgeRows_reset(EdgeRows* rows, size rowsCount, size edgesCount) {
+
+    if(rowsCount + 1 > rows->rowsCapacity) {
+        uint32_t* offsets = Pool_resize(rows->pool, rows->offsets,
+                                        rows->rowsCapacity * sizeof(uint32_t), (rowsCount + 1) * sizeof(uint32_t));
+
+        if(!offsets) {
+            fprintf(stderr, "EdgeRows: unable to grow to %lu rows\n", rowsCount);
+            abort();
+        }
+
+        rows->offsets       = offsets;
+        rows->rowsCapacity  = rowsCount + 1;
+    }
+
+    if(edgesCount > rows->edgesCapacity) {
+        uint32_t* edges = Pool_resize(rows->pool, rows->edges,
+                                      rows->edgesCapacity * sizeof(uint32_t), edgesCount * sizeof(uint32_t));
+
+        if(!edges) {
+            fprintf(stderr, "EdgeRows: unable to grow to %lu edges\n", edgesCount);
+            abort();
+        }
+
+        rows->edges         = edges;
+        rows->edgesCapacity = edgesCount;
+    }
+
+    memset(rows->offsets, 0, (rowsCount + 1) * sizeof(uint32_t));
+    rows->rowsCount = rowsCount;
+}
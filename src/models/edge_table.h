@@ -0,0 +1,137 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * Edge Table Header:
+ *
+ * Describes the two indexes that sit over a table of edges (enrollments) between two kinds of records (students and
+ * courses), where every record and every edge is addressed by its arena slot.
+ *
+ * - EdgeIndex maps a (left slot, right slot) pair to the slot of the edge joining them. It is an open-addressing hash
+ *   in the same style as IdIndex, and answers "is this student enrolled in this course" without a scan.
+ * - EdgeRows is a compressed sparse row index: the edge slots of every record are stored back to back in one array,
+ *   and offsets[row] .. offsets[row + 1] delimits the edges of the record in slot `row`. Walking a roster or a
+ *   transcript therefore reads one contiguous run of memory.
+ */
+
+#ifndef _H_EDGE_TABLE
+    #define _H_EDGE_TABLE
+    #include <stdint.h>
+    #include "../util.h"
+    #include "pool.h"
+
+// Begin Header "edge table" -------------------------------------------------------------------------------------------
+
+typedef struct S_EdgeIndexEntry {
+
+    /*
+     * Left slot in the upper 32 bits, right slot in the lower 32 bits
+     */
+    uint64_t key;
+
+    /*
+     * Slot of the edge, or EdgeIndex_EMPTY
+     */
+    uint32_t edge;
+
+} EdgeIndexEntry;
+
+typedef struct S_EdgeIndex {
+
+    /*
+     * Table of entries, `capacity` long. Capacity is always zero or a power of two.
+     */
+    EdgeIndexEntry* entries;
+
+    size capacity;
+
+    size count;
+
+    /*
+     * Pool that the table is allocated from
+     */
+    Pool* pool;
+
+} EdgeIndex;
+
+/*
+ * Edge value that marks an unused entry
+ */
+extern const uint32_t EdgeIndex_EMPTY;
+
+void EdgeIndex_init(EdgeIndex* index, Pool* pool);
+
+void EdgeIndex_free(EdgeIndex* index);
+
+/*
+ * Make `destination`, which must be initialized and empty, an independent copy of `source`, allocated from the pool of
+ * `destination`. Returns false, leaving `destination` empty, on allocation failure.
+ */
+bool EdgeIndex_clone(EdgeIndex* destination, const EdgeIndex* source);
+
+/*
+ * Map (left, right) to edge. Returns false, and leaves the index unchanged, if the pair is already present.
+ */
+bool EdgeIndex_insert(EdgeIndex* index, uint32_t left, uint32_t right, size edge);
+
+/*
+ * Return the edge mapped to (left, right), or -1 if the pair is not present.
+ */
+long EdgeIndex_find(const EdgeIndex* index, uint32_t left, uint32_t right);
+
+/*
+ * Remove the mapping for (left, right). Returns false if the pair was not present.
+ */
+bool EdgeIndex_remove(EdgeIndex* index, uint32_t left, uint32_t right);
+
+typedef struct S_EdgeRows {
+
+    /*
+     * rowsCount + 1 offsets in to `edges`
+     */
+    uint32_t* offsets;
+
+    /*
+     * Edge slots, grouped by row
+     */
+    uint32_t* edges;
+
+    size rowsCount;
+
+    size rowsCapacity;
+
+    size edgesCapacity;
+
+    /*
+     * Pool that offsets and edges are allocated from
+     */
+    Pool* pool;
+
+} EdgeRows;
+
+void EdgeRows_init(EdgeRows* rows, Pool* pool);
+
+void EdgeRows_free(EdgeRows* rows);
+
+/*
+ * Make room for `rowsCount` rows holding `edgesCount` edges in total, and zero every offset.
+ * Aborts if memory could not be allocated.
+ */
+void EdgeRows_reset(EdgeRows* rows, size rowsCount, size edgesCount);
+
+/*
+ * Return the edges of `row`, storing their number in `count`. A row past the end of the index is empty.
+ */
+static inline const uint32_t* EdgeRows_row(const EdgeRows* rows, size row, size* count) {
+    if(row >= rows->rowsCount) {
+        *count = 0;
+        return NULL;
+    }
+
+    *count = rows->offsets[row + 1] - rows->offsets[row];
+    return &rows->edges[rows->offsets[row]];
+}
+
+// End Header "edge table" ---------------------------------------------------------------------------------------------
+
+#endif
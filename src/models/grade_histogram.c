@@ -0,0 +1,232 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * Grade Histogram Definitions:
+ *
+ * Implements the narrow and wide grade histograms, and the distribution queries, described in grade_histogram.h
+ */
+
+#include <string.h>
+#include <math.h>
+#include "grade_histogram.h"
+
+/*
+ * 64 narrow or 16 wide histograms (16KiB) per arena chunk
+ */
+static const size _HISTOGRAM_NARROW_CHUNK_SHIFT  = 6;
+static const size _HISTOGRAM_WIDE_CHUNK_SHIFT    = 4;
+
+static inline bool HistogramRef_isWide(HistogramRef histogram) {
+    return ((histogram - 1) & 1) != 0;
+}
+
+static inline size HistogramRef_slot(HistogramRef histogram) {
+    return (histogram - 1) >> 1;
+}
+
+static inline HistogramRef HistogramRef_make(size slot, bool wide) {
+    return (HistogramRef) ((slot << 1) | wide) + 1;
+}
+
+void HistogramPool_init(HistogramPool* histograms, Pool* memory) {
+    Arena_init(&histograms->narrow, memory, GradeHistogram_BUCKETS * sizeof(byte), _HISTOGRAM_NARROW_CHUNK_SHIFT);
+    Arena_init(&histograms->wide, memory, GradeHistogram_BUCKETS * sizeof(uint32_t), _HISTOGRAM_WIDE_CHUNK_SHIFT);
+}
+
+bool HistogramPool_clone(HistogramPool* destination, const HistogramPool* source) {
+    return Arena_clone(&destination->narrow, &source->narrow) && Arena_clone(&destination->wide, &source->wide);
+}
+
+/*
+ * Move a narrow histogram to a wide one
+ */
+static void Histogram_widen(HistogramPool* histograms, HistogramRef* histogram) {
+    uint32_t counts[GradeHistogram_BUCKETS];
+    size narrowSlot     = HistogramRef_slot(*histogram);
+    const byte* narrow  = Arena_at(&histograms->narrow, narrowSlot);
+
+    for(size bucket = 0; bucket < GradeHistogram_BUCKETS; ++bucket) counts[bucket] = narrow[bucket];
+
+    size wideSlot = Arena_push(&histograms->wide, counts);
+    Arena_release(&histograms->narrow, narrowSlot);
+
+    *histogram = HistogramRef_make(wideSlot, true);
+}
+
+void Histogram_add(HistogramPool* histograms, HistogramRef* histogram, grade value) {
+
+    if(*histogram == 0) {
+        byte empty[GradeHistogram_BUCKETS] = {};
+        *histogram = HistogramRef_make(Arena_push(&histograms->narrow, empty), false);
+    }
+
+    if(!HistogramRef_isWide(*histogram)) {
+        byte* counts = Arena_at(&histograms->narrow, HistogramRef_slot(*histogram));
+
+        if(counts[value] < 0xFF) {
+            ++counts[value];
+            return;
+        }
+
+        Histogram_widen(histograms, histogram);
+    }
+
+    ++((uint32_t*) Arena_at(&histograms->wide, HistogramRef_slot(*histogram)))[value];
+}
+
+void Histogram_remove(HistogramPool* histograms, HistogramRef* histogram, grade value) {
+    if(HistogramRef_isWide(*histogram)) {
+        --((uint32_t*) Arena_at(&histograms->wide, HistogramRef_slot(*histogram)))[value];
+    } else {
+        --((byte*) Arena_at(&histograms->narrow, HistogramRef_slot(*histogram)))[value];
+    }
+}
+
+void Histogram_subtract(HistogramPool* histograms, HistogramRef* histogram, const uint32_t counts[GradeHistogram_BUCKETS]) {
+    if(HistogramRef_isWide(*histogram)) {
+        uint32_t* wide = Arena_at(&histograms->wide, HistogramRef_slot(*histogram));
+        for(size bucket = 0; bucket < GradeHistogram_BUCKETS; ++bucket) wide[bucket] -= counts[bucket];
+    } else {
+        byte* narrow = Arena_at(&histograms->narrow, HistogramRef_slot(*histogram));
+        for(size bucket = 0; bucket < GradeHistogram_BUCKETS; ++bucket) narrow[bucket] -= (byte) counts[bucket];
+    }
+}
+
+void Histogram_remap(HistogramPool* histograms, HistogramRef* histogram, const uint32_t counts[GradeHistogram_BUCKETS],
+                     const grade table[GradeHistogram_BUCKETS]) {
+    if(*histogram == 0) return;
+
+    GradeDistribution remapped;
+    Histogram_read(histograms, *histogram, &remapped);
+
+    for(size bucket = 0; bucket < GradeHistogram_BUCKETS; ++bucket) {
+        remapped.counts[bucket]         -= counts[bucket];
+        remapped.counts[table[bucket]]  += counts[bucket];
+    }
+
+    if(!HistogramRef_isWide(*histogram)) {
+        bool fits = true;
+
+        for(size bucket = 0; bucket < GradeHistogram_BUCKETS; ++bucket) fits &= remapped.counts[bucket] <= 0xFF;
+
+        if(fits) {
+            byte* narrow = Arena_at(&histograms->narrow, HistogramRef_slot(*histogram));
+            for(size bucket = 0; bucket < GradeHistogram_BUCKETS; ++bucket) narrow[bucket] = (byte) remapped.counts[bucket];
+            return;
+        }
+
+        Histogram_widen(histograms, histogram);
+    }
+
+    memcpy(Arena_at(&histograms->wide, HistogramRef_slot(*histogram)), remapped.counts, sizeof(remapped.counts));
+}
+
+void Histogram_release(HistogramPool* histograms, HistogramRef* histogram) {
+    if(*histogram == 0) return;
+
+    Arena_release(HistogramRef_isWide(*histogram) ? &histograms->wide : &histograms->narrow, HistogramRef_slot(*histogram));
+    *histogram = 0;
+}
+
+void Histogram_read(const HistogramPool* histograms, HistogramRef histogram, GradeDistribution* distribution) {
+
+    distribution->count = 0;
+
+    if(histogram == 0) {
+        memset(distribution->counts, 0, sizeof(distribution->counts));
+    } else if(HistogramRef_isWide(histogram)) {
+        memcpy(distribution->counts, Arena_at(&histograms->wide, HistogramRef_slot(histogram)), sizeof(distribution->counts));
+    } else {
+        const byte* narrow = Arena_at(&histograms->narrow, HistogramRef_slot(histogram));
+        for(size bucket = 0; bucket < GradeHistogram_BUCKETS; ++bucket) distribution->counts[bucket] = narrow[bucket];
+    }
+
+    for(size bucket = 0; bucket < GradeHistogram_BUCKETS; ++bucket) distribution->count += distribution->counts[bucket];
+}
+
+void GradeDistribution_merge(GradeDistribution* distribution, const GradeDistribution* other) {
+    for(size bucket = 0; bucket < GradeHistogram_BUCKETS; ++bucket) distribution->counts[bucket] += other->counts[bucket];
+    distribution->count += other->count;
+}
+
+// -- Queries ----------------------------------------------------------------------------------------------------------
+
+/*
+ * Return the grade of the given rank, counting from 1, in sorted order
+ */
+static grade GradeDistribution_ranked(const GradeDistribution* distribution, size rank) {
+    size seen = 0;
+
+    for(size bucket = 0; bucket < GradeHistogram_BUCKETS; ++bucket) {
+        seen += distribution->counts[bucket];
+        if(seen >= rank) return (grade) bucket;
+    }
+
+    return (grade) (GradeHistogram_BUCKETS - 1);
+}
+
+grade GradeDistribution_percentile(const GradeDistribution* distribution, double percentile) {
+    if(distribution->count == 0) return 0;
+
+    if(percentile < 0) percentile = 0;
+    if(percentile > 100) percentile = 100;
+
+    size rank = (size) ceil(percentile / 100.0 * (double) distribution->count);
+
+    return GradeDistribution_ranked(distribution, rank > 0 ? rank : 1);
+}
+
+double GradeDistribution_median(const GradeDistribution* distribution) {
+    size count = distribution->count;
+
+    if(count == 0) return 0;
+
+    if(count % 2 == 1) return GradeDistribution_ranked(distribution, count / 2 + 1);
+
+    return (GradeDistribution_ranked(distribution, count / 2) + GradeDistribution_ranked(distribution, count / 2 + 1)) / 2.0;
+}
+
+grade GradeDistribution_mode(const GradeDistribution* distribution) {
+    size mode = 0;
+
+    for(size bucket = 1; bucket < GradeHistogram_BUCKETS; ++bucket) {
+        if(distribution->counts[bucket] > distribution->counts[mode]) mode = bucket;
+    }
+
+    return (grade) mode;
+}
+
+double GradeDistribution_mean(const GradeDistribution* distribution) {
+    if(distribution->count == 0) return 0;
+
+    uint64_t sum = 0;
+
+    for(size bucket = 0; bucket < GradeHistogram_BUCKETS; ++bucket) sum += (uint64_t) bucket * distribution->counts[bucket];
+
+    return (double) sum / (double) distribution->count;
+}
+
+double GradeDistribution_stddev(const GradeDistribution* distribution) {
+    if(distribution->count == 0) return 0;
+
+    double mean = GradeDistribution_mean(distribution), squares = 0;
+
+    for(size bucket = 0; bucket < GradeHistogram_BUCKETS; ++bucket) {
+        squares += distribution->counts[bucket] * (bucket - mean) * (bucket - mean);
+    }
+
+    return sqrt(squares / (double) distribution->count);
+}
+
+double GradeDistribution_percentileRank(const GradeDistribution* distribution, double score) {
+    if(distribution->count == 0) return 0;
+
+    size atOrBelow = 0;
+
+    for(size bucket = 0; bucket < GradeHistogram_BUCKETS && bucket <= score; ++bucket) {
+        atOrBelow += distribution->counts[bucket];
+    }
+
+    return 100.0 * (double) atOrBelow / (double) distribution->count;
+}
@@ -0,0 +1,148 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * Grade Histogram Header:
+ *
+ * Describes the grade histograms kept by every course and student, and the queries answered from them.
+ *
+ * A grade is a single byte, so the exact distribution of any number of grades is 256 counters. A record with no grades
+ * has no histogram. Its first grade takes a narrow histogram from the pool, whose counters are single bytes (256 bytes
+ * in all), and the first counter to pass 255 moves it to a wide histogram of 32 bit counters (1KiB). Most students
+ * never give a single grade value 255 times, so they stay narrow; busy courses go wide. Histograms never narrow again,
+ * and are given back to the pool when the last grade of their record is taken away.
+ *
+ * Histograms live in two Arenas of their own, and records refer to them by slot, so a GradeBook copies them wholesale.
+ */
+
+#ifndef _H_GRADE_HISTOGRAM
+    #define _H_GRADE_HISTOGRAM
+    #include <stdint.h>
+    #include "../util.h"
+    #include "arena.h"
+    #include "grade_kernels.h"
+
+// Begin Header "grade histogram" --------------------------------------------------------------------------------------
+
+/*
+ * Number of distinct grades
+ */
+#define GradeHistogram_BUCKETS 256
+
+/*
+ * Histogram of a record, as held in the record: 0 for none, or the arena slot, shifted up past a bit that is set for a
+ * wide histogram, plus one.
+ */
+typedef uint32_t HistogramRef;
+
+typedef struct S_HistogramPool {
+
+    /*
+     * Histograms of byte counters
+     */
+    Arena narrow;
+
+    /*
+     * Histograms of 32 bit counters
+     */
+    Arena wide;
+
+} HistogramPool;
+
+/*
+ * Exact distribution of a set of grades, expanded from a histogram for querying
+ */
+typedef struct S_GradeDistribution {
+
+    uint32_t counts[GradeHistogram_BUCKETS];
+
+    /*
+     * Sum of counts
+     */
+    size count;
+
+} GradeDistribution;
+
+void HistogramPool_init(HistogramPool* histograms, Pool* memory);
+
+/*
+ * Make `destination`, which must be initialized and empty, a copy of `source`. Returns false on allocation failure.
+ */
+bool HistogramPool_clone(HistogramPool* destination, const HistogramPool* source);
+
+/*
+ * Count `value` once more in a histogram, taking one from the pool, or widening it, as needed.
+ * Aborts if memory could not be allocated.
+ */
+void Histogram_add(HistogramPool* histograms, HistogramRef* histogram, grade value);
+
+/*
+ * Count `value` once less. The histogram must hold it.
+ */
+void Histogram_remove(HistogramPool* histograms, HistogramRef* histogram, grade value);
+
+/*
+ * Take every count of `counts` away from a histogram, which must hold them all
+ */
+void Histogram_subtract(HistogramPool* histograms, HistogramRef* histogram, const uint32_t counts[GradeHistogram_BUCKETS]);
+
+/*
+ * Move every count of `counts`, which the histogram must hold, from its grade g to grade table[g], widening the
+ * histogram if a bucket outgrows a byte. Aborts if memory could not be allocated.
+ */
+void Histogram_remap(HistogramPool* histograms, HistogramRef* histogram, const uint32_t counts[GradeHistogram_BUCKETS],
+                     const grade table[GradeHistogram_BUCKETS]);
+
+/*
+ * Give a histogram back to the pool, leaving the record with none
+ */
+void Histogram_release(HistogramPool* histograms, HistogramRef* histogram);
+
+/*
+ * Expand a histogram in to `distribution`. A record with no histogram has an empty distribution.
+ */
+void Histogram_read(const HistogramPool* histograms, HistogramRef histogram, GradeDistribution* distribution);
+
+/*
+ * Add every count of `other` to `distribution`, so that it describes the grades of both. Distributions from any number
+ * of records, or GradeBooks, merge exactly.
+ */
+void GradeDistribution_merge(GradeDistribution* distribution, const GradeDistribution* other);
+
+// -- Queries ----------------------------------------------------------------------------------------------------------
+
+/*
+ * Each query on an empty distribution returns 0
+ */
+
+/*
+ * Grade at `percentile` (0 to 100) by the nearest-rank method: the smallest grade that at least `percentile` percent
+ * of the grades are less than or equal to
+ */
+grade GradeDistribution_percentile(const GradeDistribution* distribution, double percentile);
+
+/*
+ * Middle grade, or the mean of the two middle grades of an even number of grades
+ */
+double GradeDistribution_median(const GradeDistribution* distribution);
+
+/*
+ * Most common grade, the lowest of them if several are equally common
+ */
+grade GradeDistribution_mode(const GradeDistribution* distribution);
+
+double GradeDistribution_mean(const GradeDistribution* distribution);
+
+/*
+ * Population standard deviation
+ */
+double GradeDistribution_stddev(const GradeDistribution* distribution);
+
+/*
+ * Percentage of grades less than or equal to `score`
+ */
+double GradeDistribution_percentileRank(const GradeDistribution* distribution, double score);
+
+// End Header "grade histogram" ----------------------------------------------------------------------------------------
+
+#endif
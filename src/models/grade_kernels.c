@@ -0,0 +1,553 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * Grade Kernels Definitions:
+ *
+ * Implements the scalar, SSE2 and AVX2 grade kernels described in grade_kernels.h
+ */
+
+#include <string.h>
+#include <pthread.h>
+#include "grade_kernels.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+    #define _GRADE_KERNELS_X86
+    #include <immintrin.h>
+#endif
+
+const GradeSummary GradeSummary_EMPTY = { .sum = 0, .count = 0, .smallest = 0xFF, .largest = 0x00 };
+
+// -- Scalar -----------------------------------------------------------------------------------------------------------
+
+static long GradeKernels_sumScalar(const grade* grades, size count) {
+    long accumulator = 0;
+
+    for(size idx = 0; idx < count; ++idx) {
+        accumulator += grades[idx];
+    }
+
+    return accumulator;
+}
+
+static grade GradeKernels_smallestScalar(const grade* grades, size count) {
+    grade smallest = 0xFF;
+
+    for(size idx = 0; idx < count; ++idx) {
+        smallest = grades[idx] < smallest ? grades[idx] : smallest;
+    }
+
+    return smallest;
+}
+
+static grade GradeKernels_largestScalar(const grade* grades, size count) {
+    grade largest = 0x00;
+
+    for(size idx = 0; idx < count; ++idx) {
+        largest = grades[idx] > largest ? grades[idx] : largest;
+    }
+
+    return largest;
+}
+
+static GradeSummary GradeKernels_summarizeScalar(const grade* grades, size count) {
+    GradeSummary summary = GradeSummary_EMPTY;
+
+    for(size idx = 0; idx < count; ++idx) {
+        summary.sum        += grades[idx];
+        summary.smallest    = grades[idx] < summary.smallest ? grades[idx] : summary.smallest;
+        summary.largest     = grades[idx] > summary.largest ? grades[idx] : summary.largest;
+    }
+
+    summary.count = count;
+
+    return summary;
+}
+
+static inline grade GradeCurve_applyOne(const GradeCurve* curve, grade value) {
+    switch(curve->kind) {
+        case CURVE_OFFSET: {
+            int moved = value + curve->offset;
+            return (grade) (moved < 0 ? 0 : (moved > 0xFF ? 0xFF : moved));
+        }
+        case CURVE_SCALE: {
+            uint32_t scaled = ((uint32_t) value * curve->scale + 0x80) >> 8;
+            return (grade) (scaled > 0xFF ? 0xFF : scaled);
+        }
+        case CURVE_CLAMP:
+            return value < curve->low ? curve->low : (value > curve->high ? curve->high : value);
+        case CURVE_MAP:
+            return curve->table[value];
+    }
+
+    return value;
+}
+
+static void GradeKernels_curveScalar(const GradeCurve* curve, grade* grades, size count) {
+    for(size idx = 0; idx < count; ++idx) {
+        grades[idx] = GradeCurve_applyOne(curve, grades[idx]);
+    }
+}
+
+static void GradeKernels_unpackScalar(const byte* packed, grade* grades, size groups) {
+    for(size group = 0; group < groups; ++group, packed += 7, grades += 8) {
+        uint64_t bits = 0;
+
+        for(int idx = 6; idx >= 0; --idx) bits = bits << 8 | packed[idx];
+        for(int idx = 0; idx < 8; ++idx) grades[idx] = (grade) (bits >> (7 * idx) & 0x7F);
+    }
+}
+
+static const GradeKernels _GRADE_KERNELS_SCALAR = {
+        .name       = "scalar",
+        .sum        = &GradeKernels_sumScalar,
+        .smallest   = &GradeKernels_smallestScalar,
+        .largest    = &GradeKernels_largestScalar,
+        .summarize  = &GradeKernels_summarizeScalar,
+        .curve      = &GradeKernels_curveScalar,
+        .unpack     = &GradeKernels_unpackScalar
+};
+
+#ifdef _GRADE_KERNELS_X86
+
+/*
+ * Runs that are not a whole number of vectors end with one more load of the last full vector of grades. That load
+ * overlaps grades that have already been seen, which does not matter to smallest and largest; sums mask the overlap
+ * out with a window of this table, which selects the last `rest` bytes of a vector when loaded from `rest`.
+ */
+static const byte _GRADE_KERNELS_TAIL_MASK[64] = {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+// -- SSE2 -------------------------------------------------------------------------------------------------------------
+
+/*
+ * psadbw against zero sums each half of the vector in to a 64 bit lane
+ */
+static inline long GradeKernels_reduceSum(__m128i sums) {
+    return (long) (_mm_cvtsi128_si64(sums) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(sums, sums)));
+}
+
+static inline grade GradeKernels_reduceSmallest(__m128i lows) {
+    lows = _mm_min_epu8(lows, _mm_srli_si128(lows, 8));
+    lows = _mm_min_epu8(lows, _mm_srli_si128(lows, 4));
+    lows = _mm_min_epu8(lows, _mm_srli_si128(lows, 2));
+    lows = _mm_min_epu8(lows, _mm_srli_si128(lows, 1));
+    return (grade) _mm_cvtsi128_si32(lows);
+}
+
+static inline grade GradeKernels_reduceLargest(__m128i highs) {
+    highs = _mm_max_epu8(highs, _mm_srli_si128(highs, 8));
+    highs = _mm_max_epu8(highs, _mm_srli_si128(highs, 4));
+    highs = _mm_max_epu8(highs, _mm_srli_si128(highs, 2));
+    highs = _mm_max_epu8(highs, _mm_srli_si128(highs, 1));
+    return (grade) _mm_cvtsi128_si32(highs);
+}
+
+static long GradeKernels_sumSse2(const grade* grades, size count) {
+    if(count < 16) return GradeKernels_sumScalar(grades, count);
+
+    __m128i zero = _mm_setzero_si128(), sums = zero;
+    size idx = 0;
+
+    for(; idx + 16 <= count; idx += 16) {
+        sums = _mm_add_epi64(sums, _mm_sad_epu8(_mm_loadu_si128((const __m128i*) &grades[idx]), zero));
+    }
+
+    if(idx < count) {
+        __m128i last = _mm_loadu_si128((const __m128i*) &grades[count - 16]);
+        __m128i mask = _mm_loadu_si128((const __m128i*) &_GRADE_KERNELS_TAIL_MASK[32 - 16 + (count - idx)]);
+        sums = _mm_add_epi64(sums, _mm_sad_epu8(_mm_and_si128(last, mask), zero));
+    }
+
+    return GradeKernels_reduceSum(sums);
+}
+
+static grade GradeKernels_smallestSse2(const grade* grades, size count) {
+    if(count < 16) return GradeKernels_smallestScalar(grades, count);
+
+    __m128i lows = _mm_loadu_si128((const __m128i*) &grades[count - 16]);
+
+    for(size idx = 0; idx + 16 <= count; idx += 16) {
+        lows = _mm_min_epu8(lows, _mm_loadu_si128((const __m128i*) &grades[idx]));
+    }
+
+    return GradeKernels_reduceSmallest(lows);
+}
+
+static grade GradeKernels_largestSse2(const grade* grades, size count) {
+    if(count < 16) return GradeKernels_largestScalar(grades, count);
+
+    __m128i highs = _mm_loadu_si128((const __m128i*) &grades[count - 16]);
+
+    for(size idx = 0; idx + 16 <= count; idx += 16) {
+        highs = _mm_max_epu8(highs, _mm_loadu_si128((const __m128i*) &grades[idx]));
+    }
+
+    return GradeKernels_reduceLargest(highs);
+}
+
+static GradeSummary GradeKernels_summarizeSse2(const grade* grades, size count) {
+    if(count < 16) return GradeKernels_summarizeScalar(grades, count);
+
+    __m128i zero    = _mm_setzero_si128(), sums = zero;
+    __m128i last    = _mm_loadu_si128((const __m128i*) &grades[count - 16]);
+    __m128i lows    = last, highs = last;
+    size idx = 0;
+
+    for(; idx + 16 <= count; idx += 16) {
+        __m128i run = _mm_loadu_si128((const __m128i*) &grades[idx]);
+        sums    = _mm_add_epi64(sums, _mm_sad_epu8(run, zero));
+        lows    = _mm_min_epu8(lows, run);
+        highs   = _mm_max_epu8(highs, run);
+    }
+
+    if(idx < count) {
+        __m128i mask = _mm_loadu_si128((const __m128i*) &_GRADE_KERNELS_TAIL_MASK[32 - 16 + (count - idx)]);
+        sums = _mm_add_epi64(sums, _mm_sad_epu8(_mm_and_si128(last, mask), zero));
+    }
+
+    return (GradeSummary){
+            .sum        = GradeKernels_reduceSum(sums),
+            .count      = count,
+            .smallest   = GradeKernels_reduceSmallest(lows),
+            .largest    = GradeKernels_reduceLargest(highs)
+    };
+}
+
+/*
+ * Multiply 8 grades, widened to 16 bits, by a factor in 1/256ths, rounding halves up: the high half of the product
+ * of the grade shifted up 8 bits is the whole part, and bit 7 of the low half of the plain product is the half.
+ * Anything past the highest grade is cut down to it, so that packing back to bytes cannot wrap.
+ */
+static inline __m128i GradeKernels_scaleWordsSse2(__m128i words, __m128i scale) {
+    __m128i whole   = _mm_mulhi_epu16(_mm_slli_epi16(words, 8), scale);
+    __m128i half    = _mm_and_si128(_mm_srli_epi16(_mm_mullo_epi16(words, scale), 7), _mm_set1_epi16(1));
+    __m128i scaled  = _mm_add_epi16(whole, half);
+
+    return _mm_sub_epi16(scaled, _mm_subs_epu16(scaled, _mm_set1_epi16(0xFF)));
+}
+
+static inline __m128i GradeKernels_curveVectorSse2(const GradeCurve* curve, __m128i run, __m128i operand,
+                                                   __m128i high) {
+    switch(curve->kind) {
+        case CURVE_OFFSET:
+            return curve->offset >= 0 ? _mm_adds_epu8(run, operand) : _mm_subs_epu8(run, operand);
+        case CURVE_SCALE: {
+            __m128i zero = _mm_setzero_si128();
+            return _mm_packus_epi16(GradeKernels_scaleWordsSse2(_mm_unpacklo_epi8(run, zero), operand),
+                                    GradeKernels_scaleWordsSse2(_mm_unpackhi_epi8(run, zero), operand));
+        }
+        case CURVE_CLAMP:
+            return _mm_max_epu8(_mm_min_epu8(run, high), operand);
+        default:
+            return run;
+    }
+}
+
+/*
+ * Offset, scale and clamp take 16 grades per instruction. A table lookup needs a byte shuffle, which SSE2 lacks, so it
+ * is left to the scalar kernel, as is the tail of every run.
+ */
+static void GradeKernels_curveSse2(const GradeCurve* curve, grade* grades, size count) {
+    if(curve->kind == CURVE_MAP) return GradeKernels_curveScalar(curve, grades, count);
+
+    __m128i operand = curve->kind == CURVE_OFFSET ? _mm_set1_epi8((char) (curve->offset >= 0 ? curve->offset : -curve->offset))
+                    : curve->kind == CURVE_SCALE ? _mm_set1_epi16((short) curve->scale)
+                    : _mm_set1_epi8((char) curve->low);
+    __m128i high    = _mm_set1_epi8((char) curve->high);
+    size idx = 0;
+
+    for(; idx + 16 <= count; idx += 16) {
+        __m128i run = _mm_loadu_si128((const __m128i*) &grades[idx]);
+        _mm_storeu_si128((__m128i*) &grades[idx], GradeKernels_curveVectorSse2(curve, run, operand, high));
+    }
+
+    GradeKernels_curveScalar(curve, &grades[idx], count - idx);
+}
+
+/*
+ * Spread the 56 bits low in each 64 bit lane out to 8 bytes of 7 bits: halves of 28 bits in to 32 bit lanes, then
+ * quarters of 14 bits in to 16 bit lanes, then eighths in to bytes, each step one shift and two masks
+ */
+static inline __m128i GradeKernels_spreadSse2(__m128i bits) {
+    bits = _mm_or_si128(_mm_and_si128(bits, _mm_set1_epi64x(0x000000000FFFFFFF)),
+                        _mm_and_si128(_mm_slli_epi64(bits, 4), _mm_set1_epi64x(0x0FFFFFFF00000000)));
+    bits = _mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x00003FFF)),
+                        _mm_and_si128(_mm_slli_epi32(bits, 2), _mm_set1_epi32(0x3FFF0000)));
+    return _mm_or_si128(_mm_and_si128(bits, _mm_set1_epi16(0x007F)),
+                        _mm_and_si128(_mm_slli_epi16(bits, 1), _mm_set1_epi16(0x7F00)));
+}
+
+/*
+ * Two groups at a time. Each load takes 16 bytes for the 14 of two groups, so the last groups are left to the scalar
+ * kernel, which reads no further than they go.
+ */
+static void GradeKernels_unpackSse2(const byte* packed, grade* grades, size groups) {
+    size group = 0;
+
+    for(; group + 3 <= groups; group += 2) {
+        __m128i run = _mm_loadu_si128((const __m128i*) &packed[group * 7]);
+
+        // The second group starts 7 bytes in; the byte past each group is masked off by the spread
+        run = _mm_unpacklo_epi64(run, _mm_srli_si128(run, 7));
+        _mm_storeu_si128((__m128i*) &grades[group * 8], GradeKernels_spreadSse2(run));
+    }
+
+    GradeKernels_unpackScalar(&packed[group * 7], &grades[group * 8], groups - group);
+}
+
+static const GradeKernels _GRADE_KERNELS_SSE2 = {
+        .name       = "sse2",
+        .sum        = &GradeKernels_sumSse2,
+        .smallest   = &GradeKernels_smallestSse2,
+        .largest    = &GradeKernels_largestSse2,
+        .summarize  = &GradeKernels_summarizeSse2,
+        .curve      = &GradeKernels_curveSse2,
+        .unpack     = &GradeKernels_unpackSse2
+};
+
+// -- AVX2 -------------------------------------------------------------------------------------------------------------
+
+/*
+ * The AVX2 kernels are compiled for AVX2 whatever the flags of the build, and are only ever called once
+ * GradeKernels_select has found that the CPU supports it. Runs shorter than a vector are left to the SSE2 kernels.
+ */
+#define _GRADE_KERNELS_AVX2 __attribute__((target("avx2")))
+
+_GRADE_KERNELS_AVX2
+static long GradeKernels_sumAvx2(const grade* grades, size count) {
+    if(count < 32) return GradeKernels_sumSse2(grades, count);
+
+    __m256i zero = _mm256_setzero_si256(), sums = zero;
+    size idx = 0;
+
+    for(; idx + 32 <= count; idx += 32) {
+        sums = _mm256_add_epi64(sums, _mm256_sad_epu8(_mm256_loadu_si256((const __m256i*) &grades[idx]), zero));
+    }
+
+    if(idx < count) {
+        __m256i last = _mm256_loadu_si256((const __m256i*) &grades[count - 32]);
+        __m256i mask = _mm256_loadu_si256((const __m256i*) &_GRADE_KERNELS_TAIL_MASK[count - idx]);
+        sums = _mm256_add_epi64(sums, _mm256_sad_epu8(_mm256_and_si256(last, mask), zero));
+    }
+
+    return GradeKernels_reduceSum(_mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1)));
+}
+
+_GRADE_KERNELS_AVX2
+static grade GradeKernels_smallestAvx2(const grade* grades, size count) {
+    if(count < 32) return GradeKernels_smallestSse2(grades, count);
+
+    __m256i lows = _mm256_loadu_si256((const __m256i*) &grades[count - 32]);
+
+    for(size idx = 0; idx + 32 <= count; idx += 32) {
+        lows = _mm256_min_epu8(lows, _mm256_loadu_si256((const __m256i*) &grades[idx]));
+    }
+
+    return GradeKernels_reduceSmallest(_mm_min_epu8(_mm256_castsi256_si128(lows), _mm256_extracti128_si256(lows, 1)));
+}
+
+_GRADE_KERNELS_AVX2
+static grade GradeKernels_largestAvx2(const grade* grades, size count) {
+    if(count < 32) return GradeKernels_largestSse2(grades, count);
+
+    __m256i highs = _mm256_loadu_si256((const __m256i*) &grades[count - 32]);
+
+    for(size idx = 0; idx + 32 <= count; idx += 32) {
+        highs = _mm256_max_epu8(highs, _mm256_loadu_si256((const __m256i*) &grades[idx]));
+    }
+
+    return GradeKernels_reduceLargest(_mm_max_epu8(_mm256_castsi256_si128(highs), _mm256_extracti128_si256(highs, 1)));
+}
+
+_GRADE_KERNELS_AVX2
+static GradeSummary GradeKernels_summarizeAvx2(const grade* grades, size count) {
+    if(count < 32) return GradeKernels_summarizeSse2(grades, count);
+
+    __m256i zero    = _mm256_setzero_si256(), sums = zero;
+    __m256i last    = _mm256_loadu_si256((const __m256i*) &grades[count - 32]);
+    __m256i lows    = last, highs = last;
+    size idx = 0;
+
+    for(; idx + 32 <= count; idx += 32) {
+        __m256i run = _mm256_loadu_si256((const __m256i*) &grades[idx]);
+        sums    = _mm256_add_epi64(sums, _mm256_sad_epu8(run, zero));
+        lows    = _mm256_min_epu8(lows, run);
+        highs   = _mm256_max_epu8(highs, run);
+    }
+
+    if(idx < count) {
+        __m256i mask = _mm256_loadu_si256((const __m256i*) &_GRADE_KERNELS_TAIL_MASK[count - idx]);
+        sums = _mm256_add_epi64(sums, _mm256_sad_epu8(_mm256_and_si256(last, mask), zero));
+    }
+
+    return (GradeSummary){
+            .sum        = GradeKernels_reduceSum(_mm_add_epi64(_mm256_castsi256_si128(sums),
+                                                               _mm256_extracti128_si256(sums, 1))),
+            .count      = count,
+            .smallest   = GradeKernels_reduceSmallest(_mm_min_epu8(_mm256_castsi256_si128(lows),
+                                                                   _mm256_extracti128_si256(lows, 1))),
+            .largest    = GradeKernels_reduceLargest(_mm_max_epu8(_mm256_castsi256_si128(highs),
+                                                                  _mm256_extracti128_si256(highs, 1)))
+    };
+}
+
+_GRADE_KERNELS_AVX2
+static inline __m256i GradeKernels_scaleWordsAvx2(__m256i words, __m256i scale) {
+    __m256i whole   = _mm256_mulhi_epu16(_mm256_slli_epi16(words, 8), scale);
+    __m256i half    = _mm256_and_si256(_mm256_srli_epi16(_mm256_mullo_epi16(words, scale), 7), _mm256_set1_epi16(1));
+
+    return _mm256_min_epu16(_mm256_add_epi16(whole, half), _mm256_set1_epi16(0xFF));
+}
+
+/*
+ * Look 32 grades up in a 256 entry table, held as 16 rows of 16. Each row is shuffled by the low nibbles of every
+ * grade, and kept only in the bytes whose high nibble is its row.
+ */
+_GRADE_KERNELS_AVX2
+static inline __m256i GradeKernels_mapAvx2(const __m256i rows[16], __m256i run) {
+    __m256i nibble  = _mm256_set1_epi8(0x0F);
+    __m256i low     = _mm256_and_si256(run, nibble);
+    __m256i high    = _mm256_and_si256(_mm256_srli_epi16(run, 4), nibble);
+    __m256i mapped  = _mm256_setzero_si256();
+
+    for(int row = 0; row < 16; ++row) {
+        __m256i inRow   = _mm256_cmpeq_epi8(high, _mm256_set1_epi8((char) row));
+        mapped          = _mm256_or_si256(mapped, _mm256_and_si256(inRow, _mm256_shuffle_epi8(rows[row], low)));
+    }
+
+    return mapped;
+}
+
+/*
+ * Unpacking and packing work within each 128 bit half alike, so bytes widened to words for scaling come back in order
+ */
+_GRADE_KERNELS_AVX2
+static void GradeKernels_curveAvx2(const GradeCurve* curve, grade* grades, size count) {
+    __m256i rows[16];
+    __m256i zero    = _mm256_setzero_si256();
+    __m256i operand = _mm256_set1_epi8((char) (curve->offset >= 0 ? curve->offset : -curve->offset));
+    __m256i scale   = _mm256_set1_epi16((short) curve->scale);
+    __m256i low     = _mm256_set1_epi8((char) curve->low);
+    __m256i high    = _mm256_set1_epi8((char) curve->high);
+    size idx = 0;
+
+    if(curve->kind == CURVE_MAP) {
+        for(int row = 0; row < 16; ++row) {
+            rows[row] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) &curve->table[row * 16]));
+        }
+    }
+
+    for(; idx + 32 <= count; idx += 32) {
+        __m256i run = _mm256_loadu_si256((const __m256i*) &grades[idx]);
+
+        switch(curve->kind) {
+            case CURVE_OFFSET:
+                run = curve->offset >= 0 ? _mm256_adds_epu8(run, operand) : _mm256_subs_epu8(run, operand);
+                break;
+            case CURVE_SCALE:
+                run = _mm256_packus_epi16(GradeKernels_scaleWordsAvx2(_mm256_unpacklo_epi8(run, zero), scale),
+                                          GradeKernels_scaleWordsAvx2(_mm256_unpackhi_epi8(run, zero), scale));
+                break;
+            case CURVE_CLAMP:
+                run = _mm256_max_epu8(_mm256_min_epu8(run, high), low);
+                break;
+            case CURVE_MAP:
+                run = GradeKernels_mapAvx2(rows, run);
+                break;
+        }
+
+        _mm256_storeu_si256((__m256i*) &grades[idx], run);
+    }
+
+    GradeKernels_curveScalar(curve, &grades[idx], count - idx);
+}
+
+_GRADE_KERNELS_AVX2
+static inline __m256i GradeKernels_spreadAvx2(__m256i bits) {
+    bits = _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi64x(0x000000000FFFFFFF)),
+                           _mm256_and_si256(_mm256_slli_epi64(bits, 4), _mm256_set1_epi64x(0x0FFFFFFF00000000)));
+    bits = _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x00003FFF)),
+                           _mm256_and_si256(_mm256_slli_epi32(bits, 2), _mm256_set1_epi32(0x3FFF0000)));
+    return _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi16(0x007F)),
+                           _mm256_and_si256(_mm256_slli_epi16(bits, 1), _mm256_set1_epi16(0x7F00)));
+}
+
+/*
+ * Four groups at a time, two to each half, loaded as the SSE2 kernel loads them. The second load reaches 30 bytes in
+ * to the 28 of four groups.
+ */
+_GRADE_KERNELS_AVX2
+static void GradeKernels_unpackAvx2(const byte* packed, grade* grades, size groups) {
+    size group = 0;
+
+    for(; group + 5 <= groups; group += 4) {
+        __m256i run = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*) &packed[group * 7])),
+                _mm_loadu_si128((const __m128i*) &packed[group * 7 + 14]), 1);
+
+        run = _mm256_unpacklo_epi64(run, _mm256_srli_si256(run, 7));
+        _mm256_storeu_si256((__m256i*) &grades[group * 8], GradeKernels_spreadAvx2(run));
+    }
+
+    GradeKernels_unpackSse2(&packed[group * 7], &grades[group * 8], groups - group);
+}
+
+static const GradeKernels _GRADE_KERNELS_AVX2_SET = {
+        .name       = "avx2",
+        .sum        = &GradeKernels_sumAvx2,
+        .smallest   = &GradeKernels_smallestAvx2,
+        .largest    = &GradeKernels_largestAvx2,
+        .summarize  = &GradeKernels_summarizeAvx2,
+        .curve      = &GradeKernels_curveAvx2,
+        .unpack     = &GradeKernels_unpackAvx2
+};
+
+#endif
+
+// -- Dispatch ---------------------------------------------------------------------------------------------------------
+
+size GradeKernels_supported(const GradeKernels** sets) {
+    size count = 0;
+
+    sets[count++] = &_GRADE_KERNELS_SCALAR;
+
+#ifdef _GRADE_KERNELS_X86
+    __builtin_cpu_init();
+
+    // SSE2 is part of x86-64 itself
+    sets[count++] = &_GRADE_KERNELS_SSE2;
+
+    if(__builtin_cpu_supports("avx2")) sets[count++] = &_GRADE_KERNELS_AVX2_SET;
+#endif
+
+    return count;
+}
+
+/*
+ * The set chosen by GradeKernels_select, once, by whichever thread asks first: books are decoded and summarized on
+ * worker threads (see WorkerPool), so the choice is made under pthread_once rather than by whoever gets there
+ */
+static pthread_once_t _GRADE_KERNELS_ONCE = PTHREAD_ONCE_INIT;
+
+static const GradeKernels* _GRADE_KERNELS_SELECTED = NULL;
+
+static void GradeKernels_choose(void) {
+    const GradeKernels* sets[GradeKernels_MAX_SETS];
+    _GRADE_KERNELS_SELECTED = sets[GradeKernels_supported(sets) - 1];
+}
+
+const GradeKernels* GradeKernels_select(void) {
+    pthread_once(&_GRADE_KERNELS_ONCE, &GradeKernels_choose);
+    return _GRADE_KERNELS_SELECTED;
+}
+
+void GradeCurve_table(const GradeCurve* curve, grade table[256]) {
+    for(size value = 0; value < 256; ++value) table[value] = (grade) value;
+
+    GradeKernels_curveScalar(curve, table, 256);
+}
@@ -0,0 +1,169 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * Grade Kernels Header:
+ *
+ * Describes the loops that every report runs over runs of grades: sum, smallest, largest, and all of them at once; the
+ * loop that rewrites a run of grades by a curve; and the loop that unpacks grades stored in 7 bits apiece.
+ *
+ * Grades are single bytes, so each kernel comes in a scalar version and in versions that take 16 (SSE2) or 32 (AVX2)
+ * grades per instruction. The fastest set the CPU supports is chosen the first time GradeKernels_select is called;
+ * the scalar set is used on every other architecture. Each set gives exactly the same results as the scalar one.
+ */
+
+#ifndef _H_GRADE_KERNELS
+    #define _H_GRADE_KERNELS
+    #include <stdint.h>
+    #include "../util.h"
+
+// Begin Header "grade kernels" ----------------------------------------------------------------------------------------
+
+/*
+ * Define the type used for numeric grades
+ */
+typedef byte grade;
+
+/*
+ * Sum, bounds and count of a run of grades.
+ * The summary of no grades has a sum of 0, a smallest grade of 0xFF and a largest grade of 0, so that it may be merged
+ * with any other.
+ */
+typedef struct S_GradeSummary {
+
+    long sum;
+
+    size count;
+
+    grade smallest;
+
+    grade largest;
+
+} GradeSummary;
+
+extern const GradeSummary GradeSummary_EMPTY;
+
+/*
+ * Fold the summary of another run of grades in to `summary`
+ */
+static inline void GradeSummary_merge(GradeSummary* summary, GradeSummary other) {
+    summary->sum       += other.sum;
+    summary->count     += other.count;
+    summary->smallest   = other.smallest < summary->smallest ? other.smallest : summary->smallest;
+    summary->largest    = other.largest > summary->largest ? other.largest : summary->largest;
+}
+
+/*
+ * Mean of the grades summarized, or 0 for none
+ */
+static inline double GradeSummary_average(GradeSummary summary) {
+    return summary.count > 0 ? (double) summary.sum / (double) summary.count : 0;
+}
+
+typedef enum E_GradeCurveKind {
+
+    /*
+     * Add `offset`, which may be negative, stopping at the lowest and highest grades
+     */
+    CURVE_OFFSET    = 0,
+
+    /*
+     * Multiply by `scale` / 256, rounding halves up, stopping at the highest grade
+     */
+    CURVE_SCALE     = 1,
+
+    /*
+     * Raise grades below `low` to it, and lower grades above `high` to it
+     */
+    CURVE_CLAMP     = 2,
+
+    /*
+     * Replace each grade g with table[g]
+     */
+    CURVE_MAP       = 3
+
+} GradeCurveKind;
+
+/*
+ * One step of a curve, taking each grade to a new one by itself alone
+ */
+typedef struct S_GradeCurve {
+
+    GradeCurveKind kind;
+
+    /*
+     * -255 to 255
+     */
+    int offset;
+
+    /*
+     * Factor in 1/256ths, so that 256 leaves grades as they are
+     */
+    uint16_t scale;
+
+    grade low;
+
+    grade high;
+
+    grade table[256];
+
+} GradeCurve;
+
+typedef struct S_GradeKernels {
+
+    /*
+     * Instruction set the kernels are written for, such as "avx2"
+     */
+    const char* name;
+
+    long (*sum)(const grade* grades, size count);
+
+    /*
+     * 0xFF for no grades
+     */
+    grade (*smallest)(const grade* grades, size count);
+
+    /*
+     * 0 for no grades
+     */
+    grade (*largest)(const grade* grades, size count);
+
+    /*
+     * Sum, smallest, largest and count in a single pass
+     */
+    GradeSummary (*summarize)(const grade* grades, size count);
+
+    /*
+     * Rewrite each grade of the run by `curve`, in place
+     */
+    void (*curve)(const GradeCurve* curve, grade* grades, size count);
+
+    /*
+     * Unpack `groups` groups of 8 grades below 0x80, each packed in to 7 bytes: grade i of a group is bits 7i to
+     * 7i + 6 of the group, read as a little-endian 56 bit number. Only the 7 * groups bytes at `packed` are read.
+     */
+    void (*unpack)(const byte* packed, grade* grades, size groups);
+
+} GradeKernels;
+
+/*
+ * Return the fastest set of kernels that the CPU supports
+ */
+const GradeKernels* GradeKernels_select(void);
+
+/*
+ * Fill `sets` with every set of kernels that the CPU supports, scalar first, and return how many there are.
+ * `sets` must have room for GradeKernels_MAX_SETS sets.
+ */
+size GradeKernels_supported(const GradeKernels** sets);
+
+#define GradeKernels_MAX_SETS 3
+
+/*
+ * Fill `table` with the grade that `curve` takes each grade to
+ */
+void GradeCurve_table(const GradeCurve* curve, grade table[256]);
+
+// End Header "grade kernels" ------------------------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,241 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * Grade Log Definitions:
+ *
+ * Implements the chunked grade log described in grade_log.h
+ */
+
+#include <string.h>
+#include "grade_log.h"
+#include "grade_kernels.h"
+
+/*
+ * 256 chunks (8KiB) per pool chunk
+ */
+static const size _GRADE_POOL_CHUNK_SHIFT = 8;
+
+static inline GradeChunk* GradeLog_chunk(const Arena* pool, uint32_t slot) {
+    return (GradeChunk*) Arena_at(pool, slot);
+}
+
+/*
+ * Return the pool slot of the chunk holding grade `index`
+ */
+static uint32_t GradeLog_seek(const Arena* pool, const GradeLog* log, size index) {
+
+    // The tail is the common case (the last grade given), and is reached without walking the list
+    if(index / GradeLog_CHUNK_GRADES == (log->count - 1) / GradeLog_CHUNK_GRADES) return log->tail;
+
+    uint32_t slot = log->head;
+
+    for(size hops = index / GradeLog_CHUNK_GRADES; hops > 0; --hops) {
+        slot = GradeLog_chunk(pool, slot)->next;
+    }
+
+    return slot;
+}
+
+void GradeLog_initPool(Arena* pool, Pool* memory) {
+    Arena_init(pool, memory, sizeof(GradeChunk), _GRADE_POOL_CHUNK_SHIFT);
+}
+
+void GradeLog_append(Arena* pool, GradeLog* log, grade value) {
+
+    size position = log->count % GradeLog_CHUNK_GRADES;
+
+    if(position == 0) {
+        // The tail is full (or there is none yet); Arena_push aborts if it cannot grow the pool
+        GradeChunk empty    = {};
+        uint32_t slot       = (uint32_t) Arena_push(pool, &empty);
+
+        if(log->count == 0) {
+            log->head = slot;
+        } else {
+            GradeLog_chunk(pool, log->tail)->next = slot;
+        }
+
+        log->tail = slot;
+    }
+
+    GradeLog_chunk(pool, log->tail)->grades[position] = value;
+    ++log->count;
+}
+
+grade GradeLog_at(const Arena* pool, const GradeLog* log, size index) {
+    return GradeLog_chunk(pool, GradeLog_seek(pool, log, index))->grades[index % GradeLog_CHUNK_GRADES];
+}
+
+bool GradeLog_remove(Arena* pool, GradeLog* log, size index) {
+
+    if(index >= log->count) return false;
+
+    // Shift every later grade down by one, following the links where a run crosses in to the next chunk
+    GradeChunk* chunk   = GradeLog_chunk(pool, GradeLog_seek(pool, log, index));
+    size position       = index % GradeLog_CHUNK_GRADES;
+
+    for(size idx = index + 1; idx < log->count; ++idx) {
+        if(position == GradeLog_CHUNK_GRADES - 1) {
+            GradeChunk* next                = GradeLog_chunk(pool, chunk->next);
+            chunk->grades[position]         = next->grades[0];
+            chunk                           = next;
+            position                        = 0;
+        } else {
+            chunk->grades[position] = chunk->grades[position + 1];
+            ++position;
+        }
+    }
+
+    chunk->grades[position] = 0;
+    --log->count;
+
+    // Give the tail back to the pool once it no longer holds any grade
+    if(log->count % GradeLog_CHUNK_GRADES == 0) {
+        uint32_t emptied = log->tail;
+
+        // The new tail is the chunk before the emptied one. GradeLog_seek would take its shortcut to the old tail.
+        if(log->count > 0) {
+            uint32_t slot = log->head;
+
+            for(size hops = (log->count - 1) / GradeLog_CHUNK_GRADES; hops > 0; --hops) {
+                slot = GradeLog_chunk(pool, slot)->next;
+            }
+
+            log->tail = slot;
+        }
+
+        Arena_release(pool, emptied);
+    }
+
+    return true;
+}
+
+void GradeLog_clear(Arena* pool, GradeLog* log) {
+
+    if(log->count > 0) {
+        uint32_t slot   = log->head;
+        size nChunks    = (log->count + GradeLog_CHUNK_GRADES - 1) / GradeLog_CHUNK_GRADES;
+
+        for(size idx = 0; idx < nChunks; ++idx) {
+            uint32_t next = GradeLog_chunk(pool, slot)->next;
+            Arena_release(pool, slot);
+            slot = next;
+        }
+    }
+
+    memset(log, 0, sizeof(GradeLog));
+}
+
+size GradeLog_copy(const Arena* pool, const GradeLog* log, grade* destination) {
+    return GradeLog_copyFirst(pool, log, destination, log->count);
+}
+
+size GradeLog_copyFirst(const Arena* pool, const GradeLog* log, grade* destination, size limit) {
+
+    size copied = 0;
+    size wanted = limit < log->count ? limit : log->count;
+
+    if(wanted == 0) return 0;
+
+    for(GradeChunk* chunk = GradeLog_chunk(pool, log->head); ; chunk = GradeLog_chunk(pool, chunk->next)) {
+        size run = wanted - copied;
+
+        if(run > GradeLog_CHUNK_GRADES) run = GradeLog_CHUNK_GRADES;
+
+        memcpy(destination + copied, chunk->grades, run * sizeof(grade));
+        copied += run;
+
+        if(copied == wanted) return copied;
+    }
+}
+
+void GradeLog_eachRun(const Arena* pool, const GradeLog* log, void (*visit)(void* context, const grade* run, size count),
+                      void* context) {
+
+    size remaining = log->count;
+
+    if(remaining == 0) return;
+
+    for(GradeChunk* chunk = GradeLog_chunk(pool, log->head); ; chunk = GradeLog_chunk(pool, chunk->next)) {
+        size run = remaining > GradeLog_CHUNK_GRADES ? GradeLog_CHUNK_GRADES : remaining;
+
+        visit(context, chunk->grades, run);
+        remaining -= run;
+
+        if(remaining == 0) return;
+    }
+}
+
+void GradeLog_overwrite(Arena* pool, GradeLog* log, const grade* source) {
+
+    size written = 0;
+
+    if(log->count == 0) return;
+
+    for(GradeChunk* chunk = GradeLog_chunk(pool, log->head); ; chunk = GradeLog_chunk(pool, chunk->next)) {
+        size run = log->count - written;
+
+        if(run > GradeLog_CHUNK_GRADES) run = GradeLog_CHUNK_GRADES;
+
+        memcpy(chunk->grades, source + written, run * sizeof(grade));
+        written += run;
+
+        if(written == log->count) return;
+    }
+}
+
+long GradeLog_sum(const Arena* pool, const GradeLog* log) {
+
+    const GradeKernels* kernels = GradeKernels_select();
+    long accumulator            = 0;
+    size remaining              = log->count;
+
+    if(remaining == 0) return 0;
+
+    for(GradeChunk* chunk = GradeLog_chunk(pool, log->head); ; chunk = GradeLog_chunk(pool, chunk->next)) {
+        size run = remaining > GradeLog_CHUNK_GRADES ? GradeLog_CHUNK_GRADES : remaining;
+
+        accumulator    += kernels->sum(chunk->grades, run);
+        remaining      -= run;
+
+        if(remaining == 0) return accumulator;
+    }
+}
+
+GradeSummary GradeLog_summarize(const Arena* pool, const GradeLog* log) {
+
+    const GradeKernels* kernels = GradeKernels_select();
+    GradeSummary summary        = GradeSummary_EMPTY;
+    size remaining              = log->count;
+
+    if(remaining == 0) return summary;
+
+    for(GradeChunk* chunk = GradeLog_chunk(pool, log->head); ; chunk = GradeLog_chunk(pool, chunk->next)) {
+        size run = remaining > GradeLog_CHUNK_GRADES ? GradeLog_CHUNK_GRADES : remaining;
+
+        GradeSummary_merge(&summary, kernels->summarize(chunk->grades, run));
+        remaining -= run;
+
+        if(remaining == 0) return summary;
+    }
+}
+
+void GradeLog_tally(const Arena* pool, const GradeLog* log, uint32_t counts[256]) {
+
+    size remaining = log->count;
+
+    if(remaining == 0) return;
+
+    for(GradeChunk* chunk = GradeLog_chunk(pool, log->head); ; chunk = GradeLog_chunk(pool, chunk->next)) {
+        size run = remaining > GradeLog_CHUNK_GRADES ? GradeLog_CHUNK_GRADES : remaining;
+
+        for(size idx = 0; idx < run; ++idx) {
+            ++counts[chunk->grades[idx]];
+        }
+
+        remaining -= run;
+
+        if(remaining == 0) return;
+    }
+}
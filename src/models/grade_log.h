@@ -0,0 +1,116 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * Grade Log Header:
+ *
+ * Describes the grade log kept by each enrollment. A log holds any number of grades, in the order in which they were
+ * given, in a singly linked list of fixed-size chunks. The chunks of every log live in one shared Arena (the
+ * GradeBook's grade pool), so a log costs nothing until its first grade, and appending never moves a grade that is
+ * already stored: an append writes in to the tail chunk, and takes one more chunk from the pool every
+ * GradeLog_CHUNK_GRADES grades.
+ */
+
+#ifndef _H_GRADE_LOG
+    #define _H_GRADE_LOG
+    #include <stdint.h>
+    #include "../util.h"
+    #include "arena.h"
+    #include "grade_kernels.h"
+
+// Begin Header "grade log" --------------------------------------------------------------------------------------------
+
+/*
+ * Number of grades held by one chunk. With the link this makes a chunk 32 bytes.
+ */
+#define GradeLog_CHUNK_GRADES 28
+
+typedef struct S_GradeChunk {
+
+    /*
+     * Pool slot of the next chunk of the log. Meaningless in the tail chunk.
+     */
+    uint32_t next;
+
+    grade grades[GradeLog_CHUNK_GRADES];
+
+} GradeChunk;
+
+typedef struct S_GradeLog {
+
+    /*
+     * Pool slots of the first and last chunks. Meaningless while count is 0, so a zeroed log is an empty log.
+     */
+    uint32_t head;
+
+    uint32_t tail;
+
+    size count;
+
+} GradeLog;
+
+/*
+ * Prepare an arena, allocating from `memory`, to be used as a pool of grade chunks
+ */
+void GradeLog_initPool(Arena* pool, Pool* memory);
+
+/*
+ * Append a grade to the end of the log. Aborts if memory could not be allocated.
+ */
+void GradeLog_append(Arena* pool, GradeLog* log, grade value);
+
+/*
+ * Return the grade at index, which must be less than log->count
+ */
+grade GradeLog_at(const Arena* pool, const GradeLog* log, size index);
+
+/*
+ * Remove the grade at index, keeping the remaining grades in order. Returns false if there is no such grade.
+ */
+bool GradeLog_remove(Arena* pool, GradeLog* log, size index);
+
+/*
+ * Return every chunk of the log to the pool, leaving the log empty
+ */
+void GradeLog_clear(Arena* pool, GradeLog* log);
+
+/*
+ * Copy the grades of the log, in order, to destination, which must have room for log->count grades.
+ * Returns the number of grades copied.
+ */
+size GradeLog_copy(const Arena* pool, const GradeLog* log, grade* destination);
+
+/*
+ * Copy no more than the first `limit` grades of the log, in order, to destination, and return how many were copied
+ */
+size GradeLog_copyFirst(const Arena* pool, const GradeLog* log, grade* destination, size limit);
+
+/*
+ * Hand the grades of the log to `visit`, in order, a chunk at a time, without copying them
+ */
+void GradeLog_eachRun(const Arena* pool, const GradeLog* log, void (*visit)(void* context, const grade* run, size count),
+                      void* context);
+
+/*
+ * Replace the grades of the log, in order, with the first log->count grades of `source`
+ */
+void GradeLog_overwrite(Arena* pool, GradeLog* log, const grade* source);
+
+/*
+ * Sum of the grades in the log
+ */
+long GradeLog_sum(const Arena* pool, const GradeLog* log);
+
+/*
+ * Sum, bounds and count of the grades in the log, in one pass (see grade_kernels.h)
+ */
+GradeSummary GradeLog_summarize(const Arena* pool, const GradeLog* log);
+
+/*
+ * Add the number of times each grade appears in the log to `counts`, which is indexed by grade
+ */
+void GradeLog_tally(const Arena* pool, const GradeLog* log, uint32_t counts[256]);
+
+// End Header "grade log" ----------------------------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,163 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * Grade Report Definitions:
+ *
+ * Implements the parallel statistics pass described in grade_report.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "grade_report.h"
+
+/*
+ * What every unit of a build reads, and writes to
+ */
+typedef struct S_ReportJob {
+
+    GradeReport* report;
+
+    GradeBook* book;
+
+} ReportJob;
+
+/*
+ * Grow `*array` to hold at least `count` elements of `width` bytes, keeping its capacity in `*capacity`
+ */
+static void GradeReport_reserve(void** array, size* capacity, size count, size width) {
+    if(count <= *capacity) return;
+
+    void* grown = realloc(*array, count * width);
+
+    if(!grown) {
+        fprintf(stderr, "GradeReport: unable to allocate %lu records\n", count);
+        abort();
+    }
+
+    *array      = grown;
+    *capacity   = count;
+}
+
+void GradeReport_init(GradeReport* report) {
+    *report = (GradeReport){ .grades = GradeSummary_EMPTY };
+}
+
+void GradeReport_free(GradeReport* report) {
+    free(report->courses);
+    free(report->courseDistributions);
+    free(report->students);
+    GradeReport_init(report);
+}
+
+/*
+ * Gather one course: its roster's grades are summarized and tallied in to its distribution
+ */
+static void GradeReport_course(ReportJob* job, size index) {
+    Course* course                  = GradeBook_courseAt(job->book, index);
+    RecordStatistics* statistics    = &job->report->courses[index];
+    GradeDistribution* distribution = &job->report->courseDistributions[index];
+    double averagesSum              = 0;
+
+    memset(distribution, 0, sizeof(GradeDistribution));
+
+    *statistics = (RecordStatistics){
+            .id                 = course->courseId,
+            .name               = course->courseName,
+            .enrollmentsCount   = Course_studentsCount(course),
+            .grades             = GradeSummary_EMPTY
+    };
+
+    for(size idx = 0; idx < statistics->enrollmentsCount; ++idx) {
+        StudentEnrollment* enrollment   = Course_enrollmentAt(job->book, course, idx);
+        GradeSummary summary            = GradeLog_summarize(&job->book->gradeChunks, &enrollment->grades);
+
+        GradeSummary_merge(&statistics->grades, summary);
+        averagesSum += GradeSummary_average(summary);
+
+        if(summary.count > 0) GradeLog_tally(&job->book->gradeChunks, &enrollment->grades, distribution->counts);
+    }
+
+    distribution->count = statistics->grades.count;
+    statistics->average = statistics->enrollmentsCount > 0 ? (float) (averagesSum / statistics->enrollmentsCount) : 0;
+}
+
+static void GradeReport_student(ReportJob* job, size index) {
+    Student* student                = GradeBook_studentAt(job->book, index);
+    RecordStatistics* statistics    = &job->report->students[index];
+    double averagesSum              = 0;
+
+    *statistics = (RecordStatistics){
+            .id                 = student->studentId,
+            .name               = student->studentName,
+            .enrollmentsCount   = Student_coursesCount(student),
+            .grades             = GradeSummary_EMPTY
+    };
+
+    for(size idx = 0; idx < statistics->enrollmentsCount; ++idx) {
+        StudentEnrollment* enrollment   = Student_enrollmentAt(job->book, student, idx);
+        GradeSummary summary            = GradeLog_summarize(&job->book->gradeChunks, &enrollment->grades);
+
+        GradeSummary_merge(&statistics->grades, summary);
+        averagesSum += GradeSummary_average(summary);
+    }
+
+    statistics->average = statistics->enrollmentsCount > 0 ? (float) (averagesSum / statistics->enrollmentsCount) : 0;
+}
+
+/*
+ * Units are every course, one apiece, and then every batch of students. Courses come first, as they are the largest.
+ */
+static void GradeReport_unit(void* context, size unit) {
+    ReportJob* job = context;
+
+    if(unit < job->report->coursesCount) {
+        GradeReport_course(job, unit);
+        return;
+    }
+
+    size first  = (unit - job->report->coursesCount) * GradeReport_STUDENT_BATCH;
+    size last   = first + GradeReport_STUDENT_BATCH;
+
+    if(last > job->report->studentsCount) last = job->report->studentsCount;
+
+    for(size index = first; index < last; ++index) GradeReport_student(job, index);
+}
+
+void GradeReport_build(GradeReport* report, GradeBook* book, WorkerPool* workers) {
+
+    size coursesCapacity = report->coursesCapacity;
+
+    GradeReport_reserve((void**) &report->courses, &coursesCapacity, book->coursesCount, sizeof(RecordStatistics));
+    GradeReport_reserve((void**) &report->courseDistributions, &report->coursesCapacity, book->coursesCount,
+                        sizeof(GradeDistribution));
+    GradeReport_reserve((void**) &report->students, &report->studentsCapacity, book->studentsCount,
+                        sizeof(RecordStatistics));
+
+    report->coursesCount    = book->coursesCount;
+    report->studentsCount   = book->studentsCount;
+
+    // Everything a unit could otherwise set up on first use is set up here, before there is more than one thread
+    GradeBook_settle(book);
+    GradeKernels_select();
+
+    ReportJob job = { .report = report, .book = book };
+    size studentBatches = (report->studentsCount + GradeReport_STUDENT_BATCH - 1) / GradeReport_STUDENT_BATCH;
+
+    WorkerPool_run(workers, &GradeReport_unit, &job, report->coursesCount + studentBatches);
+
+    // Every grade belongs to exactly one course, so the book's totals are those of its courses
+    report->grades = GradeSummary_EMPTY;
+    memset(&report->distribution, 0, sizeof(GradeDistribution));
+
+    for(size idx = 0; idx < report->coursesCount; ++idx) {
+        GradeSummary_merge(&report->grades, report->courses[idx].grades);
+
+        for(size bucket = 0; bucket < GradeHistogram_BUCKETS; ++bucket) {
+            report->distribution.counts[bucket] += report->courseDistributions[idx].counts[bucket];
+        }
+    }
+
+    report->distribution.count = report->grades.count;
+}
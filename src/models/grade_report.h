@@ -0,0 +1,113 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * Grade Report Header:
+ *
+ * Describes the statistics of a whole GradeBook, gathered in one pass over its grades, that the course and student
+ * listings are printed from.
+ *
+ * GradeReport_build reads every grade log twice: once through the rosters, for the statistics and histogram of each
+ * course, and once through the transcripts, for the statistics of each student. Each course, and each run of
+ * GradeReport_STUDENT_BATCH students, is a unit of work for a WorkerPool (see worker_pool.h), and writes only to its
+ * own entries of the report, so the pass scales with the number of workers and takes no locks.
+ *
+ * Students have no histogram in the report: a large book has far more students than courses, and 1KiB apiece would
+ * dwarf the GradeBook itself. Student_gradeDistribution answers for a single student.
+ *
+ * A report keeps its arrays between builds, so rebuilding it for a GradeBook of the same size allocates nothing.
+ */
+
+#ifndef _H_GRADE_REPORT
+    #define _H_GRADE_REPORT
+    #include "../util.h"
+    #include "models.h"
+    #include "worker_pool.h"
+
+// Begin Header "grade report" -----------------------------------------------------------------------------------------
+
+/*
+ * Students per unit of work
+ */
+#define GradeReport_STUDENT_BATCH 512
+
+/*
+ * Statistics of one course or student
+ */
+typedef struct S_RecordStatistics {
+
+    identifier id;
+
+    /*
+     * In the GradeBook's name pool, so only valid while the GradeBook is open
+     */
+    const char* name;
+
+    /*
+     * Students of a course, or courses of a student
+     */
+    size enrollmentsCount;
+
+    /*
+     * Every grade of the record
+     */
+    GradeSummary grades;
+
+    /*
+     * Mean of the averages of each enrollment, as Course_averageGrade and Student_averageGrade
+     */
+    float average;
+
+} RecordStatistics;
+
+typedef struct S_GradeReport {
+
+    /*
+     * Courses, in courseId order
+     */
+    RecordStatistics* courses;
+
+    /*
+     * Grade distribution of each course, in the same order
+     */
+    GradeDistribution* courseDistributions;
+
+    size coursesCount;
+
+    size coursesCapacity;
+
+    /*
+     * Students, in studentId order
+     */
+    RecordStatistics* students;
+
+    size studentsCount;
+
+    size studentsCapacity;
+
+    /*
+     * Every grade in the GradeBook
+     */
+    GradeSummary grades;
+
+    GradeDistribution distribution;
+
+} GradeReport;
+
+/*
+ * Prepare an empty report
+ */
+void GradeReport_init(GradeReport* report);
+
+void GradeReport_free(GradeReport* report);
+
+/*
+ * Fill `report` with the statistics of every course and student of `book`, sharing the work between `workers`, or
+ * on the calling thread if `workers` is NULL. `book` is settled first (see GradeBook_settle), and must not be changed
+ * while the report is being built. Aborts if memory could not be allocated.
+ */
+void GradeReport_build(GradeReport* report, GradeBook* book, WorkerPool* workers);
+
+// End Header "grade report" -------------------------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,225 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * Grade Sketch Definitions:
+ *
+ * Implements the mergeable book summaries described in grade_sketch.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "grade_sketch.h"
+
+// -- Distinct Sketch --------------------------------------------------------------------------------------------------
+
+/*
+ * Spread the bits of a value over the whole word (the finalizer of MurmurHash3), so that IDs given out in order fall
+ * in to registers evenly
+ */
+static inline uint64_t DistinctSketch_hash(uint64_t value) {
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCDULL;
+    value ^= value >> 33;
+    value *= 0xC4CEB9FE1A85EC53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+void DistinctSketch_add(DistinctSketch* sketch, uint64_t value) {
+    uint64_t hash       = DistinctSketch_hash(value);
+    size reg            = (size) (hash >> (64 - DistinctSketch_PRECISION));
+    uint64_t rest       = hash << DistinctSketch_PRECISION;
+
+    // Leading zeroes of the bits left after the register's, plus one
+    uint8_t rank = rest ? (uint8_t) (__builtin_clzll(rest) + 1) : (uint8_t) (64 - DistinctSketch_PRECISION + 1);
+
+    if(rank > sketch->registers[reg]) sketch->registers[reg] = rank;
+}
+
+void DistinctSketch_merge(DistinctSketch* sketch, const DistinctSketch* other) {
+    for(size reg = 0; reg < DistinctSketch_REGISTERS; ++reg) {
+        uint8_t theirs          = other->registers[reg];
+        sketch->registers[reg]  = theirs > sketch->registers[reg] ? theirs : sketch->registers[reg];
+    }
+}
+
+double DistinctSketch_estimate(const DistinctSketch* sketch) {
+    const double registers = DistinctSketch_REGISTERS;
+
+    double harmonic = 0;
+    size zeroes     = 0;
+
+    for(size reg = 0; reg < DistinctSketch_REGISTERS; ++reg) {
+        harmonic += ldexp(1, -sketch->registers[reg]);
+        zeroes   += sketch->registers[reg] == 0;
+    }
+
+    double alpha    = 0.7213 / (1 + 1.079 / registers);
+    double estimate = alpha * registers * registers / harmonic;
+
+    // Small sets leave registers empty, and are counted far better by how many
+    if(estimate <= 2.5 * registers && zeroes > 0) estimate = registers * log(registers / (double) zeroes);
+
+    return estimate;
+}
+
+// -- Grade Sketch -----------------------------------------------------------------------------------------------------
+
+void GradeSketch_init(GradeSketch* sketch) {
+    memset(sketch, 0, sizeof(GradeSketch));
+}
+
+void GradeSketch_free(GradeSketch* sketch) {
+    free(sketch->courses);
+    GradeSketch_init(sketch);
+}
+
+/*
+ * Position of the course `courseId` in sketch->courses, or of where it would be inserted
+ */
+static size GradeSketch_locate(const GradeSketch* sketch, identifier courseId) {
+    size low = 0, high = sketch->coursesCount;
+
+    while(low < high) {
+        size middle = low + (high - low) / 2;
+
+        if(sketch->courses[middle].courseId < courseId) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+const CourseSketch* GradeSketch_findCourse(const GradeSketch* sketch, identifier courseId) {
+    size position = GradeSketch_locate(sketch, courseId);
+    return position < sketch->coursesCount && sketch->courses[position].courseId == courseId
+           ? &sketch->courses[position]
+           : NULL;
+}
+
+/*
+ * Make sure the sketch has a course for each of `ids`, which are sorted and distinct. New courses are merged in from
+ * the back, so every course moves at most once.
+ */
+static void GradeSketch_insertCourses(GradeSketch* sketch, const identifier* ids, size idsCount) {
+    size added = 0;
+
+    for(size idx = 0; idx < idsCount; ++idx) added += GradeSketch_findCourse(sketch, ids[idx]) == NULL;
+
+    if(added == 0) return;
+
+    size total = sketch->coursesCount + added;
+
+    if(total > sketch->coursesCapacity) {
+        CourseSketch* grown = realloc(sketch->courses, total * sizeof(CourseSketch));
+
+        if(!grown) {
+            fprintf(stderr, "GradeSketch: unable to allocate %lu courses\n", total);
+            abort();
+        }
+
+        sketch->courses         = grown;
+        sketch->coursesCapacity = total;
+    }
+
+    size kept = sketch->coursesCount, given = idsCount, write = total;
+
+    while(given > 0) {
+        identifier id = ids[given - 1];
+
+        if(kept > 0 && sketch->courses[kept - 1].courseId >= id) {
+            // A course given that the sketch already has is skipped along with it
+            if(sketch->courses[kept - 1].courseId == id) --given;
+            sketch->courses[--write] = sketch->courses[--kept];
+        } else {
+            CourseSketch* course = &sketch->courses[--write];
+            memset(course, 0, sizeof(CourseSketch));
+            course->courseId = id;
+            --given;
+        }
+    }
+
+    sketch->coursesCount = total;
+}
+
+void GradeSketch_addBook(GradeSketch* sketch, GradeBook* book) {
+    identifier* ids     = malloc((book->coursesCount ? book->coursesCount : 1) * sizeof(identifier));
+    size* bySlot        = malloc((book->courses.slotsCount ? book->courses.slotsCount : 1) * sizeof(size));
+
+    if(!ids || !bySlot) {
+        fprintf(stderr, "GradeSketch: unable to map %lu courses\n", book->courses.slotsCount);
+        abort();
+    }
+
+    // Courses are walked in courseId order, so their IDs are already sorted
+    for(size idx = 0; idx < book->coursesCount; ++idx) ids[idx] = book->courseOrder[idx].id;
+
+    GradeSketch_insertCourses(sketch, ids, book->coursesCount);
+
+    GradeDistribution distribution;
+
+    for(size idx = 0; idx < book->coursesCount; ++idx) {
+        Course* course              = GradeBook_courseAt(book, idx);
+        size position               = GradeSketch_locate(sketch, course->courseId);
+        bySlot[course->self.slot]   = position;
+
+        Histogram_read(&book->histograms, course->histogram, &distribution);
+        GradeDistribution_merge(&sketch->courses[position].grades, &distribution);
+        GradeDistribution_merge(&sketch->grades, &distribution);
+    }
+
+    for(size slot = 0; slot < book->enrollments.slotsCount; ++slot) {
+        StudentEnrollment* enrollment = Arena_at(&book->enrollments, slot);
+        if(Handle_isNull(enrollment->student)) continue;
+
+        Student* student = Arena_at(&book->students, enrollment->student.slot);
+
+        DistinctSketch_add(&sketch->courses[bySlot[enrollment->course.slot]].students, student->studentId);
+        DistinctSketch_add(&sketch->students, student->studentId);
+        ++sketch->enrollmentsCount;
+    }
+
+    ++sketch->booksCount;
+
+    free(bySlot);
+    free(ids);
+}
+
+void GradeSketch_merge(GradeSketch* sketch, const GradeSketch* other) {
+    identifier* ids = malloc((other->coursesCount ? other->coursesCount : 1) * sizeof(identifier));
+
+    if(!ids) {
+        fprintf(stderr, "GradeSketch: unable to merge %lu courses\n", other->coursesCount);
+        abort();
+    }
+
+    for(size idx = 0; idx < other->coursesCount; ++idx) ids[idx] = other->courses[idx].courseId;
+
+    GradeSketch_insertCourses(sketch, ids, other->coursesCount);
+
+    // Both lists are now sorted, and every course of `other` is in `sketch`
+    size position = 0;
+
+    for(size idx = 0; idx < other->coursesCount; ++idx) {
+        const CourseSketch* theirs = &other->courses[idx];
+
+        while(sketch->courses[position].courseId != theirs->courseId) ++position;
+
+        GradeDistribution_merge(&sketch->courses[position].grades, &theirs->grades);
+        DistinctSketch_merge(&sketch->courses[position].students, &theirs->students);
+    }
+
+    GradeDistribution_merge(&sketch->grades, &other->grades);
+    DistinctSketch_merge(&sketch->students, &other->students);
+
+    sketch->enrollmentsCount   += other->enrollmentsCount;
+    sketch->booksCount         += other->booksCount;
+
+    free(ids);
+}
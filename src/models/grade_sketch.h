@@ -0,0 +1,123 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * Grade Sketch Header:
+ *
+ * Describes sketches: fixed-size summaries of one or more GradeBooks, which merge with each other, for statistics over
+ * many books at once (such as the books of several archived terms) without holding any of them.
+ *
+ * A GradeSketch holds, for all of its books and for each course ID in them:
+ * - the distribution of every grade given. Grades are single bytes, so 256 counters are an exact quantile sketch, as
+ *   small as any approximate one would be. Medians, percentiles and means read from a sketch are exact.
+ * - a DistinctSketch (a HyperLogLog) of the IDs of the students enrolled, which estimates how many different students
+ *   there were, counting a student who appears in several books once. The estimate's standard error is about 1.6%.
+ *
+ * A book is added to a sketch in one pass over its enrollment table and its course histograms; no grade is read.
+ * Sketches of separate books may be built on separate threads, and merged in any order with the same result.
+ */
+
+#ifndef _H_GRADE_SKETCH
+    #define _H_GRADE_SKETCH
+    #include <stdint.h>
+    #include "../util.h"
+    #include "models.h"
+
+// Begin Header "grade sketch" -----------------------------------------------------------------------------------------
+
+/*
+ * Bits of each hash that choose a register
+ */
+#define DistinctSketch_PRECISION 12
+
+#define DistinctSketch_REGISTERS (1 << DistinctSketch_PRECISION)
+
+/*
+ * HyperLogLog sketch of a set of 64 bit values. A zeroed sketch is an empty one.
+ */
+typedef struct S_DistinctSketch {
+
+    /*
+     * Most leading zeroes, plus one, seen in the hashes that chose each register
+     */
+    uint8_t registers[DistinctSketch_REGISTERS];
+
+} DistinctSketch;
+
+typedef struct S_CourseSketch {
+
+    identifier courseId;
+
+    GradeDistribution grades;
+
+    DistinctSketch students;
+
+} CourseSketch;
+
+typedef struct S_GradeSketch {
+
+    /*
+     * Number of books added, directly or by merging
+     */
+    size booksCount;
+
+    size enrollmentsCount;
+
+    GradeDistribution grades;
+
+    /*
+     * Students with at least one enrollment
+     */
+    DistinctSketch students;
+
+    /*
+     * One per course ID, in courseId order
+     */
+    CourseSketch* courses;
+
+    size coursesCount;
+
+    size coursesCapacity;
+
+} GradeSketch;
+
+// -- Distinct Sketch --------------------------------------------------------------------------------------------------
+
+void DistinctSketch_add(DistinctSketch* sketch, uint64_t value);
+
+/*
+ * Make `sketch` a sketch of the values of both. Merging is exact: it gives the sketch that adding every value of each
+ * would have given.
+ */
+void DistinctSketch_merge(DistinctSketch* sketch, const DistinctSketch* other);
+
+/*
+ * Estimated number of distinct values added
+ */
+double DistinctSketch_estimate(const DistinctSketch* sketch);
+
+// -- Grade Sketch -----------------------------------------------------------------------------------------------------
+
+void GradeSketch_init(GradeSketch* sketch);
+
+void GradeSketch_free(GradeSketch* sketch);
+
+/*
+ * Add the grades and enrollments of `book` to a sketch. The book is only read, so several sketches may be built from
+ * one book at once. Aborts if memory could not be allocated.
+ */
+void GradeSketch_addBook(GradeSketch* sketch, GradeBook* book);
+
+/*
+ * Add everything sketched by `other` to `sketch`. Aborts if memory could not be allocated.
+ */
+void GradeSketch_merge(GradeSketch* sketch, const GradeSketch* other);
+
+/*
+ * Return the sketch of a course, or NULL if no book added had a course with that ID
+ */
+const CourseSketch* GradeSketch_findCourse(const GradeSketch* sketch, identifier courseId);
+
+// End Header "grade sketch" -------------------------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,462 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * GradeBook Map Definitions:
+ *
+ * Writes the mapped layout described in gradebook_map.h, and reads it in place
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "gradebook_map.h"
+#include "../debug.h"
+
+const byte GRADEBOOK_MAPPED_MAGIC[4] = {0x01, 0xD5, 0xC0, 0x4D};
+
+/*
+ * Bytes of the header, and of each entry of the table of contents
+ */
+#define GradeBookMap_HEADER_BYTES 16
+#define GradeBookMap_SECTION_BYTES 24
+
+/*
+ * Sections written, in the order they are written
+ */
+static const MappedSectionKind GradeBookMap_SECTIONS[] = {
+        MAPPED_COURSES, MAPPED_STUDENTS, MAPPED_ENROLLMENTS, MAPPED_TRANSCRIPTS, MAPPED_NAMES, MAPPED_GRADES
+};
+
+#define GradeBookMap_SECTIONS_COUNT NMEMBERS(GradeBookMap_SECTIONS, MappedSectionKind)
+
+static inline size GradeBookMap_align(size offset) {
+    return (offset + 7) & ~(size) 7;
+}
+
+// -- Writing ----------------------------------------------------------------------------------------------------------
+
+static void GradeBookMap_putU32(SerialSink* sink, uint32_t value) {
+    byte bytes[4] = { (byte) value, (byte) (value >> 8), (byte) (value >> 16), (byte) (value >> 24) };
+    SerialSink_put(sink, bytes, 4);
+}
+
+static void GradeBookMap_putU64(SerialSink* sink, uint64_t value) {
+    GradeBookMap_putU32(sink, (uint32_t) value);
+    GradeBookMap_putU32(sink, (uint32_t) (value >> 32));
+}
+
+static void GradeBookMap_putDouble(SerialSink* sink, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(double));
+    GradeBookMap_putU64(sink, bits);
+}
+
+/*
+ * Pad with zeroes until `start` bytes before the sink's position is a multiple of 8
+ */
+static void GradeBookMap_pad(SerialSink* sink, size start) {
+    static const byte zeroes[8] = {0};
+    size written = sink->written - start;
+    SerialSink_put(sink, zeroes, GradeBookMap_align(written) - written);
+}
+
+static void GradeBookMap_putRun(void* context, const grade* run, size count) {
+    SerialSink_put(context, run, count);
+}
+
+SerializationStatus GradeBook_encodeMapped(GradeBook* book, SerialSink* sink) {
+
+    size nCourses   = book->coursesCount;
+    size nStudents  = book->studentsCount;
+    size start      = sink->written;
+
+    // Position of each course and student by slot, and the next place in each course's roster to hand to a transcript
+    size tableSize          = book->courses.slotsCount + book->students.slotsCount + nCourses;
+    uint32_t* positions     = malloc((tableSize ? tableSize : 1) * sizeof(uint32_t));
+
+    if(!positions) {
+        fprintf(stderr, "GradeBook: unable to allocate a map of %lu records\n", tableSize);
+        abort();
+    }
+
+    uint32_t* coursePositions   = positions;
+    uint32_t* studentPositions  = coursePositions + book->courses.slotsCount;
+    uint32_t* rosterCursors     = studentPositions + book->students.slotsCount;
+
+    // Size every section before anything is written, as the table of contents comes first
+    size nEnrollments   = 0;
+    size nGrades        = 0;
+    size namesLength    = 0;
+
+    for(size courseIdx = 0; courseIdx < nCourses; ++courseIdx) {
+        Course* course                          = GradeBook_courseAt(book, courseIdx);
+        coursePositions[course->self.slot]      = (uint32_t) courseIdx;
+        rosterCursors[courseIdx]                = (uint32_t) nEnrollments;
+        namesLength                            += strlen(course->courseName) + 1;
+
+        for(size studentIdx = 0; studentIdx < Course_studentsCount(course); ++studentIdx) {
+            nGrades += Course_enrollmentAt(book, course, studentIdx)->grades.count;
+        }
+
+        nEnrollments += Course_studentsCount(course);
+    }
+
+    for(size studentIdx = 0; studentIdx < nStudents; ++studentIdx) {
+        Student* student                        = GradeBook_studentAt(book, studentIdx);
+        studentPositions[student->self.slot]    = (uint32_t) studentIdx;
+        namesLength                            += strlen(student->studentName) + 1;
+    }
+
+    if(nEnrollments > UINT32_MAX || namesLength > UINT32_MAX) {
+        printf("GradeBook has %lu enrollments, and %lu bytes of names, too many for the mapped layout\n",
+                nEnrollments, namesLength);
+        free(positions);
+        return FAILURE;
+    }
+
+    size lengths[GradeBookMap_SECTIONS_COUNT] = {
+            nCourses * sizeof(MappedCourse),
+            nStudents * sizeof(MappedStudent),
+            nEnrollments * sizeof(MappedEnrollment),
+            nEnrollments * sizeof(uint32_t),
+            namesLength,
+            nGrades
+    };
+
+    // Header and table of contents
+    SerialSink_put(sink, GRADEBOOK_MAPPED_MAGIC, NMEMBERS(GRADEBOOK_MAPPED_MAGIC, byte));
+    GradeBookMap_putU32(sink, GradeBookMap_VERSION);
+    GradeBookMap_putU32(sink, GradeBookMap_SECTIONS_COUNT);
+    GradeBookMap_putU32(sink, 0);
+
+    size offset = GradeBookMap_HEADER_BYTES + GradeBookMap_SECTIONS_COUNT * GradeBookMap_SECTION_BYTES;
+
+    for(size sectionIdx = 0; sectionIdx < GradeBookMap_SECTIONS_COUNT; ++sectionIdx) {
+        GradeBookMap_putU32(sink, GradeBookMap_SECTIONS[sectionIdx]);
+        GradeBookMap_putU32(sink, 0);
+        GradeBookMap_putU64(sink, offset);
+        GradeBookMap_putU64(sink, lengths[sectionIdx]);
+
+        offset = GradeBookMap_align(offset + lengths[sectionIdx]);
+    }
+
+    // COURSES
+    uint32_t nameOffset         = 0;
+    uint32_t enrollmentsStart   = 0;
+
+    for(size courseIdx = 0; courseIdx < nCourses; ++courseIdx) {
+        Course* course = GradeBook_courseAt(book, courseIdx);
+
+        GradeBookMap_putU32(sink, course->courseId);
+        GradeBookMap_putU32(sink, nameOffset);
+        GradeBookMap_putU32(sink, enrollmentsStart);
+        GradeBookMap_putU32(sink, (uint32_t) Course_studentsCount(course));
+        GradeBookMap_putDouble(sink, course->aggregate.averagesSum);
+
+        nameOffset         += (uint32_t) strlen(course->courseName) + 1;
+        enrollmentsStart   += (uint32_t) Course_studentsCount(course);
+    }
+
+    // STUDENTS
+    uint32_t transcriptStart = 0;
+
+    for(size studentIdx = 0; studentIdx < nStudents; ++studentIdx) {
+        Student* student = GradeBook_studentAt(book, studentIdx);
+
+        GradeBookMap_putU32(sink, student->studentId);
+        GradeBookMap_putU32(sink, nameOffset);
+        GradeBookMap_putU32(sink, transcriptStart);
+        GradeBookMap_putU32(sink, (uint32_t) Student_coursesCount(student));
+        GradeBookMap_putDouble(sink, student->aggregate.averagesSum);
+
+        nameOffset         += (uint32_t) strlen(student->studentName) + 1;
+        transcriptStart    += (uint32_t) Student_coursesCount(student);
+    }
+
+    // ENROLLMENTS
+    uint64_t gradesStart = 0;
+
+    for(size courseIdx = 0; courseIdx < nCourses; ++courseIdx) {
+        Course* course = GradeBook_courseAt(book, courseIdx);
+
+        for(size studentIdx = 0; studentIdx < Course_studentsCount(course); ++studentIdx) {
+            StudentEnrollment* enrollment = Course_enrollmentAt(book, course, studentIdx);
+
+            GradeBookMap_putU32(sink, (uint32_t) courseIdx);
+            GradeBookMap_putU32(sink, studentPositions[enrollment->student.slot]);
+            GradeBookMap_putU64(sink, gradesStart);
+            GradeBookMap_putU64(sink, enrollment->grades.count);
+            GradeBookMap_putU64(sink, (uint64_t) enrollment->summary.sum);
+
+            gradesStart += enrollment->grades.count;
+        }
+    }
+
+    /*
+     * TRANSCRIPTS. Students are walked in studentId order, as is every roster, so the k'th student to list a course is
+     * the k'th of its roster.
+     */
+    for(size studentIdx = 0; studentIdx < nStudents; ++studentIdx) {
+        Student* student = GradeBook_studentAt(book, studentIdx);
+
+        for(size courseIdx = 0; courseIdx < Student_coursesCount(student); ++courseIdx) {
+            StudentEnrollment* enrollment = Student_enrollmentAt(book, student, courseIdx);
+            GradeBookMap_putU32(sink, rosterCursors[coursePositions[enrollment->course.slot]]++);
+        }
+    }
+
+    GradeBookMap_pad(sink, start);
+
+    // NAMES
+    for(size courseIdx = 0; courseIdx < nCourses; ++courseIdx) {
+        const char* name = GradeBook_courseAt(book, courseIdx)->courseName;
+        SerialSink_put(sink, (const byte*) name, strlen(name) + 1);
+    }
+
+    for(size studentIdx = 0; studentIdx < nStudents; ++studentIdx) {
+        const char* name = GradeBook_studentAt(book, studentIdx)->studentName;
+        SerialSink_put(sink, (const byte*) name, strlen(name) + 1);
+    }
+
+    GradeBookMap_pad(sink, start);
+
+    // GRADES
+    for(size courseIdx = 0; courseIdx < nCourses; ++courseIdx) {
+        Course* course = GradeBook_courseAt(book, courseIdx);
+
+        for(size studentIdx = 0; studentIdx < Course_studentsCount(course); ++studentIdx) {
+            StudentEnrollment* enrollment = Course_enrollmentAt(book, course, studentIdx);
+            GradeLog_eachRun(&book->gradeChunks, &enrollment->grades, &GradeBookMap_putRun, sink);
+        }
+    }
+
+    free(positions);
+
+    return SerialSink_flush(sink) ? SUCCESS : FAILURE;
+}
+
+// -- Reading ----------------------------------------------------------------------------------------------------------
+
+static inline uint32_t GradeBookMap_readU32(const byte* data) {
+    return (uint32_t) data[0] | (uint32_t) data[1] << 8 | (uint32_t) data[2] << 16 | (uint32_t) data[3] << 24;
+}
+
+static inline uint64_t GradeBookMap_readU64(const byte* data) {
+    return (uint64_t) GradeBookMap_readU32(data) | (uint64_t) GradeBookMap_readU32(data + 4) << 32;
+}
+
+SerializationStatus GradeBookMap_wrap(GradeBookMap* map, const byte* data, size length) {
+
+    memset(map, 0, sizeof(GradeBookMap));
+
+    // Records are read where they lie, so their numbers must already be in the host's order
+    if(__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__) {
+        printf("The mapped layout can only be read in place on little-endian hosts\n");
+        return FAILURE;
+    }
+
+    if(length < GradeBookMap_HEADER_BYTES) return length < 4 ? SHORT_BUFFER : BAD_MAGIC;
+
+    if(memcmp(data, GRADEBOOK_MAPPED_MAGIC, NMEMBERS(GRADEBOOK_MAPPED_MAGIC, byte)) != 0) return BAD_MAGIC;
+
+    uint32_t version = GradeBookMap_readU32(data + 4);
+
+    if(version != GradeBookMap_VERSION) {
+        printf("Mapped GradeBook is version %u, this build reads version %u\n", version, GradeBookMap_VERSION);
+        return BAD_MAGIC;
+    }
+
+    size nSections = GradeBookMap_readU32(data + 8);
+
+    if(nSections > (length - GradeBookMap_HEADER_BYTES) / GradeBookMap_SECTION_BYTES) {
+        d_printf("[Map] %lu sections do not fit in %lu bytes\n", nSections, length);
+        return SHORT_BUFFER;
+    }
+
+    for(size sectionIdx = 0; sectionIdx < nSections; ++sectionIdx) {
+        const byte* entry       = data + GradeBookMap_HEADER_BYTES + sectionIdx * GradeBookMap_SECTION_BYTES;
+        uint32_t kind           = GradeBookMap_readU32(entry);
+        uint64_t offset         = GradeBookMap_readU64(entry + 8);
+        uint64_t sectionLength  = GradeBookMap_readU64(entry + 16);
+
+        if(offset > length || sectionLength > length - offset) {
+            d_printf("[Map] section %u at %lu, of %lu bytes, lies outside %lu bytes\n", kind, offset, sectionLength, length);
+            memset(map, 0, sizeof(GradeBookMap));
+            return SHORT_BUFFER;
+        }
+
+        if(offset % 8 != 0) {
+            printf("Mapped GradeBook section %u is not aligned\n", kind);
+            memset(map, 0, sizeof(GradeBookMap));
+            return FAILURE;
+        }
+
+        const void* section = data + offset;
+
+        switch((MappedSectionKind) kind) {
+            case MAPPED_COURSES:
+                map->courses            = section;
+                map->coursesCount       = sectionLength / sizeof(MappedCourse);
+                break;
+            case MAPPED_STUDENTS:
+                map->students           = section;
+                map->studentsCount      = sectionLength / sizeof(MappedStudent);
+                break;
+            case MAPPED_ENROLLMENTS:
+                map->enrollments        = section;
+                map->enrollmentsCount   = sectionLength / sizeof(MappedEnrollment);
+                break;
+            case MAPPED_TRANSCRIPTS:
+                map->transcripts        = section;
+                map->transcriptsCount   = sectionLength / sizeof(uint32_t);
+                break;
+            case MAPPED_NAMES:
+                map->names              = section;
+                map->namesLength        = sectionLength;
+                break;
+            case MAPPED_GRADES:
+                map->grades             = section;
+                map->gradesCount        = sectionLength;
+                break;
+            default:
+                d_printf("[Map] skipping section of unknown kind %u\n", kind);
+                break;
+        }
+    }
+
+    map->data   = data;
+    map->length = length;
+
+    return SUCCESS;
+}
+
+SerializationStatus GradeBookMap_open(GradeBookMap* map, const char* path) {
+
+    memset(map, 0, sizeof(GradeBookMap));
+
+    int fd = open(path, O_RDONLY);
+
+    if(fd < 0) return FAILURE;
+
+    struct stat status;
+
+    if(fstat(fd, &status) != 0) {
+        close(fd);
+        return FAILURE;
+    }
+
+    size length = (size) status.st_size;
+
+    if(length < GradeBookMap_HEADER_BYTES) {
+        close(fd);
+        return length < 4 ? SHORT_BUFFER : BAD_MAGIC;
+    }
+
+    // The mapping outlives the descriptor
+    void* data = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if(data == MAP_FAILED) return FAILURE;
+
+    SerializationStatus result = GradeBookMap_wrap(map, data, length);
+
+    if(result != SUCCESS) {
+        munmap(data, length);
+        return result;
+    }
+
+    map->mapped = true;
+
+    return SUCCESS;
+}
+
+void GradeBookMap_close(GradeBookMap* map) {
+    if(map->mapped) munmap((void*) map->data, map->length);
+    memset(map, 0, sizeof(GradeBookMap));
+}
+
+const MappedCourse* GradeBookMap_findCourse(const GradeBookMap* map, uint32_t courseId) {
+    size low = 0, high = map->coursesCount;
+
+    while(low < high) {
+        size middle = low + (high - low) / 2;
+
+        if(map->courses[middle].courseId < courseId) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low < map->coursesCount && map->courses[low].courseId == courseId ? &map->courses[low] : NULL;
+}
+
+const MappedStudent* GradeBookMap_findStudent(const GradeBookMap* map, uint32_t studentId) {
+    size low = 0, high = map->studentsCount;
+
+    while(low < high) {
+        size middle = low + (high - low) / 2;
+
+        if(map->students[middle].studentId < studentId) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low < map->studentsCount && map->students[low].studentId == studentId ? &map->students[low] : NULL;
+}
+
+/*
+ * A name must end within NAMES, and be no longer than a GradeBook would keep
+ */
+static const char* GradeBookMap_name(const GradeBookMap* map, uint32_t offset) {
+    if(offset >= map->namesLength) return "";
+
+    size limit = map->namesLength - offset < MAX_NAME_LENGTH + 1 ? map->namesLength - offset : MAX_NAME_LENGTH + 1;
+
+    return memchr(map->names + offset, 0, limit) ? map->names + offset : "";
+}
+
+const char* GradeBookMap_courseName(const GradeBookMap* map, const MappedCourse* course) {
+    return GradeBookMap_name(map, course->nameOffset);
+}
+
+const char* GradeBookMap_studentName(const GradeBookMap* map, const MappedStudent* student) {
+    return GradeBookMap_name(map, student->nameOffset);
+}
+
+const MappedEnrollment* GradeBookMap_rosterAt(const GradeBookMap* map, const MappedCourse* course, size index) {
+    size position = (size) course->enrollmentsStart + index;
+    return index < course->studentsCount && position < map->enrollmentsCount ? &map->enrollments[position] : NULL;
+}
+
+const MappedEnrollment* GradeBookMap_transcriptAt(const GradeBookMap* map, const MappedStudent* student, size index) {
+    size position = (size) student->transcriptStart + index;
+
+    if(index >= student->coursesCount || position >= map->transcriptsCount) return NULL;
+
+    uint32_t enrollment = map->transcripts[position];
+    return enrollment < map->enrollmentsCount ? &map->enrollments[enrollment] : NULL;
+}
+
+const MappedCourse* GradeBookMap_enrollmentCourse(const GradeBookMap* map, const MappedEnrollment* enrollment) {
+    return enrollment->course < map->coursesCount ? &map->courses[enrollment->course] : NULL;
+}
+
+const MappedStudent* GradeBookMap_enrollmentStudent(const GradeBookMap* map, const MappedEnrollment* enrollment) {
+    return enrollment->student < map->studentsCount ? &map->students[enrollment->student] : NULL;
+}
+
+const grade* GradeBookMap_grades(const GradeBookMap* map, const MappedEnrollment* enrollment) {
+    if(enrollment->gradesStart > map->gradesCount || enrollment->gradesCount > map->gradesCount - enrollment->gradesStart) {
+        return NULL;
+    }
+
+    return map->grades + enrollment->gradesStart;
+}
@@ -0,0 +1,233 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * GradeBook Map Header:
+ *
+ * Describes the mapped layout of a GradeBook file, and a read-only view of such a file that answers lookups, rosters,
+ * transcripts and averages straight from its bytes, without building a GradeBook.
+ *
+ * The serial format (see model_io.c) can only be read front to back. The mapped layout is instead a table of contents
+ * followed by sections of fixed-size records, so that a file may be mapped in to memory (see GradeBookMap_open) and
+ * used where it lies. Opening one checks the header and the table of contents alone, and costs the same for a file of
+ * any size; a record is checked when it is read.
+ *
+ * Layout, all numbers little-endian, every section starting on an 8 byte boundary:
+ *
+ * [magic: 4][version: u32][sectionsCount: u32][reserved: u32]
+ * sectionsCount * [kind: u32][reserved: u32][offset: u64][length: u64]
+ * COURSES      coursesCount * MappedCourse, in courseId order
+ * STUDENTS     studentsCount * MappedStudent, in studentId order
+ * ENROLLMENTS  one MappedEnrollment per enrollment, course by course, and by studentId within each course, so that
+ *              the roster of a course is a run of the section
+ * TRANSCRIPTS  u32 positions in ENROLLMENTS, student by student, and by courseId within each student
+ * NAMES        every course and student name, each ended by a 0
+ * GRADES       every grade of every enrollment, in ENROLLMENTS order, oldest first within each
+ *
+ * Sections may be in any order, and a reader skips those of kinds it does not know.
+ */
+
+#ifndef _H_GRADEBOOK_MAP
+    #define _H_GRADEBOOK_MAP
+    #include <stdint.h>
+    #include "../util.h"
+    #include "models.h"
+    #include "model_io.h"
+
+// Begin Header "gradebook map" ----------------------------------------------------------------------------------------
+
+/*
+ * Identifies a GradeBook file in the mapped layout
+ */
+extern const byte GRADEBOOK_MAPPED_MAGIC[4];
+
+#define GradeBookMap_VERSION 1
+
+typedef enum E_MappedSectionKind {
+
+    MAPPED_COURSES      = 1,
+    MAPPED_STUDENTS     = 2,
+    MAPPED_ENROLLMENTS  = 3,
+    MAPPED_TRANSCRIPTS  = 4,
+    MAPPED_NAMES        = 5,
+    MAPPED_GRADES       = 6
+
+} MappedSectionKind;
+
+typedef struct S_MappedCourse {
+
+    uint32_t courseId;
+
+    /*
+     * Position of the course's name in NAMES
+     */
+    uint32_t nameOffset;
+
+    /*
+     * The course's roster is ENROLLMENTS[enrollmentsStart] to ENROLLMENTS[enrollmentsStart + studentsCount - 1]
+     */
+    uint32_t enrollmentsStart;
+
+    uint32_t studentsCount;
+
+    /*
+     * Sum of the averages of the course's enrollments (see GradeAggregate)
+     */
+    double averagesSum;
+
+} MappedCourse;
+
+typedef struct S_MappedStudent {
+
+    uint32_t studentId;
+
+    uint32_t nameOffset;
+
+    /*
+     * The student's transcript is TRANSCRIPTS[transcriptStart] to TRANSCRIPTS[transcriptStart + coursesCount - 1]
+     */
+    uint32_t transcriptStart;
+
+    uint32_t coursesCount;
+
+    double averagesSum;
+
+} MappedStudent;
+
+typedef struct S_MappedEnrollment {
+
+    /*
+     * Positions of the course and student in COURSES and STUDENTS
+     */
+    uint32_t course;
+
+    uint32_t student;
+
+    /*
+     * The enrollment's grades are GRADES[gradesStart] to GRADES[gradesStart + gradesCount - 1]
+     */
+    uint64_t gradesStart;
+
+    uint64_t gradesCount;
+
+    uint64_t gradesSum;
+
+} MappedEnrollment;
+
+/*
+ * A GradeBook file in the mapped layout, and its sections. Everything is read-only, and lives as long as the map.
+ */
+typedef struct S_GradeBookMap {
+
+    const byte* data;
+
+    size length;
+
+    /*
+     * Set if `data` was mapped by GradeBookMap_open, and must be unmapped by GradeBookMap_close
+     */
+    bool mapped;
+
+    const MappedCourse* courses;
+
+    size coursesCount;
+
+    const MappedStudent* students;
+
+    size studentsCount;
+
+    const MappedEnrollment* enrollments;
+
+    size enrollmentsCount;
+
+    const uint32_t* transcripts;
+
+    size transcriptsCount;
+
+    const char* names;
+
+    size namesLength;
+
+    const grade* grades;
+
+    size gradesCount;
+
+} GradeBookMap;
+
+// -- Writing ----------------------------------------------------------------------------------------------------------
+
+/*
+ * Encode a GradeBook in the mapped layout. Returns FAILURE if the sink failed, and aborts if memory for the writer's
+ * tables, one entry for every course slot, could not be allocated.
+ */
+SerializationStatus GradeBook_encodeMapped(GradeBook* book, SerialSink* sink);
+
+// -- Reading ----------------------------------------------------------------------------------------------------------
+
+/*
+ * Map the file at `path` in to memory, read-only, and check its header and table of contents. Returns FAILURE if the
+ * file could not be opened or mapped, BAD_MAGIC if it is not in the mapped layout, and SHORT_BUFFER if a section lies
+ * outside of it. `map` is left empty unless SUCCESS is returned.
+ */
+SerializationStatus GradeBookMap_open(GradeBookMap* map, const char* path);
+
+/*
+ * Read the `length` bytes at `data`, which must outlast the map and be 8 byte aligned, as GradeBookMap_open does a file
+ */
+SerializationStatus GradeBookMap_wrap(GradeBookMap* map, const byte* data, size length);
+
+void GradeBookMap_close(GradeBookMap* map);
+
+/*
+ * Return the course, or student, with an ID, or NULL if there is none. A binary search of COURSES, or STUDENTS.
+ */
+const MappedCourse* GradeBookMap_findCourse(const GradeBookMap* map, uint32_t courseId);
+
+const MappedStudent* GradeBookMap_findStudent(const GradeBookMap* map, uint32_t studentId);
+
+/*
+ * Return the name of a course, or student, or "" if it does not lie within NAMES, or is longer than MAX_NAME_LENGTH
+ */
+const char* GradeBookMap_courseName(const GradeBookMap* map, const MappedCourse* course);
+
+const char* GradeBookMap_studentName(const GradeBookMap* map, const MappedStudent* student);
+
+/*
+ * Return the enrollment at `index` of the roster of `course`, in studentId order, or of the transcript of `student`, in
+ * courseId order. Returns NULL if there is no such enrollment, or the file names one that is not in it.
+ */
+const MappedEnrollment* GradeBookMap_rosterAt(const GradeBookMap* map, const MappedCourse* course, size index);
+
+const MappedEnrollment* GradeBookMap_transcriptAt(const GradeBookMap* map, const MappedStudent* student, size index);
+
+/*
+ * Return the course, or student, of an enrollment, or NULL if the file names one that is not in it
+ */
+const MappedCourse* GradeBookMap_enrollmentCourse(const GradeBookMap* map, const MappedEnrollment* enrollment);
+
+const MappedStudent* GradeBookMap_enrollmentStudent(const GradeBookMap* map, const MappedEnrollment* enrollment);
+
+/*
+ * Return the grades of an enrollment, enrollment->gradesCount of them, where they lie in the file, or NULL if they do
+ * not lie within GRADES
+ */
+const grade* GradeBookMap_grades(const GradeBookMap* map, const MappedEnrollment* enrollment);
+
+/*
+ * Averages, as Enrollment_average, Course_averageGrade and Student_averageGrade would give for the GradeBook written
+ */
+static inline float MappedEnrollment_average(const MappedEnrollment* enrollment) {
+    return enrollment->gradesCount > 0 ? (float) enrollment->gradesSum / (float) enrollment->gradesCount : 0;
+}
+
+static inline float MappedCourse_average(const MappedCourse* course) {
+    return course->studentsCount > 0 ? (float) (course->averagesSum / course->studentsCount) : 0;
+}
+
+static inline float MappedStudent_average(const MappedStudent* student) {
+    return student->coursesCount > 0 ? (float) (student->averagesSum / student->coursesCount) : 0;
+}
+
+// End Header "gradebook map" ------------------------------------------------------------------------------------------
+
+#endif
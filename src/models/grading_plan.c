@@ -0,0 +1,310 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * Grading Plan Definitions:
+ *
+ * Implements the policy compiler and plan evaluation described in grading_plan.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdarg.h>
+#include "grading_plan.h"
+
+/*
+ * Cap of a category that was given none; the highest grade there is
+ */
+static const float _PLAN_NO_CAP = 0xFF;
+
+// -- Compiler ---------------------------------------------------------------------------------------------------------
+
+static const char* GradingPlan_skipSpace(const char* cursor) {
+    while(*cursor && isspace((unsigned char) *cursor)) ++cursor;
+    return cursor;
+}
+
+/*
+ * Length of the word at `cursor`, which ends at a space, a comma or the end of the policy
+ */
+static size GradingPlan_wordLength(const char* cursor) {
+    size length = 0;
+    while(cursor[length] && cursor[length] != ',' && !isspace((unsigned char) cursor[length])) ++length;
+    return length;
+}
+
+static bool GradingPlan_isWord(const char* cursor, size length, const char* word) {
+    return strlen(word) == length && strncmp(cursor, word, length) == 0;
+}
+
+/*
+ * Read a number that makes up a whole word, moving `cursor` past it
+ */
+static bool GradingPlan_readNumber(const char** cursor, double* value) {
+    *cursor = GradingPlan_skipSpace(*cursor);
+
+    size length = GradingPlan_wordLength(*cursor);
+    char* end;
+
+    if(length == 0) return false;
+
+    *value = strtod(*cursor, &end);
+
+    if(end != *cursor + length) return false;
+
+    *cursor = end;
+
+    return true;
+}
+
+static bool GradingPlan_isCount(double value) {
+    return value >= 0 && value == (double) (uint32_t) value;
+}
+
+GradingPlanStatus GradingPlan_compile(const char* policy, GradingPlan* plan) {
+
+    GradingPlan compiled = {};
+    const char* cursor = policy;
+
+    for(;;) {
+        if(compiled.categoriesCount == GradingPlan_MAX_CATEGORIES) return PLAN_TOO_LARGE;
+
+        uint32_t category = compiled.categoriesCount++;
+
+        // Name, which may not be mistaken for a count
+        cursor = GradingPlan_skipSpace(cursor);
+        size length = GradingPlan_wordLength(cursor);
+
+        if(length == 0 || length > GradingPlan_NAME_LENGTH || isdigit((unsigned char) *cursor)) return PLAN_BAD_SYNTAX;
+
+        memcpy(compiled.names[category], cursor, length);
+        cursor += length;
+
+        // Count
+        double value;
+
+        if(!GradingPlan_readNumber(&cursor, &value) || !GradingPlan_isCount(value)) return PLAN_BAD_SYNTAX;
+        if(value == 0) return PLAN_BAD_VALUE;
+        if(value > GradingPlan_MAX_WIDTH - compiled.width) return PLAN_TOO_LARGE;
+
+        compiled.first[category]    = compiled.width;
+        compiled.count[category]    = (uint32_t) value;
+        compiled.weight[category]   = 1;
+        compiled.cap[category]      = _PLAN_NO_CAP;
+        compiled.width             += compiled.count[category];
+
+        // Options, in any order
+        for(;;) {
+            cursor = GradingPlan_skipSpace(cursor);
+            length = GradingPlan_wordLength(cursor);
+
+            if(length == 0) break;
+
+            const char* option = cursor;
+            cursor += length;
+
+            if(!GradingPlan_readNumber(&cursor, &value)) return PLAN_BAD_SYNTAX;
+
+            if(GradingPlan_isWord(option, length, "weight")) {
+                if(!(value > 0)) return PLAN_BAD_VALUE;
+                compiled.weight[category] = (float) value;
+            } else if(GradingPlan_isWord(option, length, "drop")) {
+                if(!GradingPlan_isCount(value)) return PLAN_BAD_SYNTAX;
+                if(value > GradingPlan_MAX_DROPPED) return PLAN_TOO_LARGE;
+                if(value >= compiled.count[category]) return PLAN_BAD_VALUE;
+                compiled.dropped[category] = (uint32_t) value;
+            } else if(GradingPlan_isWord(option, length, "cap")) {
+                if(!(value >= 0 && value <= _PLAN_NO_CAP)) return PLAN_BAD_VALUE;
+                compiled.cap[category] = (float) value;
+            } else {
+                return PLAN_BAD_SYNTAX;
+            }
+        }
+
+        if(*cursor == '\0') break;
+
+        // Only a comma can be left, as every word has been read
+        ++cursor;
+    }
+
+    *plan = compiled;
+
+    return PLAN_COMPILED;
+}
+
+/*
+ * Append to a policy being formatted. Returns false, and appends nothing more from then on, once it does not fit.
+ */
+static bool GradingPlan_append(char* destination, size length, size* written, const char* format, ...) {
+    va_list arguments;
+    va_start(arguments, format);
+    int count = vsnprintf(destination + *written, length - *written, format, arguments);
+    va_end(arguments);
+
+    if(count < 0 || (size) count >= length - *written) return false;
+
+    *written += (size) count;
+
+    return true;
+}
+
+bool GradingPlan_format(const GradingPlan* plan, char* destination, size length) {
+    size written = 0;
+
+    if(length == 0) return false;
+
+    destination[0] = '\0';
+
+    for(uint32_t category = 0; category < plan->categoriesCount; ++category) {
+        bool fits = GradingPlan_append(destination, length, &written, "%s%s %u", category ? ", " : "",
+                                       plan->names[category], plan->count[category]);
+
+        if(fits && plan->weight[category] != 1) {
+            fits = GradingPlan_append(destination, length, &written, " weight %g", plan->weight[category]);
+        }
+
+        if(fits && plan->dropped[category] != 0) {
+            fits = GradingPlan_append(destination, length, &written, " drop %u", plan->dropped[category]);
+        }
+
+        if(fits && plan->cap[category] != _PLAN_NO_CAP) {
+            fits = GradingPlan_append(destination, length, &written, " cap %g", plan->cap[category]);
+        }
+
+        if(!fits) return false;
+    }
+
+    return true;
+}
+
+// -- Evaluation -------------------------------------------------------------------------------------------------------
+
+/*
+ * Average of a category once its lowest grades are dropped, capped, for `present` grades summing to `sum`, of which the
+ * lowest `dropped` sum to `droppedSum`. Shared by both evaluators, so that they agree to the last bit.
+ */
+static inline float GradingPlan_categoryAverage(const GradingPlan* plan, uint32_t category, uint32_t present,
+                                                uint32_t sum, uint32_t droppedSum, uint32_t dropped) {
+    uint32_t kept   = present - dropped;
+    float average   = kept > 0 ? (float) (sum - droppedSum) / (float) kept : 0;
+
+    return average < plan->cap[category] ? average : plan->cap[category];
+}
+
+/*
+ * Grades a category may drop from `present` grades
+ */
+static inline uint32_t GradingPlan_droppable(const GradingPlan* plan, uint32_t category, uint32_t present) {
+    uint32_t most = present > 0 ? present - 1 : 0;
+    return plan->dropped[category] < most ? plan->dropped[category] : most;
+}
+
+float GradingPlan_score(const GradingPlan* plan, const grade* grades, size count) {
+    float total = 0, weights = 0;
+
+    for(uint32_t category = 0; category < plan->categoriesCount; ++category) {
+        uint32_t first      = plan->first[category];
+        size available      = count > first ? count - first : 0;
+        uint32_t present    = available < plan->count[category] ? (uint32_t) available : plan->count[category];
+
+        if(present == 0) continue;
+
+        // Sort the category's grades, which are few, so that the lowest come first
+        grade sorted[GradingPlan_MAX_WIDTH];
+        uint32_t sum = 0;
+
+        for(uint32_t idx = 0; idx < present; ++idx) {
+            grade value = grades[first + idx];
+            uint32_t position = idx;
+
+            for(; position > 0 && sorted[position - 1] > value; --position) sorted[position] = sorted[position - 1];
+
+            sorted[position] = value;
+            sum += value;
+        }
+
+        uint32_t dropped = GradingPlan_droppable(plan, category, present), droppedSum = 0;
+
+        for(uint32_t idx = 0; idx < dropped; ++idx) droppedSum += sorted[idx];
+
+        float average = GradingPlan_categoryAverage(plan, category, present, sum, droppedSum, dropped);
+
+        total   += plan->weight[category] * average;
+        weights += plan->weight[category];
+    }
+
+    return weights > 0 ? total / weights : 0;
+}
+
+/*
+ * Score one tile of at most GradingPlan_TILE_ROWS enrollments, starting at row `start` of `columns`.
+ *
+ * Each category is added up a column at a time. Alongside its sum and count, every enrollment keeps its lowest grades
+ * so far in ascending order, in `lowest`: each grade is passed down the list, leaving the smaller of itself and each
+ * entry behind, so that a grade is kept in a few minimums and maximums rather than a search. Missing grades are larger
+ * than any grade, and so are never kept ahead of one.
+ */
+static void GradingPlan_evaluateTile(const GradingPlan* plan, const uint16_t* columns, size rows, size start,
+                                     size tileRows, float* scores) {
+
+    float total[GradingPlan_TILE_ROWS], weights[GradingPlan_TILE_ROWS];
+    uint32_t sums[GradingPlan_TILE_ROWS], present[GradingPlan_TILE_ROWS];
+    uint16_t lowest[GradingPlan_MAX_DROPPED][GradingPlan_TILE_ROWS], carried[GradingPlan_TILE_ROWS];
+
+    for(size row = 0; row < tileRows; ++row) total[row] = weights[row] = 0;
+
+    for(uint32_t category = 0; category < plan->categoriesCount; ++category) {
+        uint32_t nDropped = plan->dropped[category];
+
+        for(size row = 0; row < tileRows; ++row) sums[row] = present[row] = 0;
+
+        for(uint32_t drop = 0; drop < nDropped; ++drop) {
+            for(size row = 0; row < tileRows; ++row) lowest[drop][row] = GradingPlan_MISSING;
+        }
+
+        for(uint32_t position = 0; position < plan->count[category]; ++position) {
+            const uint16_t* column = &columns[(plan->first[category] + position) * rows + start];
+
+            for(size row = 0; row < tileRows; ++row) {
+                uint16_t value  = column[row];
+                uint32_t given  = value != GradingPlan_MISSING;
+
+                sums[row]      += given ? value : 0;
+                present[row]   += given;
+                carried[row]    = value;
+            }
+
+            for(uint32_t drop = 0; drop < nDropped; ++drop) {
+                for(size row = 0; row < tileRows; ++row) {
+                    uint16_t kept   = lowest[drop][row];
+                    uint16_t value  = carried[row];
+
+                    lowest[drop][row]   = value < kept ? value : kept;
+                    carried[row]        = value < kept ? kept : value;
+                }
+            }
+        }
+
+        for(size row = 0; row < tileRows; ++row) {
+            uint32_t dropped = GradingPlan_droppable(plan, category, present[row]), droppedSum = 0;
+
+            for(uint32_t drop = 0; drop < nDropped; ++drop) droppedSum += drop < dropped ? lowest[drop][row] : 0;
+
+            float average = GradingPlan_categoryAverage(plan, category, present[row], sums[row], droppedSum, dropped);
+
+            total[row]     += present[row] ? plan->weight[category] * average : 0;
+            weights[row]   += present[row] ? plan->weight[category] : 0;
+        }
+    }
+
+    for(size row = 0; row < tileRows; ++row) scores[start + row] = weights[row] > 0 ? total[row] / weights[row] : 0;
+}
+
+void GradingPlan_evaluate(const GradingPlan* plan, const uint16_t* columns, size rows, float* scores) {
+    for(size start = 0; start < rows; start += GradingPlan_TILE_ROWS) {
+        size tileRows = rows - start < GradingPlan_TILE_ROWS ? rows - start : GradingPlan_TILE_ROWS;
+        GradingPlan_evaluateTile(plan, columns, rows, start, tileRows, scores);
+    }
+}
@@ -0,0 +1,141 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * Grading Plan Header:
+ *
+ * Describes grading policies, and the flat plans they are compiled to.
+ *
+ * A policy splits the grade log of an enrollment in to categories, in the order the grades were given, and weighs the
+ * average of each. It is written as a list of categories separated by commas:
+ *
+ *     homework 6 weight 40 drop 2, quizzes 4 weight 20 drop 1, exams 2 weight 40 cap 100
+ *
+ * Each category is a name, the number of grades it takes from the log, and any of:
+ * - weight <w>: its share of the score, relative to the other categories (1 if not given)
+ * - drop <d>: how many of its lowest grades are left out of its average (none if not given)
+ * - cap <c>: the most its average may count for (MAX_GRADE if not given)
+ *
+ * The score of an enrollment is the weighted mean of the averages of the categories in which it has any grades; a
+ * category with no grades yet takes no part, and an enrollment with none at all scores 0. Drops never leave a category
+ * with fewer than one grade, and grades past the last category are not counted.
+ *
+ * A policy is parsed once, by GradingPlan_compile, in to a GradingPlan: one fixed-size row of numbers per category,
+ * which holds no pointers, so a plan may be copied by value. GradingPlan_evaluate then scores a batch of enrollments
+ * at once, a category at a time, with each step a plain loop across the batch; nothing is parsed, and no branch is
+ * taken per enrollment.
+ */
+
+#ifndef _H_GRADING_PLAN
+    #define _H_GRADING_PLAN
+    #include <stdint.h>
+    #include "../util.h"
+    #include "grade_kernels.h"
+
+// Begin Header "grading plan" -----------------------------------------------------------------------------------------
+
+#define GradingPlan_MAX_CATEGORIES 8
+
+/*
+ * Most grades a plan may read from each log, over all of its categories
+ */
+#define GradingPlan_MAX_WIDTH 256
+
+/*
+ * Most grades one category may drop
+ */
+#define GradingPlan_MAX_DROPPED 8
+
+/*
+ * Longest category name, not counting the terminator
+ */
+#define GradingPlan_NAME_LENGTH 15
+
+/*
+ * Marks a grade that has not been given yet in a batch passed to GradingPlan_evaluate
+ */
+#define GradingPlan_MISSING 0x100
+
+/*
+ * Enrollments scored together by GradingPlan_evaluate. Batches of any size are split in to tiles of this many.
+ */
+#define GradingPlan_TILE_ROWS 256
+
+typedef enum GradingPlanStatus {
+
+    PLAN_COMPILED           = 0,
+
+    /*
+     * A category is not of the form "<name> <count> [weight <w>] [drop <d>] [cap <c>]"
+     */
+    PLAN_BAD_SYNTAX         = 1,
+
+    /*
+     * Too many categories, or grades, or a category drops too many grades (see GradingPlan_MAX_*)
+     */
+    PLAN_TOO_LARGE          = 2,
+
+    /*
+     * A weight that is not positive, a category that would drop all of its grades, or a cap past MAX_GRADE
+     */
+    PLAN_BAD_VALUE          = 3
+
+} GradingPlanStatus;
+
+typedef struct S_GradingPlan {
+
+    /*
+     * At least one in a compiled plan
+     */
+    uint32_t categoriesCount;
+
+    /*
+     * Grades read from the start of each log: the sum of every category's count
+     */
+    uint32_t width;
+
+    /*
+     * Position in the log of the first grade of each category
+     */
+    uint32_t first[GradingPlan_MAX_CATEGORIES];
+
+    uint32_t count[GradingPlan_MAX_CATEGORIES];
+
+    uint32_t dropped[GradingPlan_MAX_CATEGORIES];
+
+    float weight[GradingPlan_MAX_CATEGORIES];
+
+    float cap[GradingPlan_MAX_CATEGORIES];
+
+    char names[GradingPlan_MAX_CATEGORIES][GradingPlan_NAME_LENGTH + 1];
+
+} GradingPlan;
+
+/*
+ * Compile a policy in to `plan`. `plan` is only written when the policy compiles.
+ */
+GradingPlanStatus GradingPlan_compile(const char* policy, GradingPlan* plan);
+
+/*
+ * Write a plan back out as a policy, which compiles to the same plan, to `destination`, which has room for `length`
+ * characters including the terminator. Returns false if it did not fit.
+ */
+bool GradingPlan_format(const GradingPlan* plan, char* destination, size length);
+
+/*
+ * Score one enrollment from its grades, oldest first. Gives the same score as GradingPlan_evaluate, one grade at a
+ * time; use GradingPlan_evaluate to score more than a few.
+ */
+float GradingPlan_score(const GradingPlan* plan, const grade* grades, size count);
+
+/*
+ * Score `rows` enrollments at once, writing one score per enrollment to `scores`.
+ *
+ * `columns` holds plan->width columns of `rows` grades each, column by column: the grade at position p of the log of
+ * enrollment r is columns[p * rows + r], or GradingPlan_MISSING if the enrollment has fewer than p + 1 grades.
+ */
+void GradingPlan_evaluate(const GradingPlan* plan, const uint16_t* columns, size rows, float* scores);
+
+// End Header "grading plan" -------------------------------------------------------------------------------------------
+
+#endif
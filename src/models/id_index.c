@@ -0,0 +1,154 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * ID Index Definitions:
+ *
+ * Implements the open-addressing ID index described in id_index.h
+ */
+
+#include <string.h>
+#include "id_index.h"
+
+const uint32_t IdIndex_EMPTY = UINT32_MAX;
+
+static const size _ID_INDEX_INITIAL_CAPACITY = 16;
+
+/*
+ * Fibonacci hashing: multiply by 2^32 / phi and fold the high bits down, which spreads sequential ID's across the table.
+ */
+static inline size IdIndex_home(const IdIndex* index, identifier id) {
+    uint32_t hash = (uint32_t) id * 2654435769u;
+    return (size) (hash ^ (hash >> 16)) & (index->capacity - 1);
+}
+
+void IdIndex_init(IdIndex* index, Pool* pool) {
+    memset(index, 0, sizeof(IdIndex));
+    index->pool = pool;
+}
+
+void IdIndex_free(IdIndex* index) {
+    Pool_release(index->pool, index->entries, index->capacity * sizeof(IdIndexEntry));
+    IdIndex_init(index, index->pool);
+}
+
+bool IdIndex_clone(IdIndex* destination, const IdIndex* source) {
+
+    IdIndex_init(destination, destination->pool);
+
+    if(source->capacity == 0) return true;
+
+    destination->entries = Pool_alloc(destination->pool, source->capacity * sizeof(IdIndexEntry));
+
+    if(!destination->entries) return false;
+
+    memcpy(destination->entries, source->entries, source->capacity * sizeof(IdIndexEntry));
+    destination->capacity   = source->capacity;
+    destination->count      = source->count;
+
+    return true;
+}
+
+static bool IdIndex_resize(IdIndex* index, size capacity) {
+
+    IdIndexEntry* entries = Pool_alloc(index->pool, capacity * sizeof(IdIndexEntry));
+
+    if(!entries) return false;
+
+    for(size idx = 0; idx < capacity; ++idx) {
+        entries[idx].slot = IdIndex_EMPTY;
+    }
+
+    IdIndex old = *index;
+
+    index->entries  = entries;
+    index->capacity = capacity;
+    index->count    = 0;
+
+    for(size idx = 0; idx < old.capacity; ++idx) {
+        if(old.entries[idx].slot != IdIndex_EMPTY) {
+            IdIndex_insert(index, old.entries[idx].id, old.entries[idx].slot);
+        }
+    }
+
+    Pool_release(index->pool, old.entries, old.capacity * sizeof(IdIndexEntry));
+
+    return true;
+}
+
+bool IdIndex_insert(IdIndex* index, identifier id, size slot) {
+
+    // Keep the load factor at or below 1/2, which keeps linear probe sequences short
+    if((index->count + 1) * 2 > index->capacity) {
+        size capacity = index->capacity ? index->capacity * 2 : _ID_INDEX_INITIAL_CAPACITY;
+
+        if(!IdIndex_resize(index, capacity)) {
+            fprintf(stderr, "IdIndex: unable to grow to %lu entries\n", capacity);
+            abort();
+        }
+    }
+
+    size mask = index->capacity - 1;
+
+    for(size pos = IdIndex_home(index, id); ; pos = (pos + 1) & mask) {
+        IdIndexEntry* entry = &index->entries[pos];
+
+        if(entry->slot == IdIndex_EMPTY) {
+            entry->id   = id;
+            entry->slot = (uint32_t) slot;
+            ++index->count;
+            return true;
+        }
+
+        if(entry->id == id) return false;
+    }
+}
+
+long IdIndex_find(const IdIndex* index, identifier id) {
+
+    if(index->count == 0) return -1;
+
+    size mask = index->capacity - 1;
+
+    for(size pos = IdIndex_home(index, id); ; pos = (pos + 1) & mask) {
+        const IdIndexEntry* entry = &index->entries[pos];
+
+        if(entry->slot == IdIndex_EMPTY) return -1;
+        if(entry->id == id) return (long) entry->slot;
+    }
+}
+
+bool IdIndex_remove(IdIndex* index, identifier id) {
+
+    if(index->count == 0) return false;
+
+    size mask   = index->capacity - 1;
+    size pos    = IdIndex_home(index, id);
+
+    while(index->entries[pos].slot != IdIndex_EMPTY && index->entries[pos].id != id) {
+        pos = (pos + 1) & mask;
+    }
+
+    if(index->entries[pos].slot == IdIndex_EMPTY) return false;
+
+    /*
+     * Backward-shift deletion: pull every following entry of the same probe run back in to the hole, unless doing so
+     * would move it in front of its home position.
+     */
+    size hole = pos;
+
+    for(size next = (hole + 1) & mask; index->entries[next].slot != IdIndex_EMPTY; next = (next + 1) & mask) {
+        size home = IdIndex_home(index, index->entries[next].id);
+
+        // Distance from home to next, and from home to hole, both measured in probe order
+        if(((next - home) & mask) >= ((next - hole) & mask)) {
+            index->entries[hole] = index->entries[next];
+            hole = next;
+        }
+    }
+
+    index->entries[hole].slot = IdIndex_EMPTY;
+    --index->count;
+
+    return true;
+}
@@ -0,0 +1,93 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * ID Index Header:
+ *
+ * Describes an open-addressing hash index that maps a student or course ID to the arena slot holding that record.
+ *
+ * Entries are (id, slot) pairs stored inline in one flat table, and collisions are resolved by linear probing, so a
+ * lookup touches one or two cache lines no matter how large the record it refers to is. Removal uses backward-shift
+ * deletion, which keeps probe sequences short without tombstones.
+ */
+
+#ifndef _H_ID_INDEX
+    #define _H_ID_INDEX
+    #include <stdint.h>
+    #include "../util.h"
+    #include "pool.h"
+
+// Begin Header "id index" ---------------------------------------------------------------------------------------------
+
+/*
+ * Type used for student and course ID's.
+ * By default an ID is one byte wide. Defining _GB_WIDE_IDS widens it to 32 bits.
+ */
+#ifdef _GB_WIDE_IDS
+typedef uint32_t identifier;
+#else
+typedef byte identifier;
+#endif
+
+typedef struct S_IdIndexEntry {
+
+    identifier id;
+
+    /*
+     * Arena slot of the record, or IdIndex_EMPTY
+     */
+    uint32_t slot;
+
+} IdIndexEntry;
+
+typedef struct S_IdIndex {
+
+    /*
+     * Table of entries, `capacity` long. Capacity is always zero or a power of two.
+     */
+    IdIndexEntry* entries;
+
+    size capacity;
+
+    size count;
+
+    /*
+     * Pool that the table is allocated from
+     */
+    Pool* pool;
+
+} IdIndex;
+
+/*
+ * Slot value that marks an unused entry
+ */
+extern const uint32_t IdIndex_EMPTY;
+
+void IdIndex_init(IdIndex* index, Pool* pool);
+
+void IdIndex_free(IdIndex* index);
+
+/*
+ * Make `destination`, which must be initialized and empty, an independent copy of `source`, allocated from the pool of
+ * `destination`. Returns false, leaving `destination` empty, on allocation failure.
+ */
+bool IdIndex_clone(IdIndex* destination, const IdIndex* source);
+
+/*
+ * Map id to slot. Returns false, and leaves the index unchanged, if id is already present.
+ */
+bool IdIndex_insert(IdIndex* index, identifier id, size slot);
+
+/*
+ * Return the slot mapped to id, or -1 if id is not present.
+ */
+long IdIndex_find(const IdIndex* index, identifier id);
+
+/*
+ * Remove the mapping for id. Returns false if id was not present.
+ */
+bool IdIndex_remove(IdIndex* index, identifier id);
+
+// End Header "id index" -----------------------------------------------------------------------------------------------
+
+#endif
@@ -15,9 +15,14 @@
  * model_io.h includes models.h
  */
 #include <string.h>
+#include <limits.h>
 #include <search.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 #include "../util.h"
 
 #include "model_io.h"
@@ -35,10 +40,471 @@ int compare_byte(const void* a, const void* b) {
     }
 }
 
+/*
+ * Comparator for serial ID's, which are always held as 32-bit integers regardless of the ID width on disk
+ */
+int compare_serialId(const void* a, const void* b) {
+    uint32_t idA = *((uint32_t*)a), idB = *((uint32_t*)b);
+    return (idA > idB) - (idA < idB);
+}
+
+/*
+ * Write `value` as an integer `width` bytes wide, most significant byte first, and return the next free index
+ */
+size Serial_writeId(byte* receiver, size offset, uint32_t value, byte width) {
+    for(byte place = width; place > 0; --place) {
+        receiver[offset++] = (byte) (value >> ((place - 1) * 8));
+    }
+    return offset;
+}
+
+/*
+ * Read an integer `width` bytes wide, most significant byte first, and return the next unread index
+ */
+size Serial_readId(const byte* data, size offset, uint32_t* value, byte width) {
+    *value = 0;
+    for(byte place = 0; place < width; ++place) {
+        *value = (*value << 8) | data[offset++];
+    }
+    return offset;
+}
+
+/*
+ * Write `value` as an unsigned LEB128 varint (seven bits per byte, least significant group first, high bit set on every
+ * byte but the last) and return the next free index. Values below 128 take a single byte, equal to the value.
+ */
+size Serial_writeVarint(byte* receiver, size offset, size value) {
+    while(value >= 0x80) {
+        receiver[offset++] = (byte) (value | 0x80);
+        value >>= 7;
+    }
+    receiver[offset++] = (byte) value;
+    return offset;
+}
+
+/*
+ * Read an unsigned LEB128 varint and return the next unread index
+ */
+size Serial_readVarint(const byte* data, size offset, size* value) {
+    byte shift = 0;
+    *value = 0;
+    do {
+        *value |= (size) (data[offset] & 0x7F) << shift;
+        shift += 7;
+    } while(data[offset++] & 0x80 && shift < 64);
+    return offset;
+}
+
+/*
+ * Number of bytes `count` grades take, packed 7 bits apiece
+ */
+size Serial_sizeOfPacked(size count) {
+    return (count * 7 + 7) / 8;
+}
+
+/*
+ * Number of bytes Serial_writeVarint uses for `value`
+ */
+size Serial_sizeOfVarint(size value) {
+    size nBytes = 1;
+    while(value >= 0x80) {
+        value >>= 7;
+        ++nBytes;
+    }
+    return nBytes;
+}
+
+// Sinks ---------------------------------------------------------------------------------------------------------------
+
+void SerialBuffer_init(SerialBuffer* buffer) {
+    memset(buffer, 0, sizeof(SerialBuffer));
+}
+
+void SerialBuffer_wrap(SerialBuffer* buffer, byte* data, size capacity) {
+    buffer->data        = data;
+    buffer->count       = 0;
+    buffer->capacity    = capacity;
+    buffer->fixed       = true;
+}
+
+void SerialBuffer_free(SerialBuffer* buffer) {
+    if(!buffer->fixed) free(buffer->data);
+    SerialBuffer_init(buffer);
+}
+
+static bool SerialBuffer_write(void* target, const byte* data, size count) {
+    SerialBuffer* buffer = target;
+
+    if(buffer->count + count > buffer->capacity) {
+        if(buffer->fixed) return false;
+
+        size capacity = buffer->capacity ? buffer->capacity : SerialSink_BUFFER_BYTES;
+        while(capacity < buffer->count + count) capacity *= 2;
+
+        byte* grown = realloc(buffer->data, capacity);
+        if(!grown) return false;
+
+        buffer->data        = grown;
+        buffer->capacity    = capacity;
+    }
+
+    memcpy(buffer->data + buffer->count, data, count);
+    buffer->count += count;
+
+    return true;
+}
+
+static bool SerialSink_writeFile(void* target, const byte* data, size count) {
+    return fwrite(data, sizeof(byte), count, target) == count;
+}
+
+static bool SerialSink_writeFd(void* target, const byte* data, size count) {
+    int fd = (int) (intptr_t) target;
+
+    while(count > 0) {
+        ssize_t wrote = write(fd, data, count);
+
+        if(wrote < 0 && errno == EINTR) continue;
+        if(wrote <= 0) return false;
+
+        data    += wrote;
+        count   -= (size) wrote;
+    }
+
+    return true;
+}
+
+/*
+ * Point a sink at a target, with nothing buffered
+ */
+static void SerialSink_init(SerialSink* sink, bool (*write)(void* target, const byte* data, size count), void* target) {
+    sink->write     = write;
+    sink->target    = target;
+    sink->buffered  = 0;
+    sink->written   = 0;
+    sink->failed    = false;
+}
+
+void SerialSink_initFile(SerialSink* sink, FILE* file) {
+    SerialSink_init(sink, &SerialSink_writeFile, file);
+}
+
+void SerialSink_initFd(SerialSink* sink, int fd) {
+    SerialSink_init(sink, &SerialSink_writeFd, (void*) (intptr_t) fd);
+}
+
+void SerialSink_initBuffer(SerialSink* sink, SerialBuffer* buffer) {
+    SerialSink_init(sink, &SerialBuffer_write, buffer);
+}
+
+/*
+ * Hand the buffered bytes on, leaving the buffer empty
+ */
+static void SerialSink_drain(SerialSink* sink) {
+    if(sink->buffered > 0 && !sink->failed) sink->failed = !sink->write(sink->target, sink->buffer, sink->buffered);
+    sink->buffered = 0;
+}
+
+void SerialSink_put(SerialSink* sink, const byte* data, size count) {
+    sink->written += count;
+
+    if(sink->buffered + count > SerialSink_BUFFER_BYTES) {
+        SerialSink_drain(sink);
+
+        // A run too long to buffer goes straight through
+        if(count > SerialSink_BUFFER_BYTES) {
+            if(!sink->failed) sink->failed = !sink->write(sink->target, data, count);
+            return;
+        }
+    }
+
+    memcpy(sink->buffer + sink->buffered, data, count);
+    sink->buffered += count;
+}
+
+/*
+ * Make room for at least `count` bytes, which must be no more than the buffer holds, and return where they go
+ */
+static inline byte* SerialSink_reserve(SerialSink* sink, size count) {
+    if(sink->buffered + count > SerialSink_BUFFER_BYTES) SerialSink_drain(sink);
+    return sink->buffer + sink->buffered;
+}
+
+static inline void SerialSink_putByte(SerialSink* sink, byte value) {
+    *SerialSink_reserve(sink, 1) = value;
+    ++sink->buffered;
+    ++sink->written;
+}
+
+static inline void SerialSink_putId(SerialSink* sink, uint32_t value, byte width) {
+    size used       = Serial_writeId(SerialSink_reserve(sink, width), 0, value, width);
+    sink->buffered += used;
+    sink->written  += used;
+}
+
+/*
+ * Write a 64 bit offset or length, most significant byte first
+ */
+static inline void SerialSink_putOffset(SerialSink* sink, uint64_t value) {
+    SerialSink_putId(sink, (uint32_t) (value >> 32), 4);
+    SerialSink_putId(sink, (uint32_t) value, 4);
+}
+
+static inline void SerialSink_putVarint(SerialSink* sink, size value) {
+    // A 64 bit value takes at most 10 groups of 7 bits
+    size used       = Serial_writeVarint(SerialSink_reserve(sink, 10), 0, value);
+    sink->buffered += used;
+    sink->written  += used;
+}
+
+/*
+ * Write the length of an ID list: one ID wide, or a varint in a compact GradeBook
+ */
+static inline void SerialSink_putCount(SerialSink* sink, size count, byte width, byte flags) {
+    if(flags & GRADEBOOK_COMPACT) {
+        SerialSink_putVarint(sink, count);
+    } else {
+        SerialSink_putId(sink, (uint32_t) count, width);
+    }
+}
+
+/*
+ * Write the next ID of a list in ID order, which a compact GradeBook writes as a varint difference from `previous`
+ */
+static inline void SerialSink_putListId(SerialSink* sink, uint32_t id, uint32_t* previous, byte width, byte flags) {
+    if(flags & GRADEBOOK_COMPACT) {
+        SerialSink_putVarint(sink, id - *previous);
+    } else {
+        SerialSink_putId(sink, id, width);
+    }
+
+    *previous = id;
+}
+
+/*
+ * Packs grades below 0x80 in to a sink 7 bits apiece, as they are handed over a run at a time, each group of 8 being
+ * written as it fills (see GradeKernels.unpack)
+ */
+typedef struct S_GradePacker {
+
+    SerialSink* sink;
+
+    uint64_t bits;
+
+    /*
+     * Grades held in `bits`
+     */
+    byte count;
+
+} GradePacker;
+
+/*
+ * Write the low `count` bytes of the grades held, least significant first, and hold none
+ */
+static void GradePacker_drain(GradePacker* packer, size count) {
+    byte* out = SerialSink_reserve(packer->sink, count);
+
+    for(size idx = 0; idx < count; ++idx) out[idx] = (byte) (packer->bits >> (8 * idx));
+
+    packer->sink->buffered += count;
+    packer->sink->written  += count;
+    packer->bits            = 0;
+    packer->count           = 0;
+}
+
+static void GradePacker_run(void* target, const grade* run, size count) {
+    GradePacker* packer = target;
+
+    for(size idx = 0; idx < count; ++idx) {
+        packer->bits |= (uint64_t) run[idx] << (7 * packer->count);
+
+        if(++packer->count == 8) GradePacker_drain(packer, 7);
+    }
+}
+
+/*
+ * Write the last group, cut short to the bytes its grades need
+ */
+static void GradePacker_finish(GradePacker* packer) {
+    if(packer->count > 0) GradePacker_drain(packer, Serial_sizeOfPacked(packer->count));
+}
+
+bool SerialSink_flush(SerialSink* sink) {
+    SerialSink_drain(sink);
+    return !sink->failed;
+}
+
+// Sources -------------------------------------------------------------------------------------------------------------
+
+static long SerialSource_readFile(void* target, byte* data, size count) {
+    size got = fread(data, sizeof(byte), count, target);
+    return got > 0 || !ferror(target) ? (long) got : -1;
+}
+
+static long SerialSource_readFd(void* target, byte* data, size count) {
+    ssize_t got;
+
+    do {
+        got = read((int) (intptr_t) target, data, count);
+    } while(got < 0 && errno == EINTR);
+
+    return (long) got;
+}
+
+static void SerialSource_init(SerialSource* source, long (*read)(void* target, byte* data, size count), void* target) {
+    source->read        = read;
+    source->target      = target;
+    source->data        = source->window;
+    source->position    = 0;
+    source->length      = 0;
+    source->consumed    = 0;
+    source->failed      = false;
+    source->malformed   = false;
+}
+
+void SerialSource_initFile(SerialSource* source, FILE* file) {
+    SerialSource_init(source, &SerialSource_readFile, file);
+}
+
+void SerialSource_initFd(SerialSource* source, int fd) {
+    SerialSource_init(source, &SerialSource_readFd, (void*) (intptr_t) fd);
+}
+
+void SerialSource_initMemory(SerialSource* source, const byte* data, size length) {
+    SerialSource_init(source, NULL, NULL);
+    source->data    = data;
+    source->length  = length;
+}
+
+/*
+ * Make at least `count` bytes, no more than the window holds, ready to decode. Returns false if the source ends, or
+ * fails, first; whatever could be read is still ready.
+ */
+static bool SerialSource_fill(SerialSource* source, size count) {
+    size ready = source->length - source->position;
+
+    if(ready >= count) return true;
+    if(!source->read || source->failed) return false;
+
+    // Slide what is left to the front of the window, and read in behind it
+    memmove(source->window, source->data + source->position, ready);
+    source->consumed   += source->position;
+    source->data        = source->window;
+    source->position    = 0;
+    source->length      = ready;
+
+    while(source->length < count) {
+        long got = source->read(source->target, source->window + source->length, SerialSource_WINDOW_BYTES - source->length);
+
+        if(got < 0) source->failed = true;
+        if(got <= 0) return false;
+
+        source->length += (size) got;
+    }
+
+    return true;
+}
+
+static bool SerialSource_take(SerialSource* source, byte* destination, size count) {
+    while(count > 0) {
+        if(!SerialSource_fill(source, 1)) return false;
+
+        size run = source->length - source->position;
+        if(run > count) run = count;
+
+        memcpy(destination, source->data + source->position, run);
+        source->position   += run;
+        destination        += run;
+        count              -= run;
+    }
+
+    return true;
+}
+
+static inline bool SerialSource_takeByte(SerialSource* source, byte* value) {
+    if(!SerialSource_fill(source, 1)) return false;
+
+    *value = source->data[source->position++];
+    return true;
+}
+
+static inline bool SerialSource_takeId(SerialSource* source, uint32_t* value, byte width) {
+    if(!SerialSource_fill(source, width)) return false;
+
+    source->position = Serial_readId(source->data, source->position, value, width);
+    return true;
+}
+
+static inline bool SerialSource_takeOffset(SerialSource* source, uint64_t* value) {
+    uint32_t high, low;
+
+    if(!SerialSource_takeId(source, &high, 4) || !SerialSource_takeId(source, &low, 4)) return false;
+
+    *value = (uint64_t) high << 32 | low;
+    return true;
+}
+
+/*
+ * How far in to the source the next byte to decode is
+ */
+static inline size SerialSource_tell(const SerialSource* source) {
+    return source->consumed + source->position;
+}
+
+/*
+ * Pass over every byte up to `offset` bytes in to the source, which must not be behind SerialSource_tell. Returns false
+ * if the source ends, or fails, first.
+ */
+static bool SerialSource_skipTo(SerialSource* source, uint64_t offset) {
+    uint64_t count = offset - SerialSource_tell(source);
+
+    while(count > 0) {
+        if(!SerialSource_fill(source, 1)) return false;
+
+        size run = source->length - source->position;
+        if(run > count) run = (size) count;
+
+        source->position   += run;
+        count              -= run;
+    }
+
+    return true;
+}
+
+static bool SerialSource_takeVarint(SerialSource* source, size* value) {
+    // A varint is at most 10 bytes long, and must end within the bytes that are left
+    SerialSource_fill(source, 10);
+
+    size ready  = source->length - source->position;
+    size length = 0;
+
+    while(length < ready && length < 10 && (source->data[source->position + length] & 0x80)) ++length;
+
+    // Ten bytes that all go on are not a varint, however many more there are, and a tenth byte holds only bit 63
+    if(length == 10 || (length == 9 && length < ready && source->data[source->position + length] > 0x01)) {
+        source->malformed = true;
+        return false;
+    }
+
+    if(length == ready) return false;
+
+    source->position = Serial_readVarint(source->data, source->position, value);
+    return true;
+}
+
 // Begin IO Utilities --------------------------------------------------------------------------------------------------
 
 const byte GRADEBOOK_MAGIC[4] = {0x01, 0xD5, 0xC0, 0x01};
 
+const byte GRADEBOOK_WIDE_MAGIC[4] = {0x01, 0xD5, 0xC0, 0x04};
+
+const byte GRADEBOOK_VERSIONED_MAGIC[4] = {0x01, 0xD5, 0xC0, 0x56};
+
+/*
+ * Width of the ID's written by this build: one byte, or four when built with _GB_WIDE_IDS
+ */
+static const byte SERIAL_ID_WIDTH = sizeof(identifier);
+
 
 /*
  * A bit on formats.
@@ -49,33 +515,240 @@ const byte GRADEBOOK_MAGIC[4] = {0x01, 0xD5, 0xC0, 0x01};
  * '_' simply serves to space out bytes
  * '(...)' denotes that the enclosed data is conditionally present
  * 'B' is the space of one byte
+ * 'I' is the space of one ID, or one count of ID's: one byte in files beginning with GRADEBOOK_MAGIC, and four bytes
+ *     (most significant first) in files beginning with GRADEBOOK_WIDE_MAGIC. Sectioned files give the width in their
+ *     header.
+ * 'O' is the space of one offset or length, eight bytes, most significant first
  * '[...]' is the placeholder for a large amount of arbitrary data
  *
- * Overall file format:
+ * The examples below are written with one-byte ID's.
+ * A build with _GB_WIDE_IDS writes the wide form, and either build reads both forms. Reading a wide file in to a
+ * one-byte build fails with ILLEGAL_COURSE_ID/ILLEGAL_STUDENT_ID if any ID does not fit.
+ *
+ * Overall file format, version 1:
  * 0x00 MAGIC;
  * 0x04 GradeBook;
  * 0x?? n Course's;
  * 0x?? n Student's;
  *
  * Where the number of courses and students is provided by the GradeBook.
+ *
+ * A version 1 file can only be read from front to back. The sectioned format (version 2 on) puts a table of contents
+ * after the magic, so that a reader may go straight to a section, and an index of record offsets in front of the
+ * records, so that it may go straight to one record:
+ *
+ * 0x00 VERSIONED MAGIC;
+ * 0x04 B|B|B|B
+ *      - - - -
+ *      | | | |- flags (see GradeBookFlags)
+ *      | | |- number of sections
+ *      | |- width of an ID, 1 or 4
+ *      |- format version
+ * 0x08 number of sections * [kind: 4|offset: O|length: O], offsets being from the start of the file;
+ * 0x?? sections.
+ *
+ * Sections are written in the order of their kinds:
+ * - COURSE_INDEX, and STUDENT_INDEX: [ID: I|offset: O] for every course, or student, in ID order, each offset being
+ *   that of its record from the start of COURSES, or STUDENTS. Each record lists the ID's of the other kind of
+ *   record that it is enrolled with, and these are checked against the indexes.
+ * - COURSES, and STUDENTS: the records, in ID order, as they are in version 1 (see Course_encode and Student_encode)
+ * - POLICIES: [course ID: I|length: 2|policy] for every course with a grading policy, the policy being written as
+ *   GradingPlan_format writes it, without a terminator
+ *
+ * In a file with the GRADEBOOK_COMPACT flag, records are written as in version 1 but for their ID lists, and their runs
+ * of grades (see Course_encode and Student_encode).
+ *
+ * The records of a section are as long as the table of contents says, or the file is corrupt. A reader must take
+ * sections in the order above, as every index comes before the records it lists, but skips any of a kind it does not
+ * know, and a writer may leave out those it has nothing to write in.
+ */
+
+
+/*
+ * A GradeBook is written straight from its records, and read straight in to them, record by record. Reading needs a
+ * little state besides the GradeBook, which is kept by a GradeBookDecoder.
+ */
+
+/*
+ * Where the roster of one course ends in GradeBookDecoder.rosters
  */
+typedef struct S_DecodedRoster {
+
+    uint32_t courseId;
+
+    size end;
+
+} DecodedRoster;
+
+typedef struct S_GradeBookDecoder {
+
+    SerialSource* source;
+
+    GradeBook* book;
+
+    /*
+     * Width of the ID's of the GradeBook being read
+     */
+    byte width;
+
+    /*
+     * GradeBookFlags of the GradeBook being read, which are none for version 1
+     */
+    byte flags;
+
+    /*
+     * Course and student ID's listed by the GradeBook index, sorted once all are read
+     */
+    uint32_t* courseIds;
+
+    size coursesCount;
+
+    uint32_t* studentIds;
+
+    size studentsCount;
+
+    /*
+     * The roster of each course, end to end, in the order the courses were read. Courses come before any student does,
+     * so rosters are kept until every student has been added.
+     */
+    uint32_t* rosters;
+
+    size rostersCount;
+
+    DecodedRoster* rosterEnds;
 
+    size rosterEndsCount;
+
+    /*
+     * The course ID's and grades of the student being read, which come before its ID
+     */
+    uint32_t* transcript;
+
+    size* gradeCounts;
+
+    grade* grades;
+
+    // Capacity of each list, in elements
+    size courseIdsCapacity, studentIdsCapacity, rostersCapacity, rosterEndsCapacity;
+    size transcriptCapacity, gradeCountsCapacity, gradesCapacity;
+
+} GradeBookDecoder;
 
 /*
- * Intermediary models
+ * Grow `*array`, of `*capacity` elements `width` bytes wide, to hold at least `needed`. Returns false if memory could
+ * not be allocated, which the decoder reports rather than aborting on, as the sizes are read from the data.
  */
+static bool GradeBookDecoder_reserve(void* array, size* capacity, size needed, size width) {
+    if(needed <= *capacity) return true;
+
+    size grown = *capacity ? *capacity : 16;
+    while(grown < needed) grown *= 2;
+
+    void* moved = realloc(*(void**) array, grown * width);
+    if(!moved) return false;
+
+    *(void**) array = moved;
+    *capacity       = grown;
+
+    return true;
+}
+
+/*
+ * Status of a decoder whose source ran out part way through a record, or gave a value that is not well formed
+ */
+static SerializationStatus GradeBookDecoder_ended(GradeBookDecoder* decoder) {
+    if(decoder->source->failed) {
+        printf("The GradeBook could not be read\n");
+        return FAILURE;
+    }
+
+    if(decoder->source->malformed) {
+        printf("The GradeBook holds a value that is not well formed\n");
+        return FAILURE;
+    }
+
+    printf("The GradeBook ends part way through a record\n");
+    return SHORT_BUFFER;
+}
+
+/*
+ * Read the length of an ID list (see SerialSink_putCount)
+ */
+static bool GradeBookDecoder_takeCount(GradeBookDecoder* decoder, uint32_t* count) {
+    size value = 0;
+
+    if(!(decoder->flags & GRADEBOOK_COMPACT)) return SerialSource_takeId(decoder->source, count, decoder->width);
+    if(!SerialSource_takeVarint(decoder->source, &value)) return false;
+
+    // A length past any ID list is cut short, and then runs out of ID's to read
+    *count = value > UINT32_MAX ? UINT32_MAX : (uint32_t) value;
+    return true;
+}
+
+/*
+ * Read the next ID of a list (see SerialSink_putListId). A difference that runs past the widest ID wraps around, to an
+ * ID that is checked like any other.
+ */
+static bool GradeBookDecoder_takeListId(GradeBookDecoder* decoder, uint32_t* previous, uint32_t* id) {
+    size difference = 0;
+
+    if(!(decoder->flags & GRADEBOOK_COMPACT)) return SerialSource_takeId(decoder->source, id, decoder->width);
+    if(!SerialSource_takeVarint(decoder->source, &difference)) return false;
+
+    *id = *previous = *previous + (uint32_t) difference;
+    return true;
+}
+
+/*
+ * Read `count` grades packed 7 bits apiece, which must take no more bytes than the window holds. Whole groups are
+ * unpacked where they lie in the window, by the fastest kernel the CPU supports.
+ */
+static bool GradeBookDecoder_takePacked(GradeBookDecoder* decoder, grade* grades, size count) {
+    SerialSource* source    = decoder->source;
+    size groups             = count / 8;
+    size nBytes             = Serial_sizeOfPacked(count);
+    uint64_t bits           = 0;
+
+    if(!SerialSource_fill(source, nBytes)) return false;
+
+    const byte* packed = source->data + source->position;
+
+    GradeKernels_select()->unpack(packed, grades, groups);
+
+    // The last group is cut short to the bytes its grades need
+    for(size idx = nBytes; idx > groups * 7; --idx) bits = bits << 8 | packed[idx - 1];
+    for(size idx = groups * 8; idx < count; ++idx) grades[idx] = (grade) (bits >> (7 * (idx - groups * 8)) & 0x7F);
+
+    source->position += nBytes;
+    return true;
+}
+
+static SerializationStatus GradeBookDecoder_outOfMemory(const char* what) {
+    printf("Unable to allocate memory for %s when deserializing\n", what);
+    return FAILURE;
+}
+
+static void GradeBookDecoder_free(GradeBookDecoder* decoder) {
+    free(decoder->courseIds);
+    free(decoder->studentIds);
+    free(decoder->rosters);
+    free(decoder->rosterEnds);
+    free(decoder->transcript);
+    free(decoder->gradeCounts);
+    free(decoder->grades);
+}
 
 // ---- GradeBook ------------------------------------------------------------------------------------------------------
 
 /*
- * Serial format of GradeBook (not that it is constructed from IGradeBook):
+ * Serial format of GradeBook, in version 1 files:
  * Also not that the GradeBook will be placed at the beginning of the serialized data following the file magic.
  *
- * B|[course ID's]|B|[student ID's]
+ * I|[course ID's]|I|[student ID's]
  * - ------------- - -------------
- * | |             | |- student ID's, one byte each
+ * | |             | |- student ID's, one ID each
  * | |             |- number of student ID's
- * | |- course ID's, one byte each
+ * | |- course ID's, one ID each
  * |- number of course ID's
  *
  * Example:
@@ -116,99 +789,63 @@ const byte GRADEBOOK_MAGIC[4] = {0x01, 0xD5, 0xC0, 0x01};
  *  A simpler solution is simply do what the compiler does and destroy that course or student and put a new one in its place.
  */
 
-typedef struct S_IGradeBook {
-
-    /*
-     * Courses by Course ID
-     */
-    byte courses[25];
-
-    byte coursesCount;
-
-    /*
-     * Students by Student ID
-     */
-    byte students[100];
-
-    byte studentsCount;
-
-} IGradeBook;
-
 /*
- * Serialize book in to receiver, starting at offset, and return the next NULL pointer index
+ * Read a version 1 GradeBook's ID lists in to the decoder, and sort them. Sectioned files hold them in their index
+ * sections instead (see GradeBook_decodeIds).
  */
-size IGradeBook_serialize(IGradeBook* book, byte* receiver, size offset) {
+static SerializationStatus GradeBook_decodeIndex(GradeBookDecoder* decoder) {
 
-    size idx            = offset;
-    byte nCourses       = book->coursesCount;
-    byte nStudents      = book->studentsCount;
+    SerialSource* source    = decoder->source;
+    uint32_t nCourses       = 0;
+    uint32_t nStudents      = 0;
 
-    // Segment 1 - nCourses, followed by nCourses of byte courseId
-    receiver[idx++]     = nCourses;
+    // Segment 1 - Get course count, then read course ID's
+    if(!SerialSource_takeId(source, &nCourses, decoder->width)) return GradeBookDecoder_ended(decoder);
 
-    // -- Proceed to write so many course ID's
-    for(byte courseIdx = 0; courseIdx < nCourses; ++courseIdx) {
-        receiver[idx++]  = book->courses[courseIdx];
-    }
-
-    // Segment 2 - nStudents, following by nStudents of byte studentId
-    receiver[idx++]    = nStudents;
+    for(size courseIdx = 0; courseIdx < nCourses; ++courseIdx) {
+        if(!GradeBookDecoder_reserve(&decoder->courseIds, &decoder->courseIdsCapacity, courseIdx + 1, sizeof(uint32_t))) {
+            return GradeBookDecoder_outOfMemory("course ID's");
+        }
 
-    // -- Proceed to write so many student ID's
-    for(byte studentIdx = 0; studentIdx < nStudents; ++studentIdx) {
-        receiver[idx++]  = book->students[studentIdx];
+        if(!SerialSource_takeId(source, &decoder->courseIds[courseIdx], decoder->width)) {
+            return GradeBookDecoder_ended(decoder);
+        }
     }
 
-    // IDX will sit at the last written byte of data.
-    return idx;
-}
-
-/*
- * Deserialize a GradeBook, and return the position of the next unrelated byte
- */
-size IGradeBook_deserialize(byte* data, size offset, IGradeBook* destination) {
+    // Segment 2 - Get student count, then read student ID's
+    if(!SerialSource_takeId(source, &nStudents, decoder->width)) return GradeBookDecoder_ended(decoder);
 
-    size idx        = offset;
-    byte nCourses   = 0;
-    byte nStudents  = 0;
-
-    // Segment 1 - Get course count
-    nCourses        = data[idx++];
-
-    // -- Read course ID's
-    for(byte courseIdx = 0; courseIdx < nCourses; ++courseIdx) {
-        destination->courses[courseIdx] = data[idx++];
-    }
-
-    // Segment 2 - Get student count
-    nStudents       = data[idx++];
+    for(size studentIdx = 0; studentIdx < nStudents; ++studentIdx) {
+        if(!GradeBookDecoder_reserve(&decoder->studentIds, &decoder->studentIdsCapacity, studentIdx + 1, sizeof(uint32_t))) {
+            return GradeBookDecoder_outOfMemory("student ID's");
+        }
 
-    // -- Read student ID's
-    for(byte studentIdx = 0; studentIdx < nStudents; ++studentIdx) {
-        destination->students[studentIdx] = data[idx++];
+        if(!SerialSource_takeId(source, &decoder->studentIds[studentIdx], decoder->width)) {
+            return GradeBookDecoder_ended(decoder);
+        }
     }
 
-    // Sort course and student ID's
-    qsort(destination->courses, nCourses, sizeof(byte), &compare_byte);
-    qsort(destination->students, nStudents, sizeof(byte), &compare_byte);
+    // Sort course and student ID's, so that records can be checked against them
+    qsort(decoder->courseIds, nCourses, sizeof(uint32_t), &compare_serialId);
+    qsort(decoder->studentIds, nStudents, sizeof(uint32_t), &compare_serialId);
 
-    destination->coursesCount = nCourses;
-    destination->studentsCount = nStudents;
+    decoder->coursesCount   = nCourses;
+    decoder->studentsCount  = nStudents;
 
-    return idx;
+    return SUCCESS;
 }
 
 // ---- Course ---------------------------------------------------------------------------------------------------------
 
 /*
- * Serial format of Course (note that it is constructed from ICourse):
+ * Serial format of Course:
  *
- * B|[student ID's]|B|B|[name]
+ * I|[student ID's]|I|B|[name]
  * - -------------  - - ------
  * | |              | | |- Course name, ASCII data.
  * | |              | |- Course name length in bytes
  * | |              |- Course ID
- * | |- student ID's, one byte per
+ * | |- student ID's, one ID per
  * |- Number of students
  *
  * Example:
@@ -227,381 +864,676 @@ size IGradeBook_deserialize(byte* data, size offset, IGradeBook* destination) {
  *  |       | |- 0xA5 is name length, followed by 0xA5 bytes of ASCII encoded characters
  *  |       |- 0xAA is Course ID
  *  |- 0x03 Students
+ *
+ * A compact GradeBook writes the number of students as a varint, and each student ID as a varint difference from the
+ * one before it, the first from 0. The example above would begin 03010101.
  */
 
-typedef struct S_ICourse {
+/*
+ * Encode a course, whose roster must only name students in the GradeBook
+ */
+static void Course_encode(GradeBook* book, Course* course, SerialSink* sink, byte width, byte flags) {
 
-    /*
-     * Students by student ID
-     */
-    byte students[20];
+    size nStudents      = Course_studentsCount(course);
+    byte nameSize       = (byte) strlen(course->courseName);
+    uint32_t previous   = 0;
 
-    byte studentsCount;
+    // Segment 1 - number of students followed by as many student ID's, in studentId order
+    SerialSink_putCount(sink, nStudents, width, flags);
 
-    /**
-    * Describes the course ID
-    * Once again, a range of [0, 255] which exceeds the 25 course limit by far.
-    */
-    byte courseId;
+    for(size studentIdx = 0; studentIdx < nStudents; ++studentIdx) {
+        StudentEnrollment* enrollment = Course_enrollmentAt(book, course, studentIdx);
+        SerialSink_putListId(sink, GradeBook_resolveStudent(book, enrollment->student)->studentId, &previous, width,
+                             flags);
+    }
+
+    // Segment 2 - Course ID
+    SerialSink_putId(sink, course->courseId, width);
 
-    /**
-    * Describes the course name
-    * The course name should not reasonably exceed 16 characters, if it should be in the format of a college course
-    * name, such as 'CSCE 1040' (8 Characters).
-    */
-    char courseName[255];
+    // Segment 3 - actual name length followed as many character values
+    SerialSink_putByte(sink, nameSize);
+    SerialSink_put(sink, (const byte*) course->courseName, nameSize);
+}
+
+/*
+ * For a description of the sizing algorithm for Course, see Course_encode
+ */
+static size Course_encodedSize(GradeBook* book, Course* course, byte flags) {
+
+    size nStudents  = Course_studentsCount(course);
+    size sName      = strlen(course->courseName);
+    size sIds       = Serial_sizeOfVarint(nStudents);
+    uint32_t previous = 0;
+
+    if(!(flags & GRADEBOOK_COMPACT)) return SERIAL_ID_WIDTH * (1 + nStudents) + (1 + sName) + SERIAL_ID_WIDTH;
+
+    for(size studentIdx = 0; studentIdx < nStudents; ++studentIdx) {
+        uint32_t studentId = GradeBook_resolveStudent(book, Course_enrollmentAt(book, course, studentIdx)->student)->studentId;
+
+        sIds    += Serial_sizeOfVarint(studentId - previous);
+        previous = studentId;
+    }
+
+    return sIds + (1 + sName) + SERIAL_ID_WIDTH;
+}
+
+/*
+ * Read a course, and add it to the GradeBook. Its roster is kept by the decoder until every student has been added.
+ */
+static SerializationStatus Course_decode(GradeBookDecoder* decoder) {
+
+    SerialSource* source    = decoder->source;
+    uint32_t nStudents      = 0;
+    uint32_t courseId       = 0;
+    uint32_t previous       = 0;
+    byte nameSize           = 0;
+    char courseName[256];
+
+    // Segment 1 - Read number of students, and read as many student ID's
+    if(!GradeBookDecoder_takeCount(decoder, &nStudents)) return GradeBookDecoder_ended(decoder);
+
+    for(size studentIdx = 0; studentIdx < nStudents; ++studentIdx) {
+        if(!GradeBookDecoder_reserve(&decoder->rosters, &decoder->rostersCapacity, decoder->rostersCount + 1,
+                                     sizeof(uint32_t))) {
+            return GradeBookDecoder_outOfMemory("rosters");
+        }
+
+        if(!GradeBookDecoder_takeListId(decoder, &previous, &decoder->rosters[decoder->rostersCount++])) {
+            return GradeBookDecoder_ended(decoder);
+        }
+    }
+
+    // Segment 2 - Read course ID
+    // Segment 3 - Read length of course name, followed by as many ASCII characters
+    if(!SerialSource_takeId(source, &courseId, decoder->width)
+       || !SerialSource_takeByte(source, &nameSize)
+       || !SerialSource_take(source, (byte*) courseName, nameSize)) {
+        return GradeBookDecoder_ended(decoder);
+    }
+
+    courseName[nameSize] = 0x00;
+
+    if(!bsearch(&courseId, decoder->courseIds, decoder->coursesCount, sizeof(uint32_t), &compare_serialId)) {
+        printf("Course has unreferenced id %u when deserializing\n", courseId);
+        return ILLEGAL_COURSE_ID;
+    }
+
+    if(!Course_isValidId(courseId)) {
+        printf("Course has id %u, which is too wide for this build\n", courseId);
+        return ILLEGAL_COURSE_ID;
+    }
+
+    // The name is interned by the GradeBook, so it may be borrowed
+    size nCourses = decoder->book->coursesCount;
+
+    if(GradeBook_addCourse(decoder->book, (Course){ .courseId = (identifier) courseId, .courseName = courseName }) == nCourses) {
+        printf("Course has duplicate id %u when deserializing\n", courseId);
+        return ILLEGAL_COURSE_ID;
+    }
+
+    if(!GradeBookDecoder_reserve(&decoder->rosterEnds, &decoder->rosterEndsCapacity, decoder->rosterEndsCount + 1,
+                                 sizeof(DecodedRoster))) {
+        return GradeBookDecoder_outOfMemory("rosters");
+    }
+
+    decoder->rosterEnds[decoder->rosterEndsCount++] = (DecodedRoster){ .courseId = courseId, .end = decoder->rostersCount };
+
+    return SUCCESS;
+}
+
+// ---- Student --------------------------------------------------------------------------------------------------------
+
+/*
+ * Serial format of Student:
+ *
+ * I|[course ID's]|[course grades: V|[grades]]|I|B|[name]
+ * - -------------                 - -------   - -  ----
+ * | |                             | |         | |  |- sequence of bytes representing characters in name
+ * | |                             | |         | |- length of name
+ * | |                             | |         |- student ID
+ * | |                             | |- sequence of bytes representing grades
+ * | |                             |- number of grades in that specific course, as a varint
+ * | |- sequence of bytes representing course ID's
+ * |- Number of courses
+ *
+ * The number of grades is a varint (see Serial_readVarint) of 7 bits per byte, least significant first, the top bit of
+ * each byte set where another follows. Version 1 files give it as a single byte, so a record only reads the same in
+ * both where every course has fewer than 128 grades; a count of 128 or more takes two bytes or more.
+ *
+ * Example:
+ *
+ * Student ID 0xA5 (#165)
+ * Student Name: Test Student (54 65 73 74 20 53 74 75 64 65 6E 74)
+ * Name length: 0x0C (12)
+ *
+ * 4 Courses:
+ * - Course #0
+ * - Course #1
+ * - Course #2
+ * - Course #3
+ *
+ * Course #0 has 0 grades
+ * Course #1 has 3 grades
+ * - 95 (0x5F)
+ * - 80 (0x50)
+ * - 60 (0x3C)
+ * Course #2 has 2 grades
+ * - 90  (0x5A)
+ * - 100 (0x64)
+ * Course #3 has 1 grade
+ * - 100 (0x64)
+ *
+ *           |- 0x00 has 0x00 Grades
+ *           --
+ * 040001020300035F503C025A640164A50C646573742053747564656E74
+ *  ---------  -------- ----- --- - -------------------------
+ *  |          |        |     |   | | |- Sequence 0x0C bytes long containing ASCII data
+ *  |          |        |     |   | |- 0x0C is name length
+ *  |          |        |     |   |- 0xA5 is studentId
+ *  |          |        |     |- 0x03 has 0x01 grades, 0x64
+ *  |          |        |- 0x02 has 0x02 grades, 0x5A, 0x64
+ *  |          |- 0x01 has 0x03 grades, 0x5F, 0x50, 0x3C
+ *  |- 4 Courses, 0x00, 0x01, 0x02, 0x03
+ *
+ * Line split in to fields delimited by `;'
+ * 04 00 01 02 03; 00; 03 5F 50 3C; 02 5A 64; 01 64; A5; 0C 54 65 73 74 20 53 74 75 64 65 6E 74
+ *
+ * A compact GradeBook writes the number of courses as a varint, and each course ID as a varint difference from the one
+ * before it, the first from 0. Each run of grades is written behind a varint of twice its number of grades, plus one
+ * where the run is written a byte per grade, as above, which it is if any grade may be 0x80 or above. Any other run is
+ * packed 7 bits apiece (see GradeKernels.unpack), the last group cut short to the bytes its grades need:
+ *
+ * V|[grades]
+ * - --------
+ * | |- count bytes, or (count * 7 + 7) / 8 bytes of packed grades
+ * |- count << 1 | 1 for a run of bytes, or count << 1 for a packed run
+ *
+ * The example above would be:
+ *
+ * 04 00 01 01 01; 00; 06 5F 28 0F; 04 5A 32; 02 64; A5; 0C 54 65 73 74 20 53 74 75 64 65 6E 74
+ */
+
+/*
+ * Whether every grade of an enrollment is below 0x80, and may be packed. The largest grade kept by its summary may be
+ * stale, but is never less than the real one.
+ */
+static inline bool Enrollment_isPackable(const StudentEnrollment* enrollment) {
+    return enrollment->summary.largest < 0x80;
+}
+
+static void Student_encodeRun(void* sink, const grade* run, size count) {
+    SerialSink_put(sink, run, count);
+}
+
+/*
+ * Encode a student, whose transcript must only name courses in the GradeBook. Grades are copied from the grade log
+ * to the sink a chunk at a time.
+ */
+static void Student_encode(GradeBook* book, Student* student, SerialSink* sink, byte width, byte flags) {
+
+    size nCourses       = Student_coursesCount(student);
+    byte nameSize       = (byte) strlen(student->studentName);
+    uint32_t previous   = 0;
+
+    // Segment 1 - nCourses followed by as many Course ID's, in courseId order
+    SerialSink_putCount(sink, nCourses, width, flags);
+
+    for(size courseIdx = 0; courseIdx < nCourses; ++courseIdx) {
+        StudentEnrollment* enrollment = Student_enrollmentAt(book, student, courseIdx);
+        SerialSink_putListId(sink, GradeBook_resolveCourse(book, enrollment->course)->courseId, &previous, width,
+                             flags);
+    }
+
+    // Segment 2 - for nCourses, write the number of grades as a varint, followed by one byte for each grade
+    for(size courseIdx = 0; courseIdx < nCourses; ++courseIdx) {
+        StudentEnrollment* enrollment = Student_enrollmentAt(book, student, courseIdx);
+        size nGrades = enrollment->grades.count;
+
+        d_printf("[Student>>FD] gradeCount[%02lu] = %lu \n", courseIdx, nGrades);
+
+        if(!(flags & GRADEBOOK_COMPACT)) {
+            SerialSink_putVarint(sink, nGrades);
+            GradeLog_eachRun(&book->gradeChunks, &enrollment->grades, &Student_encodeRun, sink);
+        } else if(Enrollment_isPackable(enrollment)) {
+            GradePacker packer = { .sink = sink };
+
+            SerialSink_putVarint(sink, nGrades << 1);
+            GradeLog_eachRun(&book->gradeChunks, &enrollment->grades, &GradePacker_run, &packer);
+            GradePacker_finish(&packer);
+        } else {
+            SerialSink_putVarint(sink, nGrades << 1 | 1);
+            GradeLog_eachRun(&book->gradeChunks, &enrollment->grades, &Student_encodeRun, sink);
+        }
+    }
+
+    // Segment 3 - Student ID
+    SerialSink_putId(sink, student->studentId, width);
+
+    // Segment 4 - Length of name, followed by ASCII name
+    SerialSink_putByte(sink, nameSize);
+    SerialSink_put(sink, (const byte*) student->studentName, nameSize);
+}
+
+/*
+ * For a description of the sizing algorithm for Student, see Student_encode
+ */
+static size Student_encodedSize(GradeBook* book, Student* student, byte flags) {
+
+    size nCourses       = Student_coursesCount(student);
+    size sName          = strlen(student->studentName);
+    size sIds           = SERIAL_ID_WIDTH * (1 + nCourses);
+    size sGrades        = 0;
+    uint32_t previous   = 0;
+
+    if(flags & GRADEBOOK_COMPACT) sIds = Serial_sizeOfVarint(nCourses);
+
+    // Each course contributes its grades, one byte apiece or packed, behind a varint count of them
+    for(size idx = 0; idx < nCourses; ++idx){
+        StudentEnrollment* enrollment   = Student_enrollmentAt(book, student, idx);
+        size nGrades                    = enrollment->grades.count;
+
+        if(!(flags & GRADEBOOK_COMPACT)) {
+            sGrades += Serial_sizeOfVarint(nGrades) + nGrades;
+            continue;
+        }
+
+        uint32_t courseId = GradeBook_resolveCourse(book, enrollment->course)->courseId;
+
+        sIds    += Serial_sizeOfVarint(courseId - previous);
+        previous = courseId;
+
+        sGrades += Enrollment_isPackable(enrollment) ? Serial_sizeOfVarint(nGrades << 1) + Serial_sizeOfPacked(nGrades)
+                                                     : Serial_sizeOfVarint(nGrades << 1 | 1) + nGrades;
+    }
+
+    return sIds + (1 + sName) + sGrades + SERIAL_ID_WIDTH;
+}
+
+/*
+ * Read a student, add it to the GradeBook, and enroll it, with its grades, in each course it lists
+ */
+static SerializationStatus Student_decode(GradeBookDecoder* decoder) {
+
+    SerialSource* source    = decoder->source;
+    GradeBook* book         = decoder->book;
+    uint32_t nCourses       = 0;
+    uint32_t studentId      = 0;
+    uint32_t previous       = 0;
+    size nGradesTotal       = 0;
+    byte nameSize           = 0;
+    char studentName[256];
+
+    // Segment 1 - Read course count, followed by as many course ID's
+    if(!GradeBookDecoder_takeCount(decoder, &nCourses)) return GradeBookDecoder_ended(decoder);
+
+    for(size courseIdx = 0; courseIdx < nCourses; ++courseIdx) {
+        if(!GradeBookDecoder_reserve(&decoder->transcript, &decoder->transcriptCapacity, courseIdx + 1, sizeof(uint32_t))
+           || !GradeBookDecoder_reserve(&decoder->gradeCounts, &decoder->gradeCountsCapacity, courseIdx + 1, sizeof(size))) {
+            return GradeBookDecoder_outOfMemory("a transcript");
+        }
+
+        if(!GradeBookDecoder_takeListId(decoder, &previous, &decoder->transcript[courseIdx])) {
+            return GradeBookDecoder_ended(decoder);
+        }
+    }
+
+    // Segment 2 - Read grades for each course, end to end. A count is only trusted as far as grades are read.
+    for(size courseIdx = 0; courseIdx < nCourses; ++courseIdx) {
+        size nGrades = 0;
+        bool packed  = false;
+
+        if(!SerialSource_takeVarint(source, &nGrades)) return GradeBookDecoder_ended(decoder);
+
+        if(decoder->flags & GRADEBOOK_COMPACT) {
+            packed    = !(nGrades & 1);
+            nGrades >>= 1;
+        }
+
+        d_printf("[FD>>Student] gradeCount[%02lu] = %lu \n", courseIdx, nGrades);
+        decoder->gradeCounts[courseIdx] = nGrades;
+
+        // Runs of a whole window of grades are whole groups of packed grades, as the window is a multiple of 8
+        for(size remaining = nGrades; remaining > 0; ) {
+            size run = remaining < SerialSource_WINDOW_BYTES ? remaining : SerialSource_WINDOW_BYTES;
+
+            if(!GradeBookDecoder_reserve(&decoder->grades, &decoder->gradesCapacity, nGradesTotal + run, sizeof(grade))) {
+                return GradeBookDecoder_outOfMemory("grades");
+            }
+
+            if(packed ? !GradeBookDecoder_takePacked(decoder, &decoder->grades[nGradesTotal], run)
+                      : !SerialSource_take(source, &decoder->grades[nGradesTotal], run)) {
+                return GradeBookDecoder_ended(decoder);
+            }
+
+            nGradesTotal   += run;
+            remaining      -= run;
+        }
+    }
+
+    // Segment 3 - Read student ID
+    // Segment 4 - Get length of student's name and read as many characters
+    if(!SerialSource_takeId(source, &studentId, decoder->width)
+       || !SerialSource_takeByte(source, &nameSize)
+       || !SerialSource_take(source, (byte*) studentName, nameSize)) {
+        return GradeBookDecoder_ended(decoder);
+    }
+
+    studentName[nameSize] = 0x00;
+
+    if(!bsearch(&studentId, decoder->studentIds, decoder->studentsCount, sizeof(uint32_t), &compare_serialId)) {
+        printf("Student has unreferenced id %u when deserializing\n", studentId);
+        return ILLEGAL_STUDENT_ID;
+    }
+
+    if(!Student_isValidId(studentId)) {
+        printf("Student has id %u, which is too wide for this build\n", studentId);
+        return ILLEGAL_STUDENT_ID;
+    }
+
+    size nStudents = book->studentsCount;
+
+    if(GradeBook_addStudent(book, (Student){ .studentId = (identifier) studentId, .studentName = studentName }) == nStudents) {
+        printf("Student has duplicate id %u when deserializing\n", studentId);
+        return ILLEGAL_STUDENT_ID;
+    }
+
+    // Every course has been added by now, so each one listed can be enrolled in straight away
+    Student* student    = GradeBook_findStudent(book, (identifier) studentId);
+    const grade* grades = decoder->grades;
+
+    for(size courseIdx = 0; courseIdx < nCourses; ++courseIdx) {
+        Course* course = Course_isValidId(decoder->transcript[courseIdx])
+                ? GradeBook_findCourse(book, (identifier) decoder->transcript[courseIdx])
+                : NULL;
+
+        if(!course) {
+            char* studentString = Student_toString(student);
+
+            printf("Student %s references an illegal course ID: %u at index %lu \n",
+                    studentString, decoder->transcript[courseIdx], courseIdx);
+
+            free(studentString);
+            return ILLEGAL_COURSE_ID;
+        }
+
+        Course_addStudent(book, course, student);
+
+        // A course listed twice keeps the grades listed last
+        StudentEnrollment* enrollment = GradeBook_findEnrollment(book, student, course);
+        GradeBook_clearGrades(book, enrollment);
+
+        for(size gradeIdx = 0; gradeIdx < decoder->gradeCounts[courseIdx]; ++gradeIdx) {
+            GradeBook_addGrade(book, enrollment, grades[gradeIdx]);
+        }
+
+        grades += decoder->gradeCounts[courseIdx];
+    }
+
+    return SUCCESS;
+}
 
-} ICourse;
+// ---- Sections -------------------------------------------------------------------------------------------------------
 
 /*
- * GNU C Comparator for ICourse that compares by courseId
+ * Room for the longest policy written to POLICIES, terminator included. A plan has few categories, with short names,
+ * so every plan fits.
  */
-int ICourse_compareByID(const void* a, const void* b) {
-    if( !a | !b /* NULL Pointer check */) {
-        return (!a && !b) ? 0 : -1 /* Always send NULL to the end */ ;
-    } else {
-        return ((ICourse *) a)->courseId - ((ICourse *) b)->courseId;
-    }
-}
+#define SERIAL_POLICY_LENGTH 1024
 
 /*
- * Initializes an ICourse (primitive course serialization intermediate model) from a course
- * courseId and courseName will be copied to their respective fields in the ICourse, but
- * course->studentIds will be converted from pointers to student ID numbers and stored as such
+ * Kinds of section, in the order they are written and read
  */
-ICourse ICourse_fromCourse(Course* course) {
+static const GradeBookSectionKind SECTION_ORDER[] = {
+    SECTION_COURSE_INDEX, SECTION_STUDENT_INDEX, SECTION_COURSES, SECTION_STUDENTS, SECTION_POLICIES
+};
 
-    ICourse iCourse = {
-            .courseId       = course->courseId,
-            .studentsCount  = (byte) Course_studentsCount(course)
-    };
+#define SECTIONS_WRITTEN NMEMBERS(SECTION_ORDER, GradeBookSectionKind)
 
-    strncpy(iCourse.courseName, course->courseName, strlen(course->courseName));
-
-    for(byte idx = 0; idx < iCourse.studentsCount; ++idx){
-        iCourse.students[idx] = course->students[idx]->studentId;
-    }
-
-    return iCourse;
-}
+/*
+ * Size of the magic, header, and table of contents of a sectioned file
+ */
+#define SECTIONED_HEADER_BYTES (8 + SECTIONS_WRITTEN * (4 + 8 + 8))
 
 /*
- * Create a Course object from a primitive. Does not add students.
+ * Size of one entry of an index section
  */
-Course ICourse_toCourse(ICourse* iCourse) {
+#define SERIAL_INDEX_ENTRY_BYTES(width) ((width) + 8)
 
-    Course course = {
-            .courseId = iCourse->courseId
-    };
+/*
+ * Write the grading policy of `course` to `policy`, and return its length, or 0 if it is graded by plain average
+ */
+static size Course_formatPolicy(GradeBook* book, Course* course, char policy[SERIAL_POLICY_LENGTH]) {
+    const GradingPlan* plan = Course_policy(book, course);
 
-    strncpy(course.courseName, iCourse->courseName, strlen(iCourse->courseName));
+    if(!plan || !GradingPlan_format(plan, policy, SERIAL_POLICY_LENGTH)) return 0;
 
-    return course;
+    return strlen(policy);
 }
 
 /*
- * Serialize course in to the receiver, starting at offset, and return the next NULL pointer index
+ * Lay out the sections of a GradeBook end to end, in SECTION_ORDER, behind the header and table of contents
  */
-size ICourse_serialize(ICourse* course, byte* receiver, size offset) {
+static void GradeBook_layout(GradeBook* book, GradeBookContents* contents, byte flags) {
 
-    size idx        = offset;
-    byte nStudents  = (byte) course->studentsCount;
-    byte nameSize   = (byte) strlen(course->courseName);
+    char policy[SERIAL_POLICY_LENGTH];
+    uint64_t offset = SECTIONED_HEADER_BYTES;
 
-    // Segment 1 - number of students followed by as many student ID's
-    receiver[idx++]  = nStudents;
+    memset(contents, 0, sizeof(GradeBookContents));
+    contents->width = SERIAL_ID_WIDTH;
+    contents->flags = flags;
 
-    // -- Write so many student ID's
-    for(byte studentIdx = 0; studentIdx < nStudents; ++studentIdx) {
-        receiver[idx++] = course->students[studentIdx];
-    }
+    contents->lengths[SECTION_COURSE_INDEX]     = book->coursesCount * SERIAL_INDEX_ENTRY_BYTES(SERIAL_ID_WIDTH);
+    contents->lengths[SECTION_STUDENT_INDEX]    = book->studentsCount * SERIAL_INDEX_ENTRY_BYTES(SERIAL_ID_WIDTH);
 
-    // Segment 2 - Course ID
-    receiver[idx++]  = course->courseId;
+    for(size courseIdx = 0; courseIdx < book->coursesCount; ++courseIdx) {
+        Course* course      = GradeBook_courseAt(book, courseIdx);
+        size policyLength   = Course_formatPolicy(book, course, policy);
 
-    // Segment 3 - actual name length followed as many character values
-    receiver[idx++]  = nameSize;
+        contents->lengths[SECTION_COURSES] += Course_encodedSize(book, course, flags);
 
-    // -- Write name
-    for(byte courseIdx = 0; courseIdx < nameSize; ++courseIdx) {
-        // Assuming similar header definition, byte should be be an unsigned char.
-        // ASCII values are always positive, so this should be OK.
-        receiver[idx++] = (byte) course->courseName[courseIdx];
+        if(policyLength > 0) contents->lengths[SECTION_POLICIES] += SERIAL_ID_WIDTH + 2 + policyLength;
     }
 
-    return idx;
-}
-
-size ICourse_deserialize(byte* data, size offset, ICourse* destination) {
-
-    size idx        = offset;
-    byte nStudents  = 0;
-    byte nameSize   = 0;
-
-    // Segment 1 - Read number of students, and read as many student ID's
-    nStudents = data[idx++];
-    destination->studentsCount = nStudents;
-
-    // -- Read student ID's
-    for(byte shiftIdx = 0; shiftIdx < nStudents; ++shiftIdx) {
-        destination->students[shiftIdx] = data[idx++];
+    for(size studentIdx = 0; studentIdx < book->studentsCount; ++studentIdx) {
+        contents->lengths[SECTION_STUDENTS] += Student_encodedSize(book, GradeBook_studentAt(book, studentIdx), flags);
     }
 
-    // Segment 2 - Read course ID
-    destination->courseId = data[idx++];
-
-    // Segment 3 - Read length of course name, followed by as many ASCII characters
-    nameSize = data[idx++];
-
-    // -- Read name
-    for(byte charIdx = 0; charIdx < nameSize; ++charIdx) {
-        destination->courseName[charIdx] = data[idx++];
+    for(size sectionIdx = 0; sectionIdx < SECTIONS_WRITTEN; ++sectionIdx) {
+        contents->offsets[SECTION_ORDER[sectionIdx]] = offset;
+        offset += contents->lengths[SECTION_ORDER[sectionIdx]];
     }
-
-    // Append C ASCII null sentinel to string to prevent reading in to unused memory.
-    destination->courseName[nameSize] = 0x00;
-
-    // Sort Student ID's
-    qsort(destination->students, nStudents, sizeof(byte), &compare_byte);
-
-    return idx;
 }
 
-// ---- Student --------------------------------------------------------------------------------------------------------
-
 /*
- * Serial format of Student (note that it is constructed from IStudent):
- *
- * B|[course ID's]|[course grades: B|[grades]]|B|B|[name]
- * - -------------                 - -------   - -  ----
- * | |                             | |         | |  |- sequence of bytes representing characters in name
- * | |                             | |         | |- length of name
- * | |                             | |         |- student ID
- * | |                             | |- sequence of bytes representing grades
- * | |                             |- number of grades in that specific course
- * | |- sequence of bytes representing course ID's
- * |- Number of courses
- *
- * Example:
- *
- * Student ID 0xA5 (#165)
- * Student Name: Test Student (54 65 73 74 20 53 74 75 64 65 6E 74)
- * Name length: 0x0C (12)
- *
- * 4 Courses:
- * - Course #0
- * - Course #1
- * - Course #2
- * - Course #3
- *
- * Course #0 has 0 grades
- * Course #1 has 3 grades
- * - 95 (0x5F)
- * - 80 (0x50)
- * - 60 (0x3C)
- * Course #2 has 2 grades
- * - 99  (0x5A)
- * - 100 (0x64)
- * Course #4 has 1 grade
- * - 100 (0x64)
- *
- *           |- 0x00 has 0x00 Grades
- *           --
- * 040001020300035F503C025A640164A50C646573742053747564656E74
- *  ---------  -------- ----- --- - -------------------------
- *  |          |        |     |   | | |- Sequence 0x0C bytes long containing ASCII data
- *  |          |        |     |   | |- 0x0C is name length
- *  |          |        |     |   |- 0xA5 is studentId
- *  |          |        |     |- 0x03 has 0x01 grades, 0x64
- *  |          |        |- 0x02 has 0x02 grades, 0x5A, 0x64
- *  |          |- 0x01 has 0x03 grades, 0x5F, 0x50, 0x3C
- *  |- 4 Courses, 0x00, 0x01, 0x02, 0x03
- *
- * Line split in to fields delimited by `;'
- * 04 00 01 02 03; 00; 03 5F 50 3C; 02 5A 64; 01 64; A5; 0C 54 65 73 74 20 53 74 75 64 65 6E 74
+ * Read the header and table of contents that follow the magic of a sectioned GradeBook
  */
+static SerializationStatus GradeBookContents_decode(GradeBookDecoder* decoder, GradeBookContents* contents) {
 
-typedef struct S_IStudent {
-
-    /*
-     * Courses by course ID
-     */
-    byte courses[4];
-
-    byte coursesCount;
-
-    /*
-     * Multidimensional fixed array of unsigned 8-bit integers stores grades in relation to the course.
-     * Where the first index specifies the course number (as it occurs in courses[_]).
-     *
-     * Effectively, this is 40 bytes long
-     */
-    byte grades[4][10];
+    SerialSource* source = decoder->source;
+    byte header[4];
 
-    size gradeCount[4];
+    memset(contents, 0, sizeof(GradeBookContents));
 
-    /**
-    * 2-byte integer describes student ID.
-    * This gives the range of ID's [0, 255], which far exceeds the specifications.
-    *
-    * This will be used to identify the student in the serialization process.
-    */
-    byte studentId;
+    if(!SerialSource_take(source, header, NMEMBERS(header, byte))) return GradeBookDecoder_ended(decoder);
 
-    /**
-    * Allow for up to 64 characters in a student name.
-    * This should be more than enough.
-    */
-    char studentName[255];
+    if(header[0] < 2 || header[0] > GradeBook_FORMAT_VERSION) {
+        printf("The GradeBook is of format version %u, and only versions up to %u can be read\n",
+               header[0], GradeBook_FORMAT_VERSION);
+        return BAD_MAGIC;
+    }
 
-} IStudent;
+    if(header[1] != 1 && header[1] != 4) {
+        printf("The GradeBook has ID's %u bytes wide, which is not a known width\n", header[1]);
+        return BAD_MAGIC;
+    }
 
-/*
- * GNU C Comparator for IStudent by studentId
- */
-int IStudent_compareByID(const void* a, const void* b) {
-    return ((IStudent*)a)->studentId - ((IStudent*)b)->studentId;
-}
+    if(header[3] & ~GRADEBOOK_COMPACT) {
+        printf("The GradeBook has flags %02x, which are not all known\n", header[3]);
+        return BAD_MAGIC;
+    }
 
-/*
- * Initializes an IStudent (primitive student serialization intermediate model) from a student
- * studentId and studentName will be copied, along with the grade array for each non-null pointer
- */
-IStudent IStudent_fromStudent(Student* student) {
+    contents->width = header[1];
+    contents->flags = header[3];
 
-    IStudent iStudent = {
-            .studentId      = student->studentId,
-            .coursesCount   = (byte) Student_coursesCount(student),
-    };
+    for(size sectionIdx = 0; sectionIdx < header[2]; ++sectionIdx) {
+        uint32_t kind = 0;
+        uint64_t offset = 0, length = 0;
 
-    strncpy(iStudent.studentName, student->studentName, strlen(student->studentName));
+        if(!SerialSource_takeId(source, &kind, 4)
+           || !SerialSource_takeOffset(source, &offset)
+           || !SerialSource_takeOffset(source, &length)) {
+            return GradeBookDecoder_ended(decoder);
+        }
 
-    for(byte idx = 0; idx < iStudent.coursesCount; ++idx) {
-        d_printf("[Student->IStudent] (Pre) Course[%02u] { gradeCount = %lu } | Primitive = %lu \n", idx, student->courses[idx].gradeCount, iStudent.gradeCount[idx]);
-        iStudent.courses[idx]       = student->courses[idx].course->courseId;
-        iStudent.gradeCount[idx]    = (byte) student->courses[idx].gradeCount;
-        memcpy(iStudent.grades[idx], student->courses[idx].grades, sizeof(student->courses[idx].grades));
+        // Sections of a kind this build does not know are left out, and so skipped
+        if(kind > 0 && kind < GradeBook_SECTION_KINDS) {
+            contents->offsets[kind] = offset;
+            contents->lengths[kind] = length;
+        }
     }
 
-    return iStudent;
+    return SUCCESS;
 }
 
 /*
- * Initialize a Student from an intermediary student. Does not associate courses(!!).
+ * Read the ID's of an index section, `length` bytes long, in to `ids`, and sort them. The offsets are not needed to
+ * read every record in order, and are passed over.
  */
-Student IStudent_toStudent(IStudent* iStudent) {
+static SerializationStatus GradeBook_decodeIds(GradeBookDecoder* decoder, uint64_t length,
+                                               uint32_t** ids, size* count, size* capacity) {
 
-    size nCourses  = iStudent->coursesCount;
+    SerialSource* source    = decoder->source;
+    size entryBytes         = SERIAL_INDEX_ENTRY_BYTES(decoder->width);
 
-    Student student = {
-            .studentId  = iStudent->studentId,
-    };
+    if(length % entryBytes != 0) {
+        printf("A GradeBook index is %lu bytes long, which is not a whole number of entries\n", (size) length);
+        return FAILURE;
+    }
 
-    // Copy student name
-    strncpy(student.studentName, iStudent->studentName, strlen(iStudent->studentName));
+    size nIds = (size) (length / entryBytes);
 
-    // For each course, copy grades from the primitive model, to the non-primitive model
-    for(byte idx = 0; idx < nCourses; ++idx) {
-        d_printf("[IStudent->Student] (Pre) Course[%02u] { gradeCount = %lu } | Primitive = %lu \n", idx, student.courses[idx].gradeCount, iStudent->gradeCount[idx]);
-        student.courses[idx].gradeCount = iStudent->gradeCount[idx];
-        memcpy(student.courses[idx].grades, iStudent->grades[idx], sizeof(iStudent->grades[idx]));
-    }
+    for(size idIdx = 0; idIdx < nIds; ++idIdx) {
+        uint64_t offset = 0;
 
-    return student;
-}
+        if(!GradeBookDecoder_reserve(ids, capacity, idIdx + 1, sizeof(uint32_t))) {
+            return GradeBookDecoder_outOfMemory("an index");
+        }
 
-size IStudent_serialize(IStudent* student, byte* receiver, size offset) {
+        if(!SerialSource_takeId(source, &(*ids)[idIdx], decoder->width) || !SerialSource_takeOffset(source, &offset)) {
+            return GradeBookDecoder_ended(decoder);
+        }
+    }
 
-    size idx            = offset;
-    byte nCourses       = student->coursesCount;
-    byte nameSize       = (byte) strlen(student->studentName);
+    qsort(*ids, nIds, sizeof(uint32_t), &compare_serialId);
+    *count = nIds;
 
-    // Segment 1 - nCourses followed by as many Course ID's
-    receiver[idx++] = nCourses;
+    return SUCCESS;
+}
 
-    // -- Write Course ID's
-    for(byte courseIdx = 0; courseIdx < nCourses; ++courseIdx) {
-        receiver[idx++] = student->courses[courseIdx];
-    }
+/*
+ * Read the policies of a POLICIES section, which ends `end` bytes in to the source, and set each on its course
+ */
+static SerializationStatus GradeBook_decodePolicies(GradeBookDecoder* decoder, uint64_t end) {
 
-    // Segment 2 - for nCourses, write the number of grades followed by as many bytes representing each grade
-    for(byte courseIdx = 0; courseIdx < nCourses; ++courseIdx) {
+    SerialSource* source = decoder->source;
 
-        // Get the length of the relative course signified by courseIdx (grades[courseIdx] corresponds to courses[courseIdx] grades)
-        byte nGrades = (byte) student->gradeCount[courseIdx];
-        d_printf("[IStudent>>FD] (Pre) gradeCount[%02u] = %u \n", courseIdx, nGrades);
-        receiver[idx++] = nGrades;
+    while(SerialSource_tell(source) < end) {
+        uint32_t courseId   = 0;
+        uint32_t length     = 0;
+        char policy[SERIAL_POLICY_LENGTH];
+        GradingPlan plan;
 
-        // For each grade, write the grade as one byte
-        for(byte gradeIdx = 0; gradeIdx < nGrades; ++gradeIdx){
-            receiver[idx++] = student->grades[courseIdx][gradeIdx];
+        if(!SerialSource_takeId(source, &courseId, decoder->width) || !SerialSource_takeId(source, &length, 2)) {
+            return GradeBookDecoder_ended(decoder);
         }
-    }
-
-    // Segment 3 - Student ID
-    receiver[idx++]   = student->studentId;
 
-    // Segment 4 - Length of name, followed by ASCII name
-    receiver[idx++]   = nameSize;
+        if(length >= SERIAL_POLICY_LENGTH) {
+            printf("The grading policy of course %u is %u characters long, which is longer than any written\n",
+                   courseId, length);
+            return FAILURE;
+        }
 
-    // -- Write name
-    for(byte charIdx = 0; charIdx < nameSize; ++charIdx) {
-        receiver[idx++] = (byte) student->studentName[charIdx];
-    }
+        if(!SerialSource_take(source, (byte*) policy, length)) return GradeBookDecoder_ended(decoder);
 
-    return idx;
-}
+        policy[length] = 0x00;
 
-size IStudent_deserialize(byte* data, size offset, IStudent* destination) {
+        Course* course = Course_isValidId(courseId) ? GradeBook_findCourse(decoder->book, (identifier) courseId) : NULL;
 
-    size idx        = offset;
-    byte nCourses   = 0;
-    byte nameSize   = 0;
+        if(!course) {
+            printf("A grading policy references an illegal course ID: %u\n", courseId);
+            return ILLEGAL_COURSE_ID;
+        }
 
-    // Segment 1 - Read course count, followed by as many course ID's
-    nCourses = data[idx++];
-    destination->coursesCount = nCourses;
+        if(GradingPlan_compile(policy, &plan) != PLAN_COMPILED) {
+            printf("The grading policy of course %u, `%s`, does not compile\n", courseId, policy);
+            return FAILURE;
+        }
 
-    // -- Read course ID's
-    for(byte courseIdx = 0; courseIdx < nCourses; ++courseIdx) {
-        destination->courses[courseIdx]  = data[idx++];
+        Course_setPolicy(decoder->book, course, &plan);
     }
 
-    // Segment 2 - Read grades for each course
-    for(byte courseIdx = 0; courseIdx < nCourses; ++courseIdx) {
+    return SUCCESS;
+}
 
-        // Get the number of grades associated with this course
-        d_printf("[FD>>IStudent] (Pre) gradeCount[%02u] = %u \n", courseIdx, data[idx]);
-        byte nGrades    = data[idx++];
-        destination->gradeCount[courseIdx] = nGrades;
-        d_printf("[FD>>IStudent] (Post) gradeCount[%02u] = %u \n", courseIdx, (byte) destination->gradeCount[courseIdx]);
+/*
+ * Read every section of a sectioned GradeBook, whose magic has been read, in SECTION_ORDER
+ */
+static SerializationStatus GradeBook_decodeSections(GradeBookDecoder* decoder) {
 
-        // Copy each grade, if any, in to the associated index
+    SerialSource* source = decoder->source;
+    GradeBookContents contents;
 
-        for(byte gradeIdx = 0; gradeIdx < nGrades; ++gradeIdx) {
-            destination->grades[courseIdx][gradeIdx] = data[idx++];
-        }
-    }
+    SerializationStatus status = GradeBookContents_decode(decoder, &contents);
 
-    // Segment 3 - Read student ID
-    destination->studentId = data[idx++];
+    decoder->width = contents.width;
+    decoder->flags = contents.flags;
 
-    // Segment 4 - Get length of student's name and read as many characters
-    nameSize = data[idx++];
+    for(size sectionIdx = 0; status == SUCCESS && sectionIdx < SECTIONS_WRITTEN; ++sectionIdx) {
+        GradeBookSectionKind kind   = SECTION_ORDER[sectionIdx];
+        uint64_t offset             = contents.offsets[kind];
+        uint64_t length             = contents.lengths[kind];
 
-    // -- Read characters in name
-    for(byte charIdx = 0; charIdx < nameSize; ++charIdx) {
-        destination->studentName[charIdx] = (char) data[idx++];
-    }
+        if(length == 0) continue;
 
-    // Append C ASCII null sentinel to string to prevent reading in to unused memory.
-    destination->studentName[nameSize] = 0x00;
+        if(offset < SerialSource_tell(source) || offset + length < offset) {
+            printf("Section %u of the GradeBook overlaps the one before it\n", kind);
+            return FAILURE;
+        }
 
-    // Final Touch: Sort courseId's
+        if(!SerialSource_skipTo(source, offset)) return GradeBookDecoder_ended(decoder);
+
+        switch(kind) {
+            case SECTION_COURSE_INDEX:
+                status = GradeBook_decodeIds(decoder, length, &decoder->courseIds, &decoder->coursesCount,
+                                             &decoder->courseIdsCapacity);
+                break;
+            case SECTION_STUDENT_INDEX:
+                status = GradeBook_decodeIds(decoder, length, &decoder->studentIds, &decoder->studentsCount,
+                                             &decoder->studentIdsCapacity);
+                break;
+            case SECTION_COURSES:
+                for(size courseIdx = 0; status == SUCCESS && courseIdx < decoder->coursesCount; ++courseIdx) {
+                    status = Course_decode(decoder);
+                }
+                break;
+            case SECTION_STUDENTS:
+                for(size studentIdx = 0; status == SUCCESS && studentIdx < decoder->studentsCount; ++studentIdx) {
+                    status = Student_decode(decoder);
+                }
+                break;
+            case SECTION_POLICIES:
+                status = GradeBook_decodePolicies(decoder, offset + length);
+                break;
+        }
 
-    qsort(destination->courses, nCourses, sizeof(byte), &compare_byte);
+        if(status == SUCCESS && SerialSource_tell(source) != offset + length) {
+            printf("Section %u of the GradeBook is %lu bytes long, but its records take %lu\n",
+                   kind, (size) length, (size) (SerialSource_tell(source) - offset));
+            status = FAILURE;
+        }
+    }
 
-    return idx;
+    return status;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------
@@ -610,36 +1542,33 @@ size IStudent_deserialize(byte* data, size offset, IStudent* destination) {
 
 // ---------------------------------------------------------------------------------------------------------------------
 
-SerializationStatus GradeBook_serialize(GradeBook* gradeBook, byte* buffer) {
-
-    const size buffSize = sizeOfGradeBook(gradeBook);
-
-    byte tmpBuffer[buffSize];
+/*
+ * Check that every enrollment of the GradeBook names a course and a student that are in it, printing the first that
+ * does not
+ */
+static SerializationStatus GradeBook_checkReferences(GradeBook* gradeBook) {
 
     const size nCourses  = gradeBook->coursesCount;
     const size nStudents = gradeBook->studentsCount;
 
-    // Before beginning serialization, check for references to unknown Courses and Students
-    // -----------------------------------------------------------------------------------------------------------------
-
     /*
-     * Iterate through each course->student in the GradeBook, and insure that a student with a matching student ID is in the
-     * GradeBook.
+     * Iterate through each course->student in the GradeBook, and insure that every student handle still resolves to a
+     * student in the GradeBook.
      */
-    for(byte courseIdx = 0; courseIdx < nCourses; ++courseIdx) {
-        size nCourseStudents = Course_studentsCount(&gradeBook->courses[courseIdx]);
-        Course* course = &gradeBook->courses[courseIdx];
+    for(size courseIdx = 0; courseIdx < nCourses; ++courseIdx) {
+        Course* course = GradeBook_courseAt(gradeBook, courseIdx);
+        size nCourseStudents = Course_studentsCount(course);
+
+        for(size studentIdx = 0; studentIdx < nCourseStudents; ++studentIdx) {
+            StudentEnrollment* enrollment = Course_enrollmentAt(gradeBook, course, studentIdx);
 
-        for(byte studentIdx = 0; studentIdx < nCourseStudents; ++studentIdx) {
-            if(!Array_Contains(gradeBook->students, course->students[studentIdx], nStudents, sizeof(Student), &Student_compareById)) {
-                char* studentName = Student_toString(course->students[studentIdx]);
+            if(!GradeBook_resolveStudent(gradeBook, enrollment->student)) {
                 char* courseName = Course_toString(course);
 
-                printf("%s contains an illegal reference to %s, which does not reside in the open GradeBook\n",
-                        courseName, studentName);
+                printf("%s contains an illegal reference to student slot %u, which does not reside in the open GradeBook\n",
+                        courseName, enrollment->student.slot);
 
                 free(courseName);
-                free(studentName);
 
                 return ILLEGAL_STUDENT_ID;
             }
@@ -647,22 +1576,22 @@ SerializationStatus GradeBook_serialize(GradeBook* gradeBook, byte* buffer) {
     }
 
     /*
-     * Iterate through each student->course in the GradeBook, and insure that a course with a matching course ID is in the
-     * GradeBook.
+     * Iterate through each student->course in the GradeBook, and insure that every course handle still resolves to a
+     * course in the GradeBook.
      */
-    for(byte studentIdx = 0; studentIdx < nStudents; ++studentIdx) {
-        size nStudentCourses = Student_coursesCount(&gradeBook->students[studentIdx]);
-        Student* student = &gradeBook->students[studentIdx];
+    for(size studentIdx = 0; studentIdx < nStudents; ++studentIdx) {
+        Student* student = GradeBook_studentAt(gradeBook, studentIdx);
+        size nStudentCourses = Student_coursesCount(student);
+
+        for(size courseIdx = 0; courseIdx < nStudentCourses; ++courseIdx) {
+            StudentEnrollment* enrollment = Student_enrollmentAt(gradeBook, student, courseIdx);
 
-        for(byte courseIdx = 0; courseIdx < nStudentCourses; ++courseIdx) {
-            if(Array_Contains(gradeBook->courses, student->courses[courseIdx].course, nCourses, sizeof(Course), &Course_compareById) == false) {
+            if(!GradeBook_resolveCourse(gradeBook, enrollment->course)) {
                 char* studentName = Student_toString(student);
-                char* courseName = Course_toString(student->courses[courseIdx].course);
 
-                printf("(%u) %s contains an illegal reference to %s, which does not reside in the open GradeBook\n",
-                        courseIdx, studentName, courseName);
+                printf("(%lu) %s contains an illegal reference to course slot %u, which does not reside in the open GradeBook\n",
+                        courseIdx, studentName, enrollment->course.slot);
 
-                free(courseName);
                 free(studentName);
 
                 return ILLEGAL_COURSE_ID;
@@ -670,288 +1599,409 @@ SerializationStatus GradeBook_serialize(GradeBook* gradeBook, byte* buffer) {
         }
     }
 
-    // Create serial grade book structure with course and student ID's
-    // -----------------------------------------------------------------------------------------------------------------
+    return SUCCESS;
+}
 
-    IGradeBook serialBook = {
-            .coursesCount  = (byte) gradeBook->coursesCount,
-            .studentsCount = (byte) gradeBook->studentsCount
-    };
+/*
+ * Encode a GradeBook in the sectioned format, with records written as `flags` say
+ */
+static SerializationStatus GradeBook_encodeWith(GradeBook* gradeBook, SerialSink* sink, byte flags) {
 
-    for(byte idx = 0; idx < serialBook.coursesCount; ++idx) {
-        serialBook.courses[idx] = gradeBook->courses[idx].courseId;
-    }
+    // Before beginning serialization, check for references to unknown Courses and Students
+    SerializationStatus status = GradeBook_checkReferences(gradeBook);
 
-    for(byte idx = 0; idx < serialBook.studentsCount; ++idx) {
-        serialBook.students[idx] = gradeBook->students[idx].studentId;
-    }
+    if(status != SUCCESS) return status;
+
+    GradeBookContents contents;
+    char policy[SERIAL_POLICY_LENGTH];
+    uint64_t offset;
+
+    GradeBook_layout(gradeBook, &contents, flags);
 
-    // Create serial course structures
-    // -----------------------------------------------------------------------------------------------------------------
+    // Header and table of contents
+    SerialSink_put(sink, GRADEBOOK_VERSIONED_MAGIC, NMEMBERS(GRADEBOOK_VERSIONED_MAGIC, byte));
+    SerialSink_putByte(sink, GradeBook_FORMAT_VERSION);
+    SerialSink_putByte(sink, SERIAL_ID_WIDTH);
+    SerialSink_putByte(sink, SECTIONS_WRITTEN);
+    SerialSink_putByte(sink, flags);
 
-    ICourse coursePrim[serialBook.coursesCount];
+    for(size sectionIdx = 0; sectionIdx < SECTIONS_WRITTEN; ++sectionIdx) {
+        GradeBookSectionKind kind = SECTION_ORDER[sectionIdx];
 
-    for(byte idx = 0; idx < serialBook.coursesCount; ++idx) {
-        coursePrim[idx] = ICourse_fromCourse(&gradeBook->courses[idx]);
+        SerialSink_putId(sink, kind, 4);
+        SerialSink_putOffset(sink, contents.offsets[kind]);
+        SerialSink_putOffset(sink, contents.lengths[kind]);
     }
 
-    // Create serial student structures
-    // -----------------------------------------------------------------------------------------------------------------
+    // COURSE_INDEX, and STUDENT_INDEX - records are written in ID order, so each offset is the sum of the sizes before
+    offset = 0;
 
-    IStudent studentPrim[serialBook.studentsCount];
+    for(size courseIdx = 0; courseIdx < gradeBook->coursesCount; ++courseIdx) {
+        Course* course = GradeBook_courseAt(gradeBook, courseIdx);
 
-    for(byte idx = 0; idx < serialBook.studentsCount; ++idx) {
-        studentPrim[idx] = IStudent_fromStudent(&gradeBook->students[idx]);
+        SerialSink_putId(sink, course->courseId, SERIAL_ID_WIDTH);
+        SerialSink_putOffset(sink, offset);
+        offset += Course_encodedSize(gradeBook, course, flags);
     }
 
-    // Fill buffer
-    // -----------------------------------------------------------------------------------------------------------------
+    offset = 0;
 
-    register size idx = 0;
+    for(size studentIdx = 0; studentIdx < gradeBook->studentsCount; ++studentIdx) {
+        Student* student = GradeBook_studentAt(gradeBook, studentIdx);
 
-    for(byte shift = 0; shift < NMEMBERS(GRADEBOOK_MAGIC, byte); ++shift){
-        tmpBuffer[idx++] = GRADEBOOK_MAGIC[shift];
+        SerialSink_putId(sink, student->studentId, SERIAL_ID_WIDTH);
+        SerialSink_putOffset(sink, offset);
+        offset += Student_encodedSize(gradeBook, student, flags);
     }
 
-    // Serialize the GradeBook index, update IDX to reflect the address of the next available byte
-    idx = IGradeBook_serialize(&serialBook, tmpBuffer, idx);
+    // COURSES, and STUDENTS
+    for(size courseIdx = 0; courseIdx < gradeBook->coursesCount; ++courseIdx) {
+        Course_encode(gradeBook, GradeBook_courseAt(gradeBook, courseIdx), sink, SERIAL_ID_WIDTH, flags);
+    }
 
-    // For each course, serialize the course, and update IDX to reflect the address of the next available byte
-    for(byte courseIdx = 0; courseIdx < serialBook.coursesCount; ++courseIdx) {
-        if(idx + sizeOfCourse(&gradeBook->courses[courseIdx]) > buffSize) {
-            printf("Course Serialization: IDX %lu of %lu: Not enough space left. Exiting.", idx, buffSize);
-            return SHORT_BUFFER;
-        }
-        idx = ICourse_serialize(&coursePrim[courseIdx], tmpBuffer, idx);
+    for(size studentIdx = 0; studentIdx < gradeBook->studentsCount; ++studentIdx) {
+        Student_encode(gradeBook, GradeBook_studentAt(gradeBook, studentIdx), sink, SERIAL_ID_WIDTH, flags);
     }
 
-    // For each student, serialize the student, and update IDX to reflect the address of the next available byte
-    for(byte studentIdx = 0; studentIdx < serialBook.studentsCount; ++studentIdx) {
-        if(idx + sizeOfStudent(&gradeBook->students[studentIdx]) > buffSize) {
-            printf("Student Serialization: IDX %lu of %lu: Not enough space left. Exiting. \n", idx, buffSize);
-            return SHORT_BUFFER;
-        }
-        idx = IStudent_serialize(&studentPrim[studentIdx], tmpBuffer, idx);
+    // POLICIES
+    for(size courseIdx = 0; courseIdx < gradeBook->coursesCount; ++courseIdx) {
+        Course* course      = GradeBook_courseAt(gradeBook, courseIdx);
+        size policyLength   = Course_formatPolicy(gradeBook, course, policy);
+
+        if(policyLength == 0) continue;
+
+        SerialSink_putId(sink, course->courseId, SERIAL_ID_WIDTH);
+        SerialSink_putId(sink, (uint32_t) policyLength, 2);
+        SerialSink_put(sink, (const byte*) policy, policyLength);
     }
 
-    // Copy temporary buffer to real buffer
-    // -----------------------------------------------------------------------------------------------------------------
+    return SerialSink_flush(sink) ? SUCCESS : FAILURE;
+}
 
-    memcpy(buffer, &tmpBuffer, buffSize);
+SerializationStatus GradeBook_encode(GradeBook* gradeBook, SerialSink* sink) {
+    return GradeBook_encodeWith(gradeBook, sink, 0);
+}
 
-    return SUCCESS;
+SerializationStatus GradeBook_encodeCompact(GradeBook* gradeBook, SerialSink* sink) {
+    return GradeBook_encodeWith(gradeBook, sink, GRADEBOOK_COMPACT);
 }
 
-SerializationStatus GradeBook_deserialize(byte* serialData, GradeBook* destination) {
+SerializationStatus GradeBook_serialize(GradeBook* gradeBook, byte* buffer) {
 
-    size idx            = 0;
-    IGradeBook index    = {};
+    SerialBuffer target;
+    SerialSink sink;
 
-    // Read and validate (as we go) the magic
-    for(byte magicIdx = 0; magicIdx < NMEMBERS(GRADEBOOK_MAGIC, byte); ++magicIdx) {
-        if(GRADEBOOK_MAGIC[magicIdx] != serialData[idx++]){
-            printf("Bad magic! buffer[%lu] (%02x) != %02x\n", idx, serialData[idx - 1], GRADEBOOK_MAGIC[magicIdx]);
-            return BAD_MAGIC;
-        }
-    }
+    SerialBuffer_wrap(&target, buffer, sizeOfGradeBook(gradeBook));
+    SerialSink_initBuffer(&sink, &target);
+
+    SerializationStatus status = GradeBook_encode(gradeBook, &sink);
 
-    // Read the GradeBook, and update IDX to the next unread byte
-    idx = IGradeBook_deserialize(serialData, idx, &index);
+    // The buffer is exactly as long as the GradeBook, so the only write that can fail is one past its end
+    return status == FAILURE ? SHORT_BUFFER : status;
+}
 
-    // Courses ---------------------------------------------------------------------------------------------------------
+/*
+ * Enroll the students of each course's roster. A student listed by a course, but not the other way around, is still
+ * enrolled.
+ */
+static SerializationStatus GradeBook_decodeRosters(GradeBookDecoder* decoder) {
 
-    // For each course ID in the GradeBook, read a course, and move IDX past the course
-    destination->coursesCount   = index.coursesCount;
-    const size nCourses         = destination->coursesCount;
+    GradeBook* book = decoder->book;
+    size start      = 0;
 
-    // -- Allocate some course pointers
-    ICourse iCourses[nCourses];
+    for(size rosterIdx = 0; rosterIdx < decoder->rosterEndsCount; ++rosterIdx) {
+        DecodedRoster roster    = decoder->rosterEnds[rosterIdx];
+        Course* course          = GradeBook_findCourse(book, (identifier) roster.courseId);
 
-    // -- Assign said pointers
-    for(byte courseIdx = 0; courseIdx < nCourses; ++courseIdx) {
-        idx = ICourse_deserialize(serialData, idx, &iCourses[courseIdx]);
-    }
+        for(size studentIdx = start; studentIdx < roster.end; ++studentIdx) {
+            Student* student = Student_isValidId(decoder->rosters[studentIdx])
+                    ? GradeBook_findStudent(book, (identifier) decoder->rosters[studentIdx])
+                    : NULL;
 
-    // -- Sort iCourses according to ICourse_compareByID comparator
-    qsort(iCourses, nCourses, sizeof(ICourse), &ICourse_compareByID);
+            if(!student) {
+                char* courseName = Course_toString(course);
+
+                printf("Course %s references an illegal student ID: %u at index %lu \n",
+                        courseName, decoder->rosters[studentIdx], studentIdx - start);
 
-    // Students --------------------------------------------------------------------------------------------------------
+                free(courseName);
 
-    // For each student ID in the GradeBook, read a student, and move IDX past the student
-    destination->studentsCount  = index.studentsCount;
-    const size nStudents        = destination->studentsCount;
+                return ILLEGAL_STUDENT_ID;
+            }
 
-    // -- Allocate some student pointers
-    IStudent iStudents[nStudents];
+            Course_addStudent(book, course, student);
+        }
 
-    // -- Assign said pointers
-    for(byte studentIdx = 0; studentIdx < nStudents; ++studentIdx) {
-        idx = IStudent_deserialize(serialData, idx, &iStudents[studentIdx]);
+        start = roster.end;
     }
 
-    // -- Sort iStudents according to IStudent_compareByID comparator
-    qsort(iStudents, nStudents, sizeof(IStudent), &IStudent_compareByID);
+    return SUCCESS;
+}
 
-    // Initialize Courses, Students. Sanitize ID's ---------------------------------------------------------------------
+/*
+ * Read the index and records of a version 1 GradeBook, whose magic has been read
+ */
+static SerializationStatus GradeBook_decodeRecords(GradeBookDecoder* decoder) {
 
-    // Check Course ID's. Construct Courses from ICourses.
-    Course courses[nCourses];
+    SerializationStatus status = GradeBook_decodeIndex(decoder);
 
-    for(byte courseIdx = 0; courseIdx < nCourses; ++courseIdx) {
-        if(!Array_Contains(index.courses, &iCourses[courseIdx].courseId, index.coursesCount, sizeof(byte), &compare_byte)) {
-            printf("ICourse has unreferenced id %u when deserializing\n", iCourses[courseIdx].courseId);
-            return ILLEGAL_COURSE_ID;
-        }
+    for(size courseIdx = 0; status == SUCCESS && courseIdx < decoder->coursesCount; ++courseIdx) {
+        status = Course_decode(decoder);
+    }
 
-        courses[courseIdx]      = ICourse_toCourse(&iCourses[courseIdx]);
+    for(size studentIdx = 0; status == SUCCESS && studentIdx < decoder->studentsCount; ++studentIdx) {
+        status = Student_decode(decoder);
     }
 
-    // Check Student ID's. Construct Students from IStudents.
-    Student students[nStudents];
+    return status;
+}
+
+SerializationStatus GradeBook_decode(SerialSource* source, GradeBook* destination) {
 
-    for(byte studentIdx = 0; studentIdx < nStudents; ++studentIdx) {
-        if(!Array_Contains(index.students, &iStudents[studentIdx].studentId, index.studentsCount, sizeof(byte), &compare_byte)) {
-            printf("IStudent has unreferenced id %u when deserializing\n", iStudents[studentIdx].studentId);
-            return ILLEGAL_STUDENT_ID;
-        }
+    GradeBookDecoder decoder    = { .source = source, .book = destination };
+    SerializationStatus status;
+    byte magic[4];
 
-        students[studentIdx]    = IStudent_toStudent(&iStudents[studentIdx]);
+    // Start from an empty GradeBook, discarding anything that was previously loaded in to it
+    GradeBook_close(destination);
+
+    if(!SerialSource_take(source, magic, NMEMBERS(magic, byte))) return GradeBookDecoder_ended(&decoder);
+
+    // Validate the magic, which also tells us the format, and how wide the ID's of a version 1 file are
+    if(memcmp(magic, GRADEBOOK_VERSIONED_MAGIC, NMEMBERS(GRADEBOOK_VERSIONED_MAGIC, byte)) == 0) {
+        status = GradeBook_decodeSections(&decoder);
+    } else if(memcmp(magic, GRADEBOOK_MAGIC, NMEMBERS(GRADEBOOK_MAGIC, byte)) == 0) {
+        decoder.width = 1;
+        status = GradeBook_decodeRecords(&decoder);
+    } else if(memcmp(magic, GRADEBOOK_WIDE_MAGIC, NMEMBERS(GRADEBOOK_WIDE_MAGIC, byte)) == 0) {
+        decoder.width = 4;
+        status = GradeBook_decodeRecords(&decoder);
+    } else {
+        printf("Bad magic! buffer[0..3] (%02x%02x%02x%02x) is not a known GradeBook magic\n",
+                magic[0], magic[1], magic[2], magic[3]);
+        return BAD_MAGIC;
     }
 
-    // Copy initialized students, courses, to destination GradeBook.
+    if(status == SUCCESS) status = GradeBook_decodeRosters(&decoder);
 
-    memcpy(destination->courses, courses, nCourses * sizeof(Course));
-    memcpy(destination->students, students, nStudents * sizeof(Student));
+    GradeBookDecoder_free(&decoder);
 
-    // Fill cross-model references
+    if(status != SUCCESS) GradeBook_close(destination);
 
-    for(byte courseIdx = 0; courseIdx < nCourses; ++courseIdx) {
-        // Because both course models have their students sorted by studentId, we can zip through and relate courses
-        size nCourseStudents    = iCourses[courseIdx].studentsCount;
+    return status;
+}
 
-        for(byte studentIdx = 0; studentIdx < nCourseStudents; ++studentIdx) {
+SerializationStatus GradeBook_deserialize(const byte* serialData, size length, GradeBook* destination) {
+    SerialSource source;
+    SerialSource_initMemory(&source, serialData, length);
 
-            /*
-             * Create a temporary student structure to perform a binary search
-             */
-            Student key = { .studentId = iCourses[courseIdx].students[studentIdx] };
+    return GradeBook_decode(&source, destination);
+}
 
-            /*
-             * Search & add student
-             */
-            destination->courses[courseIdx].students[studentIdx] = bsearch(&key, destination->students, nStudents, sizeof(Student), &Student_compareById);
+size sizeOfStudent(GradeBook* book, Student* student) {
+    return Student_encodedSize(book, student, 0);
+}
 
-            /*
-             * Check that the student reference is valid
-             */
-            if(!destination->courses[courseIdx].students[studentIdx]) {
-                char* courseName = Course_toString(&destination->courses[courseIdx]);
+size sizeOfCourse(GradeBook* book, Course* course) {
+    return Course_encodedSize(book, course, 0);
+}
 
-                printf("Course %s references an illegal student ID: %u at index %u \n",
-                        courseName, iCourses[courseIdx].students[studentIdx], studentIdx);
+/*
+ * The size of a whole GradeBook is where its last section, POLICIES, ends (see GradeBook_layout)
+ */
+size sizeOfGradeBook(GradeBook* book) {
+    GradeBookContents contents;
 
-                free(courseName);
+    GradeBook_layout(book, &contents, 0);
 
-                return ILLEGAL_STUDENT_ID;
-            }
-        }
-    }
+    return contents.offsets[SECTION_POLICIES] + contents.lengths[SECTION_POLICIES];
+}
+
+/*
+ * The GradeBook itself is its header, table of contents, and indexes, which take one entry for each course and student
+ */
+size sizeOfGradeBookOnly(GradeBook* book) {
+    return SECTIONED_HEADER_BYTES
+           + SERIAL_INDEX_ENTRY_BYTES(SERIAL_ID_WIDTH) * (book->coursesCount + book->studentsCount);
+}
 
-    for(byte studentIdx = 0; studentIdx < nStudents; ++studentIdx) {
-        // Once again, sorted arrays, etc..
-        size nStudentCourses = iStudents[studentIdx].coursesCount;
-        for(byte courseIdx = 0; courseIdx < nStudentCourses; ++courseIdx) {
+// ---- Sectioned Files ------------------------------------------------------------------------------------------------
 
-            /*
-             * Create a temporary course structure to perform a binary search
-             */
-            Course key = { .courseId = iStudents[studentIdx].courses[courseIdx] };
+SerializationStatus GradeBookFile_open(GradeBookFile* file, const char* path) {
 
-            /*
-             * Search and add student
-             */
-            destination->students[studentIdx].courses[courseIdx].course =
-                    bsearch(&key, destination->courses, nCourses, sizeof(Course), &Course_compareById);
+    SerialSource source;
+    GradeBookDecoder decoder = { .source = &source };
+    SerializationStatus status;
+    struct stat info;
+    byte magic[4];
 
-            /*
-             * Check that the course reference is valid
-             */
-            if(!destination->students[studentIdx].courses[courseIdx].course) {
-                char* studentName = Student_toString(&destination->students[studentIdx]);
+    file->fd = open(path, O_RDONLY);
 
-                printf("Student %s references an illegal course ID: %u at index %u \n",
-                        studentName, iStudents[studentIdx].courses[courseIdx], courseIdx);
+    if(file->fd < 0) return FAILURE;
 
-                free(studentName);
-                return ILLEGAL_COURSE_ID;
-            }
+    SerialSource_initFd(&source, file->fd);
+
+    if(!SerialSource_take(&source, magic, NMEMBERS(magic, byte))) {
+        status = GradeBookDecoder_ended(&decoder);
+    } else if(memcmp(magic, GRADEBOOK_VERSIONED_MAGIC, NMEMBERS(GRADEBOOK_VERSIONED_MAGIC, byte)) != 0) {
+        status = BAD_MAGIC;
+    } else {
+        status = GradeBookContents_decode(&decoder, &file->contents);
+    }
+
+    if(status == SUCCESS && fstat(file->fd, &info) != 0) status = FAILURE;
+
+    // Each section must lie within the file, so that reading any record of it is only checked against its own size
+    for(size kind = 0; status == SUCCESS && kind < GradeBook_SECTION_KINDS; ++kind) {
+        uint64_t offset = file->contents.offsets[kind];
+        uint64_t length = file->contents.lengths[kind];
+
+        if(length > 0 && (offset > (uint64_t) info.st_size || length > (uint64_t) info.st_size - offset)) {
+            status = SHORT_BUFFER;
         }
     }
 
+    if(status != SUCCESS) GradeBookFile_close(file);
 
-    return SUCCESS;
+    return status;
+}
+
+void GradeBookFile_close(GradeBookFile* file) {
+    if(file->fd >= 0) close(file->fd);
+    file->fd = -1;
 }
 
 /*
- * For a description of the sizing algorithm for Student, see IStudent_serialize
+ * Find the offset of a record in its section, by a binary search of an index section. `found` is cleared if the index
+ * does not list `id`.
  */
-size sizeOfStudent(Student* student) {
+static SerializationStatus GradeBookFile_locate(GradeBookFile* file, GradeBookSectionKind index, uint32_t id,
+                                                bool* found, uint64_t* offset) {
 
-    size nCourses      = Student_coursesCount(student);
-    size sName         = strlen(student->studentName);
-    size nGrades       = 0;
+    const GradeBookContents* contents = &file->contents;
+    size entryBytes = SERIAL_INDEX_ENTRY_BYTES(contents->width);
+    size low        = 0;
+    size high       = (size) (contents->lengths[index] / entryBytes);
+    byte entry[SERIAL_INDEX_ENTRY_BYTES(4)];
 
-    for(size idx = 0; idx < nCourses; ++idx){
-        nGrades += student->courses[idx].gradeCount;
+    *found = false;
+
+    while(low < high) {
+        size middle = low + (high - low) / 2;
+        off_t at    = (off_t) (contents->offsets[index] + middle * entryBytes);
+        uint32_t entryId, offsetHigh, offsetLow;
+
+        if(pread(file->fd, entry, entryBytes, at) != (ssize_t) entryBytes) {
+            printf("The GradeBook could not be read\n");
+            return FAILURE;
+        }
+
+        size next = Serial_readId(entry, 0, &entryId, contents->width);
+
+        if(entryId < id) {
+            low = middle + 1;
+        } else if(entryId > id) {
+            high = middle;
+        } else {
+            Serial_readId(entry, Serial_readId(entry, next, &offsetHigh, 4), &offsetLow, 4);
+
+            *offset = (uint64_t) offsetHigh << 32 | offsetLow;
+            *found  = true;
+
+            return SUCCESS;
+        }
     }
 
-    return (1 + nCourses) + (1 + sName) + (nCourses + nGrades) + 1;
+    return SUCCESS;
 }
 
 /*
- * For a description of the sizing algorithm for Course, see ICourse_serialize
+ * Point `source` at the record `offset` bytes in to a section
  */
-size sizeOfCourse(Course* course) {
+static SerializationStatus GradeBookFile_seek(GradeBookFile* file, SerialSource* source, GradeBookSectionKind section,
+                                              uint64_t offset) {
 
-    size nStudents  = Course_studentsCount(course);
-    size sName      = strlen(course->courseName);
+    if(offset >= file->contents.lengths[section]) {
+        printf("The GradeBook index lists a record past the end of section %u\n", section);
+        return FAILURE;
+    }
+
+    if(lseek(file->fd, (off_t) (file->contents.offsets[section] + offset), SEEK_SET) < 0) {
+        printf("The GradeBook could not be read\n");
+        return FAILURE;
+    }
 
-    return (1 + nStudents) + (1 + sName) + 1;
+    SerialSource_initFd(source, file->fd);
+
+    return SUCCESS;
 }
 
-/*
- * This approximates the output size of a WHOLE GradeBook tree.
- * This is done by adding (one plus the number of courses), and (one plus the number of students),
- * along with the accumulated sum of the sizes of all students, and courses.
- *
- * The reason for adding one to the length (NOT SIZE) of the course and student arrays as that each course and each
- * student will be represent by one byte in a sequence of bytes N students or courses long at serialization.
- * Among other ways to determine how many students or courses to read is to prepend the number of these numbers to read
- * to the sequence. This is a good solution in this case, as nStudents < 100 and nCourses < 25, while the maximum value
- * that may be stored in one unsigned byte, 255, far exceeds these limitations.
- *
- * In addition, the size of the magic number, an identifier preceding all serialized data, is added to this.
- */
-size sizeOfGradeBook(GradeBook* book) {
-    size nCourses           = book->coursesCount;
-    size nStudents          = book->studentsCount;
-    size accumCourseSize    = 0;
-    size accumStudentSize   = 0;
+SerializationStatus GradeBookFile_loadStudent(GradeBookFile* file, uint32_t studentId, GradeBook* destination) {
+
+    SerialSource source;
+    GradeBookDecoder decoder    = { .source = &source, .book = destination, .width = file->contents.width,
+                                    .flags = file->contents.flags };
+    uint64_t studentOffset      = 0;
+    uint32_t nCourses           = 0;
+    uint32_t previous           = 0;
+    bool found                  = false;
+
+    GradeBook_close(destination);
+
+    SerializationStatus status = GradeBookFile_locate(file, SECTION_STUDENT_INDEX, studentId, &found, &studentOffset);
+
+    if(status == SUCCESS && !found) status = ILLEGAL_STUDENT_ID;
+
+    // The student's record begins with the courses it is enrolled in, which must be added before it is
+    if(status == SUCCESS) status = GradeBookFile_seek(file, &source, SECTION_STUDENTS, studentOffset);
 
-    for(byte idx = 0; idx < nCourses; ++idx) {
-        accumCourseSize += sizeOfCourse(&book->courses[idx]);
+    if(status == SUCCESS && !GradeBookDecoder_takeCount(&decoder, &nCourses)) status = GradeBookDecoder_ended(&decoder);
+
+    for(size courseIdx = 0; status == SUCCESS && courseIdx < nCourses; ++courseIdx) {
+        if(!GradeBookDecoder_reserve(&decoder.courseIds, &decoder.courseIdsCapacity, courseIdx + 1, sizeof(uint32_t))) {
+            status = GradeBookDecoder_outOfMemory("course ID's");
+        } else if(!GradeBookDecoder_takeListId(&decoder, &previous, &decoder.courseIds[courseIdx])) {
+            status = GradeBookDecoder_ended(&decoder);
+        }
     }
 
-    for(byte idx = 0; idx < nStudents; ++idx) {
-        accumStudentSize += sizeOfStudent(&book->students[idx]);
+    if(status == SUCCESS) {
+        qsort(decoder.courseIds, nCourses, sizeof(uint32_t), &compare_serialId);
+        decoder.coursesCount = nCourses;
+
+        if(GradeBookDecoder_reserve(&decoder.studentIds, &decoder.studentIdsCapacity, 1, sizeof(uint32_t))) {
+            decoder.studentIds[decoder.studentsCount++] = studentId;
+        } else {
+            status = GradeBookDecoder_outOfMemory("student ID's");
+        }
     }
 
-    return (1 + nCourses) + (1 + nStudents) + accumCourseSize + accumStudentSize + NMEMBERS(GRADEBOOK_MAGIC, byte);
-}
+    for(size courseIdx = 0; status == SUCCESS && courseIdx < nCourses; ++courseIdx) {
+        uint32_t courseId       = decoder.courseIds[courseIdx];
+        uint64_t courseOffset   = 0;
 
-size sizeOfGradeBookOnly(GradeBook* book) {
-    size nCourses  = book->coursesCount;
-    size nStudents = book->studentsCount;
+        // A course listed twice is read once
+        if(courseIdx > 0 && courseId == decoder.courseIds[courseIdx - 1]) continue;
+
+        status = GradeBookFile_locate(file, SECTION_COURSE_INDEX, courseId, &found, &courseOffset);
+
+        if(status == SUCCESS && !found) {
+            printf("Student %u references an illegal course ID: %u\n", studentId, courseId);
+            status = ILLEGAL_COURSE_ID;
+        }
+
+        if(status == SUCCESS) status = GradeBookFile_seek(file, &source, SECTION_COURSES, courseOffset);
+
+        // The course's roster is kept by the decoder, and never enrolled
+        if(status == SUCCESS) status = Course_decode(&decoder);
+    }
+
+    if(status == SUCCESS) status = GradeBookFile_seek(file, &source, SECTION_STUDENTS, studentOffset);
+    if(status == SUCCESS) status = Student_decode(&decoder);
+
+    GradeBookDecoder_free(&decoder);
+
+    if(status != SUCCESS) GradeBook_close(destination);
 
-    return (1 + nCourses) + (1 + nStudents);
+    return status;
 }
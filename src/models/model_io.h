@@ -23,6 +23,23 @@
  */
 extern const byte GRADEBOOK_MAGIC[4];
 
+/*
+ * Identifies a serialized GradeBook whose student and course ID's are four bytes wide.
+ * Written by builds with _GB_WIDE_IDS; accepted by every build.
+ */
+extern const byte GRADEBOOK_WIDE_MAGIC[4];
+
+/*
+ * Identifies a serialized GradeBook in the sectioned format, which is followed by a format version. GradeBook_encode
+ * writes this format; files beginning with GRADEBOOK_MAGIC or GRADEBOOK_WIDE_MAGIC are version 1, and still read.
+ */
+extern const byte GRADEBOOK_VERSIONED_MAGIC[4];
+
+/*
+ * Newest format version this build reads, and the one it writes
+ */
+#define GradeBook_FORMAT_VERSION 2
+
 typedef enum SerializationStatus {
 
     /*
@@ -57,28 +74,204 @@ typedef enum SerializationStatus {
 
 } SerializationStatus;
 
+// -- Sinks ------------------------------------------------------------------------------------------------------------
+
+/*
+ * Bytes a SerialSink gathers before handing them on
+ */
+#define SerialSink_BUFFER_BYTES 4096
+
+/*
+ * Destination of an encoded GradeBook. Bytes are gathered in a fixed buffer, and handed to `write` whenever it fills,
+ * and by SerialSink_flush, so that a GradeBook of any size is encoded in SerialSink_BUFFER_BYTES of memory.
+ *
+ * A sink is made for a FILE*, a file descriptor, or a SerialBuffer by the SerialSink_init functions, or for anything
+ * else by filling in `write` and `target`, and zeroing the rest.
+ */
+typedef struct S_SerialSink {
+
+    /*
+     * Take `count` bytes of `data`, and return false if they could not all be taken
+     */
+    bool (*write)(void* target, const byte* data, size count);
+
+    void* target;
+
+    byte buffer[SerialSink_BUFFER_BYTES];
+
+    size buffered;
+
+    /*
+     * Bytes put in to the sink, buffered ones included
+     */
+    size written;
+
+    /*
+     * Set by the first write that fails, after which every byte is dropped
+     */
+    bool failed;
+
+} SerialSink;
+
+/*
+ * Memory that a SerialSink writes in to: grown as needed, or, once given by SerialBuffer_wrap, of a fixed capacity
+ * that a write past fails
+ */
+typedef struct S_SerialBuffer {
+
+    byte* data;
+
+    size count;
+
+    size capacity;
+
+    bool fixed;
+
+} SerialBuffer;
+
+void SerialBuffer_init(SerialBuffer* buffer);
+
+/*
+ * Write in to `capacity` bytes at `data`, which the buffer does not own
+ */
+void SerialBuffer_wrap(SerialBuffer* buffer, byte* data, size capacity);
+
+/*
+ * Release the memory of a growable buffer. A wrapped buffer's memory is left to its owner.
+ */
+void SerialBuffer_free(SerialBuffer* buffer);
+
+void SerialSink_initFile(SerialSink* sink, FILE* file);
+
+void SerialSink_initFd(SerialSink* sink, int fd);
+
+void SerialSink_initBuffer(SerialSink* sink, SerialBuffer* buffer);
+
+void SerialSink_put(SerialSink* sink, const byte* data, size count);
+
+/*
+ * Hand every buffered byte on, and return false if any write, then or before, failed. A FILE* is not itself flushed.
+ */
+bool SerialSink_flush(SerialSink* sink);
+
+// -- Sources ----------------------------------------------------------------------------------------------------------
+
+/*
+ * Bytes a SerialSource reads ahead
+ */
+#define SerialSource_WINDOW_BYTES 65536
+
+/*
+ * Where an encoded GradeBook is decoded from. A source over a FILE* or a file descriptor is read through a window of
+ * SerialSource_WINDOW_BYTES, refilled as the decoder pulls from it, so that a GradeBook of any size is decoded in that
+ * much memory besides the GradeBook itself. A source over memory is read in place.
+ *
+ * A source for anything else is made by filling in `read` and `target`, and zeroing the rest.
+ */
+typedef struct S_SerialSource {
+
+    /*
+     * Read at most `count` bytes in to `data`, and return how many were read, 0 at the end, or -1 on failure
+     */
+    long (*read)(void* target, byte* data, size count);
+
+    void* target;
+
+    /*
+     * Bytes not yet decoded are data[position] to data[length - 1]. `data` is `window`, unless the source is memory.
+     */
+    const byte* data;
+
+    size position;
+
+    size length;
+
+    /*
+     * Bytes slid off the front of the window, so that `consumed + position` is how far in to the source the decoder is
+     */
+    size consumed;
+
+    /*
+     * Set by the first read that fails
+     */
+    bool failed;
+
+    /*
+     * Set by the first value that is not well formed, such as a varint that does not end within 10 bytes, or is wider
+     * than 64 bits
+     */
+    bool malformed;
+
+    byte window[SerialSource_WINDOW_BYTES];
+
+} SerialSource;
+
+void SerialSource_initFile(SerialSource* source, FILE* file);
+
+void SerialSource_initFd(SerialSource* source, int fd);
+
+/*
+ * Read `length` bytes at `data`, which must outlast the source
+ */
+void SerialSource_initMemory(SerialSource* source, const byte* data, size length);
+
+// -- GradeBooks -------------------------------------------------------------------------------------------------------
+
+/*
+ * Flags of a GradeBook in the sectioned format, given in its header
+ */
+typedef enum E_GradeBookFlags {
+
+    /*
+     * The ID lists of records are written as varint differences, each from the ID before it, and runs of grades below
+     * 0x80 are packed 7 bits apiece (see GradeKernels.unpack). Indexes are left as they are, so that records may
+     * still be found by a binary search.
+     */
+    GRADEBOOK_COMPACT   = 0x01
+
+} GradeBookFlags;
+
+/*
+ * Encode a GradeBook in to a sink, straight from its records, and flush it, in format version
+ * GradeBook_FORMAT_VERSION. The bytes are those GradeBook_serialize writes. Returns FAILURE if the sink failed, in
+ * which case any part of the GradeBook may have been written.
+ */
+SerializationStatus GradeBook_encode(GradeBook* gradeBook, SerialSink* sink);
+
+/*
+ * Encode a GradeBook as GradeBook_encode does, with GRADEBOOK_COMPACT records, for archives and copies sent elsewhere.
+ * It is read by GradeBook_decode and GradeBookFile alike.
+ */
+SerializationStatus GradeBook_encodeCompact(GradeBook* gradeBook, SerialSink* sink);
+
 /**
-* Write the GradeBook referenced by pointer gradeBook to buffer, where buffer is GRADEBOOK_LENGTH bytes long
+* Write the GradeBook referenced by pointer gradeBook to buffer, which must be sizeOfGradeBook bytes long
 */
 SerializationStatus GradeBook_serialize(GradeBook* gradeBook, byte* buffer);
 
-/**
-* Construct necessary elements and create a GradeBook using the stream 'serialData'.
-* Assign the constructed GradeBook to target.
-*
-* A return value of '0'
-*/
-SerializationStatus GradeBook_deserialize(byte* serialData, GradeBook* destination);
+/*
+ * Decode a GradeBook of any format version up to GradeBook_FORMAT_VERSION from a source in to `destination`, which is
+ * emptied first, and left empty unless SUCCESS is returned. Each record is checked as it is read: SHORT_BUFFER is
+ * returned if the source ends part way through one, BAD_MAGIC if the version is newer than this build reads, and
+ * FAILURE if the source could not be read, holds a value that is not well formed, a section does not hold what the
+ * table of contents says it does, or memory for the GradeBook could not be allocated.
+ */
+SerializationStatus GradeBook_decode(SerialSource* source, GradeBook* destination);
 
 /*
- * Calculate the actual serialized size of a Student
+ * Decode the GradeBook held in the `length` bytes at `serialData` (see GradeBook_decode)
  */
-size sizeOfStudent(Student* student);
+SerializationStatus GradeBook_deserialize(const byte* serialData, size length, GradeBook* destination);
 
 /*
- * Calculate the actual serialized size of a Course
+ * Calculate the actual serialized size of a Student, as GradeBook_encode writes it
  */
-size sizeOfCourse(Course* course);
+size sizeOfStudent(GradeBook* book, Student* student);
+
+/*
+ * Calculate the actual serialized size of a Course, as GradeBook_encode writes it
+ */
+size sizeOfCourse(GradeBook* book, Course* course);
 
 /*
  * Calculate the actual serialized size of a GradeBook
@@ -92,6 +285,87 @@ size sizeOfGradeBook(GradeBook* book);
  */
 size sizeOfGradeBookOnly(GradeBook* book);
 
+// -- Sectioned Files -------------------------------------------------------------------------------------------------
+
+/*
+ * Sections of a GradeBook in the sectioned format (see model_io.c). A reader skips sections of kinds it does not know.
+ */
+typedef enum E_GradeBookSectionKind {
+
+    /*
+     * Every course ID, in courseId order, each with the offset of its record in COURSES
+     */
+    SECTION_COURSE_INDEX    = 1,
+
+    SECTION_STUDENT_INDEX   = 2,
+
+    SECTION_COURSES         = 3,
+
+    SECTION_STUDENTS        = 4,
+
+    /*
+     * The grading policy of each course that has one
+     */
+    SECTION_POLICIES        = 5
+
+} GradeBookSectionKind;
+
+/*
+ * One more than the largest section kind
+ */
+#define GradeBook_SECTION_KINDS 6
+
+/*
+ * Header and table of contents of a GradeBook in the sectioned format. A section that is missing has a length of 0.
+ */
+typedef struct S_GradeBookContents {
+
+    /*
+     * Width of the file's ID's
+     */
+    byte width;
+
+    /*
+     * GradeBookFlags
+     */
+    byte flags;
+
+    uint64_t offsets[GradeBook_SECTION_KINDS];
+
+    uint64_t lengths[GradeBook_SECTION_KINDS];
+
+} GradeBookContents;
+
+/*
+ * A GradeBook file in the sectioned format, open for records to be read from it one at a time
+ */
+typedef struct S_GradeBookFile {
+
+    int fd;
+
+    GradeBookContents contents;
+
+} GradeBookFile;
+
+/*
+ * Open the file at `path`, and read its header and table of contents. Returns FAILURE if it could not be opened or
+ * read, BAD_MAGIC if it is not in the sectioned format, which includes version 1 files, and SHORT_BUFFER if a section
+ * lies outside of it. `file` is left closed unless SUCCESS is returned.
+ */
+SerializationStatus GradeBookFile_open(GradeBookFile* file, const char* path);
+
+/*
+ * Read one student, and the courses it is enrolled in, in to `destination`, which is emptied first. The records are
+ * found by binary searches of the file's indexes. What is read is the student's record, and the whole record of each
+ * course it is enrolled in, roster included, each from a fresh window of up to SerialSource_WINDOW_BYTES: the cost
+ * grows with the student's courses and the lengths of their rosters, and only with the logarithm of the number of
+ * records in the file. Courses hold only the student read. Returns ILLEGAL_STUDENT_ID, leaving `destination` empty, if
+ * there is no such student, and otherwise as GradeBook_decode does.
+ */
+SerializationStatus GradeBookFile_loadStudent(GradeBookFile* file, uint32_t studentId, GradeBook* destination);
+
+void GradeBookFile_close(GradeBookFile* file);
+
 // End Model "model_io" ------------------------------------------------------------------------------------------------
 
 #endif
\ No newline at end of file
@@ -9,6 +9,8 @@
 
 #include <string.h>
 #include <stdio.h>
+#include <limits.h>
+#include <stdint.h>
 #include <strings.h>
 #include <search.h>
 #include "models.h"
@@ -19,6 +21,18 @@
 const grade MAX_GRADE = 0xFF;
 const grade MIN_GRADE = 0x00;
 
+/*
+ * Names are written with a one-byte length
+ */
+const size MAX_NAME_LENGTH = 254;
+
+const identifier ID_MIN = 0;
+#ifdef _GB_WIDE_IDS
+const identifier ID_MAX = UINT32_MAX;
+#else
+const identifier ID_MAX = UCHAR_MAX;
+#endif
+
 static const size _GB_TOSTRING_INITIAL = 256;
 
 // Student -------------------------------------------------------------------------------------------------------------
@@ -27,18 +41,20 @@ int Student_compareById(const void *a, const void *b){
     if(!a | !b) {
       return (!a && !b) ? 0 : -1;
     } else {
-        return ((Student*)a)->studentId - ((Student*)b)->studentId;
+        // Compare rather than subtract, as the difference of two wide ID's does not fit in an int
+        identifier idA = ((Student*)a)->studentId, idB = ((Student*)b)->studentId;
+        return (idA > idB) - (idA < idB);
     }
 }
 
-const char* Student_stringFormat = "Student{ .studentId = %03u, .studentName = \"%s\", .courses[%u] }";
+const char* Student_stringFormat = "Student{ .studentId = %03u, .studentName = \"%s\", .courses[%lu] }";
 
 char* Student_toString(Student* student) {
 
     char* buffer;
 
     if(student) {
-        asprintf(&buffer, Student_stringFormat, student->studentId, student->studentName, Student_coursesCount(student));
+        asprintf(&buffer, Student_stringFormat, student->studentId, student->studentName, student->coursesCount);
     } else {
         asprintf(&buffer, "(null: Student)");
     }
@@ -46,231 +62,1756 @@ char* Student_toString(Student* student) {
     return buffer;
 }
 
-size Student_coursesCount(Student* student) {
-    // How to write hard-to-follow C code in one easy line:
-    for(size idx = 0; idx < NMEMBERS(student->courses, StudentEnrollment); ++idx) {
-        if(!student->courses[idx].course) return idx;
-    };
+// Course --------------------------------------------------------------------------------------------------------------
 
-    return 0;
+int Course_compareById(const void* a, const void* b){
+    if(!a | !b){
+        return (!a && !b) ? 0 : -1;
+    } else {
+        identifier idA = ((Course*)a)->courseId, idB = ((Course*)b)->courseId;
+        return (idA > idB) - (idA < idB);
+    }
 }
 
-long Student_courseIndex(Student* student, Course* course) {
-    size nCourses = Student_coursesCount(student);
-    for(size idx = 0; idx < nCourses; ++idx) {
-        if(Course_compareById(course, student->courses[idx].course) == 0) {
-            return idx;
-        }
-    }
+const char* Course_stringFormat = "Course{ .courseId = %03u, .courseName = \"%s\", .students[%02lu] }";
 
-    return -1;
-}
+char* Course_toString(Course* course) {
 
-int StudentEnrollment_compareByCourseId(const void* a, const void* b) {
-    if(!a || !b) {
-        return (!a && !b) ? 0 : -1;
-    } else if(!((StudentEnrollment*)a)->course || !((StudentEnrollment*)b)->course) {
-        return (!((StudentEnrollment*)a)->course && !((StudentEnrollment*)b)->course) ? 0 : -1;
+    char* buffer;
+
+    if(course) {
+        asprintf(&buffer, Course_stringFormat, course->courseId, course->courseName, course->studentsCount);
     } else {
-        return ((StudentEnrollment*)a)->course->courseId - ((StudentEnrollment*)b)->course->courseId;
+        asprintf(&buffer, "(null: Course)");
     }
+
+    return buffer;
+
 }
 
-bool Student_removeCourse(Student* student, Course* course) {
+// GradeBook -----------------------------------------------------------------------------------------------------------
+
+const char* GradeBook_stringFormat = "GradeBook{ .courses[%02u], .students[%03u] }";
 
-    long courseIdx = Student_courseIndex(student, course);
-    if(courseIdx < 0) return false;
+char* GradeBook_toString(GradeBook* book) {
+    if(!book) return "(GradeBook)null";
+    char* nameFormatted[strlen(Student_stringFormat)];
+    sprintf(nameFormatted, GradeBook_stringFormat, book->coursesCount, book->studentsCount);
 
-    size nCourses = Student_coursesCount(student);
+    return nameFormatted;
+}
 
-    student->courses[courseIdx].course = NULL;
-    student->courses[courseIdx].gradeCount = 0;
-    memset(student->courses[courseIdx].grades, 0, sizeof(student->courses[courseIdx].grades));
+// -- Storage ----------------------------------------------------------------------------------------------------------
 
-    qsort(student->courses, NMEMBERS(student->courses, StudentEnrollment), sizeof(StudentEnrollment), &StudentEnrollment_compareByCourseId);
+/*
+ * Number of records per arena chunk, as a power of two.
+ * Courses are few and large, students are many.
+ */
+static const size _GB_COURSE_CHUNK_SHIFT  = 5;
+static const size _GB_STUDENT_CHUNK_SHIFT = 8;
+
+static const size _GB_ENROLLMENT_CHUNK_SHIFT = 8;
+
+void GradeBook_init(GradeBook* book) {
+    memset(book, 0, sizeof(GradeBook));
+    Pool_init(&book->pool);
+    Arena_init(&book->courses, &book->pool, sizeof(Course), _GB_COURSE_CHUNK_SHIFT);
+    Arena_init(&book->students, &book->pool, sizeof(Student), _GB_STUDENT_CHUNK_SHIFT);
+    Arena_init(&book->enrollments, &book->pool, sizeof(StudentEnrollment), _GB_ENROLLMENT_CHUNK_SHIFT);
+    GradeLog_initPool(&book->gradeChunks, &book->pool);
+    StringPool_init(&book->names, &book->pool);
+    HistogramPool_init(&book->histograms, &book->pool);
+    IdIndex_init(&book->courseIds, &book->pool);
+    IdIndex_init(&book->studentIds, &book->pool);
+    EdgeIndex_init(&book->enrollmentPairs, &book->pool);
+    EdgeRows_init(&book->rosters, &book->pool);
+    EdgeRows_init(&book->transcripts, &book->pool);
+    RankIndex_init(&book->courseRanks, &book->pool);
+    RankIndex_init(&book->studentRanks, &book->pool);
+}
 
-    return true;
+void GradeBook_close(GradeBook* book) {
+    // Every table was allocated from the pool, so there is nothing to release one by one
+    Pool_free(&book->pool);
+    GradeBook_init(book);
 }
 
-bool Student_addCourse(Student* student, Course* course) {
+// -- Order Index ------------------------------------------------------------------------------------------------------
 
-    size nCourses = Student_coursesCount(student);
-    if(nCourses >= NMEMBERS(student->courses, Course*)) return false;
+/*
+ * An order index is an array of (id, slot) entries kept sorted by id. Searching it never touches the records
+ * themselves, and inserting or removing a record only moves entries, which are 8 bytes each.
+ */
 
-    StudentEnrollment enrollment = {
-            .course = course
-    };
+/*
+ * Make room for at least `needed` entries in an order index
+ */
+static void Order_reserve(Pool* pool, IdIndexEntry** order, size* capacity, size needed) {
+    if(needed <= *capacity) return;
 
-    memset(enrollment.grades, 0, NMEMBERS(enrollment.grades, grade) * sizeof(grade));
-    enrollment.gradeCount = 0;
+    size newCapacity = *capacity ? *capacity : 32;
+    while(newCapacity < needed) newCapacity *= 2;
 
-    memcpy(&student->courses[nCourses], &enrollment, sizeof(StudentEnrollment));
+    IdIndexEntry* resized = Pool_resize(pool, *order, *capacity * sizeof(IdIndexEntry), newCapacity * sizeof(IdIndexEntry));
 
-    return true;
+    if(!resized) {
+        fprintf(stderr, "GradeBook: unable to grow order index to %lu entries\n", newCapacity);
+        abort();
+    }
+
+    *order      = resized;
+    *capacity   = newCapacity;
 }
 
-// Course --------------------------------------------------------------------------------------------------------------
+/*
+ * Return the position of the first entry whose id is not less than `id`
+ */
+static size Order_lowerBound(const IdIndexEntry* order, size count, identifier id) {
+    size low = 0, high = count;
 
-int Course_compareById(const void* a, const void* b){
-    if(!a | !b){
-        return (!a && !b) ? 0 : -1;
-    } else {
-        return ((Course*)a)->courseId - ((Course*)b)->courseId;
+    while(low < high) {
+        size mid = low + (high - low) / 2;
+        if(order[mid].id < id) low = mid + 1; else high = mid;
     }
+
+    return low;
 }
 
-const char* Course_stringFormat = "Course{ .courseId = %03u, .courseName = \"%s\", .students[%02u] }";
+/*
+ * Insert `entry` in to an order index holding `count` entries, keeping it sorted
+ */
+static void Order_insert(IdIndexEntry* order, size count, IdIndexEntry entry) {
+    size position = Order_lowerBound(order, count, entry.id);
+    memmove(&order[position + 1], &order[position], (count - position) * sizeof(IdIndexEntry));
+    order[position] = entry;
+}
 
-char* Course_toString(Course* course) {
+/*
+ * Return the position of `id` in an order index, or -1
+ */
+static long Order_find(const IdIndexEntry* order, size count, identifier id) {
+    size position = Order_lowerBound(order, count, id);
+    return (position < count && order[position].id == id) ? (long) position : -1;
+}
 
-    char* buffer;
+static int Order_compareEntries(const void* a, const void* b) {
+    identifier idA = ((IdIndexEntry*)a)->id, idB = ((IdIndexEntry*)b)->id;
+    return (idA > idB) - (idA < idB);
+}
 
-    if(course) {
-        asprintf(&buffer, Course_stringFormat, course->courseId, course->courseName, Course_studentsCount(course));
-    } else {
-        asprintf(&buffer, "(null: Course)");
+/*
+ * The first `sortedCount` entries are sorted, and the entries up to `totalCount` were appended in any order.
+ * Sort the appended entries, then merge them in to place. This costs O(k log k) for k appended entries, plus one
+ * linear merge pass, rather than a sort of the whole index.
+ */
+static void Order_mergeTail(Pool* pool, IdIndexEntry* order, size sortedCount, size totalCount) {
+    size tailCount      = totalCount - sortedCount;
+    IdIndexEntry* tail  = &order[sortedCount];
+
+    qsort(tail, tailCount, sizeof(IdIndexEntry), &Order_compareEntries);
+
+    // Nothing to merge if the appended entries all belong after the existing ones
+    if(sortedCount == 0 || tailCount == 0 || order[sortedCount - 1].id < tail[0].id) return;
+
+    IdIndexEntry* buffer = Pool_alloc(pool, tailCount * sizeof(IdIndexEntry));
+
+    if(!buffer) {
+        // Fall back to sorting the whole index
+        qsort(order, totalCount, sizeof(IdIndexEntry), &Order_compareEntries);
+        return;
     }
 
-    return buffer;
+    memcpy(buffer, tail, tailCount * sizeof(IdIndexEntry));
+
+    // Merge from the back, so that nothing is overwritten before it has been moved
+    size left = sortedCount, right = tailCount, out = totalCount;
+
+    while(right > 0) {
+        if(left > 0 && order[left - 1].id > buffer[right - 1].id) {
+            order[--out] = order[--left];
+        } else {
+            order[--out] = buffer[--right];
+        }
+    }
 
+    Pool_release(pool, buffer, tailCount * sizeof(IdIndexEntry));
 }
 
-size Course_studentsCount(Course* course) {
-    return PtrArray_CountSane((void**) course->students, NMEMBERS(course->students, Student*));
+// -- Lookup -----------------------------------------------------------------------------------------------------------
+
+/*
+ * Return the name pool's copy of a caller's name, cut to MAX_NAME_LENGTH. A record added without a name gets "".
+ */
+static const char* GradeBook_internName(GradeBook* book, const char* name) {
+    if(!name) name = "";
+    return StringPool_intern(&book->names, name, strnlen(name, MAX_NAME_LENGTH));
 }
 
-bool Course_addStudent(Course* course, Student* student) {
+bool GradeBook_clone(GradeBook* destination, const GradeBook* source) {
+
+    GradeBook_init(destination);
+
+    /*
+     * Records hold handles rather than pointers, so every table is copied as-is, bar the names
+     */
+    destination->courseOrder    = Pool_alloc(&destination->pool, source->courseOrderCapacity * sizeof(IdIndexEntry));
+    destination->studentOrder   = Pool_alloc(&destination->pool, source->studentOrderCapacity * sizeof(IdIndexEntry));
+
+    if(!destination->courseOrder || !destination->studentOrder
+       || !Arena_clone(&destination->courses, &source->courses) || !Arena_clone(&destination->students, &source->students)
+       || !Arena_clone(&destination->enrollments, &source->enrollments)
+       || !Arena_clone(&destination->gradeChunks, &source->gradeChunks)
+       || !HistogramPool_clone(&destination->histograms, &source->histograms)
+       || !IdIndex_clone(&destination->courseIds, &source->courseIds)
+       || !IdIndex_clone(&destination->studentIds, &source->studentIds)
+       || !EdgeIndex_clone(&destination->enrollmentPairs, &source->enrollmentPairs)) {
+        GradeBook_close(destination);
+        GradeBook_init(destination);
+        return false;
+    }
+
+    memcpy(destination->courseOrder, source->courseOrder, source->coursesCount * sizeof(IdIndexEntry));
+    memcpy(destination->studentOrder, source->studentOrder, source->studentsCount * sizeof(IdIndexEntry));
+
+    destination->courseOrderCapacity    = source->courseOrderCapacity;
+    destination->studentOrderCapacity   = source->studentOrderCapacity;
+    destination->coursesCount           = source->coursesCount;
+    destination->studentsCount          = source->studentsCount;
 
-    size nStudents = Course_studentsCount(course);
+    // Names still point in to the source's pool
+    for(size idx = 0; idx < destination->coursesCount; ++idx) {
+        Course* course      = GradeBook_courseAt(destination, idx);
+        course->courseName  = GradeBook_internName(destination, course->courseName);
+    }
+
+    for(size idx = 0; idx < destination->studentsCount; ++idx) {
+        Student* student        = GradeBook_studentAt(destination, idx);
+        student->studentName    = GradeBook_internName(destination, student->studentName);
+    }
 
-    if(nStudents >= NMEMBERS(course->students, Student*)) return false;
-    if(lsearch(student, course->students, &nStudents, sizeof(Student*), &Student_compareById)) return false;
+    if(source->coursePlansCapacity > 0) {
+        destination->coursePlans = Pool_alloc(&destination->pool, source->coursePlansCapacity * sizeof(GradingPlan));
 
-    course->students[Course_studentsCount(course)] = student;
+        if(!destination->coursePlans) {
+            GradeBook_close(destination);
+            GradeBook_init(destination);
+            return false;
+        }
 
-    qsort(course->students, Course_studentsCount(course), sizeof(Student*), &Student_compareById);
+        memcpy(destination->coursePlans, source->coursePlans, source->coursePlansCapacity * sizeof(GradingPlan));
+        destination->coursePlansCapacity = source->coursePlansCapacity;
+    }
 
-    Student_addCourse(student, course);
+    // Rosters and transcripts are derived from the enrollment table, so let the copy rebuild its own
+    destination->enrollmentsDirty       = true;
 
     return true;
 }
 
-bool Course_remStudentIndex(Course* course, size index) {
+Course* GradeBook_resolveCourse(GradeBook* book, CourseHandle handle) {
+    return Arena_resolve(&book->courses, handle);
+}
 
-    size initialSize = Course_studentsCount(course);
+Student* GradeBook_resolveStudent(GradeBook* book, StudentHandle handle) {
+    return Arena_resolve(&book->students, handle);
+}
 
-    course->students[index] = NULL;
+Course* GradeBook_courseAt(GradeBook* book, size index) {
+    return index < book->coursesCount ? Arena_at(&book->courses, book->courseOrder[index].slot) : NULL;
+}
 
-    qsort(course->students, initialSize, sizeof(Student*), &Student_compareById);
+Student* GradeBook_studentAt(GradeBook* book, size index) {
+    return index < book->studentsCount ? Arena_at(&book->students, book->studentOrder[index].slot) : NULL;
+}
 
-    return true;
+Course* GradeBook_findCourse(GradeBook* book, identifier courseId) {
+    long slot = IdIndex_find(&book->courseIds, courseId);
+    return slot < 0 ? NULL : Arena_at(&book->courses, (size) slot);
 }
 
-bool Course_remStudent(Course* course, Student* student) {
-    size initialSize = Course_studentsCount(course);
+Student* GradeBook_findStudent(GradeBook* book, identifier studentId) {
+    long slot = IdIndex_find(&book->studentIds, studentId);
+    return slot < 0 ? NULL : Arena_at(&book->students, (size) slot);
+}
 
-    for(size idx = 0; idx < initialSize; ++idx) {
-        if(Student_compareById(student, course->students[idx]) == 0){
-            return Course_remStudentIndex(course, idx);
-        }
+// -- Ranking ----------------------------------------------------------------------------------------------------------
+
+/*
+ * Ranking queries of a cold GradeBook that are answered by partial sort before the rank index is built
+ */
+static const size _GB_COLD_RANK_QUERIES = 1;
+
+static RankEntry GradeBook_courseRank(GradeBook* book, size slot) {
+    Course* course = Arena_at(&book->courses, slot);
+    return (RankEntry){ .key = Course_averageGrade(book, course), .id = course->courseId, .slot = (uint32_t) slot };
+}
+
+static RankEntry GradeBook_studentRank(GradeBook* book, size slot) {
+    Student* student = Arena_at(&book->students, slot);
+    return (RankEntry){ .key = Student_averageGrade(book, student), .id = student->studentId, .slot = (uint32_t) slot };
+}
+
+/*
+ * Move a course or student whose average may have changed to its new place in the ranking, if the ranking is live
+ */
+static void GradeBook_rerankCourse(GradeBook* book, size slot) {
+    if(RankIndex_isLive(&book->courseRanks)) RankIndex_set(&book->courseRanks, GradeBook_courseRank(book, slot));
+}
+
+static void GradeBook_rerankStudent(GradeBook* book, size slot) {
+    if(RankIndex_isLive(&book->studentRanks)) RankIndex_set(&book->studentRanks, GradeBook_studentRank(book, slot));
+}
+
+static size GradeBook_rank(GradeBook* book, RankIndex* ranks, const IdIndexEntry* order, size count,
+                           RankEntry (*rankOf)(GradeBook*, size), size k, bool highest, RankEntry* destination) {
+
+    if(!RankIndex_isLive(ranks) && ranks->coldQueries++ >= _GB_COLD_RANK_QUERIES) {
+        RankIndex_open(ranks);
+        for(size idx = 0; idx < count; ++idx) RankIndex_set(ranks, rankOf(book, order[idx].slot));
     }
 
-    Student_removeCourse(student, course);
+    if(RankIndex_isLive(ranks)) return RankIndex_top(ranks, k, highest, destination);
+
+    RankSelection selection;
+    RankSelection_init(&selection, destination, k, highest);
 
-    return false;
+    for(size idx = 0; idx < count; ++idx) RankSelection_offer(&selection, rankOf(book, order[idx].slot));
+
+    return RankSelection_finish(&selection);
 }
 
-// GradeBook -----------------------------------------------------------------------------------------------------------
+size GradeBook_rankCourses(GradeBook* book, size k, bool highest, RankEntry* destination) {
+    return GradeBook_rank(book, &book->courseRanks, book->courseOrder, book->coursesCount, &GradeBook_courseRank,
+                          k, highest, destination);
+}
 
-const char* GradeBook_stringFormat = "GradeBook{ .courses[%02u], .students[%03u] }";
+size GradeBook_rankStudents(GradeBook* book, size k, bool highest, RankEntry* destination) {
+    return GradeBook_rank(book, &book->studentRanks, book->studentOrder, book->studentsCount, &GradeBook_studentRank,
+                          k, highest, destination);
+}
 
-char* GradeBook_toString(GradeBook* book) {
-    if(!book) return "(GradeBook)null";
-    char* nameFormatted[strlen(Student_stringFormat)];
-    sprintf(nameFormatted, GradeBook_stringFormat, book->coursesCount, book->studentsCount);
+// -- Roster Sets ------------------------------------------------------------------------------------------------------
 
-    return nameFormatted;
+/*
+ * Make sure the course in `slot` has a member set, zeroing any new ones
+ */
+static void GradeBook_reserveMembers(GradeBook* book, size slot) {
+    if(slot < book->courseMembersCapacity) return;
+
+    size capacity = book->courseMembersCapacity ? book->courseMembersCapacity : 1;
+    while(capacity <= slot) capacity *= 2;
+
+    SlotSet* members = Pool_resize(&book->pool, book->courseMembers, book->courseMembersCapacity * sizeof(SlotSet),
+                                   capacity * sizeof(SlotSet));
+
+    if(!members) {
+        fprintf(stderr, "GradeBook: unable to keep members of %lu courses\n", capacity);
+        abort();
+    }
+
+    memset(&members[book->courseMembersCapacity], 0, (capacity - book->courseMembersCapacity) * sizeof(SlotSet));
+
+    book->courseMembers         = members;
+    book->courseMembersCapacity = capacity;
 }
 
-// -- Course Management ------------------------------------------------------------------------------------------------
+static void GradeBook_joinMembers(GradeBook* book, size courseSlot, size studentSlot) {
+    if(!book->courseMembers) return;
 
-void GradeBook_sortCourses(GradeBook* book) {
-    qsort(book->courses, book->coursesCount, sizeof(Course), &Course_compareById);
+    GradeBook_reserveMembers(book, courseSlot);
+    SlotSet_add(&book->pool, &book->courseMembers[courseSlot], (uint32_t) studentSlot);
 }
 
-size GradeBook_addCourse(GradeBook* book, Course course) {
-    book->courses[book->coursesCount++] = course;
-    GradeBook_sortCourses(book);
-    return book->coursesCount;
+/*
+ * A course's set is left empty when its last student leaves, so a course that reuses the slot starts with no members
+ */
+static void GradeBook_leaveMembers(GradeBook* book, size courseSlot, size studentSlot) {
+    if(!book->courseMembers) return;
+
+    SlotSet_remove(&book->pool, &book->courseMembers[courseSlot], (uint32_t) studentSlot);
 }
 
-size GradeBook_removeCourse(GradeBook* book, Course* course) {
-    // Lovely O(N)+ search oh my
-    char* cname = Course_toString(course);
-    for(size idx = 0; idx < book->coursesCount; ++idx) {
-        if(Course_compareById(course, &book->courses[idx]) == 0) {
-            return GradeBook_removeCourseIndex(book, idx);
+/*
+ * Make sure the member sets of `a` and `b` can be read, building every set from the enrollment table first if they are
+ * cold. Either set may move when the other is reserved, so neither is returned.
+ */
+static void GradeBook_openMembers(GradeBook* book, Course* a, Course* b) {
+    if(!book->courseMembers) {
+        GradeBook_reserveMembers(book, book->courses.slotsCount);
+
+        for(size slot = 0; slot < book->enrollments.slotsCount; ++slot) {
+            StudentEnrollment* enrollment = Arena_at(&book->enrollments, slot);
+            if(Handle_isNull(enrollment->student)) continue;
+
+            GradeBook_joinMembers(book, enrollment->course.slot, enrollment->student.slot);
         }
     }
-    return book->coursesCount;
+
+    GradeBook_reserveMembers(book, a->self.slot > b->self.slot ? a->self.slot : b->self.slot);
 }
 
-size GradeBook_removeCourseIndex(GradeBook* book, size index) {
-    if(index == book->coursesCount - 1){
-        --book->coursesCount;
-    } else if(index < book->coursesCount) {
-        Course* replacement = &book->courses[book->coursesCount - 2];
+static int GradeBook_compareStudentPointers(const void* a, const void* b) {
+    return Student_compareById(*(Student* const*) a, *(Student* const*) b);
+}
 
-        --book->coursesCount;
+/*
+ * Turn `count` student slots in to students, in studentId order
+ */
+static size GradeBook_studentsOf(GradeBook* book, const uint32_t* slots, size count, Student** destination) {
+    for(size idx = 0; idx < count; ++idx) destination[idx] = Arena_at(&book->students, slots[idx]);
 
-        memmove(&book->courses[index], replacement, sizeof(Course));
+    qsort(destination, count, sizeof(Student*), &GradeBook_compareStudentPointers);
 
-        GradeBook_sortCourses(book);
-    }
-    return book->coursesCount;
+    return count;
 }
 
+size Course_commonStudentsCount(GradeBook* book, Course* a, Course* b) {
+    GradeBook_openMembers(book, a, b);
+    return SlotSet_intersectionCount(&book->courseMembers[a->self.slot], &book->courseMembers[b->self.slot]);
+}
 
-bool Course_isValidId(long number) {
-    return (number >= BYTE_MIN) && (number <= BYTE_MAX);
+/*
+ * Run a set operation between the members of `a` and `b`, for which `a`'s members are always enough room
+ */
+static size GradeBook_combineMembers(GradeBook* book, Course* a, Course* b, Student** destination,
+                                     size (*operation)(const SlotSet*, const SlotSet*, uint32_t*)) {
+    GradeBook_openMembers(book, a, b);
+
+    const SlotSet* membersA = &book->courseMembers[a->self.slot];
+    const SlotSet* membersB = &book->courseMembers[b->self.slot];
+
+    if(membersA->count == 0) return 0;
+
+    uint32_t* slots = Pool_alloc(&book->pool, membersA->count * sizeof(uint32_t));
+
+    if(!slots) {
+        fprintf(stderr, "GradeBook: unable to compare rosters of %lu students\n", membersA->count);
+        abort();
+    }
+
+    size count = GradeBook_studentsOf(book, slots, operation(membersA, membersB, slots), destination);
+
+    Pool_release(&book->pool, slots, membersA->count * sizeof(uint32_t));
+
+    return count;
 }
 
-// -- Student Management -----------------------------------------------------------------------------------------------
+size Course_commonStudents(GradeBook* book, Course* a, Course* b, Student** destination) {
+    // The result fits in the smaller course, and so does the scratch space
+    if(b->studentsCount < a->studentsCount) {
+        Course* swap = a;
+        a = b;
+        b = swap;
+    }
 
-void GradeBook_sortStudents(GradeBook* book) {
-    qsort(book->students, book->studentsCount, sizeof(Student), &Student_compareById);
+    return GradeBook_combineMembers(book, a, b, destination, &SlotSet_intersection);
 }
 
-size GradeBook_addStudent(GradeBook* book, Student student) {
-    book->students[book->studentsCount++] = student;
-    GradeBook_sortStudents(book);
-    return book->studentsCount;
+size Course_exclusiveStudents(GradeBook* book, Course* a, Course* b, Student** destination) {
+    return GradeBook_combineMembers(book, a, b, destination, &SlotSet_difference);
 }
 
-size GradeBook_removeStudent(GradeBook* book, Student* student) {
-    for(size idx = 0; idx < book->studentsCount; ++idx) {
-        if(Student_compareById(student, &book->students[idx]) == 0) {
-            return GradeBook_removeStudentIndex(book, idx);
+// -- Grading Policies -------------------------------------------------------------------------------------------------
+
+void Course_setPolicy(GradeBook* book, Course* course, const GradingPlan* plan) {
+    size slot = course->self.slot;
+
+    if(!plan) {
+        if(slot < book->coursePlansCapacity) book->coursePlans[slot].categoriesCount = 0;
+        return;
+    }
+
+    if(slot >= book->coursePlansCapacity) {
+        size capacity = book->coursePlansCapacity ? book->coursePlansCapacity : 1;
+        while(capacity <= slot) capacity *= 2;
+
+        GradingPlan* plans = Pool_resize(&book->pool, book->coursePlans,
+                                         book->coursePlansCapacity * sizeof(GradingPlan), capacity * sizeof(GradingPlan));
+
+        if(!plans) {
+            fprintf(stderr, "GradeBook: unable to keep grading plans of %lu courses\n", capacity);
+            abort();
         }
+
+        for(size idx = book->coursePlansCapacity; idx < capacity; ++idx) plans[idx].categoriesCount = 0;
+
+        book->coursePlans           = plans;
+        book->coursePlansCapacity   = capacity;
     }
-    return book->studentsCount;
+
+    book->coursePlans[slot] = *plan;
 }
 
-size GradeBook_removeStudentIndex(GradeBook* book, size index) {
-    if(index < book->studentsCount) {
-        Student* original = &book->students[index];
-        size nCourses = Student_coursesCount(original);
-        for(size idx = 0; idx < nCourses; ++idx) {
-            Course_remStudent(original->courses[idx].course, original);
+const GradingPlan* Course_policy(GradeBook* book, Course* course) {
+    size slot = course->self.slot;
+    bool graded = slot < book->coursePlansCapacity && book->coursePlans[slot].categoriesCount > 0;
+    return graded ? &book->coursePlans[slot] : NULL;
+}
+
+// -- Enrollment Table -------------------------------------------------------------------------------------------------
+
+/*
+ * Rebuild rosters and transcripts from the enrollment table.
+ *
+ * Both indexes are filled by counting sort, which takes four linear passes and no comparisons:
+ * 1. count the enrollments of every course and every student, and turn the counts in to row offsets
+ * 2. bucket the enrollments by course, in table order
+ * 3. walk courses in courseId order, bucketing each of their enrollments by student, so transcripts come out sorted
+ *    by courseId
+ * 4. walk students in studentId order, bucketing each of their enrollments by course, so rosters come out sorted
+ *    by studentId
+ */
+static void GradeBook_indexEnrollments(GradeBook* book) {
+
+    size nCourseRows    = book->courses.slotsCount;
+    size nStudentRows   = book->students.slotsCount;
+    size nEdges         = book->enrollmentPairs.count;
+
+    EdgeRows_reset(&book->rosters, nCourseRows, nEdges);
+    EdgeRows_reset(&book->transcripts, nStudentRows, nEdges);
+
+    uint32_t* rosterOffsets     = book->rosters.offsets;
+    uint32_t* transcriptOffsets = book->transcripts.offsets;
+
+    // Pass 1 - counts are stored one row late, so that the prefix sum leaves the start of each row in offsets[row]
+    for(size slot = 0; slot < book->enrollments.slotsCount; ++slot) {
+        StudentEnrollment* enrollment = Arena_at(&book->enrollments, slot);
+        if(Handle_isNull(enrollment->student)) continue;
+
+        ++rosterOffsets[enrollment->course.slot + 1];
+        ++transcriptOffsets[enrollment->student.slot + 1];
+    }
+
+    for(size row = 0; row < nCourseRows; ++row) rosterOffsets[row + 1] += rosterOffsets[row];
+    for(size row = 0; row < nStudentRows; ++row) transcriptOffsets[row + 1] += transcriptOffsets[row];
+
+    size nCursors       = (nCourseRows > nStudentRows ? nCourseRows : nStudentRows) + 1;
+    uint32_t* cursors   = Pool_alloc(&book->pool, nCursors * sizeof(uint32_t));
+
+    if(!cursors) {
+        fprintf(stderr, "GradeBook: unable to index %lu enrollments\n", nEdges);
+        abort();
+    }
+
+    // Pass 2
+    memcpy(cursors, rosterOffsets, nCourseRows * sizeof(uint32_t));
+
+    for(size slot = 0; slot < book->enrollments.slotsCount; ++slot) {
+        StudentEnrollment* enrollment = Arena_at(&book->enrollments, slot);
+        if(Handle_isNull(enrollment->student)) continue;
+
+        book->rosters.edges[cursors[enrollment->course.slot]++] = (uint32_t) slot;
+    }
+
+    // Pass 3
+    memcpy(cursors, transcriptOffsets, nStudentRows * sizeof(uint32_t));
+
+    for(size idx = 0; idx < book->coursesCount; ++idx) {
+        size row = book->courseOrder[idx].slot;
+
+        for(size edge = rosterOffsets[row]; edge < rosterOffsets[row + 1]; ++edge) {
+            StudentEnrollment* enrollment = Arena_at(&book->enrollments, book->rosters.edges[edge]);
+            book->transcripts.edges[cursors[enrollment->student.slot]++] = book->rosters.edges[edge];
         }
-        Student* replacement = &book->students[--book->studentsCount];
-        memmove(&book->students[index], replacement, sizeof(Student));
-        memset(&book->students[book->studentsCount], 0, sizeof(Student));
-        GradeBook_sortStudents(book);
     }
-    return book->studentsCount;
+
+    // Pass 4
+    memcpy(cursors, rosterOffsets, nCourseRows * sizeof(uint32_t));
+
+    for(size idx = 0; idx < book->studentsCount; ++idx) {
+        size row = book->studentOrder[idx].slot;
+
+        for(size edge = transcriptOffsets[row]; edge < transcriptOffsets[row + 1]; ++edge) {
+            StudentEnrollment* enrollment = Arena_at(&book->enrollments, book->transcripts.edges[edge]);
+            book->rosters.edges[cursors[enrollment->course.slot]++] = book->transcripts.edges[edge];
+        }
+    }
+
+    Pool_release(&book->pool, cursors, nCursors * sizeof(uint32_t));
+
+    book->enrollmentsDirty = false;
 }
 
-bool Student_isValidId(long number) {
-    return (number >= BYTE_MIN) && (number <= BYTE_MAX);
+/*
+ * Return the roster of `course` as enrollment slots, rebuilding the index first if it is stale
+ */
+static const uint32_t* GradeBook_roster(GradeBook* book, Course* course, size* count) {
+    if(book->enrollmentsDirty) GradeBook_indexEnrollments(book);
+    return EdgeRows_row(&book->rosters, course->self.slot, count);
+}
+
+/*
+ * Return the transcript of `student` as enrollment slots, rebuilding the index first if it is stale
+ */
+static const uint32_t* GradeBook_transcript(GradeBook* book, Student* student, size* count) {
+    if(book->enrollmentsDirty) GradeBook_indexEnrollments(book);
+    return EdgeRows_row(&book->transcripts, student->self.slot, count);
+}
+
+void GradeBook_settle(GradeBook* book) {
+    if(book->enrollmentsDirty) GradeBook_indexEnrollments(book);
+}
+
+size Course_studentsCount(Course* course) {
+    return course->studentsCount;
+}
+
+size Student_coursesCount(Student* student) {
+    return student->coursesCount;
+}
+
+StudentEnrollment* Course_enrollmentAt(GradeBook* book, Course* course, size index) {
+    size count;
+    const uint32_t* roster = GradeBook_roster(book, course, &count);
+    return index < count ? Arena_at(&book->enrollments, roster[index]) : NULL;
+}
+
+StudentEnrollment* Student_enrollmentAt(GradeBook* book, Student* student, size index) {
+    size count;
+    const uint32_t* transcript = GradeBook_transcript(book, student, &count);
+    return index < count ? Arena_at(&book->enrollments, transcript[index]) : NULL;
+}
+
+StudentEnrollment* GradeBook_findEnrollment(GradeBook* book, Student* student, Course* course) {
+    long slot = EdgeIndex_find(&book->enrollmentPairs, student->self.slot, course->self.slot);
+    return slot < 0 ? NULL : Arena_at(&book->enrollments, (size) slot);
+}
+
+bool Course_addStudent(GradeBook* book, Course* course, Student* student) {
+
+    if(EdgeIndex_find(&book->enrollmentPairs, student->self.slot, course->self.slot) >= 0) return false;
+
+    StudentEnrollment enrollment = {
+            .student    = student->self,
+            .course     = course->self,
+            .summary    = GradeSummary_EMPTY
+    };
+
+    size slot = Arena_push(&book->enrollments, &enrollment);
+    EdgeIndex_insert(&book->enrollmentPairs, student->self.slot, course->self.slot, slot);
+
+    ++course->studentsCount;
+    ++student->coursesCount;
+
+    GradeBook_joinMembers(book, course->self.slot, student->self.slot);
+
+    book->enrollmentsDirty = true;
+
+    // An enrollment with no grades yet still counts towards both averages
+    GradeBook_rerankCourse(book, course->self.slot);
+    GradeBook_rerankStudent(book, student->self.slot);
+
+    return true;
+}
+
+/*
+ * Remove the enrollment at `slot` from the table. Rosters and transcripts are left as they are until they are next
+ * read, so that a caller may keep walking a row while dropping its enrollments.
+ */
+static void GradeBook_dropEnrollment(GradeBook* book, size slot) {
+    StudentEnrollment* enrollment = Arena_at(&book->enrollments, slot);
+
+    --((Course*) Arena_at(&book->courses, enrollment->course.slot))->studentsCount;
+    --((Student*) Arena_at(&book->students, enrollment->student.slot))->coursesCount;
+
+    EdgeIndex_remove(&book->enrollmentPairs, enrollment->student.slot, enrollment->course.slot);
+    GradeBook_leaveMembers(book, enrollment->course.slot, enrollment->student.slot);
+    GradeBook_clearGrades(book, enrollment);
+    Arena_release(&book->enrollments, slot);
+
+    book->enrollmentsDirty = true;
+}
+
+bool Course_remStudentIndex(GradeBook* book, Course* course, size index) {
+    size count;
+    const uint32_t* roster = GradeBook_roster(book, course, &count);
+
+    if(index >= count) return false;
+
+    GradeBook_dropEnrollment(book, roster[index]);
+
+    return true;
+}
+
+bool Course_remStudent(GradeBook* book, Course* course, Student* student) {
+    long slot = EdgeIndex_find(&book->enrollmentPairs, student->self.slot, course->self.slot);
+
+    if(slot < 0) return false;
+
+    GradeBook_dropEnrollment(book, (size) slot);
+
+    return true;
+}
+
+// -- Grades -----------------------------------------------------------------------------------------------------------
+
+/*
+ * Fold a change in one enrollment in to the totals of its student or course. `added` and `removed` are the grades the
+ * enrollment has gained and lost, and the averages are those of the enrollment before and after the change.
+ */
+static void GradeAggregate_update(GradeAggregate* aggregate, GradeSummary added, GradeSummary removed,
+                                  double averageBefore, double averageAfter) {
+
+    GradeSummary_merge(&aggregate->grades, added);
+
+    aggregate->grades.sum      -= removed.sum;
+    aggregate->grades.count    -= removed.count;
+    aggregate->averagesSum     += averageAfter - averageBefore;
+
+    if(aggregate->grades.count == 0) {
+        // Nothing left to be wrong about, which also stops the sum of averages from drifting
+        aggregate->grades       = GradeSummary_EMPTY;
+        aggregate->averagesSum  = 0;
+        aggregate->boundsStale  = false;
+    } else if(removed.count > 0
+              && (removed.smallest <= aggregate->grades.smallest || removed.largest >= aggregate->grades.largest)) {
+        aggregate->boundsStale  = true;
+    }
+}
+
+/*
+ * Update the totals of the student and course of an enrollment whose grades have just changed. A record left with no
+ * grades gives its histogram back.
+ */
+static void GradeBook_updateAggregates(GradeBook* book, StudentEnrollment* enrollment, GradeSummary added,
+                                       GradeSummary removed, double averageBefore) {
+
+    double averageAfter = GradeSummary_average(enrollment->summary);
+
+    Course* course      = Arena_at(&book->courses, enrollment->course.slot);
+    Student* student    = Arena_at(&book->students, enrollment->student.slot);
+
+    GradeAggregate_update(&course->aggregate, added, removed, averageBefore, averageAfter);
+    GradeAggregate_update(&student->aggregate, added, removed, averageBefore, averageAfter);
+
+    if(course->aggregate.grades.count == 0) Histogram_release(&book->histograms, &course->histogram);
+    if(student->aggregate.grades.count == 0) Histogram_release(&book->histograms, &student->histogram);
+
+    GradeBook_rerankCourse(book, enrollment->course.slot);
+    GradeBook_rerankStudent(book, enrollment->student.slot);
+}
+
+void GradeBook_addGrade(GradeBook* book, StudentEnrollment* enrollment, grade value) {
+
+    GradeSummary added      = { .sum = value, .count = 1, .smallest = value, .largest = value };
+    double averageBefore    = GradeSummary_average(enrollment->summary);
+
+    GradeLog_append(&book->gradeChunks, &enrollment->grades, value);
+    GradeSummary_merge(&enrollment->summary, added);
+
+    Histogram_add(&book->histograms, &((Course*) Arena_at(&book->courses, enrollment->course.slot))->histogram, value);
+    Histogram_add(&book->histograms, &((Student*) Arena_at(&book->students, enrollment->student.slot))->histogram, value);
+
+    GradeBook_updateAggregates(book, enrollment, added, GradeSummary_EMPTY, averageBefore);
+}
+
+bool GradeBook_removeGrade(GradeBook* book, StudentEnrollment* enrollment, size index) {
+
+    if(index >= enrollment->grades.count) return false;
+
+    grade value             = GradeLog_at(&book->gradeChunks, &enrollment->grades, index);
+    GradeSummary removed    = { .sum = value, .count = 1, .smallest = value, .largest = value };
+    double averageBefore    = GradeSummary_average(enrollment->summary);
+
+    GradeLog_remove(&book->gradeChunks, &enrollment->grades, index);
+
+    Histogram_remove(&book->histograms, &((Course*) Arena_at(&book->courses, enrollment->course.slot))->histogram, value);
+    Histogram_remove(&book->histograms, &((Student*) Arena_at(&book->students, enrollment->student.slot))->histogram, value);
+
+    /*
+     * Removing a grade already moves every grade after it, so narrowing the enrollment's own bounds straight away
+     * costs no more than that
+     */
+    if(value == enrollment->summary.smallest || value == enrollment->summary.largest) {
+        enrollment->summary = GradeLog_summarize(&book->gradeChunks, &enrollment->grades);
+    } else {
+        enrollment->summary.sum    -= value;
+        enrollment->summary.count  -= 1;
+    }
+
+    GradeBook_updateAggregates(book, enrollment, GradeSummary_EMPTY, removed, averageBefore);
+
+    return true;
+}
+
+void GradeBook_clearGrades(GradeBook* book, StudentEnrollment* enrollment) {
+
+    GradeSummary removed    = enrollment->summary;
+    double averageBefore    = GradeSummary_average(enrollment->summary);
+
+    if(removed.count > 0) {
+        uint32_t counts[GradeHistogram_BUCKETS] = {};
+        GradeLog_tally(&book->gradeChunks, &enrollment->grades, counts);
+
+        Histogram_subtract(&book->histograms, &((Course*) Arena_at(&book->courses, enrollment->course.slot))->histogram, counts);
+        Histogram_subtract(&book->histograms, &((Student*) Arena_at(&book->students, enrollment->student.slot))->histogram, counts);
+    }
+
+    GradeLog_clear(&book->gradeChunks, &enrollment->grades);
+    enrollment->summary     = GradeSummary_EMPTY;
+
+    GradeBook_updateAggregates(book, enrollment, GradeSummary_EMPTY, removed, averageBefore);
+}
+
+size GradeBook_curveCourse(GradeBook* book, Course* course, const GradeCurve* curve) {
+
+    size count;
+    const uint32_t* roster = GradeBook_roster(book, course, &count);
+
+    size total = 0;
+    for(size idx = 0; idx < count; ++idx) {
+        total += ((StudentEnrollment*) Arena_at(&book->enrollments, roster[idx]))->grades.count;
+    }
+
+    if(total == 0) return 0;
+
+    // The grades before the curve, then after it
+    grade* before = Pool_alloc(&book->pool, 2 * total * sizeof(grade));
+
+    if(!before) {
+        fprintf(stderr, "GradeBook: unable to curve %lu grades\n", total);
+        abort();
+    }
+
+    grade* after = before + total;
+    size offset  = 0;
+
+    for(size idx = 0; idx < count; ++idx) {
+        offset += GradeLog_copy(&book->gradeChunks, &((StudentEnrollment*) Arena_at(&book->enrollments, roster[idx]))->grades,
+                                before + offset);
+    }
+
+    uint32_t counts[GradeHistogram_BUCKETS] = {};
+    for(size idx = 0; idx < total; ++idx) ++counts[before[idx]];
+
+    grade table[GradeHistogram_BUCKETS];
+    GradeCurve_table(curve, table);
+
+    const GradeKernels* kernels = GradeKernels_select();
+
+    memcpy(after, before, total * sizeof(grade));
+    kernels->curve(curve, after, total);
+
+    offset = 0;
+    for(size idx = 0; idx < count; ++idx) {
+        StudentEnrollment* enrollment   = Arena_at(&book->enrollments, roster[idx]);
+        HistogramRef* histogram         = &((Student*) Arena_at(&book->students, enrollment->student.slot))->histogram;
+        size run                        = enrollment->grades.count;
+
+        if(run == 0) continue;
+
+        GradeLog_overwrite(&book->gradeChunks, &enrollment->grades, after + offset);
+
+        /*
+         * A student has a few grades in each course, so moving them one by one costs less than remapping every bucket.
+         * All are taken out before any goes back, so that a narrow histogram is never widened by a passing count.
+         */
+        for(size position = offset; position < offset + run; ++position) {
+            Histogram_remove(&book->histograms, histogram, before[position]);
+        }
+
+        for(size position = offset; position < offset + run; ++position) {
+            Histogram_add(&book->histograms, histogram, after[position]);
+        }
+
+        GradeSummary removed    = enrollment->summary;
+        double averageBefore    = GradeSummary_average(removed);
+        enrollment->summary     = kernels->summarize(after + offset, run);
+
+        GradeBook_updateAggregates(book, enrollment, enrollment->summary, removed, averageBefore);
+
+        offset += run;
+    }
+
+    Histogram_remap(&book->histograms, &course->histogram, counts, table);
+
+    Pool_release(&book->pool, before, 2 * total * sizeof(grade));
+
+    return total;
+}
+
+GradeSummary Course_gradeSummary(GradeBook* book, Course* course) {
+
+    if(course->aggregate.boundsStale) {
+        size count;
+        const uint32_t* roster = GradeBook_roster(book, course, &count);
+        GradeSummary bounds = GradeSummary_EMPTY;
+
+        for(size idx = 0; idx < count; ++idx) {
+            GradeSummary_merge(&bounds, ((StudentEnrollment*) Arena_at(&book->enrollments, roster[idx]))->summary);
+        }
+
+        course->aggregate.grades.smallest   = bounds.smallest;
+        course->aggregate.grades.largest    = bounds.largest;
+        course->aggregate.boundsStale       = false;
+    }
+
+    return course->aggregate.grades;
+}
+
+GradeSummary Student_gradeSummary(GradeBook* book, Student* student) {
+
+    if(student->aggregate.boundsStale) {
+        size count;
+        const uint32_t* transcript = GradeBook_transcript(book, student, &count);
+        GradeSummary bounds = GradeSummary_EMPTY;
+
+        for(size idx = 0; idx < count; ++idx) {
+            GradeSummary_merge(&bounds, ((StudentEnrollment*) Arena_at(&book->enrollments, transcript[idx]))->summary);
+        }
+
+        student->aggregate.grades.smallest  = bounds.smallest;
+        student->aggregate.grades.largest   = bounds.largest;
+        student->aggregate.boundsStale      = false;
+    }
+
+    return student->aggregate.grades;
+}
+
+void Course_gradeDistribution(GradeBook* book, Course* course, GradeDistribution* distribution) {
+    Histogram_read(&book->histograms, course->histogram, distribution);
+}
+
+void Student_gradeDistribution(GradeBook* book, Student* student, GradeDistribution* distribution) {
+    Histogram_read(&book->histograms, student->histogram, distribution);
+}
+
+/*
+ * Set up the bookkeeping of a course that has just been copied in to `slot`. A new course has no enrollments, whatever
+ * the copied record said, and its name is moved in to the name pool.
+ */
+static void GradeBook_adoptCourse(GradeBook* book, size slot) {
+    Course* course          = Arena_at(&book->courses, slot);
+    course->self            = Arena_handle(&book->courses, slot);
+    course->studentsCount   = 0;
+    course->courseName      = GradeBook_internName(book, course->courseName);
+    course->aggregate       = (GradeAggregate){ .grades = GradeSummary_EMPTY };
+    course->histogram       = 0;
+    GradeBook_rerankCourse(book, slot);
+
+    // The slot may have held a course with a policy
+    if(slot < book->coursePlansCapacity) book->coursePlans[slot].categoriesCount = 0;
+}
+
+static void GradeBook_adoptStudent(GradeBook* book, size slot) {
+    Student* student        = Arena_at(&book->students, slot);
+    student->self           = Arena_handle(&book->students, slot);
+    student->coursesCount   = 0;
+    student->studentName    = GradeBook_internName(book, student->studentName);
+    student->aggregate      = (GradeAggregate){ .grades = GradeSummary_EMPTY };
+    student->histogram      = 0;
+    GradeBook_rerankStudent(book, slot);
+}
+
+// -- Course Management ------------------------------------------------------------------------------------------------
+
+size GradeBook_addCourse(GradeBook* book, Course course) {
+    if(IdIndex_find(&book->courseIds, course.courseId) >= 0) return book->coursesCount;
+
+    Order_reserve(&book->pool, &book->courseOrder, &book->courseOrderCapacity, book->coursesCount + 1);
+
+    size slot = Arena_push(&book->courses, &course);
+    IdIndex_insert(&book->courseIds, course.courseId, slot);
+    GradeBook_adoptCourse(book, slot);
+
+    Order_insert(book->courseOrder, book->coursesCount++, (IdIndexEntry){ .id = course.courseId, .slot = slot });
+
+    return book->coursesCount;
+}
+
+size GradeBook_bulkAddCourses(GradeBook* book, const Course* courses, size count) {
+    size sortedCount = book->coursesCount;
+
+    Order_reserve(&book->pool, &book->courseOrder, &book->courseOrderCapacity, book->coursesCount + count);
+
+    for(size idx = 0; idx < count; ++idx) {
+        if(IdIndex_find(&book->courseIds, courses[idx].courseId) >= 0) continue;
+
+        size slot = Arena_push(&book->courses, &courses[idx]);
+        IdIndex_insert(&book->courseIds, courses[idx].courseId, slot);
+        GradeBook_adoptCourse(book, slot);
+
+        book->courseOrder[book->coursesCount++] = (IdIndexEntry){ .id = courses[idx].courseId, .slot = slot };
+    }
+
+    Order_mergeTail(&book->pool, book->courseOrder, sortedCount, book->coursesCount);
+
+    return book->coursesCount;
+}
+
+size GradeBook_removeCourse(GradeBook* book, Course* course) {
+    long index = Order_find(book->courseOrder, book->coursesCount, course->courseId);
+    return index < 0 ? book->coursesCount : GradeBook_removeCourseIndex(book, (size) index);
+}
+
+size GradeBook_removeCourseIndex(GradeBook* book, size index) {
+    if(index < book->coursesCount) {
+        size slot       = book->courseOrder[index].slot;
+        Course* course  = Arena_at(&book->courses, slot);
+
+        // Disenroll everybody first, so that no enrollment keeps a handle to a released slot
+        size nStudents;
+        const uint32_t* roster = GradeBook_roster(book, course, &nStudents);
+
+        for(size idx = 0; idx < nStudents; ++idx) {
+            GradeBook_dropEnrollment(book, roster[idx]);
+        }
+
+        --book->coursesCount;
+        memmove(&book->courseOrder[index], &book->courseOrder[index + 1], (book->coursesCount - index) * sizeof(IdIndexEntry));
+
+        IdIndex_remove(&book->courseIds, course->courseId);
+        RankIndex_remove(&book->courseRanks, slot);
+        Arena_release(&book->courses, slot);
+    }
+    return book->coursesCount;
+}
+
+
+bool Course_isValidId(long number) {
+    return (number >= ID_MIN) && (number <= (long) ID_MAX);
+}
+
+// -- Student Management -----------------------------------------------------------------------------------------------
+
+size GradeBook_addStudent(GradeBook* book, Student student) {
+    if(IdIndex_find(&book->studentIds, student.studentId) >= 0) return book->studentsCount;
+
+    Order_reserve(&book->pool, &book->studentOrder, &book->studentOrderCapacity, book->studentsCount + 1);
+
+    size slot = Arena_push(&book->students, &student);
+    IdIndex_insert(&book->studentIds, student.studentId, slot);
+    GradeBook_adoptStudent(book, slot);
+
+    Order_insert(book->studentOrder, book->studentsCount++, (IdIndexEntry){ .id = student.studentId, .slot = slot });
+
+    return book->studentsCount;
+}
+
+size GradeBook_bulkAddStudents(GradeBook* book, const Student* students, size count) {
+    size sortedCount = book->studentsCount;
+
+    Order_reserve(&book->pool, &book->studentOrder, &book->studentOrderCapacity, book->studentsCount + count);
+
+    for(size idx = 0; idx < count; ++idx) {
+        if(IdIndex_find(&book->studentIds, students[idx].studentId) >= 0) continue;
+
+        size slot = Arena_push(&book->students, &students[idx]);
+        IdIndex_insert(&book->studentIds, students[idx].studentId, slot);
+        GradeBook_adoptStudent(book, slot);
+
+        book->studentOrder[book->studentsCount++] = (IdIndexEntry){ .id = students[idx].studentId, .slot = slot };
+    }
+
+    Order_mergeTail(&book->pool, book->studentOrder, sortedCount, book->studentsCount);
+
+    return book->studentsCount;
+}
+
+size GradeBook_removeStudent(GradeBook* book, Student* student) {
+    long index = Order_find(book->studentOrder, book->studentsCount, student->studentId);
+    return index < 0 ? book->studentsCount : GradeBook_removeStudentIndex(book, (size) index);
+}
+
+size GradeBook_removeStudentIndex(GradeBook* book, size index) {
+    if(index < book->studentsCount) {
+        size slot           = book->studentOrder[index].slot;
+        Student* original   = Arena_at(&book->students, slot);
+
+        size nCourses;
+        const uint32_t* transcript = GradeBook_transcript(book, original, &nCourses);
+
+        for(size idx = 0; idx < nCourses; ++idx) {
+            GradeBook_dropEnrollment(book, transcript[idx]);
+        }
+
+        --book->studentsCount;
+        memmove(&book->studentOrder[index], &book->studentOrder[index + 1], (book->studentsCount - index) * sizeof(IdIndexEntry));
+
+        IdIndex_remove(&book->studentIds, original->studentId);
+        RankIndex_remove(&book->studentRanks, slot);
+        Arena_release(&book->students, slot);
+    }
+    return book->studentsCount;
+}
+
+bool Student_isValidId(long number) {
+    return (number >= ID_MIN) && (number <= (long) ID_MAX);
+}
+
+// -- Transactions -----------------------------------------------------------------------------------------------------
+
+static const size _GB_TRANSACTION_INITIAL_CAPACITY = 64;
+
+bool GradeBook_begin(GradeBook* book) {
+    if(book->transaction.open) return false;
+
+    book->transaction.open      = true;
+    book->transaction.opsCount  = 0;
+    book->transaction.failedAt  = 0;
+
+    return true;
+}
+
+static bool GradeBook_queue(GradeBook* book, TransactionOp op) {
+    Transaction* transaction = &book->transaction;
+
+    if(!transaction->open) return false;
+
+    if(transaction->opsCount == transaction->opsCapacity) {
+        size capacity       = transaction->opsCapacity ? transaction->opsCapacity * 2 : _GB_TRANSACTION_INITIAL_CAPACITY;
+        TransactionOp* ops  = Pool_resize(&book->pool, transaction->ops, transaction->opsCapacity * sizeof(TransactionOp),
+                                          capacity * sizeof(TransactionOp));
+
+        if(!ops) {
+            fprintf(stderr, "GradeBook: unable to queue %lu changes\n", capacity);
+            abort();
+        }
+
+        transaction->ops            = ops;
+        transaction->opsCapacity    = capacity;
+    }
+
+    transaction->ops[transaction->opsCount++] = op;
+
+    return true;
+}
+
+/*
+ * Release the queue, and close the transaction
+ */
+static void GradeBook_endTransaction(GradeBook* book) {
+    Pool_release(&book->pool, book->transaction.ops, book->transaction.opsCapacity * sizeof(TransactionOp));
+
+    book->transaction.ops           = NULL;
+    book->transaction.opsCount      = 0;
+    book->transaction.opsCapacity   = 0;
+    book->transaction.open          = false;
+}
+
+bool GradeBook_queueAddCourse(GradeBook* book, Course course) {
+    if(!book->transaction.open) return false;
+
+    return GradeBook_queue(book, (TransactionOp){
+            .kind       = TXN_ADD_COURSE,
+            .courseId   = course.courseId,
+            .name       = GradeBook_internName(book, course.courseName)
+    });
+}
+
+bool GradeBook_queueRemoveCourse(GradeBook* book, identifier courseId) {
+    return GradeBook_queue(book, (TransactionOp){ .kind = TXN_REMOVE_COURSE, .courseId = courseId });
+}
+
+bool GradeBook_queueAddStudent(GradeBook* book, Student student) {
+    if(!book->transaction.open) return false;
+
+    return GradeBook_queue(book, (TransactionOp){
+            .kind       = TXN_ADD_STUDENT,
+            .studentId  = student.studentId,
+            .name       = GradeBook_internName(book, student.studentName)
+    });
+}
+
+bool GradeBook_queueRemoveStudent(GradeBook* book, identifier studentId) {
+    return GradeBook_queue(book, (TransactionOp){ .kind = TXN_REMOVE_STUDENT, .studentId = studentId });
+}
+
+bool GradeBook_queueEnroll(GradeBook* book, identifier studentId, identifier courseId) {
+    return GradeBook_queue(book, (TransactionOp){ .kind = TXN_ENROLL, .studentId = studentId, .courseId = courseId });
+}
+
+bool GradeBook_queueDisenroll(GradeBook* book, identifier studentId, identifier courseId) {
+    return GradeBook_queue(book, (TransactionOp){ .kind = TXN_DISENROLL, .studentId = studentId, .courseId = courseId });
+}
+
+bool GradeBook_queueGrade(GradeBook* book, identifier studentId, identifier courseId, grade value) {
+    return GradeBook_queue(book, (TransactionOp){
+            .kind       = TXN_ADD_GRADE,
+            .studentId  = studentId,
+            .courseId   = courseId,
+            .value      = value
+    });
+}
+
+void GradeBook_rollback(GradeBook* book) {
+    GradeBook_endTransaction(book);
+}
+
+/*
+ * A commit first plays the queue against a record of what it has changed so far, without touching the GradeBook.
+ *
+ * The state of each course and student ID the queue has touched is kept in an IdIndex, in place of a slot: the lowest
+ * bit is set while a record with the ID is present, and the remaining bits count how many times one has been removed.
+ * An ID the queue has not touched is present if it is present in the GradeBook, and has never been removed.
+ *
+ * Removing a record removes its enrollments, so each enrollment the queue has touched remembers the removal counts of
+ * its student and course at the time. Once either has moved on, the enrollment belonged to a removed record, and no
+ * longer counts.
+ */
+typedef struct S_TransactionPair {
+
+    uint32_t studentRemovals;
+
+    uint32_t courseRemovals;
+
+    bool enrolled;
+
+} TransactionPair;
+
+typedef struct S_TransactionCheck {
+
+    GradeBook* book;
+
+    IdIndex courses;
+
+    IdIndex students;
+
+    /*
+     * Maps (studentId, courseId) to a position in `pairs`
+     */
+    EdgeIndex pairIndex;
+
+    TransactionPair* pairs;
+
+    size pairsCount;
+
+    size pairsCapacity;
+
+} TransactionCheck;
+
+static uint32_t TransactionCheck_state(const IdIndex* touched, const IdIndex* present, identifier id) {
+    long state = IdIndex_find(touched, id);
+    return state >= 0 ? (uint32_t) state : (IdIndex_find(present, id) >= 0 ? 1 : 0);
+}
+
+static void TransactionCheck_setState(IdIndex* touched, identifier id, uint32_t state) {
+    IdIndex_remove(touched, id);
+    IdIndex_insert(touched, id, state);
+}
+
+static bool TransactionCheck_isEnrolled(TransactionCheck* check, identifier studentId, identifier courseId) {
+    uint32_t studentState   = TransactionCheck_state(&check->students, &check->book->studentIds, studentId);
+    uint32_t courseState    = TransactionCheck_state(&check->courses, &check->book->courseIds, courseId);
+    long pair               = EdgeIndex_find(&check->pairIndex, studentId, courseId);
+
+    if(pair >= 0) {
+        return check->pairs[pair].enrolled
+               && check->pairs[pair].studentRemovals == studentState >> 1
+               && check->pairs[pair].courseRemovals == courseState >> 1;
+    }
+
+    // Untouched, so only an enrollment between two records that were in the GradeBook all along can exist
+    if(studentState != 1 || courseState != 1) return false;
+
+    Student* student    = GradeBook_findStudent(check->book, studentId);
+    Course* course      = GradeBook_findCourse(check->book, courseId);
+
+    return student && course && GradeBook_findEnrollment(check->book, student, course);
+}
+
+static void TransactionCheck_setEnrolled(TransactionCheck* check, identifier studentId, identifier courseId, bool enrolled) {
+    long pair = EdgeIndex_find(&check->pairIndex, studentId, courseId);
+
+    if(pair < 0) {
+        if(check->pairsCount == check->pairsCapacity) {
+            size capacity = check->pairsCapacity ? check->pairsCapacity * 2 : _GB_TRANSACTION_INITIAL_CAPACITY;
+            TransactionPair* pairs = Pool_resize(&check->book->pool, check->pairs,
+                                                 check->pairsCapacity * sizeof(TransactionPair),
+                                                 capacity * sizeof(TransactionPair));
+
+            if(!pairs) {
+                fprintf(stderr, "GradeBook: unable to check %lu enrollments\n", capacity);
+                abort();
+            }
+
+            check->pairs            = pairs;
+            check->pairsCapacity    = capacity;
+        }
+
+        pair = (long) check->pairsCount++;
+        EdgeIndex_insert(&check->pairIndex, studentId, courseId, (size) pair);
+    }
+
+    check->pairs[pair] = (TransactionPair){
+            .studentRemovals    = TransactionCheck_state(&check->students, &check->book->studentIds, studentId) >> 1,
+            .courseRemovals     = TransactionCheck_state(&check->courses, &check->book->courseIds, courseId) >> 1,
+            .enrolled           = enrolled
+    };
+}
+
+/*
+ * Check a single queued change, and record its effect
+ */
+static TransactionStatus TransactionCheck_apply(TransactionCheck* check, const TransactionOp* op) {
+    GradeBook* book         = check->book;
+    uint32_t courseState    = TransactionCheck_state(&check->courses, &book->courseIds, op->courseId);
+    uint32_t studentState   = TransactionCheck_state(&check->students, &book->studentIds, op->studentId);
+
+    switch(op->kind) {
+        case TXN_ADD_COURSE:
+            if(courseState & 1) return TXN_DUPLICATE_COURSE;
+            TransactionCheck_setState(&check->courses, op->courseId, courseState | 1);
+            return TXN_COMMITTED;
+        case TXN_REMOVE_COURSE:
+            if(!(courseState & 1)) return TXN_MISSING_COURSE;
+            TransactionCheck_setState(&check->courses, op->courseId, courseState + 1);
+            return TXN_COMMITTED;
+        case TXN_ADD_STUDENT:
+            if(studentState & 1) return TXN_DUPLICATE_STUDENT;
+            TransactionCheck_setState(&check->students, op->studentId, studentState | 1);
+            return TXN_COMMITTED;
+        case TXN_REMOVE_STUDENT:
+            if(!(studentState & 1)) return TXN_MISSING_STUDENT;
+            TransactionCheck_setState(&check->students, op->studentId, studentState + 1);
+            return TXN_COMMITTED;
+        default:
+            break;
+    }
+
+    // Enrollment changes
+    if(!(studentState & 1)) return TXN_MISSING_STUDENT;
+    if(!(courseState & 1)) return TXN_MISSING_COURSE;
+
+    bool enrolled = TransactionCheck_isEnrolled(check, op->studentId, op->courseId);
+
+    switch(op->kind) {
+        case TXN_ENROLL:
+            if(enrolled) return TXN_ALREADY_ENROLLED;
+            TransactionCheck_setEnrolled(check, op->studentId, op->courseId, true);
+            return TXN_COMMITTED;
+        case TXN_DISENROLL:
+            if(!enrolled) return TXN_NOT_ENROLLED;
+            TransactionCheck_setEnrolled(check, op->studentId, op->courseId, false);
+            return TXN_COMMITTED;
+        default:
+            return enrolled ? TXN_COMMITTED : TXN_NOT_ENROLLED;
+    }
+}
+
+/*
+ * Play the whole queue, stopping at the first change that would fail. Counts the records the queue adds.
+ */
+static TransactionStatus GradeBook_checkTransaction(GradeBook* book, size* coursesAdded, size* studentsAdded) {
+    TransactionCheck check = { .book = book };
+    TransactionStatus status = TXN_COMMITTED;
+
+    IdIndex_init(&check.courses, &book->pool);
+    IdIndex_init(&check.students, &book->pool);
+    EdgeIndex_init(&check.pairIndex, &book->pool);
+
+    for(size idx = 0; idx < book->transaction.opsCount && status == TXN_COMMITTED; ++idx) {
+        status = TransactionCheck_apply(&check, &book->transaction.ops[idx]);
+
+        if(status != TXN_COMMITTED) book->transaction.failedAt = idx;
+
+        *coursesAdded   += book->transaction.ops[idx].kind == TXN_ADD_COURSE;
+        *studentsAdded  += book->transaction.ops[idx].kind == TXN_ADD_STUDENT;
+    }
+
+    IdIndex_free(&check.courses);
+    IdIndex_free(&check.students);
+    EdgeIndex_free(&check.pairIndex);
+    Pool_release(&book->pool, check.pairs, check.pairsCapacity * sizeof(TransactionPair));
+
+    return status;
+}
+
+/*
+ * Bring an order index whose first `sortedCount` entries are sorted, and whose remaining entries were appended by a
+ * commit, back in to order. Entries of records that the commit removed no longer match the ID index; their records are
+ * released, and the entries dropped. Returns the number of entries left.
+ */
+static size GradeBook_settleOrder(GradeBook* book, Arena* arena, const IdIndex* ids, RankIndex* ranks,
+                                  IdIndexEntry* order, size sortedCount, size count, bool removed) {
+    if(removed) {
+        size kept = 0, keptSorted = 0;
+
+        for(size idx = 0; idx < count; ++idx) {
+            if(idx == sortedCount) keptSorted = kept;
+
+            if(IdIndex_find(ids, order[idx].id) != (long) order[idx].slot) {
+                RankIndex_remove(ranks, order[idx].slot);
+                Arena_release(arena, order[idx].slot);
+            } else {
+                order[kept++] = order[idx];
+            }
+        }
+
+        if(sortedCount == count) keptSorted = kept;
+
+        sortedCount = keptSorted;
+        count       = kept;
+    }
+
+    Order_mergeTail(&book->pool, order, sortedCount, count);
+
+    return count;
+}
+
+TransactionStatus GradeBook_commit(GradeBook* book) {
+
+    if(!book->transaction.open) return TXN_NOT_OPEN;
+
+    size coursesAdded = 0, studentsAdded = 0;
+    TransactionStatus status = GradeBook_checkTransaction(book, &coursesAdded, &studentsAdded);
+
+    if(status != TXN_COMMITTED) {
+        d_printf("Transaction: change %lu of %lu failed (%d), nothing was applied\n",
+                 book->transaction.failedAt, book->transaction.opsCount, status);
+        GradeBook_endTransaction(book);
+        return status;
+    }
+
+    Order_reserve(&book->pool, &book->courseOrder, &book->courseOrderCapacity, book->coursesCount + coursesAdded);
+    Order_reserve(&book->pool, &book->studentOrder, &book->studentOrderCapacity, book->studentsCount + studentsAdded);
+
+    size sortedCourses  = book->coursesCount;
+    size sortedStudents = book->studentsCount;
+    bool coursesRemoved = false, studentsRemoved = false;
+
+    /*
+     * Added records are appended to the order indexes, to be sorted at the end. Removed records only leave the ID
+     * index, and keep their slots until the end, so that no slot is reused, and no enrollment or order entry can be
+     * mistaken for one belonging to a newer record.
+     */
+    for(size idx = 0; idx < book->transaction.opsCount; ++idx) {
+        TransactionOp* op = &book->transaction.ops[idx];
+        Course* course;
+        Student* student;
+
+        switch(op->kind) {
+            case TXN_ADD_COURSE: {
+                size slot = Arena_push(&book->courses, &(Course){ .courseId = op->courseId, .courseName = op->name });
+                IdIndex_insert(&book->courseIds, op->courseId, slot);
+                GradeBook_adoptCourse(book, slot);
+                book->courseOrder[book->coursesCount++] = (IdIndexEntry){ .id = op->courseId, .slot = slot };
+                break;
+            }
+            case TXN_REMOVE_COURSE:
+                IdIndex_remove(&book->courseIds, op->courseId);
+                coursesRemoved = true;
+                break;
+            case TXN_ADD_STUDENT: {
+                size slot = Arena_push(&book->students, &(Student){ .studentId = op->studentId, .studentName = op->name });
+                IdIndex_insert(&book->studentIds, op->studentId, slot);
+                GradeBook_adoptStudent(book, slot);
+                book->studentOrder[book->studentsCount++] = (IdIndexEntry){ .id = op->studentId, .slot = slot };
+                break;
+            }
+            case TXN_REMOVE_STUDENT:
+                IdIndex_remove(&book->studentIds, op->studentId);
+                studentsRemoved = true;
+                break;
+            case TXN_ENROLL:
+                Course_addStudent(book, GradeBook_findCourse(book, op->courseId), GradeBook_findStudent(book, op->studentId));
+                break;
+            case TXN_DISENROLL:
+                Course_remStudent(book, GradeBook_findCourse(book, op->courseId), GradeBook_findStudent(book, op->studentId));
+                break;
+            case TXN_ADD_GRADE:
+                course  = GradeBook_findCourse(book, op->courseId);
+                student = GradeBook_findStudent(book, op->studentId);
+                GradeBook_addGrade(book, GradeBook_findEnrollment(book, student, course), op->value);
+                break;
+        }
+    }
+
+    // Drop the enrollments of removed records, while the records can still be read
+    if(coursesRemoved || studentsRemoved) {
+        for(size slot = 0; slot < book->enrollments.slotsCount; ++slot) {
+            StudentEnrollment* enrollment = Arena_at(&book->enrollments, slot);
+            if(Handle_isNull(enrollment->student)) continue;
+
+            Course* course      = Arena_at(&book->courses, enrollment->course.slot);
+            Student* student    = Arena_at(&book->students, enrollment->student.slot);
+
+            if(IdIndex_find(&book->courseIds, course->courseId) != (long) enrollment->course.slot
+               || IdIndex_find(&book->studentIds, student->studentId) != (long) enrollment->student.slot) {
+                GradeBook_dropEnrollment(book, slot);
+            }
+        }
+    }
+
+    book->coursesCount  = GradeBook_settleOrder(book, &book->courses, &book->courseIds, &book->courseRanks,
+                                                book->courseOrder, sortedCourses, book->coursesCount, coursesRemoved);
+    book->studentsCount = GradeBook_settleOrder(book, &book->students, &book->studentIds, &book->studentRanks,
+                                                book->studentOrder, sortedStudents, book->studentsCount,
+                                                studentsRemoved);
+
+    GradeBook_endTransaction(book);
+
+    return TXN_COMMITTED;
+}
+
+// -- Invariants -------------------------------------------------------------------------------------------------------
+
+static bool GradeBook_sameSummary(GradeSummary a, GradeSummary b) {
+    return a.sum == b.sum && a.count == b.count && a.smallest == b.smallest && a.largest == b.largest;
+}
+
+/*
+ * Compare running totals with totals recomputed from scratch. Stale bounds need only hold the real ones, and the sum
+ * of averages, which is updated in floating point, need only be close.
+ */
+static bool GradeAggregate_agrees(const GradeAggregate* running, const GradeAggregate* recomputed) {
+    const GradeSummary* kept = &running->grades, * real = &recomputed->grades;
+
+    if(kept->sum != real->sum || kept->count != real->count) return false;
+
+    if(running->boundsStale ? (kept->smallest > real->smallest || kept->largest < real->largest)
+                            : (kept->smallest != real->smallest || kept->largest != real->largest)) return false;
+
+    double drift = running->averagesSum - recomputed->averagesSum;
+
+    return drift < 1e-6 * (1 + real->count) && -drift < 1e-6 * (1 + real->count);
+}
+
+/*
+ * Compare a histogram with the running totals of its record, which are themselves checked against the grade logs
+ */
+static bool GradeBook_histogramAgrees(GradeBook* book, HistogramRef histogram, const GradeAggregate* aggregate) {
+    GradeDistribution distribution;
+    Histogram_read(&book->histograms, histogram, &distribution);
+
+    long sum = 0;
+    GradeSummary bounds = GradeSummary_EMPTY;
+
+    for(size bucket = 0; bucket < GradeHistogram_BUCKETS; ++bucket) {
+        if(!distribution.counts[bucket]) continue;
+
+        sum += (long) bucket * distribution.counts[bucket];
+        GradeSummary_merge(&bounds, (GradeSummary){ .smallest = (grade) bucket, .largest = (grade) bucket });
+    }
+
+    if(distribution.count != aggregate->grades.count || sum != aggregate->grades.sum) return false;
+    if((histogram == 0) != (aggregate->grades.count == 0)) return false;
+
+    return aggregate->boundsStale
+           || (bounds.smallest == aggregate->grades.smallest && bounds.largest == aggregate->grades.largest);
+}
+
+/*
+ * Whether a live rank index holds `expected` as it stands. A cold index holds nothing, and agrees with everything.
+ */
+static bool GradeBook_rankAgrees(const RankIndex* ranks, RankEntry expected) {
+    RankEntry ranked;
+
+    if(!RankIndex_isLive(ranks)) return true;
+
+    return RankIndex_find(ranks, expected.slot, &ranked) && ranked.key == expected.key && ranked.id == expected.id;
+}
+
+bool GradeBook_checkInvariants(GradeBook* book) {
+
+    if(!GB_DEBUG) return true;
+
+    bool valid = true;
+
+    size* courseTally   = calloc(book->courses.slotsCount + 1, sizeof(size));
+    size* studentTally  = calloc(book->students.slotsCount + 1, sizeof(size));
+
+    // Running grade totals of every record, recomputed from the grade logs
+    GradeAggregate* courseTotals    = calloc(book->courses.slotsCount + 1, sizeof(GradeAggregate));
+    GradeAggregate* studentTotals   = calloc(book->students.slotsCount + 1, sizeof(GradeAggregate));
+
+    if(!courseTally || !studentTally || !courseTotals || !studentTotals) {
+        d_printf("Invariants: not enough memory to check\n");
+        free(courseTally);
+        free(studentTally);
+        free(courseTotals);
+        free(studentTotals);
+        return true;
+    }
+
+    for(size slot = 0; slot <= book->courses.slotsCount; ++slot) courseTotals[slot].grades = GradeSummary_EMPTY;
+    for(size slot = 0; slot <= book->students.slotsCount; ++slot) studentTotals[slot].grades = GradeSummary_EMPTY;
+
+    // Every live enrollment joins two live records, and is the one the pair index maps them to
+    size nEnrollments   = 0;
+    size nGradeChunks   = 0;
+
+    for(size slot = 0; slot < book->enrollments.slotsCount; ++slot) {
+        StudentEnrollment* enrollment = Arena_at(&book->enrollments, slot);
+        if(Handle_isNull(enrollment->student)) continue;
+
+        ++nEnrollments;
+        nGradeChunks += (enrollment->grades.count + GradeLog_CHUNK_GRADES - 1) / GradeLog_CHUNK_GRADES;
+
+        if(!GradeBook_resolveCourse(book, enrollment->course) || !GradeBook_resolveStudent(book, enrollment->student)) {
+            d_printf("Invariants: enrollment %lu refers to a removed course or student\n", slot);
+            valid = false;
+            continue;
+        }
+
+        if(EdgeIndex_find(&book->enrollmentPairs, enrollment->student.slot, enrollment->course.slot) != (long) slot) {
+            d_printf("Invariants: enrollment %lu is not in the pair index\n", slot);
+            valid = false;
+        }
+
+        if(book->courseMembers && (enrollment->course.slot >= book->courseMembersCapacity
+           || !SlotSet_contains(&book->courseMembers[enrollment->course.slot], enrollment->student.slot))) {
+            d_printf("Invariants: enrollment %lu is not in its course's member set\n", slot);
+            valid = false;
+        }
+
+        ++courseTally[enrollment->course.slot];
+        ++studentTally[enrollment->student.slot];
+
+        GradeSummary summary = GradeLog_summarize(&book->gradeChunks, &enrollment->grades);
+
+        if(!GradeBook_sameSummary(summary, enrollment->summary)) {
+            d_printf("Invariants: enrollment %lu sums to %ld over %lu grades, but has %ld over %lu\n",
+                     slot, enrollment->summary.sum, enrollment->summary.count, summary.sum, summary.count);
+            valid = false;
+        }
+
+        GradeSummary_merge(&courseTotals[enrollment->course.slot].grades, summary);
+        GradeSummary_merge(&studentTotals[enrollment->student.slot].grades, summary);
+        courseTotals[enrollment->course.slot].averagesSum     += GradeSummary_average(summary);
+        studentTotals[enrollment->student.slot].averagesSum   += GradeSummary_average(summary);
+    }
+
+    if(nEnrollments != book->enrollmentPairs.count) {
+        d_printf("Invariants: %lu enrollments, but %lu indexed pairs\n", nEnrollments, book->enrollmentPairs.count);
+        valid = false;
+    }
+
+    // Every grade chunk in use belongs to exactly one log
+    if(nGradeChunks != book->gradeChunks.slotsCount - book->gradeChunks.freeCount) {
+        d_printf("Invariants: grade logs hold %lu chunks, but %lu are in use\n",
+                nGradeChunks, book->gradeChunks.slotsCount - book->gradeChunks.freeCount);
+        valid = false;
+    }
+
+    // Every course is in order, indexed under its own ID, and caches the number of enrollments it really has
+    if(book->courseIds.count != book->coursesCount) {
+        d_printf("Invariants: %lu courses, but %lu indexed course ID's\n", book->coursesCount, book->courseIds.count);
+        valid = false;
+    }
+
+    if(RankIndex_isLive(&book->courseRanks) && book->courseRanks.count != book->coursesCount) {
+        d_printf("Invariants: %lu courses, but %lu ranked\n", book->coursesCount, book->courseRanks.count);
+        valid = false;
+    }
+
+    for(size idx = 0; idx < book->coursesCount; ++idx) {
+        IdIndexEntry entry  = book->courseOrder[idx];
+        Course* course      = Arena_at(&book->courses, entry.slot);
+
+        if(idx > 0 && book->courseOrder[idx - 1].id >= entry.id) {
+            d_printf("Invariants: course order is broken at %lu\n", idx);
+            valid = false;
+        }
+
+        if(course->courseId != entry.id || !Handle_equals(course->self, Arena_handle(&book->courses, entry.slot))
+           || IdIndex_find(&book->courseIds, entry.id) != (long) entry.slot) {
+            d_printf("Invariants: course %u is not indexed at slot %u\n", entry.id, entry.slot);
+            valid = false;
+        }
+
+        if(course->studentsCount != courseTally[entry.slot]) {
+            d_printf("Invariants: course %u counts %lu students, but has %lu enrollments\n",
+                     entry.id, course->studentsCount, courseTally[entry.slot]);
+            valid = false;
+        }
+
+        if(!GradeAggregate_agrees(&course->aggregate, &courseTotals[entry.slot])) {
+            d_printf("Invariants: course %u has running totals that disagree with its grades\n", entry.id);
+            valid = false;
+        }
+
+        if(!GradeBook_histogramAgrees(book, course->histogram, &course->aggregate)) {
+            d_printf("Invariants: course %u has a histogram that disagrees with its grades\n", entry.id);
+            valid = false;
+        }
+
+        if(!GradeBook_rankAgrees(&book->courseRanks, GradeBook_courseRank(book, entry.slot))) {
+            d_printf("Invariants: course %u is ranked out of place\n", entry.id);
+            valid = false;
+        }
+
+        // Every enrollment is a member, so a set of the right size holds nobody else
+        if(book->courseMembers && entry.slot < book->courseMembersCapacity
+           && book->courseMembers[entry.slot].count != course->studentsCount) {
+            d_printf("Invariants: course %u has %lu members, but %lu students\n",
+                     entry.id, book->courseMembers[entry.slot].count, course->studentsCount);
+            valid = false;
+        }
+
+        if(!book->enrollmentsDirty) {
+            size rosterLength;
+            EdgeRows_row(&book->rosters, entry.slot, &rosterLength);
+
+            if(rosterLength != course->studentsCount) {
+                d_printf("Invariants: course %u has a roster of %lu students\n", entry.id, rosterLength);
+                valid = false;
+            }
+        }
+    }
+
+    // Likewise for students
+    if(book->studentIds.count != book->studentsCount) {
+        d_printf("Invariants: %lu students, but %lu indexed student ID's\n", book->studentsCount, book->studentIds.count);
+        valid = false;
+    }
+
+    if(RankIndex_isLive(&book->studentRanks) && book->studentRanks.count != book->studentsCount) {
+        d_printf("Invariants: %lu students, but %lu ranked\n", book->studentsCount, book->studentRanks.count);
+        valid = false;
+    }
+
+    for(size idx = 0; idx < book->studentsCount; ++idx) {
+        IdIndexEntry entry  = book->studentOrder[idx];
+        Student* student    = Arena_at(&book->students, entry.slot);
+
+        if(idx > 0 && book->studentOrder[idx - 1].id >= entry.id) {
+            d_printf("Invariants: student order is broken at %lu\n", idx);
+            valid = false;
+        }
+
+        if(student->studentId != entry.id || !Handle_equals(student->self, Arena_handle(&book->students, entry.slot))
+           || IdIndex_find(&book->studentIds, entry.id) != (long) entry.slot) {
+            d_printf("Invariants: student %u is not indexed at slot %u\n", entry.id, entry.slot);
+            valid = false;
+        }
+
+        if(student->coursesCount != studentTally[entry.slot]) {
+            d_printf("Invariants: student %u counts %lu courses, but has %lu enrollments\n",
+                     entry.id, student->coursesCount, studentTally[entry.slot]);
+            valid = false;
+        }
+
+        if(!GradeAggregate_agrees(&student->aggregate, &studentTotals[entry.slot])) {
+            d_printf("Invariants: student %u has running totals that disagree with its grades\n", entry.id);
+            valid = false;
+        }
+
+        if(!GradeBook_histogramAgrees(book, student->histogram, &student->aggregate)) {
+            d_printf("Invariants: student %u has a histogram that disagrees with its grades\n", entry.id);
+            valid = false;
+        }
+
+        if(!GradeBook_rankAgrees(&book->studentRanks, GradeBook_studentRank(book, entry.slot))) {
+            d_printf("Invariants: student %u is ranked out of place\n", entry.id);
+            valid = false;
+        }
+
+        if(!book->enrollmentsDirty) {
+            size transcriptLength;
+            EdgeRows_row(&book->transcripts, entry.slot, &transcriptLength);
+
+            if(transcriptLength != student->coursesCount) {
+                d_printf("Invariants: student %u has a transcript of %lu courses\n", entry.id, transcriptLength);
+                valid = false;
+            }
+        }
+    }
+
+    free(courseTally);
+    free(studentTally);
+    free(courseTotals);
+    free(studentTotals);
+
+    return valid;
 }
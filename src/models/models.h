@@ -18,24 +18,76 @@
 #ifndef _H_MODELS
     #define _H_MODELS
     #include "../util.h"
+    #include "pool.h"
+    #include "arena.h"
+    #include "id_index.h"
+    #include "edge_table.h"
+    #include "grade_log.h"
+    #include "grade_histogram.h"
+    #include "rank_index.h"
+    #include "slot_set.h"
+    #include "grading_plan.h"
+    #include "string_pool.h"
 
 // Begin Header "models" -----------------------------------------------------------------------------------------------
 
 
 /*
- * Define the type used for numeric grades
+ * Bounds of the type used for numeric grades (see `grade` in grade_kernels.h)
  */
-typedef byte grade;
 extern const grade MAX_GRADE;
 extern const grade MIN_GRADE;
 
+/*
+ * Longest student or course name a GradeBook keeps. Longer names are cut short when the record is added.
+ */
+extern const size MAX_NAME_LENGTH;
+
+/*
+ * Bounds of the type used for student and course ID's (see `identifier` in id_index.h)
+ */
+extern const identifier ID_MIN;
+extern const identifier ID_MAX;
+
 /*
  * In order to deal with the issue of circular dependency between student and course models,
  * declare an opaque student and course, and redefine them later.
  */
 typedef struct S_Student    Student;
 typedef struct S_Course     Course;
+typedef struct S_GradeBook  GradeBook;
 
+/*
+ * Courses and students refer to each other by handle (see arena.h). A handle is resolved against the GradeBook that
+ * holds the record with GradeBook_resolveCourse or GradeBook_resolveStudent.
+ */
+typedef Handle CourseHandle;
+typedef Handle StudentHandle;
+
+
+/*
+ * Running totals of the grades given in every enrollment of a course or student, kept up to date as grades are given
+ * and taken away, and as students are enrolled and disenrolled, so that averages never have to walk grades.
+ */
+typedef struct S_GradeAggregate {
+
+    /*
+     * Sum, count and bounds of every grade in the record's enrollments
+     */
+    GradeSummary grades;
+
+    /*
+     * Sum of the averages of the record's enrollments, an enrollment with no grades counting as 0
+     */
+    double averagesSum;
+
+    /*
+     * Set when the grade taken away was one of the bounds. The bounds are then only known to hold every grade, and are
+     * narrowed again the next time they are read (see Course_gradeSummary).
+     */
+    bool boundsStale;
+
+} GradeAggregate;
 
 // Course --------------------------------------------------------------------------------------------------------------
 
@@ -43,30 +95,54 @@ typedef struct S_Course     Course;
  * Course model.
  *
  * Declares members:
- * - students: Points to students
- * - courseId: Course number, 0-255
+ * - self: Handle of this course
+ * - studentsCount: Number of enrolled students
+ * - courseId: Course number, [ID_MIN, ID_MAX]
+ * - histogram: Distribution of the course's grades
  * - courseName: Course name, 16 characters max
+ * - aggregate: Running totals of the course's grades
+ *
+ * Only the fields read when sorting, searching and walking courses are held in the record. The name is cold, and lives
+ * in the GradeBook's name pool.
  */
 typedef struct S_Course {
 
     /**
-    * Array of student pointers.
-    * Serialization procedure behaves in the same manner as does that of courses[4] in student
+    * Handle of this course, set when the course is added to a GradeBook
     */
-    Student* students[20];
+    CourseHandle self;
+
+    /**
+    * Number of students enrolled in this course. Maintained by Course_addStudent and Course_remStudent(Index), and
+    * always equal to the length of the course's roster.
+    */
+    size studentsCount;
 
     /**
     * Describes the course ID
-    * Once again, a range of [0, 255] which exceeds the 25 course limit by far.
+    * A range of [0, 255], or [0, 2^32 - 1] when built with _GB_WIDE_IDS.
+    */
+    identifier courseId;
+
+    /**
+    * Histogram of every grade given in this course, in the GradeBook's histogram pool
     */
-    byte courseId;
+    HistogramRef histogram;
 
     /**
     * Describes the course name
     * The course name should not reasonably exceed 16 characters, if it should be in the format of a college course
     * name, such as 'CSCE 1040' (8 Characters).
+    *
+    * Any string may be given when adding a course; the GradeBook keeps its own copy, interned in its name pool, and
+    * points the stored record at that.
     */
-    char courseName[255];
+    const char* courseName;
+
+    /**
+    * Running totals of the grades given in this course
+    */
+    GradeAggregate aggregate;
 
 } Course;
 
@@ -82,11 +158,18 @@ size Course_studentsCount(Course* course);
  */
 int Course_compareById(const void *a, const void *b);
 
-bool Course_addStudent(Course* course, Student* student);
+/*
+ * Enroll a student in a course. Both must belong to `book`.
+ * Returns false if the student is already enrolled.
+ */
+bool Course_addStudent(GradeBook* book, Course* course, Student* student);
 
-bool Course_remStudentIndex(Course* course, size index);
+/*
+ * Disenroll the student at `index` of the course roster (see Course_enrollmentAt).
+ */
+bool Course_remStudentIndex(GradeBook* book, Course* course, size index);
 
-bool Course_remStudent(Course* course, Student* student);
+bool Course_remStudent(GradeBook* book, Course* course, Student* student);
 
 /*
  * String format of a course. Displays only course id, and course name.
@@ -105,13 +188,27 @@ bool Course_isValidId(long number);
 
 // Student -------------------------------------------------------------------------------------------------------------
 
+/*
+ * Enrollment of one student in one course, along with the grades the student has been given in it.
+ *
+ * Enrollments are the edges of the GradeBook's enrollment table. Neither Student nor Course holds a list of the other;
+ * rosters and transcripts are both read through the table (see Course_enrollmentAt, Student_enrollmentAt).
+ */
 typedef struct S_StudentEnrollment {
 
-    Course* course;
+    StudentHandle student;
 
-    grade grades[10];
+    CourseHandle course;
 
-    size gradeCount;
+    /*
+     * Every grade given in the course, oldest first. Chunks are held by the GradeBook's grade pool.
+     */
+    GradeLog grades;
+
+    /*
+     * Sum, count and bounds of `grades`, kept up to date by GradeBook_addGrade and GradeBook_removeGrade
+     */
+    GradeSummary summary;
 
 } StudentEnrollment;
 
@@ -119,37 +216,52 @@ typedef struct S_StudentEnrollment {
  * Student model.
  *
  * Declares members
- * - courses: Course*[4]
- * - grades: unsigned char[4][10]
- * - studentId: one-byte student ID
+ * - self: Handle of this student
+ * - coursesCount: Number of courses the student is enrolled in
+ * - studentId: student ID, one byte wide, or four with _GB_WIDE_IDS
+ * - histogram: Distribution of the student's grades
  * - studentName: student name, max 64 characters
+ * - aggregate: Running totals of the student's grades
+ *
+ * As with Course, the name is kept out of the record, in the GradeBook's name pool.
  */
 typedef struct S_Student {
 
-    /*
-     * For the sake of serialization, we need to assume a fixed size for each model.
-     * That being said, pointer size varies based on the processor architecture.
-     * Luckily, when serializing, we will not need to worry about storing pointers,
-     * as we can assume that for all intents and purposes, an 8-bit unsigned integer will be
-     * assigned to each course.
-     * I'll detail model serialization further in the serializer implementation.
-     * This makes the effective size of this member at serialization-time 32 bits, or 4 bytes.
-     */
-    StudentEnrollment courses[4];
+    /**
+    * Handle of this student, set when the student is added to a GradeBook
+    */
+    StudentHandle self;
+
+    /**
+    * Number of courses this student is enrolled in, maintained alongside Course.studentsCount
+    */
+    size coursesCount;
 
     /**
-    * 2-byte integer describes student ID.
-    * This gives the range of ID's [0, 255], which far exceeds the specifications.
+    * Integer describes student ID.
+    * This gives the range of ID's [0, 255], or [0, 2^32 - 1] when built with _GB_WIDE_IDS.
     *
     * This will be used to identify the student in the serialization process.
     */
-    byte studentId;
+    identifier studentId;
+
+    /**
+    * Histogram of every grade given to this student
+    */
+    HistogramRef histogram;
 
     /**
     * Allow for up to 64 characters in a student name.
     * This should be more than enough.
+    *
+    * Interned in the GradeBook's name pool when the student is added, as with Course.courseName.
     */
-    char studentName[255];
+    const char* studentName;
+
+    /**
+    * Running totals of the grades given to this student
+    */
+    GradeAggregate aggregate;
 
 } Student;
 
@@ -158,7 +270,7 @@ typedef struct S_Student {
 /*
  * Helper function for student that returns the amount of defined course references the student has
  */
-size Student_coursesCount(Student*);
+size Student_coursesCount(Student* student);
 
 /*
  * Function that, when called, returns a number representing difference between the studentId values of two students
@@ -176,19 +288,112 @@ extern const char* Student_stringFormat;
  */
 char* Student_toString(Student* student);
 
-long Student_courseIndex(Student* student, Course* course);
+
+bool Student_isValidId(long number);
+
+//#define Student_toString(student, string) sprintf(string, Student_stringFormat, student->studentId, student->studentName)
+
+// Transactions --------------------------------------------------------------------------------------------------------
 
 /*
- * These two functions should not be exposed to external callers, as they should be called by the Course_addStudent, and Course_removeStudent actions
- *
- * bool Student_removeCourse(Student* student, Course* course);
- *
- * bool Student_addCourse(Student* student, Course* course);
+ * Kinds of change that may be queued in a transaction (see GradeBook_begin)
  */
+typedef enum E_TransactionOpKind {
 
-bool Student_isValidId(long number);
+    TXN_ADD_COURSE      = 0x0,
+    TXN_REMOVE_COURSE   = 0x1,
+    TXN_ADD_STUDENT     = 0x2,
+    TXN_REMOVE_STUDENT  = 0x3,
+    TXN_ENROLL          = 0x4,
+    TXN_DISENROLL       = 0x5,
+    TXN_ADD_GRADE       = 0x6
 
-//#define Student_toString(student, string) sprintf(string, Student_stringFormat, student->studentId, student->studentName)
+} TransactionOpKind;
+
+/*
+ * One queued change. Records are named by ID, as a queued change may refer to a record that an earlier change in the
+ * same transaction adds.
+ */
+typedef struct S_TransactionOp {
+
+    TransactionOpKind kind;
+
+    identifier studentId;
+
+    identifier courseId;
+
+    /*
+     * Grade given by TXN_ADD_GRADE
+     */
+    grade value;
+
+    /*
+     * Name of the record added by TXN_ADD_COURSE or TXN_ADD_STUDENT, already interned in the GradeBook's name pool
+     */
+    const char* name;
+
+} TransactionOp;
+
+typedef enum E_TransactionStatus {
+
+    /*
+     * Every queued change was applied
+     */
+    TXN_COMMITTED           = 0,
+
+    /*
+     * GradeBook_commit was called without GradeBook_begin
+     */
+    TXN_NOT_OPEN            = 1,
+
+    /*
+     * A course or student was added with an ID that was already present at that point in the transaction
+     */
+    TXN_DUPLICATE_COURSE    = 2,
+
+    TXN_DUPLICATE_STUDENT   = 3,
+
+    /*
+     * A change referred to a course or student that was not present at that point in the transaction
+     */
+    TXN_MISSING_COURSE      = 4,
+
+    TXN_MISSING_STUDENT     = 5,
+
+    /*
+     * A student was enrolled in a course twice
+     */
+    TXN_ALREADY_ENROLLED    = 6,
+
+    /*
+     * A student was disenrolled from, or graded in, a course that they were not enrolled in
+     */
+    TXN_NOT_ENROLLED        = 7
+
+} TransactionStatus;
+
+/*
+ * Changes queued against a GradeBook, in the order they were queued
+ */
+typedef struct S_Transaction {
+
+    TransactionOp* ops;
+
+    size opsCount;
+
+    size opsCapacity;
+
+    /*
+     * Set by GradeBook_begin, and cleared by GradeBook_commit and GradeBook_rollback
+     */
+    bool open;
+
+    /*
+     * Position in the queue of the change that made the last commit fail
+     */
+    size failedAt;
+
+} Transaction;
 
 // GradeBook -----------------------------------------------------------------------------------------------------------
 
@@ -196,19 +401,46 @@ bool Student_isValidId(long number);
 * The GradeBook model is the "trunk" of the GradeBook data architecture, in that it stores the actual data inside the
 *   Course and Student models, while they simply reference each other.
 *
-* Due to the nature of C "arrays" and static allocation, the index also stores data about the number of
-*   Courses and Students inside of it.
+* Courses and Students are stored in chunked arenas (see arena.h), so the GradeBook only costs as much memory as it
+*   holds records, and a record never moves once it has been added. Courses and Students refer to each other by
+*   handle rather than by pointer; the only pointers held by a record are its name, in to the GradeBook's name pool,
+*   which GradeBook_clone re-interns in the copy.
+* Ordering is provided by a separate index of (ID, arena slot) entries, sorted by ID, which is what
+*   GradeBook_courseAt and GradeBook_studentAt walk. Adding or removing a record only ever moves these entries.
+*
+* Enrollments are kept in a table of their own, with no limit on how many students a course, or how many courses a
+*   student, may have. Adding or removing an enrollment is O(1); rosters and transcripts are compressed sparse row
+*   indexes over the table, which are rebuilt in one linear pass the first time they are read after a change.
+*
 * As such, it is recommended to use the GradeBook_add(_) and GradeBook_remove(_) functions to perform operations
 *   on actual data inside the GradeBook.
+*
+* Changes that come in large batches, such as a roster sync, should be queued in a transaction (GradeBook_begin)
+*   rather than made one at a time: a commit sorts each order index once, and checks every change before applying any.
+*
+* Every arena, index and name is allocated from the GradeBook's own Pool (see pool.h), which GradeBook_close
+*   releases as a whole. The pool's counters (pool.stats) show how often the GradeBook has had to call malloc.
+* A GradeBook must be prepared with GradeBook_init before use, and released with GradeBook_close. As its tables point
+*   at its pool, a GradeBook must not be moved or copied by value once it has been initialized; use GradeBook_clone.
 */
-typedef struct S_GradeBook {
+struct S_GradeBook {
+
+    /*
+     * Allocator for everything below
+     */
+    Pool pool;
+
+    /*
+     * Arena of Course records
+     */
+    Arena courses;
 
     /*
-     * Array of courses
-     *
-     * Size is 25 bytes at serialization
+     * (courseId, arena slot) of each course, sorted by courseId
      */
-    Course courses[25];
+    IdIndexEntry* courseOrder;
+
+    size courseOrderCapacity;
 
     /*
      * Tracks the number of courses present in the GradeBook.
@@ -216,26 +448,273 @@ typedef struct S_GradeBook {
     size coursesCount;
 
     /*
-     * Array of students
-     *
-     * Size is 100 bytes at serialization
+     * Maps courseId to arena slot
+     */
+    IdIndex courseIds;
+
+    /*
+     * Arena of Student records
      */
-    Student students[100];
+    Arena students;
+
+    /*
+     * (studentId, arena slot) of each student, sorted by studentId
+     */
+    IdIndexEntry* studentOrder;
+
+    size studentOrderCapacity;
 
     /*
      * Tracks the number of students present in the GradeBook.
      */
     size studentsCount;
 
-} GradeBook;
+    /*
+     * Maps studentId to arena slot
+     */
+    IdIndex studentIds;
+
+    /*
+     * Arena of StudentEnrollment records: the enrollment table
+     */
+    Arena enrollments;
+
+    /*
+     * Maps (student slot, course slot) to enrollment slot
+     */
+    EdgeIndex enrollmentPairs;
+
+    /*
+     * Enrollment slots of each course, by course slot, sorted by studentId
+     */
+    EdgeRows rosters;
+
+    /*
+     * Enrollment slots of each student, by student slot, sorted by courseId
+     */
+    EdgeRows transcripts;
+
+    /*
+     * Set when an enrollment is added or removed. Rosters and transcripts are rebuilt on their next use.
+     */
+    bool enrollmentsDirty;
+
+    /*
+     * Pool of GradeChunk records shared by the grade logs of every enrollment
+     */
+    Arena gradeChunks;
+
+    /*
+     * Interned names of every course and student. Names outlive the records that were removed, until GradeBook_close.
+     */
+    StringPool names;
+
+    /*
+     * Grade histograms of every course and student
+     */
+    HistogramPool histograms;
+
+    /*
+     * Courses and students by average grade. Cold until a second ranking query (see GradeBook_rankCourses).
+     */
+    RankIndex courseRanks;
+
+    RankIndex studentRanks;
+
+    /*
+     * Student slots enrolled in each course, by course slot, for set queries between rosters (see
+     * Course_commonStudents). NULL until the first such query.
+     */
+    SlotSet* courseMembers;
+
+    size courseMembersCapacity;
+
+    /*
+     * Grading plan of each course, by course slot (see Course_setPolicy). A plan with no categories, or a slot past the
+     * end, means the course is graded by plain average.
+     */
+    GradingPlan* coursePlans;
+
+    size coursePlansCapacity;
+
+    /*
+     * Changes queued since GradeBook_begin
+     */
+    Transaction transaction;
+
+};
 
 extern const char* GradeBook_stringFormat;
 
+/*
+ * Prepare an empty GradeBook. A zeroed GradeBook must be initialized before any other GradeBook_ function is called.
+ */
+void GradeBook_init(GradeBook* book);
+
+/*
+ * Release all courses and students held by the GradeBook. The GradeBook may be initialized again afterwards.
+ */
+void GradeBook_close(GradeBook* book);
+
+/*
+ * Make `destination` an independent copy of `source`. `destination` must not be initialized.
+ * Returns false, leaving `destination` initialized and empty, if memory could not be allocated.
+ */
+bool GradeBook_clone(GradeBook* destination, const GradeBook* source);
+
+/*
+ * Return the course referred to by `handle`, or NULL if that course has been removed
+ */
+Course* GradeBook_resolveCourse(GradeBook* book, CourseHandle handle);
+
+/*
+ * Return the student referred to by `handle`, or NULL if that student has been removed
+ */
+Student* GradeBook_resolveStudent(GradeBook* book, StudentHandle handle);
+
+/*
+ * Return the course at position `index` in courseId order
+ */
+Course* GradeBook_courseAt(GradeBook* book, size index);
+
+/*
+ * Return the student at position `index` in studentId order
+ */
+Student* GradeBook_studentAt(GradeBook* book, size index);
+
+/*
+ * Look up a course by courseId through the ID index. Returns NULL if no such course exists.
+ */
+Course* GradeBook_findCourse(GradeBook* book, identifier courseId);
+
+/*
+ * Look up a student by studentId through the ID index. Returns NULL if no such student exists.
+ */
+Student* GradeBook_findStudent(GradeBook* book, identifier studentId);
+
+/*
+ * Return the enrollment at `index` of the roster of `course`, in studentId order, or NULL
+ */
+StudentEnrollment* Course_enrollmentAt(GradeBook* book, Course* course, size index);
+
+/*
+ * Return the enrollment at `index` of the transcript of `student`, in courseId order, or NULL
+ */
+StudentEnrollment* Student_enrollmentAt(GradeBook* book, Student* student, size index);
+
+/*
+ * Return the enrollment of `student` in `course`, or NULL if the student is not enrolled
+ */
+StudentEnrollment* GradeBook_findEnrollment(GradeBook* book, Student* student, Course* course);
+
+/*
+ * Rebuild rosters and transcripts now, if they are stale, rather than on their next use.
+ * Until the GradeBook is next changed, the GradeBook_, Course_ and Student_ functions that only look records and
+ * enrollments up then write nothing, so a settled GradeBook may be read from several threads at once. The grade
+ * summaries are the exception: they narrow stale bounds in place.
+ */
+void GradeBook_settle(GradeBook* book);
+
+/*
+ * Append a grade to an enrollment, and add it to the running totals of the enrollment, its student and its course.
+ * Aborts if memory could not be allocated.
+ */
+void GradeBook_addGrade(GradeBook* book, StudentEnrollment* enrollment, grade value);
+
+/*
+ * Remove the grade at `index` of an enrollment, keeping the order of the others, and take it out of the running totals.
+ * Returns false if there is no such grade.
+ */
+bool GradeBook_removeGrade(GradeBook* book, StudentEnrollment* enrollment, size index);
+
+/*
+ * Remove every grade of an enrollment
+ */
+void GradeBook_clearGrades(GradeBook* book, StudentEnrollment* enrollment);
+
+/*
+ * Replace every grade given in a course with its value under `curve` (see grade_kernels.h), and return how many grades
+ * there were. Grades keep their order within each enrollment.
+ *
+ * The grades of the whole roster are gathered in to one buffer and curved in a single kernel pass; each enrollment's
+ * totals, and those of its student, are then updated once, and the histogram of the course remapped once.
+ * Aborts if memory could not be allocated.
+ */
+size GradeBook_curveCourse(GradeBook* book, Course* course, const GradeCurve* curve);
+
+/*
+ * Return the running totals of the grades given in a course, or to a student, narrowing the bounds first if they are
+ * stale. That takes one pass over the course's roster, or the student's transcript; everything else is read as-is.
+ */
+GradeSummary Course_gradeSummary(GradeBook* book, Course* course);
+
+GradeSummary Student_gradeSummary(GradeBook* book, Student* student);
+
+/*
+ * Expand the grade histogram of a course, or a student, in to `distribution`, for median, percentile, mode and
+ * standard deviation queries (see grade_histogram.h)
+ */
+void Course_gradeDistribution(GradeBook* book, Course* course, GradeDistribution* distribution);
+
+void Student_gradeDistribution(GradeBook* book, Student* student, GradeDistribution* distribution);
+
+/*
+ * Write the `k` courses, or students, with the highest averages (or the lowest, if `highest` is false) to
+ * `destination`, best first, with ties in ID order. Averages are those of Course_averageGrade and Student_averageGrade.
+ * Returns the number written, which is less than `k` if the GradeBook has fewer records.
+ *
+ * The first query of either kind is answered by a partial sort over every record, which costs about as much as building
+ * an index would. The second builds a rank index (see rank_index.h), which every change to a grade, an enrollment or a
+ * record keeps up to date from then on, and which answers every later query from the best end of the ranking.
+ */
+size GradeBook_rankCourses(GradeBook* book, size k, bool highest, RankEntry* destination);
+
+size GradeBook_rankStudents(GradeBook* book, size k, bool highest, RankEntry* destination);
+
+/*
+ * Number of students enrolled in both `a` and `b`
+ */
+size Course_commonStudentsCount(GradeBook* book, Course* a, Course* b);
+
+/*
+ * Write the students enrolled in both `a` and `b` to `destination`, in studentId order, and return how many there
+ * are. `destination` must have room for the students of the smaller course.
+ */
+size Course_commonStudents(GradeBook* book, Course* a, Course* b, Student** destination);
+
+/*
+ * Write the students enrolled in `a` but not in `b` to `destination`, in studentId order, and return how many there
+ * are. `destination` must have room for every student of `a`.
+ *
+ * These queries are answered from a set of student slots kept for every course (see slot_set.h), which is built from
+ * the enrollment table by the first of them, and kept up to date by every enrollment from then on.
+ */
+size Course_exclusiveStudents(GradeBook* book, Course* a, Course* b, Student** destination);
+
+/*
+ * Grade `course` by a compiled grading policy (see grading_plan.h and Course_policyScores), or by plain average again
+ * if `plan` is NULL. The plan is copied. Aborts if memory could not be allocated.
+ */
+void Course_setPolicy(GradeBook* book, Course* course, const GradingPlan* plan);
+
+/*
+ * Return the grading plan of `course`, or NULL if it is graded by plain average
+ */
+const GradingPlan* Course_policy(GradeBook* book, Course* course);
+
 /*
  * Add a course to the GradeBook, and update necessary metadata. Return the next available index.
+ * A course whose courseId is already present is not added.
  */
 size GradeBook_addCourse(GradeBook* book, Course course);
 
+/*
+ * Add `count` courses at once, sorting the order index only once all of them have been placed.
+ * Courses whose courseId is already present, including earlier in `courses`, are skipped.
+ * Returns the number of courses in the GradeBook.
+ */
+size GradeBook_bulkAddCourses(GradeBook* book, const Course* courses, size count);
+
 /*
  * Search for and remove a course, returns the next available index.
  */
@@ -248,9 +727,17 @@ size GradeBook_removeCourseIndex(GradeBook* book, size index);
 
 /*
  * Add a student to the GradeBook and update necessary metadata. Return the next available index.
+ * A student whose studentId is already present is not added.
  */
 size GradeBook_addStudent(GradeBook* book, Student student);
 
+/*
+ * Add `count` students at once, sorting the order index only once all of them have been placed.
+ * Students whose studentId is already present, including earlier in `students`, are skipped.
+ * Returns the number of students in the GradeBook.
+ */
+size GradeBook_bulkAddStudents(GradeBook* book, const Student* students, size count);
+
 /*
  * Remove a student by reference, and update data.
  */
@@ -263,6 +750,60 @@ size GradeBook_removeStudentIndex(GradeBook* book, size index);
 
 char* GradeBook_toString(GradeBook* book);
 
+// -- Transactions -----------------------------------------------------------------------------------------------------
+
+/*
+ * Open a transaction. Changes queued with the GradeBook_queue(_) functions are not made until GradeBook_commit, and
+ * the GradeBook may be read, or changed directly, in the meantime.
+ * Returns false if a transaction is already open.
+ */
+bool GradeBook_begin(GradeBook* book);
+
+/*
+ * Queue a change in the open transaction. Each returns false if no transaction is open.
+ *
+ * The name of a queued course or student is copied in to the name pool straight away, so the caller may reuse it.
+ */
+bool GradeBook_queueAddCourse(GradeBook* book, Course course);
+
+bool GradeBook_queueRemoveCourse(GradeBook* book, identifier courseId);
+
+bool GradeBook_queueAddStudent(GradeBook* book, Student student);
+
+bool GradeBook_queueRemoveStudent(GradeBook* book, identifier studentId);
+
+bool GradeBook_queueEnroll(GradeBook* book, identifier studentId, identifier courseId);
+
+bool GradeBook_queueDisenroll(GradeBook* book, identifier studentId, identifier courseId);
+
+bool GradeBook_queueGrade(GradeBook* book, identifier studentId, identifier courseId, grade value);
+
+/*
+ * Apply every queued change, as if each had been made in the order it was queued, and close the transaction.
+ *
+ * Every change is checked against the records present at that point in the transaction before any is applied. If one
+ *   would fail, none are applied, the GradeBook is left as it was, and the position of the failing change is left in
+ *   book->transaction.failedAt. Queued names stay in the name pool either way.
+ * Records are placed without sorting as the changes are applied; each order index is then sorted once, and the
+ *   enrollments of removed records are dropped in one pass over the enrollment table.
+ */
+TransactionStatus GradeBook_commit(GradeBook* book);
+
+/*
+ * Discard every queued change, and close the transaction
+ */
+void GradeBook_rollback(GradeBook* book);
+
+/*
+ * Check that the indexes, cached counts and running grade totals of the GradeBook agree with its records, enrollment
+ * table and grade logs, recomputing every total from the grades themselves, and printing every disagreement as debug
+ * output. Returns true when they all agree.
+ *
+ * The check is linear in the size of the GradeBook, so it only runs in builds with _GB_DEBUG; other builds always
+ * return true.
+ */
+bool GradeBook_checkInvariants(GradeBook* book);
+
 // End Header "models" -------------------------------------------------------------------------------------------------
 
 #endif
\ No newline at end of file
@@ -0,0 +1,226 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * Pool Definitions:
+ *
+ * Implements the slab and size class allocator described in pool.h
+ */
+
+#include <string.h>
+#include "pool.h"
+
+const size Pool_SLAB_SIZE = 256 * 1024;
+
+const size Pool_MIN_BLOCK = 16;
+
+const size Pool_MAX_BLOCK = 64 * 1024;
+
+/*
+ * Slabs and large blocks begin with a header of this many bytes, which keeps the blocks after it aligned
+ */
+static const size _POOL_HEADER_SIZE = 16;
+
+typedef struct S_PoolLink {
+    void* next;
+    void* previous;
+} PoolLink;
+
+/*
+ * Return the size class serving `bytes`, or Pool_CLASSES if the request is too large for any class
+ */
+static size Pool_classOf(size bytes) {
+    size class = 0;
+
+    for(size block = Pool_MIN_BLOCK; block < bytes; block <<= 1) {
+        if(++class == Pool_CLASSES) break;
+    }
+
+    return class;
+}
+
+static inline size Pool_classSize(size class) {
+    return Pool_MIN_BLOCK << class;
+}
+
+void Pool_init(Pool* pool) {
+    memset(pool, 0, sizeof(Pool));
+}
+
+void Pool_free(Pool* pool) {
+
+    for(void* slab = pool->slabs; slab; ) {
+        void* next = ((PoolLink*) slab)->next;
+        free(slab);
+        slab = next;
+    }
+
+    for(void* large = pool->largeBlocks; large; ) {
+        void* next = ((PoolLink*) large)->next;
+        free(large);
+        large = next;
+    }
+
+    Pool_init(pool);
+}
+
+/*
+ * Hand the uncut end of the newest slab to the free lists, largest blocks first, before starting a new one
+ */
+static void Pool_retireSlab(Pool* pool) {
+    for(size class = Pool_CLASSES; class-- > 0; ) {
+        while(pool->remaining >= Pool_classSize(class)) {
+            *(void**) pool->cursor      = pool->freeBlocks[class];
+            pool->freeBlocks[class]     = pool->cursor;
+            pool->cursor               += Pool_classSize(class);
+            pool->remaining            -= Pool_classSize(class);
+        }
+    }
+}
+
+static void* Pool_allocLarge(Pool* pool, size bytes) {
+
+    PoolLink* link = malloc(_POOL_HEADER_SIZE + bytes);
+
+    if(!link) return NULL;
+
+    link->previous  = NULL;
+    link->next      = pool->largeBlocks;
+
+    if(pool->largeBlocks) ((PoolLink*) pool->largeBlocks)->previous = link;
+
+    pool->largeBlocks = link;
+
+    ++pool->stats.systemAllocations;
+    pool->stats.bytesReserved   += _POOL_HEADER_SIZE + bytes;
+    pool->stats.bytesInUse      += bytes;
+
+    return (byte*) link + _POOL_HEADER_SIZE;
+}
+
+static void Pool_releaseLarge(Pool* pool, void* block, size bytes) {
+
+    PoolLink* link = (PoolLink*) ((byte*) block - _POOL_HEADER_SIZE);
+
+    if(link->previous) {
+        ((PoolLink*) link->previous)->next = link->next;
+    } else {
+        pool->largeBlocks = link->next;
+    }
+
+    if(link->next) ((PoolLink*) link->next)->previous = link->previous;
+
+    free(link);
+
+    ++pool->stats.systemReleases;
+    pool->stats.bytesReserved   -= _POOL_HEADER_SIZE + bytes;
+    pool->stats.bytesInUse      -= bytes;
+}
+
+static void* Pool_reallocLarge(Pool* pool, void* block, size oldBytes, size newBytes) {
+
+    PoolLink* link = realloc((byte*) block - _POOL_HEADER_SIZE, _POOL_HEADER_SIZE + newBytes);
+
+    if(!link) return NULL;
+
+    // The block may have moved, so its neighbours must be pointed at it again
+    if(link->previous) {
+        ((PoolLink*) link->previous)->next = link;
+    } else {
+        pool->largeBlocks = link;
+    }
+
+    if(link->next) ((PoolLink*) link->next)->previous = link;
+
+    ++pool->stats.systemAllocations;
+    ++pool->stats.allocations;
+    ++pool->stats.releases;
+    pool->stats.bytesReserved   = pool->stats.bytesReserved - oldBytes + newBytes;
+    pool->stats.bytesInUse      = pool->stats.bytesInUse - oldBytes + newBytes;
+
+    return (byte*) link + _POOL_HEADER_SIZE;
+}
+
+void* Pool_alloc(Pool* pool, size bytes) {
+
+    size class = Pool_classOf(bytes);
+
+    if(class == Pool_CLASSES) {
+        void* block = Pool_allocLarge(pool, bytes);
+        if(block) ++pool->stats.allocations;
+        return block;
+    }
+
+    size blockSize  = Pool_classSize(class);
+    void* block     = pool->freeBlocks[class];
+
+    if(block) {
+        pool->freeBlocks[class] = *(void**) block;
+    } else {
+        if(pool->remaining < blockSize) {
+            PoolLink* slab = malloc(Pool_SLAB_SIZE);
+
+            if(!slab) return NULL;
+
+            Pool_retireSlab(pool);
+
+            slab->next      = pool->slabs;
+            pool->slabs     = slab;
+            pool->cursor    = (byte*) slab + _POOL_HEADER_SIZE;
+            pool->remaining = Pool_SLAB_SIZE - _POOL_HEADER_SIZE;
+
+            ++pool->stats.systemAllocations;
+            pool->stats.bytesReserved += Pool_SLAB_SIZE;
+        }
+
+        block            = pool->cursor;
+        pool->cursor    += blockSize;
+        pool->remaining -= blockSize;
+    }
+
+    ++pool->stats.allocations;
+    pool->stats.bytesInUse += blockSize;
+
+    return block;
+}
+
+void Pool_release(Pool* pool, void* block, size bytes) {
+
+    if(!block) return;
+
+    size class = Pool_classOf(bytes);
+
+    ++pool->stats.releases;
+
+    if(class == Pool_CLASSES) {
+        Pool_releaseLarge(pool, block, bytes);
+        return;
+    }
+
+    *(void**) block             = pool->freeBlocks[class];
+    pool->freeBlocks[class]     = block;
+    pool->stats.bytesInUse     -= Pool_classSize(class);
+}
+
+void* Pool_resize(Pool* pool, void* block, size oldBytes, size newBytes) {
+
+    if(!block) return Pool_alloc(pool, newBytes);
+
+    size oldClass = Pool_classOf(oldBytes);
+    size newClass = Pool_classOf(newBytes);
+
+    // A block that already has room stays where it is
+    if(oldClass < Pool_CLASSES && oldClass == newClass) return block;
+
+    // Large blocks are left to realloc, which can often grow them in place
+    if(oldClass == Pool_CLASSES && newClass == Pool_CLASSES) return Pool_reallocLarge(pool, block, oldBytes, newBytes);
+
+    void* resized = Pool_alloc(pool, newBytes);
+
+    if(!resized) return NULL;
+
+    memcpy(resized, block, oldBytes < newBytes ? oldBytes : newBytes);
+    Pool_release(pool, block, oldBytes);
+
+    return resized;
+}
@@ -0,0 +1,123 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * Pool Header:
+ *
+ * Describes the allocator that every table of a GradeBook draws its memory from.
+ *
+ * Memory is taken from the system in slabs of Pool_SLAB_SIZE bytes and cut in to blocks of power-of-two size classes,
+ * from Pool_MIN_BLOCK to Pool_MAX_BLOCK bytes. A released block goes on the free list of its class and is handed out
+ * again before the pool cuts another block from a slab, so a structure that grows and shrinks around the same size
+ * stops calling malloc altogether. Requests above Pool_MAX_BLOCK are passed to malloc one by one, and tracked so that
+ * they can be released with everything else.
+ *
+ * Record types are served one level up: each Arena holds records of one type, and takes whole chunks of them from the
+ * pool, so every record type effectively has a size class of its own.
+ *
+ * The caller tells the pool how large a block is when releasing or resizing it, as every table already knows its
+ * capacity. Pool_free returns every slab to the system at once, without visiting the blocks inside them.
+ */
+
+#ifndef _H_POOL
+    #define _H_POOL
+    #include <stdint.h>
+    #include "../util.h"
+
+// Begin Header "pool" -------------------------------------------------------------------------------------------------
+
+extern const size Pool_SLAB_SIZE;
+
+extern const size Pool_MIN_BLOCK;
+
+extern const size Pool_MAX_BLOCK;
+
+/*
+ * log2(Pool_MAX_BLOCK) - log2(Pool_MIN_BLOCK) + 1
+ */
+#define Pool_CLASSES 13
+
+typedef struct S_PoolStats {
+
+    /*
+     * Calls to malloc (or realloc) and free made by the pool, for slabs and large blocks
+     */
+    size systemAllocations;
+
+    size systemReleases;
+
+    /*
+     * Calls to Pool_alloc and Pool_release. Pool_resize counts as both when it moves a block.
+     */
+    size allocations;
+
+    size releases;
+
+    /*
+     * Bytes held by blocks that have been handed out and not released, rounded up to their size class
+     */
+    size bytesInUse;
+
+    /*
+     * Bytes obtained from the system, and not yet given back
+     */
+    size bytesReserved;
+
+} PoolStats;
+
+typedef struct S_Pool {
+
+    /*
+     * Every slab taken from the system, linked through the first bytes of each
+     */
+    void* slabs;
+
+    /*
+     * Uncut remainder of the newest slab
+     */
+    byte* cursor;
+
+    size remaining;
+
+    /*
+     * Head of the free list of each size class, linked through the first bytes of each free block
+     */
+    void* freeBlocks[Pool_CLASSES];
+
+    /*
+     * Blocks above Pool_MAX_BLOCK, in a doubly linked list so that one may be unlinked without a search
+     */
+    void* largeBlocks;
+
+    PoolStats stats;
+
+} Pool;
+
+void Pool_init(Pool* pool);
+
+/*
+ * Give every slab and every large block back to the system, releasing everything allocated from the pool at once.
+ * The pool is left empty, and may be used again.
+ */
+void Pool_free(Pool* pool);
+
+/*
+ * Return a block of at least `bytes` bytes, aligned to 16 bytes, or NULL if the system is out of memory.
+ * The block is not zeroed.
+ */
+void* Pool_alloc(Pool* pool, size bytes);
+
+/*
+ * Return a block, allocated with the given size, to the pool. Releasing NULL does nothing.
+ */
+void Pool_release(Pool* pool, void* block, size bytes);
+
+/*
+ * Like realloc: return a block of at least `newBytes` bytes holding the contents of `block` (which may be NULL), and
+ * release `block` if it had to be moved. Returns NULL, leaving `block` as it was, if the system is out of memory.
+ */
+void* Pool_resize(Pool* pool, void* block, size oldBytes, size newBytes);
+
+// End Header "pool" ---------------------------------------------------------------------------------------------------
+
+#endif
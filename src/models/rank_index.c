@@ -0,0 +1,251 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * Rank Index Definitions:
+ *
+ * Implements the bucketed average index and bounded selection described in rank_index.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "rank_index.h"
+
+static const uint32_t _RANK_BUCKET_INITIAL_CAPACITY = 8;
+
+static const size _RANK_PLACES_INITIAL_CAPACITY = 64;
+
+/*
+ * Whether `a` ranks before `b`
+ */
+static inline bool RankEntry_precedes(RankEntry a, RankEntry b, bool highest) {
+    if(a.key != b.key) return highest ? a.key > b.key : a.key < b.key;
+    return a.id < b.id;
+}
+
+// -- Selection --------------------------------------------------------------------------------------------------------
+
+/*
+ * The heap is ordered so that every parent ranks after its children, putting the worst entry kept at the root
+ */
+
+static void RankSelection_siftUp(RankSelection* selection, size child) {
+    RankEntry* heap = selection->entries;
+
+    while(child > 0) {
+        size parent = (child - 1) / 2;
+        if(!RankEntry_precedes(heap[parent], heap[child], selection->highest)) return;
+
+        RankEntry swap  = heap[parent];
+        heap[parent]    = heap[child];
+        heap[child]     = swap;
+        child           = parent;
+    }
+}
+
+static void RankSelection_siftDown(RankSelection* selection, size parent, size count) {
+    RankEntry* heap = selection->entries;
+
+    for(;;) {
+        size worst = parent, left = parent * 2 + 1, right = left + 1;
+
+        if(left < count && RankEntry_precedes(heap[worst], heap[left], selection->highest)) worst = left;
+        if(right < count && RankEntry_precedes(heap[worst], heap[right], selection->highest)) worst = right;
+
+        if(worst == parent) return;
+
+        RankEntry swap  = heap[parent];
+        heap[parent]    = heap[worst];
+        heap[worst]     = swap;
+        parent          = worst;
+    }
+}
+
+void RankSelection_init(RankSelection* selection, RankEntry* destination, size limit, bool highest) {
+    *selection = (RankSelection){ .entries = destination, .limit = limit, .highest = highest };
+}
+
+void RankSelection_offer(RankSelection* selection, RankEntry entry) {
+    if(selection->count < selection->limit) {
+        selection->entries[selection->count] = entry;
+        RankSelection_siftUp(selection, selection->count++);
+    } else if(selection->limit > 0 && RankEntry_precedes(entry, selection->entries[0], selection->highest)) {
+        selection->entries[0] = entry;
+        RankSelection_siftDown(selection, 0, selection->count);
+    }
+}
+
+size RankSelection_finish(RankSelection* selection) {
+    // Heap sort: the worst entry left goes to the back each time
+    for(size end = selection->count; end > 1; --end) {
+        RankEntry swap                  = selection->entries[0];
+        selection->entries[0]           = selection->entries[end - 1];
+        selection->entries[end - 1]     = swap;
+        RankSelection_siftDown(selection, 0, end - 1);
+    }
+
+    return selection->count;
+}
+
+// -- Index ------------------------------------------------------------------------------------------------------------
+
+static inline uint32_t RankIndex_bucketOf(float key) {
+    float scaled = key * RankIndex_BUCKET_SCALE;
+
+    if(!(scaled > 0)) return 0;
+    if(scaled >= RankIndex_BUCKETS - 1) return RankIndex_BUCKETS - 1;
+
+    return (uint32_t) scaled;
+}
+
+void RankIndex_init(RankIndex* index, Pool* pool) {
+    *index = (RankIndex){ .pool = pool };
+}
+
+bool RankIndex_isLive(const RankIndex* index) {
+    return index->buckets != NULL;
+}
+
+void RankIndex_open(RankIndex* index) {
+    if(index->buckets) return;
+
+    index->buckets = Pool_alloc(index->pool, RankIndex_BUCKETS * sizeof(RankBucket));
+
+    if(!index->buckets) {
+        fprintf(stderr, "RankIndex: unable to allocate %d buckets\n", RankIndex_BUCKETS);
+        abort();
+    }
+
+    memset(index->buckets, 0, RankIndex_BUCKETS * sizeof(RankBucket));
+    index->count = 0;
+}
+
+void RankIndex_close(RankIndex* index) {
+    if(!index->buckets) return;
+
+    for(size bucket = 0; bucket < RankIndex_BUCKETS; ++bucket) {
+        Pool_release(index->pool, index->buckets[bucket].entries, index->buckets[bucket].capacity * sizeof(RankEntry));
+    }
+
+    Pool_release(index->pool, index->buckets, RankIndex_BUCKETS * sizeof(RankBucket));
+    Pool_release(index->pool, index->places, index->placesCapacity * sizeof(RankPlace));
+
+    RankIndex_init(index, index->pool);
+}
+
+/*
+ * Make sure `slot` has a place, marking any new places unranked
+ */
+static void RankIndex_reservePlace(RankIndex* index, size slot) {
+    if(slot < index->placesCapacity) return;
+
+    size capacity = index->placesCapacity ? index->placesCapacity : _RANK_PLACES_INITIAL_CAPACITY;
+    while(capacity <= slot) capacity *= 2;
+
+    RankPlace* places = Pool_resize(index->pool, index->places, index->placesCapacity * sizeof(RankPlace),
+                                    capacity * sizeof(RankPlace));
+
+    if(!places) {
+        fprintf(stderr, "RankIndex: unable to rank %lu records\n", capacity);
+        abort();
+    }
+
+    for(size idx = index->placesCapacity; idx < capacity; ++idx) places[idx].bucket = RankIndex_BUCKETS;
+
+    index->places           = places;
+    index->placesCapacity   = capacity;
+}
+
+/*
+ * Take the entry at `position` out of `bucket`, moving the bucket's last entry in to its place
+ */
+static void RankIndex_unlink(RankIndex* index, uint32_t bucket, uint32_t position) {
+    RankBucket* row = &index->buckets[bucket];
+    RankEntry last  = row->entries[--row->count];
+
+    if(position < row->count) {
+        row->entries[position]              = last;
+        index->places[last.slot].position   = position;
+    }
+}
+
+static void RankIndex_link(RankIndex* index, uint32_t bucket, RankEntry entry) {
+    RankBucket* row = &index->buckets[bucket];
+
+    if(row->count == row->capacity) {
+        uint32_t capacity   = row->capacity ? row->capacity * 2 : _RANK_BUCKET_INITIAL_CAPACITY;
+        RankEntry* entries  = Pool_resize(index->pool, row->entries, row->capacity * sizeof(RankEntry),
+                                          capacity * sizeof(RankEntry));
+
+        if(!entries) {
+            fprintf(stderr, "RankIndex: unable to grow bucket %u to %u entries\n", bucket, capacity);
+            abort();
+        }
+
+        row->entries    = entries;
+        row->capacity   = capacity;
+    }
+
+    index->places[entry.slot] = (RankPlace){ .bucket = bucket, .position = row->count };
+    row->entries[row->count++] = entry;
+}
+
+void RankIndex_set(RankIndex* index, RankEntry entry) {
+    if(!index->buckets) return;
+
+    RankIndex_reservePlace(index, entry.slot);
+
+    RankPlace place = index->places[entry.slot];
+    uint32_t bucket = RankIndex_bucketOf(entry.key);
+
+    if(place.bucket == bucket) {
+        index->buckets[bucket].entries[place.position] = entry;
+        return;
+    }
+
+    if(place.bucket == RankIndex_BUCKETS) {
+        ++index->count;
+    } else {
+        RankIndex_unlink(index, place.bucket, place.position);
+    }
+
+    RankIndex_link(index, bucket, entry);
+}
+
+/*
+ * Whether the record in `slot` is ranked
+ */
+static inline bool RankIndex_holds(const RankIndex* index, size slot) {
+    return index->buckets && slot < index->placesCapacity && index->places[slot].bucket != RankIndex_BUCKETS;
+}
+
+void RankIndex_remove(RankIndex* index, size slot) {
+    if(!RankIndex_holds(index, slot)) return;
+
+    RankIndex_unlink(index, index->places[slot].bucket, index->places[slot].position);
+    index->places[slot].bucket = RankIndex_BUCKETS;
+    --index->count;
+}
+
+bool RankIndex_find(const RankIndex* index, size slot, RankEntry* entry) {
+    if(!RankIndex_holds(index, slot)) return false;
+
+    *entry = index->buckets[index->places[slot].bucket].entries[index->places[slot].position];
+
+    return true;
+}
+
+size RankIndex_top(const RankIndex* index, size k, bool highest, RankEntry* destination) {
+    RankSelection selection;
+    RankSelection_init(&selection, destination, k, highest);
+
+    // Every key in a bucket ranks before every key in the buckets after it, so once k entries are kept, none can follow
+    for(size step = 0; step < RankIndex_BUCKETS && selection.count < k; ++step) {
+        const RankBucket* row = &index->buckets[highest ? RankIndex_BUCKETS - 1 - step : step];
+
+        for(uint32_t idx = 0; idx < row->count; ++idx) RankSelection_offer(&selection, row->entries[idx]);
+    }
+
+    return RankSelection_finish(&selection);
+}
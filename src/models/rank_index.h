@@ -0,0 +1,180 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * Rank Index Header:
+ *
+ * Describes the index that keeps the records of one arena ordered by average grade, for top and bottom k queries.
+ *
+ * Averages run from 0 to 255, so the index is a row of RankIndex_BUCKETS buckets, each holding the records whose
+ * average falls in one quarter of a point. A bucket is an unordered array of entries, and every record's bucket and
+ * position within it are kept by arena slot, so a change of average moves one entry between two buckets in O(1).
+ * A query walks buckets from the best end until it has k entries, putting them in exact order with a bounded heap
+ * (a RankSelection) as it goes; that costs O((k + b) log k), where b is the size of the last bucket visited.
+ *
+ * An index is cold, and holds nothing, until RankIndex_open is called. Every function that changes an index does
+ * nothing while it is cold, so the owner may call them unconditionally. A RankSelection over every record answers the
+ * same queries without an index.
+ */
+
+#ifndef _H_RANK_INDEX
+    #define _H_RANK_INDEX
+    #include <stdint.h>
+    #include "../util.h"
+    #include "pool.h"
+    #include "id_index.h"
+
+// Begin Header "rank index" -------------------------------------------------------------------------------------------
+
+/*
+ * Buckets per point of average
+ */
+#define RankIndex_BUCKET_SCALE 4
+
+#define RankIndex_BUCKETS (256 * RankIndex_BUCKET_SCALE)
+
+/*
+ * A record, as ranked. Entries rank by key, and then by ascending id.
+ */
+typedef struct S_RankEntry {
+
+    float key;
+
+    identifier id;
+
+    /*
+     * Arena slot of the record
+     */
+    uint32_t slot;
+
+} RankEntry;
+
+typedef struct S_RankBucket {
+
+    RankEntry* entries;
+
+    uint32_t count;
+
+    uint32_t capacity;
+
+} RankBucket;
+
+/*
+ * Bucket and position of a record's entry, by arena slot
+ */
+typedef struct S_RankPlace {
+
+    /*
+     * RankIndex_BUCKETS if the slot is not ranked
+     */
+    uint32_t bucket;
+
+    uint32_t position;
+
+} RankPlace;
+
+typedef struct S_RankIndex {
+
+    Pool* pool;
+
+    /*
+     * RankIndex_BUCKETS buckets, or NULL while the index is cold
+     */
+    RankBucket* buckets;
+
+    RankPlace* places;
+
+    size placesCapacity;
+
+    /*
+     * Number of records ranked
+     */
+    size count;
+
+    /*
+     * Queries answered without the index, which its owner may use to decide when to open it
+     */
+    size coldQueries;
+
+} RankIndex;
+
+/*
+ * The best `limit` entries offered so far, held as a heap whose root is the worst of them
+ */
+typedef struct S_RankSelection {
+
+    RankEntry* entries;
+
+    size count;
+
+    size limit;
+
+    /*
+     * Whether the highest keys rank first
+     */
+    bool highest;
+
+} RankSelection;
+
+// -- Selection --------------------------------------------------------------------------------------------------------
+
+/*
+ * Prepare to select the best `limit` entries in to `destination`, which must have room for `limit` entries
+ */
+void RankSelection_init(RankSelection* selection, RankEntry* destination, size limit, bool highest);
+
+/*
+ * Keep `entry` if it is among the best `limit` entries offered so far
+ */
+void RankSelection_offer(RankSelection* selection, RankEntry entry);
+
+/*
+ * Put the entries kept in rank order, best first, and return how many there are. The selection may not be offered
+ * any more entries.
+ */
+size RankSelection_finish(RankSelection* selection);
+
+// -- Index ------------------------------------------------------------------------------------------------------------
+
+/*
+ * Prepare a cold index, allocating from `pool` once it is opened
+ */
+void RankIndex_init(RankIndex* index, Pool* pool);
+
+bool RankIndex_isLive(const RankIndex* index);
+
+/*
+ * Make a cold index live, and empty. Aborts if memory could not be allocated.
+ */
+void RankIndex_open(RankIndex* index);
+
+/*
+ * Give everything held by the index back to the pool, leaving it cold
+ */
+void RankIndex_close(RankIndex* index);
+
+/*
+ * Rank the record in `entry.slot` by `entry.key`, adding it if it is not ranked yet.
+ * Aborts if memory could not be allocated.
+ */
+void RankIndex_set(RankIndex* index, RankEntry entry);
+
+/*
+ * Stop ranking the record in `slot`, if it is ranked
+ */
+void RankIndex_remove(RankIndex* index, size slot);
+
+/*
+ * Copy the entry of the record in `slot` in to `entry`. Returns false if the index is cold or the slot is not ranked.
+ */
+bool RankIndex_find(const RankIndex* index, size slot, RankEntry* entry);
+
+/*
+ * Write the best `k` entries, highest or lowest keys first, to `destination` in rank order. Returns the number
+ * written, which is less than `k` if fewer records are ranked. The index must be live.
+ */
+size RankIndex_top(const RankIndex* index, size k, bool highest, RankEntry* destination);
+
+// End Header "rank index" ---------------------------------------------------------------------------------------------
+
+#endif
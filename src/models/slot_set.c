@@ -0,0 +1,567 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * Slot Set Definitions:
+ *
+ * Implements the roaring-style slot sets, and their scalar and AVX2 bitmap kernels, described in slot_set.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "slot_set.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+    #define _SLOT_SET_X86
+    #include <immintrin.h>
+#endif
+
+static const uint32_t _SLOT_ARRAY_INITIAL_CAPACITY = 4;
+
+static const uint32_t _SLOT_BLOCKS_INITIAL_CAPACITY = 2;
+
+static const size _SLOT_BITMAP_BYTES = SlotSet_BITMAP_WORDS * sizeof(uint64_t);
+
+// -- Scalar -----------------------------------------------------------------------------------------------------------
+
+static size SlotSetKernels_andCountScalar(const uint64_t* a, const uint64_t* b, size words) {
+    size count = 0;
+
+    for(size idx = 0; idx < words; ++idx) count += (size) __builtin_popcountll(a[idx] & b[idx]);
+
+    return count;
+}
+
+static size SlotSetKernels_andScalar(uint64_t* destination, const uint64_t* a, const uint64_t* b, size words) {
+    size count = 0;
+
+    for(size idx = 0; idx < words; ++idx) {
+        destination[idx] = a[idx] & b[idx];
+        count += (size) __builtin_popcountll(destination[idx]);
+    }
+
+    return count;
+}
+
+static size SlotSetKernels_andNotScalar(uint64_t* destination, const uint64_t* a, const uint64_t* b, size words) {
+    size count = 0;
+
+    for(size idx = 0; idx < words; ++idx) {
+        destination[idx] = a[idx] & ~b[idx];
+        count += (size) __builtin_popcountll(destination[idx]);
+    }
+
+    return count;
+}
+
+static const SlotSetKernels _SLOT_SET_KERNELS_SCALAR = {
+        .name       = "scalar",
+        .andCount   = &SlotSetKernels_andCountScalar,
+        .and        = &SlotSetKernels_andScalar,
+        .andNot     = &SlotSetKernels_andNotScalar
+};
+
+#ifdef _SLOT_SET_X86
+
+// -- AVX2 -------------------------------------------------------------------------------------------------------------
+
+/*
+ * AVX2 has no population count, so each byte is counted with two lookups of a 16 entry table, one per nibble, and the
+ * bytes of each 64 bit lane summed with a SAD against zero. Words past the last whole vector are left to the scalar
+ * kernels. These kernels are only called once SlotSetKernels_select has found that the CPU supports AVX2.
+ */
+#define _SLOT_SET_AVX2 __attribute__((target("avx2")))
+
+_SLOT_SET_AVX2
+static inline __m256i SlotSetKernels_popcountAvx2(__m256i bits) {
+    const __m256i table     = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                               0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibbles   = _mm256_set1_epi8(0x0F);
+
+    __m256i low     = _mm256_shuffle_epi8(table, _mm256_and_si256(bits, nibbles));
+    __m256i high    = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(bits, 4), nibbles));
+
+    return _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256());
+}
+
+_SLOT_SET_AVX2
+static inline size SlotSetKernels_reduceAvx2(__m256i counts) {
+    __m128i pairs = _mm_add_epi64(_mm256_castsi256_si128(counts), _mm256_extracti128_si256(counts, 1));
+    return (size) (_mm_cvtsi128_si64(pairs) + _mm_extract_epi64(pairs, 1));
+}
+
+_SLOT_SET_AVX2
+static size SlotSetKernels_andCountAvx2(const uint64_t* a, const uint64_t* b, size words) {
+    __m256i counts = _mm256_setzero_si256();
+    size idx = 0;
+
+    for(; idx + 4 <= words; idx += 4) {
+        __m256i both = _mm256_and_si256(_mm256_loadu_si256((const __m256i*) &a[idx]),
+                                        _mm256_loadu_si256((const __m256i*) &b[idx]));
+        counts = _mm256_add_epi64(counts, SlotSetKernels_popcountAvx2(both));
+    }
+
+    return SlotSetKernels_reduceAvx2(counts) + SlotSetKernels_andCountScalar(&a[idx], &b[idx], words - idx);
+}
+
+_SLOT_SET_AVX2
+static size SlotSetKernels_andAvx2(uint64_t* destination, const uint64_t* a, const uint64_t* b, size words) {
+    __m256i counts = _mm256_setzero_si256();
+    size idx = 0;
+
+    for(; idx + 4 <= words; idx += 4) {
+        __m256i both = _mm256_and_si256(_mm256_loadu_si256((const __m256i*) &a[idx]),
+                                        _mm256_loadu_si256((const __m256i*) &b[idx]));
+        _mm256_storeu_si256((__m256i*) &destination[idx], both);
+        counts = _mm256_add_epi64(counts, SlotSetKernels_popcountAvx2(both));
+    }
+
+    return SlotSetKernels_reduceAvx2(counts) + SlotSetKernels_andScalar(&destination[idx], &a[idx], &b[idx], words - idx);
+}
+
+_SLOT_SET_AVX2
+static size SlotSetKernels_andNotAvx2(uint64_t* destination, const uint64_t* a, const uint64_t* b, size words) {
+    __m256i counts = _mm256_setzero_si256();
+    size idx = 0;
+
+    for(; idx + 4 <= words; idx += 4) {
+        // andnot complements its first operand
+        __m256i only = _mm256_andnot_si256(_mm256_loadu_si256((const __m256i*) &b[idx]),
+                                           _mm256_loadu_si256((const __m256i*) &a[idx]));
+        _mm256_storeu_si256((__m256i*) &destination[idx], only);
+        counts = _mm256_add_epi64(counts, SlotSetKernels_popcountAvx2(only));
+    }
+
+    return SlotSetKernels_reduceAvx2(counts)
+           + SlotSetKernels_andNotScalar(&destination[idx], &a[idx], &b[idx], words - idx);
+}
+
+static const SlotSetKernels _SLOT_SET_KERNELS_AVX2 = {
+        .name       = "avx2",
+        .andCount   = &SlotSetKernels_andCountAvx2,
+        .and        = &SlotSetKernels_andAvx2,
+        .andNot     = &SlotSetKernels_andNotAvx2
+};
+
+#endif
+
+// -- Dispatch ---------------------------------------------------------------------------------------------------------
+
+size SlotSetKernels_supported(const SlotSetKernels** sets) {
+    size count = 0;
+
+    sets[count++] = &_SLOT_SET_KERNELS_SCALAR;
+
+#ifdef _SLOT_SET_X86
+    __builtin_cpu_init();
+
+    if(__builtin_cpu_supports("avx2")) sets[count++] = &_SLOT_SET_KERNELS_AVX2;
+#endif
+
+    return count;
+}
+
+/*
+ * The set chosen by SlotSetKernels_select, once, under pthread_once, as books may be decoded, and their slot sets
+ * built, on worker threads
+ */
+static pthread_once_t _SLOT_SET_KERNELS_ONCE = PTHREAD_ONCE_INIT;
+
+static const SlotSetKernels* _SLOT_SET_KERNELS_SELECTED = NULL;
+
+static void SlotSetKernels_choose(void) {
+    const SlotSetKernels* sets[SlotSetKernels_MAX_SETS];
+    _SLOT_SET_KERNELS_SELECTED = sets[SlotSetKernels_supported(sets) - 1];
+}
+
+const SlotSetKernels* SlotSetKernels_select(void) {
+    pthread_once(&_SLOT_SET_KERNELS_ONCE, &SlotSetKernels_choose);
+    return _SLOT_SET_KERNELS_SELECTED;
+}
+
+// -- Blocks -----------------------------------------------------------------------------------------------------------
+
+static inline bool SlotBlock_isBitmap(const SlotBlock* block) {
+    return block->capacity == 0;
+}
+
+static inline bool SlotBlock_test(const SlotBlock* block, uint16_t low) {
+    return (((const uint64_t*) block->data)[low >> 6] >> (low & 63)) & 1;
+}
+
+/*
+ * Position of `low` in the array of a block, or of where it would go, with `found` set if it is there
+ */
+static uint32_t SlotBlock_search(const SlotBlock* block, uint16_t low, bool* found) {
+    const uint16_t* values = block->data;
+    uint32_t first = 0, last = block->count;
+
+    while(first < last) {
+        uint32_t middle = first + (last - first) / 2;
+
+        if(values[middle] < low) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+
+    *found = first < block->count && values[first] == low;
+
+    return first;
+}
+
+static bool SlotBlock_contains(const SlotBlock* block, uint16_t low) {
+    if(SlotBlock_isBitmap(block)) return SlotBlock_test(block, low);
+
+    bool found;
+    SlotBlock_search(block, low, &found);
+
+    return found;
+}
+
+static void* SlotSet_allocate(Pool* pool, void* block, size oldBytes, size newBytes) {
+    void* grown = Pool_resize(pool, block, oldBytes, newBytes);
+
+    if(!grown) {
+        fprintf(stderr, "SlotSet: unable to allocate %lu bytes\n", newBytes);
+        abort();
+    }
+
+    return grown;
+}
+
+/*
+ * Turn a full array block in to a bitmap
+ */
+static void SlotBlock_toBitmap(Pool* pool, SlotBlock* block) {
+    uint64_t* words         = SlotSet_allocate(pool, NULL, 0, _SLOT_BITMAP_BYTES);
+    const uint16_t* values  = block->data;
+
+    memset(words, 0, _SLOT_BITMAP_BYTES);
+
+    for(uint32_t idx = 0; idx < block->count; ++idx) words[values[idx] >> 6] |= (uint64_t) 1 << (values[idx] & 63);
+
+    Pool_release(pool, block->data, block->capacity * sizeof(uint16_t));
+
+    block->data     = words;
+    block->capacity = 0;
+}
+
+/*
+ * Write the members of a bitmap, with the block's upper bits, to `destination`, and return how many there were
+ */
+static size SlotBlock_extract(const uint64_t* words, uint32_t base, uint32_t* destination) {
+    size count = 0;
+
+    for(uint32_t word = 0; word < SlotSet_BITMAP_WORDS; ++word) {
+        for(uint64_t bits = words[word]; bits; bits &= bits - 1) {
+            destination[count++] = (base << 16) | (word << 6) | (uint32_t) __builtin_ctzll(bits);
+        }
+    }
+
+    return count;
+}
+
+/*
+ * Turn a bitmap block that has emptied out back in to an array
+ */
+static void SlotBlock_toArray(Pool* pool, SlotBlock* block) {
+    uint32_t capacity   = SlotSet_ARRAY_LIMIT / 2;
+    uint16_t* values    = SlotSet_allocate(pool, NULL, 0, capacity * sizeof(uint16_t));
+    const uint64_t* words = block->data;
+    uint32_t count      = 0;
+
+    for(uint32_t word = 0; word < SlotSet_BITMAP_WORDS; ++word) {
+        for(uint64_t bits = words[word]; bits; bits &= bits - 1) {
+            values[count++] = (uint16_t) ((word << 6) | (uint32_t) __builtin_ctzll(bits));
+        }
+    }
+
+    Pool_release(pool, block->data, _SLOT_BITMAP_BYTES);
+
+    block->data     = values;
+    block->capacity = capacity;
+}
+
+// -- Sets -------------------------------------------------------------------------------------------------------------
+
+/*
+ * Position of the block with upper bits `base`, or of where it would go, with `found` set if it is there
+ */
+static uint32_t SlotSet_findBlock(const SlotSet* set, uint32_t base, bool* found) {
+    uint32_t first = 0, last = set->blocksCount;
+
+    while(first < last) {
+        uint32_t middle = first + (last - first) / 2;
+
+        if(set->blocks[middle].base < base) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+
+    *found = first < set->blocksCount && set->blocks[first].base == base;
+
+    return first;
+}
+
+bool SlotSet_add(Pool* pool, SlotSet* set, uint32_t slot) {
+    uint32_t base   = slot >> 16;
+    uint16_t low    = (uint16_t) slot;
+    bool found;
+    uint32_t at     = SlotSet_findBlock(set, base, &found);
+
+    if(!found) {
+        if(set->blocksCount == set->blocksCapacity) {
+            uint32_t capacity = set->blocksCapacity ? set->blocksCapacity * 2 : _SLOT_BLOCKS_INITIAL_CAPACITY;
+            set->blocks = SlotSet_allocate(pool, set->blocks, set->blocksCapacity * sizeof(SlotBlock),
+                                           capacity * sizeof(SlotBlock));
+            set->blocksCapacity = capacity;
+        }
+
+        memmove(&set->blocks[at + 1], &set->blocks[at], (set->blocksCount - at) * sizeof(SlotBlock));
+        ++set->blocksCount;
+
+        set->blocks[at] = (SlotBlock){
+                .base       = base,
+                .capacity   = _SLOT_ARRAY_INITIAL_CAPACITY,
+                .data       = SlotSet_allocate(pool, NULL, 0, _SLOT_ARRAY_INITIAL_CAPACITY * sizeof(uint16_t))
+        };
+    }
+
+    SlotBlock* block = &set->blocks[at];
+
+    if(SlotBlock_isBitmap(block)) {
+        if(SlotBlock_test(block, low)) return false;
+        ((uint64_t*) block->data)[low >> 6] |= (uint64_t) 1 << (low & 63);
+    } else {
+        uint32_t position = SlotBlock_search(block, low, &found);
+        if(found) return false;
+
+        if(block->count == block->capacity) {
+            block->data = SlotSet_allocate(pool, block->data, block->capacity * sizeof(uint16_t),
+                                           block->capacity * 2 * sizeof(uint16_t));
+            block->capacity *= 2;
+        }
+
+        uint16_t* values = block->data;
+        memmove(&values[position + 1], &values[position], (block->count - position) * sizeof(uint16_t));
+        values[position] = low;
+    }
+
+    ++block->count;
+    ++set->count;
+
+    if(!SlotBlock_isBitmap(block) && block->count > SlotSet_ARRAY_LIMIT) SlotBlock_toBitmap(pool, block);
+
+    return true;
+}
+
+bool SlotSet_remove(Pool* pool, SlotSet* set, uint32_t slot) {
+    uint16_t low = (uint16_t) slot;
+    bool found;
+    uint32_t at = SlotSet_findBlock(set, slot >> 16, &found);
+
+    if(!found) return false;
+
+    SlotBlock* block = &set->blocks[at];
+
+    if(SlotBlock_isBitmap(block)) {
+        if(!SlotBlock_test(block, low)) return false;
+        ((uint64_t*) block->data)[low >> 6] &= ~((uint64_t) 1 << (low & 63));
+    } else {
+        uint32_t position = SlotBlock_search(block, low, &found);
+        if(!found) return false;
+
+        uint16_t* values = block->data;
+        memmove(&values[position], &values[position + 1], (block->count - position - 1) * sizeof(uint16_t));
+    }
+
+    --block->count;
+    --set->count;
+
+    if(block->count == 0) {
+        Pool_release(pool, block->data, SlotBlock_isBitmap(block) ? _SLOT_BITMAP_BYTES : block->capacity * sizeof(uint16_t));
+        memmove(&set->blocks[at], &set->blocks[at + 1], (set->blocksCount - at - 1) * sizeof(SlotBlock));
+        --set->blocksCount;
+    } else if(SlotBlock_isBitmap(block) && block->count <= SlotSet_ARRAY_LIMIT / 2) {
+        SlotBlock_toArray(pool, block);
+    }
+
+    return true;
+}
+
+bool SlotSet_contains(const SlotSet* set, uint32_t slot) {
+    bool found;
+    uint32_t at = SlotSet_findBlock(set, slot >> 16, &found);
+
+    return found && SlotBlock_contains(&set->blocks[at], (uint16_t) slot);
+}
+
+void SlotSet_free(Pool* pool, SlotSet* set) {
+    for(uint32_t idx = 0; idx < set->blocksCount; ++idx) {
+        SlotBlock* block = &set->blocks[idx];
+        Pool_release(pool, block->data, SlotBlock_isBitmap(block) ? _SLOT_BITMAP_BYTES : block->capacity * sizeof(uint16_t));
+    }
+
+    Pool_release(pool, set->blocks, set->blocksCapacity * sizeof(SlotBlock));
+
+    *set = (SlotSet){};
+}
+
+// -- Set Operations ---------------------------------------------------------------------------------------------------
+
+/*
+ * Intersect two blocks with the same upper bits, writing the members in common to `destination` unless it is NULL,
+ * and return how many there are
+ */
+static size SlotBlock_intersect(const SlotBlock* a, const SlotBlock* b, uint32_t* destination) {
+    uint32_t base = a->base << 16;
+    size count = 0;
+
+    if(SlotBlock_isBitmap(a) && SlotBlock_isBitmap(b)) {
+        const SlotSetKernels* kernels = SlotSetKernels_select();
+
+        if(!destination) return kernels->andCount(a->data, b->data, SlotSet_BITMAP_WORDS);
+
+        uint64_t both[SlotSet_BITMAP_WORDS];
+        kernels->and(both, a->data, b->data, SlotSet_BITMAP_WORDS);
+
+        return SlotBlock_extract(both, a->base, destination);
+    }
+
+    // An array against anything: walk the array, the smaller side when both are arrays
+    if(SlotBlock_isBitmap(a) || (!SlotBlock_isBitmap(b) && b->count < a->count)) {
+        const SlotBlock* swap = a;
+        a = b;
+        b = swap;
+    }
+
+    const uint16_t* values = a->data;
+
+    if(SlotBlock_isBitmap(b)) {
+        for(uint32_t idx = 0; idx < a->count; ++idx) {
+            if(!SlotBlock_test(b, values[idx])) continue;
+            if(destination) destination[count] = base | values[idx];
+            ++count;
+        }
+
+        return count;
+    }
+
+    const uint16_t* others = b->data;
+
+    // Counting alone needs no branch on which side is behind, which is as likely one way as the other
+    if(!destination) {
+        for(uint32_t idx = 0, other = 0; idx < a->count && other < b->count; ) {
+            uint16_t value = values[idx], otherValue = others[other];
+
+            count   += value == otherValue;
+            idx     += value <= otherValue;
+            other   += otherValue <= value;
+        }
+
+        return count;
+    }
+
+    for(uint32_t idx = 0, other = 0; idx < a->count && other < b->count; ) {
+        if(values[idx] < others[other]) {
+            ++idx;
+        } else if(values[idx] > others[other]) {
+            ++other;
+        } else {
+            if(destination) destination[count] = base | values[idx];
+            ++count;
+            ++idx;
+            ++other;
+        }
+    }
+
+    return count;
+}
+
+/*
+ * Write the members of block `a` that are not in block `b`, which has the same upper bits, or is NULL for none, to
+ * `destination`, and return how many there are
+ */
+static size SlotBlock_subtract(const SlotBlock* a, const SlotBlock* b, uint32_t* destination) {
+    uint32_t base = a->base << 16;
+    size count = 0;
+
+    if(SlotBlock_isBitmap(a)) {
+        if(!b) return SlotBlock_extract(a->data, a->base, destination);
+
+        uint64_t only[SlotSet_BITMAP_WORDS];
+
+        if(SlotBlock_isBitmap(b)) {
+            SlotSetKernels_select()->andNot(only, a->data, b->data, SlotSet_BITMAP_WORDS);
+        } else {
+            const uint16_t* others = b->data;
+            memcpy(only, a->data, _SLOT_BITMAP_BYTES);
+
+            for(uint32_t idx = 0; idx < b->count; ++idx) only[others[idx] >> 6] &= ~((uint64_t) 1 << (others[idx] & 63));
+        }
+
+        return SlotBlock_extract(only, a->base, destination);
+    }
+
+    const uint16_t* values = a->data;
+
+    for(uint32_t idx = 0; idx < a->count; ++idx) {
+        if(!b || !SlotBlock_contains(b, values[idx])) destination[count++] = base | values[idx];
+    }
+
+    return count;
+}
+
+size SlotSet_intersectionCount(const SlotSet* a, const SlotSet* b) {
+    size count = 0;
+
+    for(uint32_t left = 0, right = 0; left < a->blocksCount && right < b->blocksCount; ) {
+        if(a->blocks[left].base < b->blocks[right].base) {
+            ++left;
+        } else if(a->blocks[left].base > b->blocks[right].base) {
+            ++right;
+        } else {
+            count += SlotBlock_intersect(&a->blocks[left++], &b->blocks[right++], NULL);
+        }
+    }
+
+    return count;
+}
+
+size SlotSet_intersection(const SlotSet* a, const SlotSet* b, uint32_t* destination) {
+    size count = 0;
+
+    for(uint32_t left = 0, right = 0; left < a->blocksCount && right < b->blocksCount; ) {
+        if(a->blocks[left].base < b->blocks[right].base) {
+            ++left;
+        } else if(a->blocks[left].base > b->blocks[right].base) {
+            ++right;
+        } else {
+            count += SlotBlock_intersect(&a->blocks[left++], &b->blocks[right++], &destination[count]);
+        }
+    }
+
+    return count;
+}
+
+size SlotSet_difference(const SlotSet* a, const SlotSet* b, uint32_t* destination) {
+    size count = 0;
+    uint32_t right = 0;
+
+    for(uint32_t left = 0; left < a->blocksCount; ++left) {
+        while(right < b->blocksCount && b->blocks[right].base < a->blocks[left].base) ++right;
+
+        const SlotBlock* other = right < b->blocksCount && b->blocks[right].base == a->blocks[left].base
+                                 ? &b->blocks[right] : NULL;
+
+        count += SlotBlock_subtract(&a->blocks[left], other, &destination[count]);
+    }
+
+    return count;
+}
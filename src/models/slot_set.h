@@ -0,0 +1,160 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * Slot Set Header:
+ *
+ * Describes a compressed set of arena slots, used to hold the students of each course for set queries between
+ * rosters: who takes both of two courses, who takes one but not the other, and how many take both.
+ *
+ * Slots are grouped in to blocks of 65536 by their upper 16 bits, in the manner of a roaring bitmap. A block holds
+ * either a sorted array of the lower 16 bits of its slots, while it has up to SlotSet_ARRAY_LIMIT of them, or a bitmap
+ * of all 65536 (8KiB, the size the array would have reached). Sparse sets, which are most rosters of a large book,
+ * cost two bytes a member; dense ones cost one bit a slot.
+ *
+ * Set operations walk the blocks of both sets together. Two bitmaps are combined a word at a time by the fastest set
+ * of SlotSetKernels the CPU supports: AND, or AND NOT, and a population count, 256 bits per instruction with AVX2.
+ * Arrays are merged, and an array against a bitmap probes one bit per member.
+ *
+ * Like a GradeLog, a SlotSet does not know which pool its blocks came from; every function that may allocate or
+ * release is given it.
+ */
+
+#ifndef _H_SLOT_SET
+    #define _H_SLOT_SET
+    #include <stdint.h>
+    #include "../util.h"
+    #include "pool.h"
+
+// Begin Header "slot set" ---------------------------------------------------------------------------------------------
+
+/*
+ * Members above which a block becomes a bitmap. A bitmap goes back to an array once it has half as many.
+ */
+#define SlotSet_ARRAY_LIMIT 4096
+
+/*
+ * 64 bit words in the bitmap of a block
+ */
+#define SlotSet_BITMAP_WORDS 1024
+
+typedef struct S_SlotBlock {
+
+    /*
+     * Upper 16 bits of every slot in the block
+     */
+    uint32_t base;
+
+    uint32_t count;
+
+    /*
+     * Room in the array, or 0 if the block is a bitmap
+     */
+    uint32_t capacity;
+
+    /*
+     * The lower 16 bits of each slot as an ascending array of uint16_t, or a bitmap of SlotSet_BITMAP_WORDS uint64_t
+     */
+    void* data;
+
+} SlotBlock;
+
+typedef struct S_SlotSet {
+
+    /*
+     * Blocks, ascending by base
+     */
+    SlotBlock* blocks;
+
+    uint32_t blocksCount;
+
+    uint32_t blocksCapacity;
+
+    /*
+     * Members of every block
+     */
+    size count;
+
+} SlotSet;
+
+/*
+ * Loops over the bitmaps of two blocks. Each returns the number of bits set in its result.
+ */
+typedef struct S_SlotSetKernels {
+
+    /*
+     * Instruction set the kernels are written for, such as "avx2"
+     */
+    const char* name;
+
+    /*
+     * |a & b|
+     */
+    size (*andCount)(const uint64_t* a, const uint64_t* b, size words);
+
+    /*
+     * destination = a & b
+     */
+    size (*and)(uint64_t* destination, const uint64_t* a, const uint64_t* b, size words);
+
+    /*
+     * destination = a & ~b
+     */
+    size (*andNot)(uint64_t* destination, const uint64_t* a, const uint64_t* b, size words);
+
+} SlotSetKernels;
+
+#define SlotSetKernels_MAX_SETS 2
+
+/*
+ * Return the fastest set of kernels that the CPU supports
+ */
+const SlotSetKernels* SlotSetKernels_select(void);
+
+/*
+ * Fill `sets` with every set of kernels that the CPU supports, scalar first, and return how many there are.
+ * `sets` must have room for SlotSetKernels_MAX_SETS sets.
+ */
+size SlotSetKernels_supported(const SlotSetKernels** sets);
+
+// -- Sets -------------------------------------------------------------------------------------------------------------
+
+/*
+ * Add `slot` to a set. Returns false if it was already a member. Aborts if memory could not be allocated.
+ */
+bool SlotSet_add(Pool* pool, SlotSet* set, uint32_t slot);
+
+/*
+ * Take `slot` out of a set. Returns false if it was not a member. Aborts if memory could not be allocated.
+ */
+bool SlotSet_remove(Pool* pool, SlotSet* set, uint32_t slot);
+
+bool SlotSet_contains(const SlotSet* set, uint32_t slot);
+
+/*
+ * Give every block back to the pool, leaving the set empty
+ */
+void SlotSet_free(Pool* pool, SlotSet* set);
+
+// -- Set Operations ---------------------------------------------------------------------------------------------------
+
+/*
+ * Number of slots in both `a` and `b`
+ */
+size SlotSet_intersectionCount(const SlotSet* a, const SlotSet* b);
+
+/*
+ * Write the slots in both `a` and `b` to `destination`, ascending, and return how many there are. `destination` must
+ * have room for the smaller of the two sets.
+ */
+size SlotSet_intersection(const SlotSet* a, const SlotSet* b, uint32_t* destination);
+
+/*
+ * Write the slots in `a` but not in `b` to `destination`, ascending, and return how many there are. `destination`
+ * must have room for every slot of `a`.
+ */
+size SlotSet_difference(const SlotSet* a, const SlotSet* b, uint32_t* destination);
+
+// End Header "slot set" -----------------------------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,147 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * String Pool Definitions:
+ *
+ * Implements the interning string arena described in string_pool.h
+ */
+
+#include <string.h>
+#include "string_pool.h"
+
+const size StringPool_PAGE_SIZE = 4096;
+
+static const size _STRING_POOL_INITIAL_CAPACITY = 16;
+
+/*
+ * FNV-1a over the bytes of the string
+ */
+static uint32_t StringPool_hash(const char* string, size length) {
+    uint32_t hash = 2166136261u;
+
+    for(size idx = 0; idx < length; ++idx) {
+        hash = (hash ^ (byte) string[idx]) * 16777619u;
+    }
+
+    return hash;
+}
+
+void StringPool_init(StringPool* pool, Pool* memory) {
+    memset(pool, 0, sizeof(StringPool));
+    pool->memory = memory;
+}
+
+void StringPool_free(StringPool* pool) {
+    for(size idx = 0; idx < pool->pagesCount; ++idx) {
+        Pool_release(pool->memory, pool->pages[idx], StringPool_PAGE_SIZE);
+    }
+
+    Pool_release(pool->memory, pool->pages, pool->pagesCapacity * sizeof(char*));
+    Pool_release(pool->memory, pool->entries, pool->capacity * sizeof(StringPoolEntry));
+    StringPool_init(pool, pool->memory);
+}
+
+static void StringPool_abort(const char* what, size count) {
+    fprintf(stderr, "StringPool: unable to grow to %lu %s\n", count, what);
+    abort();
+}
+
+/*
+ * Place a new entry, which is known not to be present, in the table
+ */
+static void StringPool_place(StringPool* pool, const char* string, uint32_t hash) {
+    size mask = pool->capacity - 1;
+    size pos  = hash & mask;
+
+    while(pool->entries[pos].string) pos = (pos + 1) & mask;
+
+    pool->entries[pos].string   = string;
+    pool->entries[pos].hash     = hash;
+    ++pool->count;
+}
+
+static void StringPool_resize(StringPool* pool, size capacity) {
+
+    StringPoolEntry* entries = Pool_alloc(pool->memory, capacity * sizeof(StringPoolEntry));
+
+    if(!entries) StringPool_abort("entries", capacity);
+
+    memset(entries, 0, capacity * sizeof(StringPoolEntry));
+
+    StringPool old = *pool;
+
+    pool->entries   = entries;
+    pool->capacity  = capacity;
+    pool->count     = 0;
+
+    for(size idx = 0; idx < old.capacity; ++idx) {
+        if(old.entries[idx].string) StringPool_place(pool, old.entries[idx].string, old.entries[idx].hash);
+    }
+
+    Pool_release(pool->memory, old.entries, old.capacity * sizeof(StringPoolEntry));
+}
+
+/*
+ * Copy `length` bytes of string, and a terminator, in to the pool's pages
+ */
+static const char* StringPool_store(StringPool* pool, const char* string, size length) {
+
+    if(pool->pagesCount == 0 || pool->pageUsed + length + 1 > StringPool_PAGE_SIZE) {
+        if(pool->pagesCount == pool->pagesCapacity) {
+            size capacity   = pool->pagesCapacity ? pool->pagesCapacity * 2 : 8;
+            char** pages    = Pool_resize(pool->memory, pool->pages,
+                                          pool->pagesCapacity * sizeof(char*), capacity * sizeof(char*));
+
+            if(!pages) StringPool_abort("pages", capacity);
+
+            pool->pages         = pages;
+            pool->pagesCapacity = capacity;
+        }
+
+        char* page = Pool_alloc(pool->memory, StringPool_PAGE_SIZE);
+
+        if(!page) StringPool_abort("pages", pool->pagesCount + 1);
+
+        pool->pages[pool->pagesCount++] = page;
+        pool->pageUsed                  = 0;
+    }
+
+    char* copy = pool->pages[pool->pagesCount - 1] + pool->pageUsed;
+
+    memcpy(copy, string, length);
+    copy[length] = 0x00;
+
+    pool->pageUsed += length + 1;
+
+    return copy;
+}
+
+const char* StringPool_intern(StringPool* pool, const char* string, size length) {
+
+    if(length >= StringPool_PAGE_SIZE) length = StringPool_PAGE_SIZE - 1;
+
+    uint32_t hash = StringPool_hash(string, length);
+
+    if(pool->capacity > 0) {
+        size mask = pool->capacity - 1;
+
+        for(size pos = hash & mask; pool->entries[pos].string; pos = (pos + 1) & mask) {
+            const char* candidate = pool->entries[pos].string;
+
+            if(pool->entries[pos].hash == hash && strncmp(candidate, string, length) == 0 && !candidate[length]) {
+                return candidate;
+            }
+        }
+    }
+
+    // Keep the load factor at or below 1/2, as in IdIndex
+    if((pool->count + 1) * 2 > pool->capacity) {
+        StringPool_resize(pool, pool->capacity ? pool->capacity * 2 : _STRING_POOL_INITIAL_CAPACITY);
+    }
+
+    const char* copy = StringPool_store(pool, string, length);
+    StringPool_place(pool, copy, hash);
+
+    return copy;
+}
@@ -0,0 +1,88 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * String Pool Header:
+ *
+ * Describes an interning string arena, which holds the names of students and courses away from the records themselves.
+ *
+ * Strings are copied in to pages of StringPool_PAGE_SIZE bytes, back to back, taken from the GradeBook's Pool. A page is never moved or reallocated once
+ * it has been allocated, so a string returned by StringPool_intern stays valid until the pool is freed. Interning the
+ * same text twice returns the same string, which is found through an open-addressing table in the style of IdIndex.
+ *
+ * Strings are never released one by one: the pool only grows until it is freed as a whole.
+ */
+
+#ifndef _H_STRING_POOL
+    #define _H_STRING_POOL
+    #include <stdint.h>
+    #include "../util.h"
+    #include "pool.h"
+
+// Begin Header "string pool" ------------------------------------------------------------------------------------------
+
+/*
+ * Size of one page of string data, which bounds the length of a string in the pool
+ */
+extern const size StringPool_PAGE_SIZE;
+
+typedef struct S_StringPoolEntry {
+
+    /*
+     * Interned string, or NULL for an unused entry
+     */
+    const char* string;
+
+    uint32_t hash;
+
+} StringPoolEntry;
+
+typedef struct S_StringPool {
+
+    /*
+     * Pages of string data. Only the last one is still being filled.
+     */
+    char** pages;
+
+    size pagesCount;
+
+    size pagesCapacity;
+
+    /*
+     * Bytes used in the last page
+     */
+    size pageUsed;
+
+    /*
+     * Table of interned strings, `capacity` long. Capacity is always zero or a power of two.
+     */
+    StringPoolEntry* entries;
+
+    size capacity;
+
+    size count;
+
+    /*
+     * Pool that pages and the table are allocated from
+     */
+    Pool* memory;
+
+} StringPool;
+
+void StringPool_init(StringPool* pool, Pool* memory);
+
+/*
+ * Release every page, and with them every string handed out by the pool
+ */
+void StringPool_free(StringPool* pool);
+
+/*
+ * Return the pool's copy of the first `length` characters of `string` (which must not contain a terminator), copying
+ * them in to the pool if they are not already there. Strings are cut to StringPool_PAGE_SIZE - 1 characters.
+ * Aborts if memory could not be allocated.
+ */
+const char* StringPool_intern(StringPool* pool, const char* string, size length);
+
+// End Header "string pool" --------------------------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,126 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * Worker Pool Definitions:
+ *
+ * Implements the thread pool described in worker_pool.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "worker_pool.h"
+
+/*
+ * Claim and process units of the current job until there are none left
+ */
+static void WorkerPool_drain(WorkerPool* pool) {
+    for(;;) {
+        size unit = __atomic_fetch_add(&pool->nextUnit, 1, __ATOMIC_RELAXED);
+        if(unit >= pool->unitsCount) return;
+
+        pool->task(pool->context, unit);
+    }
+}
+
+static void* WorkerPool_thread(void* argument) {
+    WorkerPool* pool = argument;
+    size done = 0;
+
+    pthread_mutex_lock(&pool->lock);
+
+    for(;;) {
+        while(pool->jobs == done && !pool->stopping) pthread_cond_wait(&pool->posted, &pool->lock);
+        if(pool->stopping) break;
+
+        done = pool->jobs;
+        pthread_mutex_unlock(&pool->lock);
+
+        WorkerPool_drain(pool);
+
+        pthread_mutex_lock(&pool->lock);
+        if(--pool->busy == 0) pthread_cond_signal(&pool->finished);
+    }
+
+    pthread_mutex_unlock(&pool->lock);
+
+    return NULL;
+}
+
+void WorkerPool_init(WorkerPool* pool, size workers) {
+
+    if(workers == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = online > 0 ? (size) online : 1;
+    }
+
+    *pool = (WorkerPool){ .threadsCount = workers - 1 };
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->posted, NULL);
+    pthread_cond_init(&pool->finished, NULL);
+
+    if(pool->threadsCount == 0) return;
+
+    pool->threads = calloc(pool->threadsCount, sizeof(pthread_t));
+
+    if(!pool->threads) {
+        fprintf(stderr, "WorkerPool: unable to allocate %lu threads\n", pool->threadsCount);
+        abort();
+    }
+
+    for(size idx = 0; idx < pool->threadsCount; ++idx) {
+        if(pthread_create(&pool->threads[idx], NULL, &WorkerPool_thread, pool) != 0) {
+            fprintf(stderr, "WorkerPool: unable to start thread %lu of %lu\n", idx + 1, pool->threadsCount);
+            abort();
+        }
+    }
+}
+
+void WorkerPool_free(WorkerPool* pool) {
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->posted);
+    pthread_mutex_unlock(&pool->lock);
+
+    for(size idx = 0; idx < pool->threadsCount; ++idx) pthread_join(pool->threads[idx], NULL);
+
+    free(pool->threads);
+
+    pthread_cond_destroy(&pool->finished);
+    pthread_cond_destroy(&pool->posted);
+    pthread_mutex_destroy(&pool->lock);
+
+    *pool = (WorkerPool){};
+}
+
+size WorkerPool_workersCount(const WorkerPool* pool) {
+    return pool ? pool->threadsCount + 1 : 1;
+}
+
+void WorkerPool_run(WorkerPool* pool, WorkerTask task, void* context, size unitsCount) {
+
+    // Waking the threads costs more than a single unit could save
+    if(!pool || pool->threadsCount == 0 || unitsCount < 2) {
+        for(size unit = 0; unit < unitsCount; ++unit) task(context, unit);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->task          = task;
+    pool->context       = context;
+    pool->unitsCount    = unitsCount;
+    pool->nextUnit      = 0;
+    pool->busy          = pool->threadsCount;
+    ++pool->jobs;
+    pthread_cond_broadcast(&pool->posted);
+    pthread_mutex_unlock(&pool->lock);
+
+    WorkerPool_drain(pool);
+
+    pthread_mutex_lock(&pool->lock);
+    while(pool->busy > 0) pthread_cond_wait(&pool->finished, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
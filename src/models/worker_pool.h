@@ -0,0 +1,99 @@
+/*
+ * Roman Hargrave, ***REMOVED***
+ * No License Declared
+ *
+ * Worker Pool Header:
+ *
+ * Describes a fixed set of threads that split a job between them, for passes over a whole GradeBook.
+ *
+ * A job is a number of units and a task that processes one unit. Every worker, and the thread that runs the job, takes
+ * the next unclaimed unit until none are left, so a job whose units differ wildly in cost still keeps every worker busy.
+ * Units should be coarse (a course, or a few hundred students): claiming one is a single atomic increment.
+ *
+ * The threads are started once, by WorkerPool_init, and sleep between jobs. One job runs at a time, and WorkerPool_run
+ * returns only when it is complete, after which everything the task wrote may be read by the caller.
+ */
+
+#ifndef _H_WORKER_POOL
+    #define _H_WORKER_POOL
+    #include <pthread.h>
+    #include "../util.h"
+
+// Begin Header "worker pool" ------------------------------------------------------------------------------------------
+
+/*
+ * Process unit `unit` of a job. Tasks run concurrently, so each must only write to what its unit owns.
+ */
+typedef void (*WorkerTask)(void* context, size unit);
+
+typedef struct S_WorkerPool {
+
+    /*
+     * Threads started in addition to the caller's
+     */
+    pthread_t* threads;
+
+    size threadsCount;
+
+    pthread_mutex_t lock;
+
+    /*
+     * Signalled when a job is posted, or the pool is stopping
+     */
+    pthread_cond_t posted;
+
+    /*
+     * Signalled when the last thread finishes its share of a job
+     */
+    pthread_cond_t finished;
+
+    WorkerTask task;
+
+    void* context;
+
+    size unitsCount;
+
+    /*
+     * Next unit to be claimed
+     */
+    size nextUnit;
+
+    /*
+     * Threads that have not yet finished with the current job
+     */
+    size busy;
+
+    /*
+     * Number of jobs posted, so a thread can tell a new job from one it has already done
+     */
+    size jobs;
+
+    bool stopping;
+
+} WorkerPool;
+
+/*
+ * Start a pool of `workers` threads in all, counting the one that will run jobs. 0 means one per online CPU.
+ * Aborts if the threads could not be started.
+ */
+void WorkerPool_init(WorkerPool* pool, size workers);
+
+/*
+ * Stop and join every thread of the pool
+ */
+void WorkerPool_free(WorkerPool* pool);
+
+/*
+ * Number of threads that take part in a job, counting the caller
+ */
+size WorkerPool_workersCount(const WorkerPool* pool);
+
+/*
+ * Run `task` over units 0 to `unitsCount` - 1, and return once every unit has been processed.
+ * A NULL pool runs every unit on the calling thread.
+ */
+void WorkerPool_run(WorkerPool* pool, WorkerTask task, void* context, size unitsCount);
+
+// End Header "worker pool" --------------------------------------------------------------------------------------------
+
+#endif
@@ -40,6 +40,7 @@ int Option_help(int argCount, char** args) {
             "    interactive [filename]     - Run in shell mode, filename defaults to `gradebook.gb`\n"
             "    dump [filename]            - Display the contents of a gradebook \n"
             "    apply <command> [filename] - Open the specified gradebook, and execute the command as in interactive mode\n"
+            "    query <filename> <command> - Answer a read-only command from an exported gradebook, without loading it\n"
             "", args[0]);
 
     return 0;
@@ -54,6 +55,7 @@ const struct A_OptionsMapping {
         {"interactive", &Option_runShellUI},
         {"apply",       &Option_runShellCmd},
         {"dump",        &Option_printGradeBook},
+        {"query",       &Option_queryGradeBook},
 };
 
 RuntimeOption dispatchOption(char* name) {
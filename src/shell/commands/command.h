@@ -14,4 +14,12 @@ typedef enum E_ShellReturn {
 
 typedef ShellReturn(*ShellCommand)(char*, GradeBook* gradeBook);
 
+/*
+ * Read the `top <k>` or `bottom <k>` arguments of a listing command, `k` defaulting to Command_RANKING_DEFAULT.
+ * Returns false, having told the user why, if they are anything else.
+ */
+bool Command_parseRanking(char* order, char* count, bool* highest, size* k);
+
+#define Command_RANKING_DEFAULT 10
+
 #endif
\ No newline at end of file
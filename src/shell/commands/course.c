@@ -9,6 +9,69 @@
 ShellReturn Command_courseList(char* args, GradeBook* gradeBook) {
 
     size nCourses = gradeBook->coursesCount;
+    char* order = strtok(args, " ");
+
+    if(order && strcmp(order, "correlate") == 0) {
+        char* count = strtok(NULL, " ");
+        long k      = count ? strtol(count, NULL, 10) : Command_RANKING_DEFAULT;
+
+        if(k <= 0) {
+            printf("`k` must be a positive number\n");
+            return SR_FAILURE;
+        }
+
+        CourseCorrelation matrix;
+
+        if(!CourseCorrelation_build(&matrix, gradeBook)) {
+            printf("There are too many courses to correlate every pair\n");
+            return SR_FAILURE;
+        }
+
+        size nPairs = nCourses * (nCourses - 1) / 2;
+        CoursePairPosition strongest[(size) k < nPairs ? (size) k : nPairs + 1];
+        size nStrongest = CourseCorrelation_strongest(&matrix, (size) k, strongest);
+
+        if(nStrongest == 0) {
+            printf("No two courses share enough graded students to be correlated\n");
+        } else {
+            char* table[nStrongest][CourseCorrelation_COLUMNS_COUNT];
+            Table_allocStrings(nStrongest, CourseCorrelation_COLUMNS_COUNT, table, 255);
+            CourseCorrelation_pairsTable(gradeBook, &matrix, strongest, nStrongest, table);
+            Table_printRows(stdout, CourseCorrelation_COLUMNS_COUNT, nStrongest, CourseCorrelation_COLUMNS, table);
+            Table_unallocStrings(nStrongest, CourseCorrelation_COLUMNS_COUNT, table);
+        }
+
+        CourseCorrelation_free(&matrix);
+
+        return SR_SUCCESS;
+    }
+
+    if(order) {
+        bool highest;
+        size k;
+
+        if(!Command_parseRanking(order, strtok(NULL, " "), &highest, &k)) return SR_FAILURE;
+
+        if(nCourses == 0) {
+            printf("There are no courses in the gradebook\n");
+            return SR_SUCCESS;
+        }
+
+        RankEntry ranked[k < nCourses ? k : nCourses];
+        size nRanked = GradeBook_rankCourses(gradeBook, k, highest, ranked);
+
+        char* table[nRanked][GradeBook_RANK_COLUMN_COUNT];
+        Table_allocStrings(nRanked, GradeBook_RANK_COLUMN_COUNT, table, 255);
+
+        GradeBook_courseRankTable(gradeBook, ranked, nRanked, table);
+
+        Table_printRows(stdout, GradeBook_RANK_COLUMN_COUNT, nRanked, GradeBook_RANK_COLUMNS, table);
+
+        Table_unallocStrings(nRanked, GradeBook_RANK_COLUMN_COUNT, table);
+
+        return SR_SUCCESS;
+    }
+
     char* table[nCourses][GradeBook_COURSE_COLUMN_COUNT];
     Table_allocStrings(nCourses, GradeBook_COURSE_COLUMN_COUNT, table, 255);
 
@@ -21,43 +84,257 @@ ShellReturn Command_courseList(char* args, GradeBook* gradeBook) {
     return SR_SUCCESS;
 }
 
+/*
+ * Read the curve of `course curve` from the words left in strtok's string:
+ * - offset <n>: add n, which may be negative
+ * - scale <factor>: multiply by factor, to the nearest 1/256th
+ * - clamp <low> <high>: raise grades below low to it, and lower grades above high to it
+ * - map <from>=<to> ...: move each grade `from` to `to`, and grades between two points along the line joining them.
+ *   Grades below the first point, or above the last, move as far as it does. Points are given in order of `from`.
+ * Prints what was wrong, and returns false, if the curve could not be read.
+ */
+static bool Command_courseCurve(GradeCurve* curve) {
+    char* kind = strtok(NULL, " ");
+
+    if(!kind) {
+        printf("Please specify a curve: offset <n>, scale <factor>, clamp <low> <high>, or map <from>=<to> ...\n");
+        return false;
+    }
+
+    if(strcmp(kind, "offset") == 0) {
+        char* amount = strtok(NULL, " ");
+        long offset  = amount ? strtol(amount, NULL, 10) : 0;
+
+        if(!amount || offset < -MAX_GRADE || offset > MAX_GRADE) {
+            printf("An offset must be between -%u and %u\n", MAX_GRADE, MAX_GRADE);
+            return false;
+        }
+
+        *curve = (GradeCurve){ .kind = CURVE_OFFSET, .offset = (int) offset };
+    } else if(strcmp(kind, "scale") == 0) {
+        char* factorString  = strtok(NULL, " ");
+        double factor       = factorString ? strtod(factorString, NULL) * 256 + 0.5 : -1;
+
+        if(factor < 0 || factor > UINT16_MAX) {
+            printf("A scale must be between 0 and 255\n");
+            return false;
+        }
+
+        *curve = (GradeCurve){ .kind = CURVE_SCALE, .scale = (uint16_t) factor };
+    } else if(strcmp(kind, "clamp") == 0) {
+        char* lowString     = strtok(NULL, " ");
+        char* highString    = strtok(NULL, " ");
+        long low            = lowString ? strtol(lowString, NULL, 10) : -1;
+        long high           = highString ? strtol(highString, NULL, 10) : -1;
+
+        if(low < MIN_GRADE || high > MAX_GRADE || low > high) {
+            printf("A clamp must be two grades between %u and %u, the lower first\n", MIN_GRADE, MAX_GRADE);
+            return false;
+        }
+
+        *curve = (GradeCurve){ .kind = CURVE_CLAMP, .low = (grade) low, .high = (grade) high };
+    } else if(strcmp(kind, "map") == 0) {
+        long from[MAX_GRADE + 1], to[MAX_GRADE + 1];
+        size points = 0;
+
+        for(char* point = strtok(NULL, " "); point; point = strtok(NULL, " ")) {
+            char* end;
+
+            if(points > MAX_GRADE) {
+                printf("A map may have at most %u points\n", MAX_GRADE + 1);
+                return false;
+            }
+
+            from[points]    = strtol(point, &end, 10);
+            to[points]      = *end == '=' ? strtol(end + 1, NULL, 10) : -1;
+
+            if(*end != '=' || from[points] < MIN_GRADE || from[points] > MAX_GRADE
+               || to[points] < MIN_GRADE || to[points] > MAX_GRADE || (points > 0 && from[points] <= from[points - 1])) {
+                printf("Each point of a map must be `<from>=<to>`, both grades, in order of `from`\n");
+                return false;
+            }
+
+            ++points;
+        }
+
+        if(points == 0) {
+            printf("Please specify at least one point to map\n");
+            return false;
+        }
+
+        curve->kind = CURVE_MAP;
+
+        for(long value = MIN_GRADE, point = 0; value <= MAX_GRADE; ++value) {
+            while(point < (long) points && from[point] < value) ++point;
+
+            long mapped;
+
+            if(point == 0) {
+                mapped = value + to[0] - from[0];
+            } else if(point == (long) points) {
+                mapped = value + to[points - 1] - from[points - 1];
+            } else {
+                // Round to the nearest grade on the line from the point before to this one
+                long run    = from[point] - from[point - 1];
+                long rise   = (to[point] - to[point - 1]) * (value - from[point - 1]);
+                mapped      = to[point - 1] + (rise >= 0 ? rise + run / 2 : rise - run / 2) / run;
+            }
+
+            curve->table[value] = (grade) (mapped < MIN_GRADE ? MIN_GRADE : (mapped > MAX_GRADE ? MAX_GRADE : mapped));
+        }
+    } else {
+        printf("Invalid curve `%s`\n", kind);
+        return false;
+    }
+
+    return true;
+}
+
 ShellReturn Command_course(char* args, GradeBook* gradeBook) {
 
     char* action    = strtok(args, " ");
     char* courseId  = strtok(NULL, " ");
 
     if(!action | !courseId) {
-        printf("Please specify an action and courseId (show, add, rm)\n");
+        printf("Please specify an action and courseId (show, stats, scores, policy, curve, common, except, add, rm)\n");
         return SR_FAILURE;
     }
 
-    size idNum = strtoul(courseId, NULL, 10);
+    long idNum = strtol(courseId, NULL, 10);
 
-    if(idNum > BYTE_MAX) {
-        printf("`id` must be a value between %u and %u inclusive\n", BYTE_MIN, BYTE_MAX);
+    if(!Course_isValidId(idNum)) {
+        printf("`id` must be a value between %lu and %lu inclusive\n", (unsigned long) ID_MIN, (unsigned long) ID_MAX);
         return SR_FAILURE;
     }
 
-    Course* course = bsearch(&(Course){.courseId = (byte)idNum}, gradeBook->courses, gradeBook->coursesCount, sizeof(Course), &Course_compareById);
+    Course* course = GradeBook_findCourse(gradeBook, (identifier) idNum);
 
     if(!course && (strcmp(action, "add") != 0)) {
-        printf("No course could be found with the courseId `%lu`\n", idNum);
+        printf("No course could be found with the courseId `%ld`\n", idNum);
         return SR_FAILURE;
     }
 
     if((strcmp(action, "show") == 0)) {
         size nStudents = Course_studentsCount(course);
-        printf("Course «%s». %lu students. Overall average is %3.02f\n\n", course->courseName, nStudents, Course_averageGrade(course));
+        printf("Course «%s». %lu students. Overall average is %3.02f\n\n", course->courseName, nStudents, Course_averageGrade(gradeBook, course));
 
         char* table[nStudents][Course_STUDENT_COLUMNS_COUNT];
         Table_allocStrings(nStudents, Course_STUDENT_COLUMNS_COUNT, table, 255);
-        Course_studentsTable(course, table);
+        Course_studentsTable(gradeBook, course, table);
         Table_printRows(stdout, Course_STUDENT_COLUMNS_COUNT, nStudents, Course_STUDENT_COLUMNS, table);
         Table_unallocStrings(nStudents, Course_STUDENT_COLUMNS_COUNT, table);
+    } else if(strcmp(action, "stats") == 0) {
+        GradeDistribution distribution;
+        Course_gradeDistribution(gradeBook, course, &distribution);
+
+        if(distribution.count == 0) {
+            printf("Course «%s» has no grades\n", course->courseName);
+            return SR_SUCCESS;
+        }
+
+        GradeSummary summary = Course_gradeSummary(gradeBook, course);
+
+        printf("Course «%s». %lu grades from %lu students\n\n", course->courseName, distribution.count,
+               Course_studentsCount(course));
+        printf("Mean      %6.02f    Std. dev. %6.02f\n", GradeDistribution_mean(&distribution),
+               GradeDistribution_stddev(&distribution));
+        printf("Median    %6.02f    Mode      %6u\n", GradeDistribution_median(&distribution),
+               GradeDistribution_mode(&distribution));
+        printf("Lowest    %6u    Highest   %6u\n", summary.smallest, summary.largest);
+        printf("P10       %6u    P25       %6u\n", GradeDistribution_percentile(&distribution, 10),
+               GradeDistribution_percentile(&distribution, 25));
+        printf("P75       %6u    P90       %6u\n", GradeDistribution_percentile(&distribution, 75),
+               GradeDistribution_percentile(&distribution, 90));
+    } else if(strcmp(action, "policy") == 0) {
+        char* policy = strtok(NULL, "");
+        char text[255];
+
+        if(policy && strcmp(policy, "none") == 0) {
+            Course_setPolicy(gradeBook, course, NULL);
+            printf("Course «%s» is graded by plain average\n", course->courseName);
+        } else if(policy) {
+            GradingPlan plan;
+            GradingPlanStatus status = GradingPlan_compile(policy, &plan);
+
+            switch(status) {
+                case PLAN_COMPILED:
+                    break;
+                case PLAN_TOO_LARGE:
+                    printf("The policy has too many categories or grades, or drops too many grades\n");
+                    return SR_FAILURE;
+                case PLAN_BAD_VALUE:
+                    printf("Weights must be positive, drops fewer than the category's grades, and caps at most %u\n",
+                           MAX_GRADE);
+                    return SR_FAILURE;
+                default:
+                    printf("Each category must be `<name> <count> [weight <w>] [drop <d>] [cap <c>]`, separated by "
+                           "commas\n");
+                    return SR_FAILURE;
+            }
+
+            Course_setPolicy(gradeBook, course, &plan);
+            printf("Policy set\n");
+        } else if(!Course_policy(gradeBook, course)) {
+            printf("Course «%s» is graded by plain average\n", course->courseName);
+        } else if(GradingPlan_format(Course_policy(gradeBook, course), text, sizeof(text))) {
+            printf("Course «%s» is graded by: %s\n", course->courseName, text);
+        } else {
+            printf("Course «%s» is graded by a policy too long to show\n", course->courseName);
+        }
+    } else if(strcmp(action, "scores") == 0) {
+        size nStudents = Course_studentsCount(course);
+
+        printf("Course «%s». %lu students, scored by %s\n\n", course->courseName, nStudents,
+               Course_policy(gradeBook, course) ? "policy" : "plain average");
+
+        char* table[nStudents][Course_SCORE_COLUMNS_COUNT];
+        Table_allocStrings(nStudents, Course_SCORE_COLUMNS_COUNT, table, 255);
+        Course_scoresTable(gradeBook, course, table);
+        Table_printRows(stdout, Course_SCORE_COLUMNS_COUNT, nStudents, Course_SCORE_COLUMNS, table);
+        Table_unallocStrings(nStudents, Course_SCORE_COLUMNS_COUNT, table);
+    } else if(strcmp(action, "curve") == 0) {
+        GradeCurve curve;
+
+        if(!Command_courseCurve(&curve)) return SR_FAILURE;
+
+        size nGrades = GradeBook_curveCourse(gradeBook, course, &curve);
+        printf("Curved %lu grades of course «%s». Overall average is now %3.02f\n", nGrades, course->courseName,
+               Course_averageGrade(gradeBook, course));
+    } else if(strcmp(action, "common") == 0 || strcmp(action, "except") == 0) {
+        char* otherId = strtok(NULL, " ");
+
+        if(!otherId) {
+            printf("Please specify a second courseId to compare with\n");
+            return SR_FAILURE;
+        }
+
+        long otherNum = strtol(otherId, NULL, 10);
+        Course* other = Course_isValidId(otherNum) ? GradeBook_findCourse(gradeBook, (identifier) otherNum) : NULL;
+
+        if(!other) {
+            printf("No course could be found with the courseId `%s`\n", otherId);
+            return SR_FAILURE;
+        }
+
+        bool common     = strcmp(action, "common") == 0;
+        size nRoom      = Course_studentsCount(course);
+        Student* students[nRoom ? nRoom : 1];
+
+        size nStudents  = common ? Course_commonStudents(gradeBook, course, other, students)
+                                 : Course_exclusiveStudents(gradeBook, course, other, students);
+
+        printf("%lu students of «%s» %s «%s»\n\n", nStudents, course->courseName,
+               common ? "also take" : "do not take", other->courseName);
+
+        char* table[nStudents][GradeBook_STUDENT_COLUMN_COUNT];
+        Table_allocStrings(nStudents, GradeBook_STUDENT_COLUMN_COUNT, table, 255);
+        GradeBook_studentListTable(gradeBook, students, nStudents, table);
+        Table_printRows(stdout, GradeBook_STUDENT_COLUMN_COUNT, nStudents, GradeBook_STUDENT_TABLE_COLUMNS, table);
+        Table_unallocStrings(nStudents, GradeBook_STUDENT_COLUMN_COUNT, table);
     } else if(strcmp(action, "add") == 0) {
 
-        if(gradeBook->coursesCount >= NMEMBERS(gradeBook->courses, Course)) {
-            printf("No more courses may be stored in the gradebook\n");
+        if(course) {
+            printf("A course with the courseId `%ld` already exists\n", idNum);
             return SR_FAILURE;
         }
 
@@ -70,11 +347,10 @@ ShellReturn Command_course(char* args, GradeBook* gradeBook) {
         String_trim(nameBuffer);
 
         Course newCourse = {
-                .courseId = (byte) idNum,
+                .courseId   = (identifier) idNum,
+                .courseName = nameBuffer
         };
 
-        strcpy(newCourse.courseName, nameBuffer);
-
         GradeBook_addCourse(gradeBook, newCourse);
 
         printf("Course added\n");
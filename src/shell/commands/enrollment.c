@@ -9,12 +9,12 @@
 static const char* ACTION_ADD = "add";
 static const char* ACTION_DEL = "rm";
 
-Course* Command_enroll_grade_findCourse(GradeBook* book, byte cid) {
-    return bsearch(&(Course){.courseId = cid}, book->courses, book->coursesCount, sizeof(Course), &Course_compareById);
+Course* Command_enroll_grade_findCourse(GradeBook* book, identifier cid) {
+    return GradeBook_findCourse(book, cid);
 }
 
-Student* Command_enroll_grade_findStudent(GradeBook* book, byte sid) {
-    return bsearch(&(Student){.studentId = sid}, book->students, book->studentsCount, sizeof(Student), &Student_compareById);
+Student* Command_enroll_grade_findStudent(GradeBook* book, identifier sid) {
+    return GradeBook_findStudent(book, sid);
 }
 
 ShellReturn Command_enroll(char* args, GradeBook* gradeBook) {
@@ -28,18 +28,18 @@ ShellReturn Command_enroll(char* args, GradeBook* gradeBook) {
         return SR_FAILURE;
     }
 
-    int cid = atoi(cidString);
-    int sid = atoi(sidString);
+    long cid = strtol(cidString, NULL, 10);
+    long sid = strtol(sidString, NULL, 10);
 
     if(Course_isValidId(cid) == false || Student_isValidId(sid) == false) {
         printf( "Valid course and student ID's must be specified\n");
         return SR_FAILURE;
     }
 
-    d_printf("Looking up course %i, student %i\n", cid, sid);
+    d_printf("Looking up course %li, student %li\n", cid, sid);
 
-    Course* course      = Command_enroll_grade_findCourse(gradeBook, (byte) cid);
-    Student* student    = Command_enroll_grade_findStudent(gradeBook, (byte) sid);
+    Course* course      = Command_enroll_grade_findCourse(gradeBook, (identifier) cid);
+    Student* student    = Command_enroll_grade_findStudent(gradeBook, (identifier) sid);
 
     char* studentString = Student_toString(student);
     char* courseString  = Course_toString(course);
@@ -56,18 +56,18 @@ ShellReturn Command_enroll(char* args, GradeBook* gradeBook) {
 
     if(strcasecmp(action, ACTION_ADD) == 0) {
 
-        bool success = Course_addStudent(course, student);
+        bool success = Course_addStudent(gradeBook, course, student);
 
         if(success == true) {
             printf("Student added to course\n");
             return SR_SUCCESS;
         } else {
-            printf("Student could not be added. Perhaps the course is full?\n");
+            printf("Student could not be added. Perhaps they are already enrolled?\n");
             return SR_FAILURE;
         }
     } else if(strcasecmp(action, ACTION_DEL) == 0) {
 
-        bool success = Course_remStudent(course, student);
+        bool success = Course_remStudent(gradeBook, course, student);
 
         if(success == true) {
             printf("Student removed from course\n");
@@ -96,8 +96,8 @@ ShellReturn Command_grade(char* args, GradeBook* gradeBook) {
         return SR_FAILURE;
     }
 
-    int sid             = atoi(sidString);
-    int cid             = atoi(cidString);
+    long sid            = strtol(sidString, NULL, 10);
+    long cid            = strtol(cidString, NULL, 10);
     int gradeOrIndex    = atoi(numberStr);
 
     if(!Student_isValidId(sid) || !Course_isValidId(cid)) {
@@ -113,49 +113,41 @@ ShellReturn Command_grade(char* args, GradeBook* gradeBook) {
         return SR_FAILURE;
     }
 
-    Student* student    = Command_enroll_grade_findStudent(gradeBook, (byte) sid);
-    Course* course      = Command_enroll_grade_findCourse(gradeBook, (byte) cid);
+    Student* student    = Command_enroll_grade_findStudent(gradeBook, (identifier) sid);
+    Course* course      = Command_enroll_grade_findCourse(gradeBook, (identifier) cid);
 
     if(!student) {
-        printf("No student with the id %i exists\n", sid);
+        printf("No student with the id %li exists\n", sid);
         return SR_FAILURE;
     }
 
     if(!course) {
-        printf("No course with the id %i exists\n", cid);
+        printf("No course with the id %li exists\n", cid);
         return SR_FAILURE;
     }
 
-    long indexInStudent = Student_courseIndex(student, course);
-
-    if(indexInStudent < 0) {
-        printf("The student is not not enrolled in the specified course\n");
-        return SR_FAILURE;
-    }
-
-    StudentEnrollment* enrollment = &student->courses[indexInStudent];
+    StudentEnrollment* enrollment = GradeBook_findEnrollment(gradeBook, student, course);
 
     if(!enrollment) {
-        printf("Invalid enrollment! Contact support with a coredump immediately.\n");
-        printf("idx=%l ptr=0x%x\n (%lu)\n", indexInStudent, (intptr_t) enrollment, (intptr_t) enrollment);
+        printf("The student is not not enrolled in the specified course\n");
         return SR_FAILURE;
     }
 
     if(strcmp(action, ACTION_ADD) == 0) {
 
-        Enrollment_addGrade(enrollment, (grade) gradeOrIndex);
+        Enrollment_addGrade(gradeBook, enrollment, (grade) gradeOrIndex);
 
         printf( "Student grades in course updated\n"
-                "Average in course is now %f.\n", Enrollment_average(enrollment));
+                "Average in course is now %f.\n", Enrollment_average(gradeBook, enrollment));
 
     } else if(strcmp(action, ACTION_DEL) == 0) {
 
-        if(gradeOrIndex >= enrollment->gradeCount) {
+        if(gradeOrIndex >= enrollment->grades.count) {
             printf("Speicifed grade index falls outside the grade count for this student\n");
             return SR_FAILURE;
         }
 
-        if(Enrollment_removeGrade(enrollment, (size) gradeOrIndex) == true) {
+        if(Enrollment_removeGrade(gradeBook, enrollment, (size) gradeOrIndex) == true) {
 
             printf("The specified grade was removed from the student\n");
 
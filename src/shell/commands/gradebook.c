@@ -1,21 +1,185 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "command.h"
 #include "../../models/models.h"
-
-ShellReturn Command_courseList(char* args, GradeBook* gradeBook);
-ShellReturn Command_studentList(char* args, GradeBook* gradeBook);
+#include "../../models/grade_report.h"
+#include "../../models/grade_sketch.h"
+#include "../../models/model_io.h"
+#include "../../tui.h"
+#include "../model_display.h"
 
 ShellReturn Command_index(char* args, GradeBook* gradeBook) {
 
+    // Both listings are read from one report, gathered on every core
+    WorkerPool workers;
+    GradeReport report;
+
+    WorkerPool_init(&workers, 0);
+    GradeReport_init(&report);
+    GradeReport_build(&report, gradeBook, &workers);
+    WorkerPool_free(&workers);
+
     printf( "Courses: \n"
             "\n");
 
-    Command_courseList(args, gradeBook);
+    GradeReport_printCourses(stdout, &report);
 
     printf( "Students: \n"
             "\n");
 
-    Command_studentList(args, gradeBook);
+    GradeReport_printStudents(stdout, &report);
+
+    GradeReport_free(&report);
+
+    return SR_SUCCESS;
+}
+
+bool Command_parseRanking(char* order, char* count, bool* highest, size* k) {
+
+    if(strcmp(order, "top") == 0) {
+        *highest = true;
+    } else if(strcmp(order, "bottom") == 0) {
+        *highest = false;
+    } else {
+        printf("Invalid order `%s`, expected top or bottom\n", order);
+        return false;
+    }
+
+    long number = count ? strtol(count, NULL, 10) : Command_RANKING_DEFAULT;
+
+    if(number <= 0) {
+        printf("`k` must be a positive number\n");
+        return false;
+    }
+
+    *k = (size) number;
+
+    return true;
+}
+/*
+ * What every unit of a `stats` job reads, and writes to. Unit 0 sketches the open GradeBook, and each other unit the
+ * book saved at one of the paths given.
+ */
+typedef struct S_StatsJob {
+
+    GradeBook* book;
+
+    char** paths;
+
+    GradeSketch* sketches;
+
+    /*
+     * Set by each unit whose book could not be read
+     */
+    bool* failed;
+
+} StatsJob;
+
+static void Command_statsUnit(void* context, size unit) {
+    StatsJob* job = context;
+
+    if(unit == 0) {
+        GradeSketch_addBook(&job->sketches[0], job->book);
+        return;
+    }
+
+    FILE* file = fopen(job->paths[unit - 1], "r");
+
+    if(!file) {
+        job->failed[unit] = true;
+        return;
+    }
+
+    SerialSource source;
+    SerialSource_initFile(&source, file);
+
+    // Each book is read in to a GradeBook of its own, sketched, and let go before the unit ends
+    GradeBook book;
+    GradeBook_init(&book);
+
+    if(GradeBook_decode(&source, &book) == SUCCESS) {
+        GradeSketch_addBook(&job->sketches[unit], &book);
+    } else {
+        job->failed[unit] = true;
+    }
+
+    fclose(file);
+    GradeBook_close(&book);
+}
+
+ShellReturn Command_stats(char* args, GradeBook* gradeBook) {
+
+    size nPaths = 0, pathsCapacity = 0;
+    char** paths = NULL;
+
+    for(char* path = strtok(NULL, " "); path; path = strtok(NULL, " ")) {
+        if(nPaths == pathsCapacity) {
+            pathsCapacity   = pathsCapacity ? pathsCapacity * 2 : 4;
+            paths           = realloc(paths, pathsCapacity * sizeof(char*));
+
+            if(!paths) {
+                fprintf(stderr, "stats: unable to allocate %lu paths\n", pathsCapacity);
+                abort();
+            }
+        }
+
+        paths[nPaths++] = path;
+    }
+
+    size nBooks             = nPaths + 1;
+    GradeSketch* sketches   = calloc(nBooks, sizeof(GradeSketch));
+    bool* failed            = calloc(nBooks, sizeof(bool));
+
+    if(!sketches || !failed) {
+        fprintf(stderr, "stats: unable to allocate %lu sketches\n", nBooks);
+        abort();
+    }
+
+    // Books are read and sketched on every core, then merged; only one book per worker is held at a time
+    StatsJob job = { .book = gradeBook, .paths = paths, .sketches = sketches, .failed = failed };
+    WorkerPool workers;
+
+    WorkerPool_init(&workers, 0);
+    WorkerPool_run(&workers, &Command_statsUnit, &job, nBooks);
+    WorkerPool_free(&workers);
+
+    GradeSketch total;
+    GradeSketch_init(&total);
+
+    for(size unit = 0; unit < nBooks; ++unit) {
+        if(failed[unit]) {
+            printf("Could not read a gradebook from %s; it is left out\n", paths[unit - 1]);
+        } else {
+            GradeSketch_merge(&total, &sketches[unit]);
+        }
+
+        GradeSketch_free(&sketches[unit]);
+    }
+
+    printf("%lu gradebooks. %lu courses, %lu enrollments, about %.0f distinct students\n", total.booksCount,
+           total.coursesCount, total.enrollmentsCount, DistinctSketch_estimate(&total.students));
+
+    if(total.grades.count > 0) {
+        printf("%lu grades. Mean %3.02f, std. dev. %3.02f, median %3.02f, P10 %u, P90 %u\n\n", total.grades.count,
+               GradeDistribution_mean(&total.grades), GradeDistribution_stddev(&total.grades),
+               GradeDistribution_median(&total.grades), GradeDistribution_percentile(&total.grades, 10),
+               GradeDistribution_percentile(&total.grades, 90));
+    } else {
+        printf("No grades\n\n");
+    }
+
+    size nCourses = total.coursesCount;
+    char* table[nCourses][GradeSketch_COURSE_COLUMNS_COUNT];
+    Table_allocStrings(nCourses, GradeSketch_COURSE_COLUMNS_COUNT, table, 255);
+    GradeSketch_courseTable(&total, table);
+    Table_printRows(stdout, GradeSketch_COURSE_COLUMNS_COUNT, nCourses, GradeSketch_COURSE_COLUMNS, table);
+    Table_unallocStrings(nCourses, GradeSketch_COURSE_COLUMNS_COUNT, table);
+
+    GradeSketch_free(&total);
+    free(failed);
+    free(sketches);
+    free(paths);
 
     return SR_SUCCESS;
-}
\ No newline at end of file
+}
@@ -8,6 +8,34 @@
 ShellReturn Command_studentList(char* args, GradeBook* gradeBook) {
 
     size nStudents = gradeBook->studentsCount;
+    char* order = strtok(args, " ");
+
+    if(order) {
+        bool highest;
+        size k;
+
+        if(!Command_parseRanking(order, strtok(NULL, " "), &highest, &k)) return SR_FAILURE;
+
+        if(nStudents == 0) {
+            printf("There are no students in the gradebook\n");
+            return SR_SUCCESS;
+        }
+
+        RankEntry ranked[k < nStudents ? k : nStudents];
+        size nRanked = GradeBook_rankStudents(gradeBook, k, highest, ranked);
+
+        char* table[nRanked][GradeBook_RANK_COLUMN_COUNT];
+        Table_allocStrings(nRanked, GradeBook_RANK_COLUMN_COUNT, table, 255);
+
+        GradeBook_studentRankTable(gradeBook, ranked, nRanked, table);
+
+        Table_printRows(stdout, GradeBook_RANK_COLUMN_COUNT, nRanked, GradeBook_RANK_COLUMNS, table);
+
+        Table_unallocStrings(nRanked, GradeBook_RANK_COLUMN_COUNT, table);
+
+        return SR_SUCCESS;
+    }
+
     char* table[nStudents][GradeBook_STUDENT_COLUMN_COUNT];
     Table_allocStrings(nStudents, GradeBook_STUDENT_COLUMN_COUNT, table, 255);
 
@@ -31,33 +59,33 @@ ShellReturn Command_student(char* args, GradeBook* gradeBook) {
         return SR_FAILURE;
     }
 
-    size idNum = strtoul(studentId, NULL, 10);
+    long idNum = strtol(studentId, NULL, 10);
 
-    if(idNum > BYTE_MAX) {
-        printf("`id` must be a value between %u and %u inclusive\n", BYTE_MIN, BYTE_MAX);
+    if(!Student_isValidId(idNum)) {
+        printf("`id` must be a value between %lu and %lu inclusive\n", (unsigned long) ID_MIN, (unsigned long) ID_MAX);
         return SR_FAILURE;
     }
 
-    Student* student = bsearch(&(Student){.studentId = (byte)idNum}, gradeBook->students, gradeBook->studentsCount, sizeof(Student), &Student_compareById);
+    Student* student = GradeBook_findStudent(gradeBook, (identifier) idNum);
 
     if(!student && (strcmp(action, "add") != 0)) {
-        printf("No student could be found with the studentId `%lu`\n", idNum);
+        printf("No student could be found with the studentId `%ld`\n", idNum);
         return SR_FAILURE;
     }
 
     if((strcmp(action, "show") == 0)) {
         size nCourses = Student_coursesCount(student);
-        printf("Student «%s». %lu courses. Overall average is %3.02f\n\n", student->studentName, Student_coursesCount(student), Student_averageGrade(student));
+        printf("Student «%s». %lu courses. Overall average is %3.02f\n\n", student->studentName, nCourses, Student_averageGrade(gradeBook, student));
 
         char* table[nCourses][Student_COURSE_COLUMNS_COUNT];
         Table_allocStrings(nCourses, Student_COURSE_COLUMNS_COUNT, table, 255);
-        Student_coursesTable(student, table);
+        Student_coursesTable(gradeBook, student, table);
         Table_printRows(stdout, Student_COURSE_COLUMNS_COUNT, nCourses, Student_COURSE_COLUMNS, table);
         Table_unallocStrings(nCourses, Student_COURSE_COLUMNS_COUNT, table);
     } else if(strcmp(action, "add") == 0) {
 
-        if(gradeBook->studentsCount >= NMEMBERS(gradeBook->students, student)) {
-            printf("No more students may be stored in the gradebook\n");
+        if(student) {
+            printf("A student with the studentId `%ld` already exists\n", idNum);
             return SR_FAILURE;
         }
 
@@ -70,11 +98,10 @@ ShellReturn Command_student(char* args, GradeBook* gradeBook) {
         String_trim(nameBuffer);
 
         Student newStudent = {
-                .studentId = (byte) idNum,
+                .studentId      = (identifier) idNum,
+                .studentName    = nameBuffer
         };
 
-        strcpy(newStudent.studentName, nameBuffer);
-
         GradeBook_addStudent(gradeBook, newStudent);
 
         printf("Student added\n");
@@ -13,34 +13,177 @@ const char* GradeBook_STUDENT_TABLE_COLUMNS[] =
 
 const size GradeBook_STUDENT_COLUMN_COUNT = 4;
 
+const char* GradeBook_RANK_COLUMNS[] =
+        {"Place", "ID", "Name", "Average Grade"};
+
+const size GradeBook_RANK_COLUMN_COUNT = 4;
+
+const char* GradeSketch_COURSE_COLUMNS[] =
+        {"Course ID", "Grades", "Students (est.)", "Mean", "Median", "P10", "P90"};
+
+const size GradeSketch_COURSE_COLUMNS_COUNT = 7;
+
+const char* CourseCorrelation_COLUMNS[] =
+        {"Course ID", "Course Name", "Other ID", "Other Name", "Shared Students", "Covariance", "Correlation"};
+
+const size CourseCorrelation_COLUMNS_COUNT = 7;
+
 const char* Course_STUDENT_COLUMNS[] =
-        {"Student ID", "Student Name", "Course Average", "Course Grades"};
+        {"Student ID", "Student Name", "Course Average", "Percentile", "Course Grades"};
+
+const size Course_STUDENT_COLUMNS_COUNT = 5;
 
-const size Course_STUDENT_COLUMNS_COUNT = 4;
+const char* Course_SCORE_COLUMNS[] =
+        {"Student ID", "Student Name", "Course Average", "Policy Score"};
+
+const size Course_SCORE_COLUMNS_COUNT = 4;
 
 const char* Student_COURSE_COLUMNS[] =
         {"Course ID", "Course Name", "Average", "Grades"};
 
 const size Student_COURSE_COLUMNS_COUNT = 4;
 
-void GradeBook_courseTable(GradeBook* gradeBook, char* table[][GradeBook_COURSE_COLUMN_COUNT]) {
+void GradeReport_courseTable(const GradeReport* report, char* table[][GradeBook_COURSE_COLUMN_COUNT]) {
 
-    for(size courseIdx = 0; courseIdx < gradeBook->coursesCount; ++courseIdx) {
-        sprintf(table[courseIdx][0], "%03u", gradeBook->courses[courseIdx].courseId);
-        strcpy(table[courseIdx][1], gradeBook->courses[courseIdx].courseName);
-        sprintf(table[courseIdx][2], "%lu", Course_studentsCount(&gradeBook->courses[courseIdx]));
-        sprintf(table[courseIdx][3], "%3.02f", Course_averageGrade(&gradeBook->courses[courseIdx]));
+    for(size courseIdx = 0; courseIdx < report->coursesCount; ++courseIdx) {
+        const RecordStatistics* course = &report->courses[courseIdx];
+        sprintf(table[courseIdx][0], "%03u", course->id);
+        strcpy(table[courseIdx][1], course->name);
+        sprintf(table[courseIdx][2], "%lu", course->enrollmentsCount);
+        sprintf(table[courseIdx][3], "%3.02f", course->average);
     }
 
 }
 
+void GradeReport_studentsTable(const GradeReport* report, char* table[][GradeBook_STUDENT_COLUMN_COUNT]) {
+
+    for(size studentIdx = 0; studentIdx < report->studentsCount; ++studentIdx) {
+        const RecordStatistics* student = &report->students[studentIdx];
+        sprintf(table[studentIdx][0], "%03u", student->id);
+        strcpy(table[studentIdx][1], student->name);
+        sprintf(table[studentIdx][2], "%lu", student->enrollmentsCount);
+        sprintf(table[studentIdx][3], "%3.02f", student->average);
+    }
+
+}
+
+void GradeReport_printCourses(FILE* stream, const GradeReport* report) {
+
+    size nCourses = report->coursesCount;
+    char* table[nCourses][GradeBook_COURSE_COLUMN_COUNT];
+    Table_allocStrings(nCourses, GradeBook_COURSE_COLUMN_COUNT, table, 255);
+
+    GradeReport_courseTable(report, table);
+
+    Table_printRows(stream, GradeBook_COURSE_COLUMN_COUNT, nCourses, GradeBook_COURSE_TABLE_COLUMNS, table);
+
+    Table_unallocStrings(nCourses, GradeBook_COURSE_COLUMN_COUNT, table);
+}
+
+void GradeReport_printStudents(FILE* stream, const GradeReport* report) {
+
+    size nStudents = report->studentsCount;
+    char* table[nStudents][GradeBook_STUDENT_COLUMN_COUNT];
+    Table_allocStrings(nStudents, GradeBook_STUDENT_COLUMN_COUNT, table, 255);
+
+    GradeReport_studentsTable(report, table);
+
+    Table_printRows(stream, GradeBook_STUDENT_COLUMN_COUNT, nStudents, GradeBook_STUDENT_TABLE_COLUMNS, table);
+
+    Table_unallocStrings(nStudents, GradeBook_STUDENT_COLUMN_COUNT, table);
+}
+
+void GradeBook_courseTable(GradeBook* gradeBook, char* table[][GradeBook_COURSE_COLUMN_COUNT]) {
+
+    GradeReport report;
+    GradeReport_init(&report);
+    GradeReport_build(&report, gradeBook, NULL);
+
+    GradeReport_courseTable(&report, table);
+
+    GradeReport_free(&report);
+}
+
 void GradeBook_studentsTable(GradeBook* gradeBook, char* table[][GradeBook_STUDENT_COLUMN_COUNT]) {
 
-    for(size studentIdx = 0; studentIdx < gradeBook->studentsCount; ++studentIdx) {
-        sprintf(table[studentIdx][0], "%03u", gradeBook->students[studentIdx].studentId);
-        strcpy(table[studentIdx][1], gradeBook->students[studentIdx].studentName);
-        sprintf(table[studentIdx][2], "%lu", Student_coursesCount(&gradeBook->students[studentIdx]));
-        sprintf(table[studentIdx][3], "%3.02f", Student_averageGrade(&gradeBook->students[studentIdx]));
+    GradeReport report;
+    GradeReport_init(&report);
+    GradeReport_build(&report, gradeBook, NULL);
+
+    GradeReport_studentsTable(&report, table);
+
+    GradeReport_free(&report);
+}
+
+void GradeBook_studentListTable(GradeBook* gradeBook, Student* const* students, size count,
+                                char* table[][GradeBook_STUDENT_COLUMN_COUNT]) {
+
+    for(size studentIdx = 0; studentIdx < count; ++studentIdx) {
+        Student* student = students[studentIdx];
+        sprintf(table[studentIdx][0], "%03u", student->studentId);
+        strcpy(table[studentIdx][1], student->studentName);
+        sprintf(table[studentIdx][2], "%lu", Student_coursesCount(student));
+        sprintf(table[studentIdx][3], "%3.02f", Student_averageGrade(gradeBook, student));
+    }
+
+}
+
+void GradeBook_courseRankTable(GradeBook* gradeBook, const RankEntry* ranked, size count,
+                               char* table[][GradeBook_RANK_COLUMN_COUNT]) {
+
+    for(size place = 0; place < count; ++place) {
+        sprintf(table[place][0], "%lu", place + 1);
+        sprintf(table[place][1], "%03u", ranked[place].id);
+        strcpy(table[place][2], GradeBook_findCourse(gradeBook, ranked[place].id)->courseName);
+        sprintf(table[place][3], "%3.02f", ranked[place].key);
+    }
+
+}
+
+void GradeSketch_courseTable(const GradeSketch* sketch, char* table[][GradeSketch_COURSE_COLUMNS_COUNT]) {
+
+    for(size courseIdx = 0; courseIdx < sketch->coursesCount; ++courseIdx) {
+        const CourseSketch* course = &sketch->courses[courseIdx];
+
+        sprintf(table[courseIdx][0], "%03u", course->courseId);
+        sprintf(table[courseIdx][1], "%lu", course->grades.count);
+        sprintf(table[courseIdx][2], "%.0f", DistinctSketch_estimate(&course->students));
+        sprintf(table[courseIdx][3], "%3.02f", GradeDistribution_mean(&course->grades));
+        sprintf(table[courseIdx][4], "%3.02f", GradeDistribution_median(&course->grades));
+        sprintf(table[courseIdx][5], "%u", GradeDistribution_percentile(&course->grades, 10));
+        sprintf(table[courseIdx][6], "%u", GradeDistribution_percentile(&course->grades, 90));
+    }
+
+}
+
+void CourseCorrelation_pairsTable(GradeBook* gradeBook, const CourseCorrelation* matrix,
+                                  const CoursePairPosition* positions, size count,
+                                  char* table[][CourseCorrelation_COLUMNS_COUNT]) {
+
+    for(size idx = 0; idx < count; ++idx) {
+        identifier first    = matrix->courseIds[positions[idx].first];
+        identifier second   = matrix->courseIds[positions[idx].second];
+        const CoursePair* pair = CourseCorrelation_pair(matrix, positions[idx].first, positions[idx].second);
+
+        sprintf(table[idx][0], "%03u", first);
+        strcpy(table[idx][1], GradeBook_findCourse(gradeBook, first)->courseName);
+        sprintf(table[idx][2], "%03u", second);
+        strcpy(table[idx][3], GradeBook_findCourse(gradeBook, second)->courseName);
+        sprintf(table[idx][4], "%u", pair->shared);
+        sprintf(table[idx][5], "%3.02f", pair->covariance);
+        sprintf(table[idx][6], "%+1.03f", pair->correlation);
+    }
+
+}
+
+void GradeBook_studentRankTable(GradeBook* gradeBook, const RankEntry* ranked, size count,
+                                char* table[][GradeBook_RANK_COLUMN_COUNT]) {
+
+    for(size place = 0; place < count; ++place) {
+        sprintf(table[place][0], "%lu", place + 1);
+        sprintf(table[place][1], "%03u", ranked[place].id);
+        strcpy(table[place][2], GradeBook_findStudent(gradeBook, ranked[place].id)->studentName);
+        sprintf(table[place][3], "%3.02f", ranked[place].key);
     }
 
 }
@@ -49,50 +192,222 @@ void gradeStringifier(const void* gVal, FILE* stream) {
     fprintf(stream, "%u", *(grade*)gVal);
 }
 
-void Course_studentsTable(Course* course, char* table[][Course_STUDENT_COLUMNS_COUNT]) {
+/*
+ * Cells are allocated 255 characters wide by every caller, which a long grade log easily outgrows
+ */
+#define _GRADES_CELL_WIDTH ((size) 255)
+
+/*
+ * Grades of an enrollment shown in a cell. Each takes at least two characters with its separator, so no more than
+ * these could fit.
+ */
+#define _GRADES_CELL_LIMIT (_GRADES_CELL_WIDTH / 2 + 1)
+
+/*
+ * Write the first `nShown` of `count` grades in to a table cell, cutting them short with an ellipsis if they are not
+ * all shown, or do not all fit
+ */
+static void gradesListCell(char* cell, const grade* grades, size nShown, size count) {
+
+    char* gradeStr = Array_toString(grades, nShown, sizeof(grade), ", ", &gradeStringifier);
+
+    if(!gradeStr) {
+        strcpy(cell, "None");
+    } else if(strlen(gradeStr) < _GRADES_CELL_WIDTH && count <= nShown) {
+        strcpy(cell, gradeStr);
+    } else {
+        size kept = strlen(gradeStr) < _GRADES_CELL_WIDTH - 4 ? strlen(gradeStr) : _GRADES_CELL_WIDTH - 4;
+        memcpy(cell, gradeStr, kept);
+        strcpy(cell + kept, "...");
+    }
+
+    free(gradeStr);
+}
+
+/*
+ * Write the grades of an enrollment in to a table cell. Only the grades that could be shown are read, however long
+ * the log is.
+ */
+static void gradesCell(GradeBook* book, StudentEnrollment* enrollment, char* cell) {
+
+    grade grades[_GRADES_CELL_LIMIT];
+    size nGrades = GradeLog_copyFirst(&book->gradeChunks, &enrollment->grades, grades, _GRADES_CELL_LIMIT);
+
+    gradesListCell(cell, grades, nGrades, enrollment->grades.count);
+}
+
+static void mappedGradesCell(const MappedEnrollment* enrollment, const grade* grades, char* cell) {
+    size nShown = enrollment->gradesCount < _GRADES_CELL_LIMIT ? enrollment->gradesCount : _GRADES_CELL_LIMIT;
+    gradesListCell(cell, grades, nShown, enrollment->gradesCount);
+}
+
+void Course_studentsTable(GradeBook* book, Course* course, char* table[][Course_STUDENT_COLUMNS_COUNT]) {
 
     size nStudents = Course_studentsCount(course);
 
+    // Each student's average is ranked against every grade given in the course
+    GradeDistribution distribution;
+    Course_gradeDistribution(book, course, &distribution);
+
     for(size idx = 0; idx < nStudents; ++idx) {
-        Student* student = course->students[idx];
+        StudentEnrollment* enrollment   = Course_enrollmentAt(book, course, idx);
+        Student* student                = GradeBook_resolveStudent(book, enrollment->student);
         if(!student){
             strcpy(table[idx][0], "(null)");
             continue;
         }
-        long selfIdx = Student_courseIndex(student, course);
-        if(selfIdx < 0) continue;
 
-        StudentEnrollment* enrollment = &student->courses[selfIdx];
+        sprintf(table[idx][0], "%03u", student->studentId);
+        strcpy(table[idx][1], student->studentName);
+        sprintf(table[idx][2], "%3.02f", Enrollment_average(book, enrollment));
+        sprintf(table[idx][3], "%3.0f", GradeDistribution_percentileRank(&distribution, Enrollment_average(book, enrollment)));
+        gradesCell(book, enrollment, table[idx][4]);
+    }
+
+}
+
+void Course_scoresTable(GradeBook* book, Course* course, char* table[][Course_SCORE_COLUMNS_COUNT]) {
+
+    size nStudents = Course_studentsCount(course);
+    float scores[nStudents ? nStudents : 1];
+
+    // Scored all at once, rather than an enrollment at a time
+    Course_policyScores(book, course, scores);
+
+    for(size idx = 0; idx < nStudents; ++idx) {
+        StudentEnrollment* enrollment   = Course_enrollmentAt(book, course, idx);
+        Student* student                = GradeBook_resolveStudent(book, enrollment->student);
 
         sprintf(table[idx][0], "%03u", student->studentId);
         strcpy(table[idx][1], student->studentName);
-        sprintf(table[idx][2], "%3.02f", Enrollment_average(enrollment));
-        char* gradeStr = Array_toString(enrollment->grades, enrollment->gradeCount, sizeof(grade), ", ", &gradeStringifier);
-        strcpy(table[idx][3], gradeStr ? gradeStr : "None");
-        free(gradeStr);
+        sprintf(table[idx][2], "%3.02f", Enrollment_average(book, enrollment));
+        sprintf(table[idx][3], "%3.02f", scores[idx]);
     }
 
 }
 
-void Student_coursesTable(Student* student, char* table[][Student_COURSE_COLUMNS_COUNT]) {
+void Student_coursesTable(GradeBook* book, Student* student, char* table[][Student_COURSE_COLUMNS_COUNT]) {
 
     size nCourses = Student_coursesCount(student);
 
     for(size idx = 0; idx < nCourses; ++idx) {
-        Course* course = student->courses[idx].course;
+        StudentEnrollment* enrollment   = Student_enrollmentAt(book, student, idx);
+        Course* course                  = GradeBook_resolveCourse(book, enrollment->course);
         if(!course) {
             strcpy(table[idx][0], "(null)");
             continue;
         }
 
-        StudentEnrollment* enrollment = &student->courses[idx];
-
         sprintf(table[idx][0], "%02u", course->courseId);
         strcpy(table[idx][1], course->courseName);
-        sprintf(table[idx][2], "%3.02f", Enrollment_average(enrollment));
-        char* gradeStr = Array_toString(enrollment->grades, enrollment->gradeCount, sizeof(grade), ", ", &gradeStringifier);
-        strcpy(table[idx][3], (gradeStr ?  gradeStr : "None"));
-        free(gradeStr);
+        sprintf(table[idx][2], "%3.02f", Enrollment_average(book, enrollment));
+        gradesCell(book, enrollment, table[idx][3]);
+    }
+
+}
+
+// Mapped GradeBook ----------------------------------------------------------------------------------------------------
+
+void GradeBookMap_courseTable(const GradeBookMap* map, char* table[][GradeBook_COURSE_COLUMN_COUNT]) {
+
+    for(size courseIdx = 0; courseIdx < map->coursesCount; ++courseIdx) {
+        const MappedCourse* course = &map->courses[courseIdx];
+        sprintf(table[courseIdx][0], "%03u", course->courseId);
+        strcpy(table[courseIdx][1], GradeBookMap_courseName(map, course));
+        sprintf(table[courseIdx][2], "%u", course->studentsCount);
+        sprintf(table[courseIdx][3], "%3.02f", MappedCourse_average(course));
+    }
+
+}
+
+void GradeBookMap_studentsTable(const GradeBookMap* map, char* table[][GradeBook_STUDENT_COLUMN_COUNT]) {
+
+    for(size studentIdx = 0; studentIdx < map->studentsCount; ++studentIdx) {
+        const MappedStudent* student = &map->students[studentIdx];
+        sprintf(table[studentIdx][0], "%03u", student->studentId);
+        strcpy(table[studentIdx][1], GradeBookMap_studentName(map, student));
+        sprintf(table[studentIdx][2], "%u", student->coursesCount);
+        sprintf(table[studentIdx][3], "%3.02f", MappedStudent_average(student));
+    }
+
+}
+
+void GradeBookMap_printCourses(FILE* stream, const GradeBookMap* map) {
+
+    size nCourses = map->coursesCount;
+    char* table[nCourses][GradeBook_COURSE_COLUMN_COUNT];
+    Table_allocStrings(nCourses, GradeBook_COURSE_COLUMN_COUNT, table, 255);
+
+    GradeBookMap_courseTable(map, table);
+
+    Table_printRows(stream, GradeBook_COURSE_COLUMN_COUNT, nCourses, GradeBook_COURSE_TABLE_COLUMNS, table);
+
+    Table_unallocStrings(nCourses, GradeBook_COURSE_COLUMN_COUNT, table);
+}
+
+void GradeBookMap_printStudents(FILE* stream, const GradeBookMap* map) {
+
+    size nStudents = map->studentsCount;
+    char* table[nStudents][GradeBook_STUDENT_COLUMN_COUNT];
+    Table_allocStrings(nStudents, GradeBook_STUDENT_COLUMN_COUNT, table, 255);
+
+    GradeBookMap_studentsTable(map, table);
+
+    Table_printRows(stream, GradeBook_STUDENT_COLUMN_COUNT, nStudents, GradeBook_STUDENT_TABLE_COLUMNS, table);
+
+    Table_unallocStrings(nStudents, GradeBook_STUDENT_COLUMN_COUNT, table);
+}
+
+void MappedCourse_studentsTable(const GradeBookMap* map, const MappedCourse* course,
+                                char* table[][Course_STUDENT_COLUMNS_COUNT]) {
+
+    // The file keeps no histograms, so the course's grades are counted here, in the one pass over them
+    GradeDistribution distribution;
+    memset(&distribution, 0, sizeof(GradeDistribution));
+
+    for(size idx = 0; idx < course->studentsCount; ++idx) {
+        const MappedEnrollment* enrollment  = GradeBookMap_rosterAt(map, course, idx);
+        const grade* grades                 = enrollment ? GradeBookMap_grades(map, enrollment) : NULL;
+        if(!grades) continue;
+
+        for(size gradeIdx = 0; gradeIdx < enrollment->gradesCount; ++gradeIdx) ++distribution.counts[grades[gradeIdx]];
+        distribution.count += enrollment->gradesCount;
+    }
+
+    for(size idx = 0; idx < course->studentsCount; ++idx) {
+        const MappedEnrollment* enrollment  = GradeBookMap_rosterAt(map, course, idx);
+        const MappedStudent* student        = enrollment ? GradeBookMap_enrollmentStudent(map, enrollment) : NULL;
+        const grade* grades                 = enrollment ? GradeBookMap_grades(map, enrollment) : NULL;
+        if(!student || !grades) {
+            strcpy(table[idx][0], "(null)");
+            continue;
+        }
+
+        sprintf(table[idx][0], "%03u", student->studentId);
+        strcpy(table[idx][1], GradeBookMap_studentName(map, student));
+        sprintf(table[idx][2], "%3.02f", MappedEnrollment_average(enrollment));
+        sprintf(table[idx][3], "%3.0f", GradeDistribution_percentileRank(&distribution, MappedEnrollment_average(enrollment)));
+        mappedGradesCell(enrollment, grades, table[idx][4]);
+    }
+
+}
+
+void MappedStudent_coursesTable(const GradeBookMap* map, const MappedStudent* student,
+                                char* table[][Student_COURSE_COLUMNS_COUNT]) {
+
+    for(size idx = 0; idx < student->coursesCount; ++idx) {
+        const MappedEnrollment* enrollment  = GradeBookMap_transcriptAt(map, student, idx);
+        const MappedCourse* course          = enrollment ? GradeBookMap_enrollmentCourse(map, enrollment) : NULL;
+        const grade* grades                 = enrollment ? GradeBookMap_grades(map, enrollment) : NULL;
+        if(!course || !grades) {
+            strcpy(table[idx][0], "(null)");
+            continue;
+        }
+
+        sprintf(table[idx][0], "%02u", course->courseId);
+        strcpy(table[idx][1], GradeBookMap_courseName(map, course));
+        sprintf(table[idx][2], "%3.02f", MappedEnrollment_average(enrollment));
+        mappedGradesCell(enrollment, grades, table[idx][3]);
     }
 
 }
@@ -1,6 +1,11 @@
 #ifndef _H_MODEL_DISPLAY
     #define _H_MODEL_DISPLAY
+    #include <stdio.h>
     #include "../models/models.h"
+    #include "../models/grade_report.h"
+    #include "../models/grade_sketch.h"
+    #include "../models/course_correlation.h"
+    #include "../models/gradebook_map.h"
 
 // Begin header "model display" ----------------------------------------------------------------------------------------
 
@@ -12,17 +17,90 @@ extern const char* GradeBook_STUDENT_TABLE_COLUMNS[];
 
 extern const size GradeBook_STUDENT_COLUMN_COUNT;
 
+/*
+ * Fill the course, or student, listing of a report
+ */
+void GradeReport_courseTable(const GradeReport* report, char* destination[][GradeBook_COURSE_COLUMN_COUNT]);
+
+void GradeReport_studentsTable(const GradeReport* report, char* destination[][GradeBook_STUDENT_COLUMN_COUNT]);
+
+/*
+ * Print the course, or student, listing of a report to `stream`
+ */
+void GradeReport_printCourses(FILE* stream, const GradeReport* report);
+
+void GradeReport_printStudents(FILE* stream, const GradeReport* report);
+
+/*
+ * Fill a listing from a report built on the calling thread. Where both listings are printed, build one GradeReport
+ * and use the GradeReport_ functions instead.
+ */
 void GradeBook_courseTable(GradeBook* gradeBook, char* destination[][GradeBook_COURSE_COLUMN_COUNT]);
 
 void GradeBook_studentsTable(GradeBook* gradeBook, char* destination[][GradeBook_STUDENT_COLUMN_COUNT]);
 
+/*
+ * Fill the student listing for `count` students, such as those from Course_commonStudents
+ */
+void GradeBook_studentListTable(GradeBook* gradeBook, Student* const* students, size count,
+                                char* table[][GradeBook_STUDENT_COLUMN_COUNT]);
+
+extern const char* GradeBook_RANK_COLUMNS[];
+
+extern const size GradeBook_RANK_COLUMN_COUNT;
+
+/*
+ * Place, ID, name and average of each course, or student, in a ranking from GradeBook_rankCourses or
+ * GradeBook_rankStudents
+ */
+void GradeBook_courseRankTable(GradeBook* gradeBook, const RankEntry* ranked, size count,
+                               char* table[][GradeBook_RANK_COLUMN_COUNT]);
+
+void GradeBook_studentRankTable(GradeBook* gradeBook, const RankEntry* ranked, size count,
+                                char* table[][GradeBook_RANK_COLUMN_COUNT]);
+
+extern const char* GradeSketch_COURSE_COLUMNS[];
+
+extern const size GradeSketch_COURSE_COLUMNS_COUNT;
+
+/*
+ * Each course of a sketch, with the number of grades given in it, its estimated number of distinct students, and its
+ * grades' mean, median and 10th and 90th percentiles
+ */
+void GradeSketch_courseTable(const GradeSketch* sketch, char* table[][GradeSketch_COURSE_COLUMNS_COUNT]);
+
+extern const char* CourseCorrelation_COLUMNS[];
+
+extern const size CourseCorrelation_COLUMNS_COUNT;
+
+/*
+ * Both courses of each pair of a matrix at `positions`, with the number of students they share, and the covariance and
+ * correlation of those students' averages
+ */
+void CourseCorrelation_pairsTable(GradeBook* gradeBook, const CourseCorrelation* matrix,
+                                  const CoursePairPosition* positions, size count,
+                                  char* table[][CourseCorrelation_COLUMNS_COUNT]);
+
 // Course --------------------------------------------------------------------------------------------------------------
 
 extern const char* Course_STUDENT_COLUMNS[];
 
 extern const size Course_STUDENT_COLUMNS_COUNT;
 
-void Course_studentsTable(Course* course, char* table[][Course_STUDENT_COLUMNS_COUNT]);
+/*
+ * Students enrolled in a course, with their average in it, the percentage of the course's grades at or below that
+ * average, and their grades
+ */
+void Course_studentsTable(GradeBook* book, Course* course, char* table[][Course_STUDENT_COLUMNS_COUNT]);
+
+extern const char* Course_SCORE_COLUMNS[];
+
+extern const size Course_SCORE_COLUMNS_COUNT;
+
+/*
+ * Students enrolled in a course, with their average in it, and their score by the course's grading policy
+ */
+void Course_scoresTable(GradeBook* book, Course* course, char* table[][Course_SCORE_COLUMNS_COUNT]);
 
 // Student -------------------------------------------------------------------------------------------------------------
 
@@ -30,7 +108,30 @@ extern const char* Student_COURSE_COLUMNS[];
 
 extern const size Student_COURSE_COLUMNS_COUNT;
 
-void Student_coursesTable(Student* student, char* table[][Course_STUDENT_COLUMNS_COUNT]);
+void Student_coursesTable(GradeBook* book, Student* student, char* table[][Student_COURSE_COLUMNS_COUNT]);
+
+// Mapped GradeBook ----------------------------------------------------------------------------------------------------
+
+/*
+ * The same listings as above, read from a mapped GradeBook file (see gradebook_map.h). Records the file names but does
+ * not hold are shown as "(null)".
+ */
+void GradeBookMap_courseTable(const GradeBookMap* map, char* table[][GradeBook_COURSE_COLUMN_COUNT]);
+
+void GradeBookMap_studentsTable(const GradeBookMap* map, char* table[][GradeBook_STUDENT_COLUMN_COUNT]);
+
+/*
+ * Print the course, or student, listing of a mapped GradeBook to `stream`
+ */
+void GradeBookMap_printCourses(FILE* stream, const GradeBookMap* map);
+
+void GradeBookMap_printStudents(FILE* stream, const GradeBookMap* map);
+
+void MappedCourse_studentsTable(const GradeBookMap* map, const MappedCourse* course,
+                                char* table[][Course_STUDENT_COLUMNS_COUNT]);
+
+void MappedStudent_coursesTable(const GradeBookMap* map, const MappedStudent* student,
+                                char* table[][Student_COURSE_COLUMNS_COUNT]);
 
 // End header "model display" ------------------------------------------------------------------------------------------
 
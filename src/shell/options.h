@@ -11,6 +11,8 @@ int Option_runShellCmd(int argCount, char** args);
 
 int Option_printGradeBook(int argCount, char** args);
 
+int Option_queryGradeBook(int argCount, char** args);
+
 // End header "run options" --------------------------------------------------------------------------------------------
 
 #endif
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include "options.h"
 #include "../models/models.h"
 #include "../models/model_io.h"
+#include "../models/gradebook_map.h"
+#include "../models/grade_report.h"
 #include "model_display.h"
 #include "../tui.h"
 
@@ -14,15 +16,41 @@ int Option_printGradeBook(int argCount, char** args) {
 
     const char* gradeBookPath = args[2];
 
+    // An exported GradeBook is listed where it lies, without being loaded
+    GradeBookMap map;
+
+    switch(GradeBookMap_open(&map, gradeBookPath)) {
+        case SUCCESS:
+            printf("Courses: \n");
+            GradeBookMap_printCourses(stdout, &map);
+            printf("\n");
+            printf("Students: \n");
+            GradeBookMap_printStudents(stdout, &map);
+            GradeBookMap_close(&map);
+            return 0;
+        case SHORT_BUFFER:
+            printf("The grade book file was not large enough and may be corrupt.\n");
+            return 1;
+        default:
+            break;
+    }
+
     FILE* stream = fopen(gradeBookPath, "r");
-    long fileSize = fsize(stream);
-    byte fileBuffer[fileSize];
-    fread(fileBuffer, (size) fileSize, sizeof(byte), stream);
-    fclose(stream);
+
+    if(!stream) {
+        printf("Unable to open %s\n", gradeBookPath);
+        return 1;
+    }
 
     GradeBook index = {};
+    GradeBook_init(&index);
+
+    SerialSource source;
+    SerialSource_initFile(&source, stream);
+
+    SerializationStatus status = GradeBook_decode(&source, &index);
+    fclose(stream);
 
-    SerializationStatus status = GradeBook_deserialize(fileBuffer, &index);
     switch(status) {
         case SHORT_BUFFER:
             printf("The grade book file was not large enough and may be corrupt.\n");
@@ -45,28 +73,27 @@ int Option_printGradeBook(int argCount, char** args) {
     }
 
 
-    // 2-dimensional arrays containing strings of arbitrary length
-    char* courseTable[index.coursesCount][GradeBook_COURSE_COLUMN_COUNT];
-    char* studentTable[index.studentsCount][GradeBook_STUDENT_COLUMN_COUNT];
-    Table_allocStrings(index.coursesCount, GradeBook_COURSE_COLUMN_COUNT, courseTable, 255);
-    Table_allocStrings(index.studentsCount, GradeBook_STUDENT_COLUMN_COUNT, studentTable, 255);
+    WorkerPool workers;
+    GradeReport report;
 
-    GradeBook_courseTable(&index, courseTable);
-    GradeBook_studentsTable(&index, studentTable);
+    WorkerPool_init(&workers, 0);
+    GradeReport_init(&report);
+    GradeReport_build(&report, &index, &workers);
+    WorkerPool_free(&workers);
 
     printf("Courses: \n");
 
-    Table_printRows(stdout, GradeBook_COURSE_COLUMN_COUNT, index.coursesCount,
-            GradeBook_COURSE_TABLE_COLUMNS, courseTable);
+    GradeReport_printCourses(stdout, &report);
 
     printf("\n");
 
     printf("Students: \n");
-    Table_printRows(stdout, GradeBook_STUDENT_COLUMN_COUNT, index.studentsCount,
-            GradeBook_STUDENT_TABLE_COLUMNS, studentTable);
 
-    Table_unallocStrings(index.coursesCount, GradeBook_COURSE_COLUMN_COUNT, courseTable);
-    Table_unallocStrings(index.studentsCount, GradeBook_STUDENT_COLUMN_COUNT, studentTable);
+    GradeReport_printStudents(stdout, &report);
+
+    GradeReport_free(&report);
+
+    GradeBook_close(&index);
 
     return 0;
 }
\ No newline at end of file
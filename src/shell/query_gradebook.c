@@ -0,0 +1,168 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "options.h"
+#include "../models/gradebook_map.h"
+#include "model_display.h"
+#include "../tui.h"
+
+/*
+ * Read-only commands, answered from a GradeBook file in the mapped layout (see gradebook_map.h) where it lies. Nothing
+ * is read from the file but the records a command names, so a lookup costs the same in a file of any size.
+ */
+
+static bool Query_parseId(char* text, uint32_t* id) {
+
+    char* end   = NULL;
+    long number = text ? strtol(text, &end, 10) : -1;
+
+    if(!text || *end || number < 0 || number > UINT32_MAX) {
+        printf("`id` must be a value between 0 and %lu inclusive\n", (unsigned long) UINT32_MAX);
+        return false;
+    }
+
+    *id = (uint32_t) number;
+
+    return true;
+}
+
+static int Query_course(const GradeBookMap* map, char* action, char* idText) {
+
+    uint32_t courseId;
+
+    if(!action || strcmp(action, "show") != 0) {
+        printf("Only `course show <id>` may be queried\n");
+        return 1;
+    }
+
+    if(!Query_parseId(idText, &courseId)) return 1;
+
+    const MappedCourse* course = GradeBookMap_findCourse(map, courseId);
+
+    if(!course) {
+        printf("No course could be found with the courseId `%u`\n", courseId);
+        return 1;
+    }
+
+    // The counts are read from the file, and are checked against its sections before anything is allocated for them
+    if((uint64_t) course->enrollmentsStart + course->studentsCount > map->enrollmentsCount) {
+        printf("The roster of course `%u` does not lie within the GradeBook, which may be corrupt\n", courseId);
+        return 1;
+    }
+
+    size nStudents = course->studentsCount;
+    printf("Course «%s». %lu students. Overall average is %3.02f\n\n", GradeBookMap_courseName(map, course), nStudents,
+           MappedCourse_average(course));
+
+    char* table[nStudents][Course_STUDENT_COLUMNS_COUNT];
+    Table_allocStrings(nStudents, Course_STUDENT_COLUMNS_COUNT, table, 255);
+    MappedCourse_studentsTable(map, course, table);
+    Table_printRows(stdout, Course_STUDENT_COLUMNS_COUNT, nStudents, Course_STUDENT_COLUMNS, table);
+    Table_unallocStrings(nStudents, Course_STUDENT_COLUMNS_COUNT, table);
+
+    return 0;
+}
+
+static int Query_student(const GradeBookMap* map, char* action, char* idText) {
+
+    uint32_t studentId;
+
+    if(!action || strcmp(action, "show") != 0) {
+        printf("Only `student show <id>` may be queried\n");
+        return 1;
+    }
+
+    if(!Query_parseId(idText, &studentId)) return 1;
+
+    const MappedStudent* student = GradeBookMap_findStudent(map, studentId);
+
+    if(!student) {
+        printf("No student could be found with the studentId `%u`\n", studentId);
+        return 1;
+    }
+
+    if((uint64_t) student->transcriptStart + student->coursesCount > map->transcriptsCount) {
+        printf("The transcript of student `%u` does not lie within the GradeBook, which may be corrupt\n", studentId);
+        return 1;
+    }
+
+    size nCourses = student->coursesCount;
+    printf("Student «%s». %lu courses. Overall average is %3.02f\n\n", GradeBookMap_studentName(map, student), nCourses,
+           MappedStudent_average(student));
+
+    char* table[nCourses][Student_COURSE_COLUMNS_COUNT];
+    Table_allocStrings(nCourses, Student_COURSE_COLUMNS_COUNT, table, 255);
+    MappedStudent_coursesTable(map, student, table);
+    Table_printRows(stdout, Student_COURSE_COLUMNS_COUNT, nCourses, Student_COURSE_COLUMNS, table);
+    Table_unallocStrings(nCourses, Student_COURSE_COLUMNS_COUNT, table);
+
+    return 0;
+}
+
+int Option_queryGradeBook(int argCount, char** args) {
+
+    if(argCount < 4) {
+        printf("In order to query a GradeBook, you must specify a GradeBook location and a command.\n");
+        printf("The GradeBook must have been written by `export`. Commands are:\n"
+               "    index, courses, students, course show <id>, student show <id>\n");
+        return 1;
+    }
+
+    GradeBookMap map;
+
+    switch(GradeBookMap_open(&map, args[2])) {
+        case SUCCESS:
+            break;
+        case BAD_MAGIC:
+            printf("%s is not a GradeBook in the mapped layout. Write one with `export <path>`\n", args[2]);
+            return 1;
+        case SHORT_BUFFER:
+            printf("The grade book file was not large enough and may be corrupt.\n");
+            return 1;
+        default:
+            printf("Unable to map %s\n", args[2]);
+            return 1;
+    }
+
+    // The command may be given as one argument, or as several
+    size commandLength = 0;
+    for(int argIdx = 3; argIdx < argCount; ++argIdx) commandLength += strlen(args[argIdx]) + 1;
+
+    char commandText[commandLength];
+    commandText[0] = 0x00;
+
+    for(int argIdx = 3; argIdx < argCount; ++argIdx) {
+        if(argIdx > 3) strcat(commandText, " ");
+        strcat(commandText, args[argIdx]);
+    }
+
+    char* command   = strtok(commandText, " ");
+    char* action    = strtok(NULL, " ");
+    char* id        = strtok(NULL, " ");
+    int result      = 0;
+
+    if(!command) {
+        printf("No command given\n");
+        result = 1;
+    } else if(strcmp(command, "index") == 0) {
+        printf("Courses: \n\n");
+        GradeBookMap_printCourses(stdout, &map);
+        printf("Students: \n\n");
+        GradeBookMap_printStudents(stdout, &map);
+    } else if(strcmp(command, "courses") == 0) {
+        GradeBookMap_printCourses(stdout, &map);
+    } else if(strcmp(command, "students") == 0) {
+        GradeBookMap_printStudents(stdout, &map);
+    } else if(strcmp(command, "course") == 0) {
+        result = Query_course(&map, action, id);
+    } else if(strcmp(command, "student") == 0) {
+        result = Query_student(&map, action, id);
+    } else {
+        printf("`%s` can not be answered from a mapped GradeBook. Use `apply` instead.\n", command);
+        result = 1;
+    }
+
+    GradeBookMap_close(&map);
+
+    return result;
+}
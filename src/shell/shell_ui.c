@@ -4,53 +4,77 @@
 #include "commands/command.h"
 #include "options.h"
 #include "../models/model_io.h"
+#include "../models/gradebook_map.h"
 #include "../tui.h"
 
 void openGradeBook(char* path, GradeBook* destination) {
 
-    FILE* fptr  = fopen(path, "r");
-    long flen   = fsize(fptr);
+    FILE* fptr = fopen(path, "r");
 
-    byte buffer[flen];
-    fread(buffer, sizeof(byte), flen, fptr);
-    fclose(fptr);
+    if(!fptr) {
+        GradeBook_close(destination);
+        return;
+    }
+
+    // Read through a window, rather than all at once, so that large files are not held in memory beside the book
+    SerialSource source;
+    SerialSource_initFile(&source, fptr);
 
-    GradeBook_deserialize(buffer, destination);
+    GradeBook_decode(&source, destination);
+    fclose(fptr);
 }
 
-ShellReturn saveGradeBook(char* path, GradeBook* source) {
+/*
+ * The GradeBook is encoded straight in to a file beside `path`, which then replaces it, so that a save that fails part
+ * way leaves the old file as it was
+ */
+static ShellReturn writeGradeBook(char* path, GradeBook* source,
+                                  SerializationStatus (*encode)(GradeBook* book, SerialSink* sink)) {
 
-    const size flen = sizeOfGradeBook(source);
-    byte buffer[flen];
+    char partPath[strlen(path) + sizeof(".part")];
+    sprintf(partPath, "%s.part", path);
 
-    switch(GradeBook_serialize(source, buffer)) {
-        case SUCCESS:
-            break;
-        case FAILURE:
-        case SHORT_BUFFER:
-        case BAD_MAGIC:
-        case ILLEGAL_COURSE_ID:
-        case ILLEGAL_STUDENT_ID:
-            return SR_FAILURE;
-    }
+    FILE* fptr = fopen(partPath, "w");
 
-    FILE* fptr  = fopen(path, "w");
-    fwrite(buffer, sizeof(byte), flen, fptr);
-    fclose(fptr);
+    if(!fptr) return SR_FAILURE;
+
+    SerialSink sink;
+    SerialSink_initFile(&sink, fptr);
+
+    SerializationStatus status = encode(source, &sink);
+
+    if(fclose(fptr) != 0 && status == SUCCESS) status = FAILURE;
+
+    if(status != SUCCESS || rename(partPath, path) != 0) {
+        remove(partPath);
+        return SR_FAILURE;
+    }
 
     return SR_SUCCESS;
 }
 
+ShellReturn saveGradeBook(char* path, GradeBook* source) {
+    return writeGradeBook(path, source, &GradeBook_encode);
+}
+
 const char* commandTable[][3] = {
         {"clear",       "",                                     "Clear the screen"},
         {"help",        "",                                     "Display this message"},
         {"exit",        "",                                     "Exit the application"},
         {"load",        "[path]",                               "Load the gradebook. If a path is specified, it will be loaded from there."},
         {"save",        "[path]",                               "Save the gradebook. If a path is specified, it will be saved there."},
+        {"export",      "<path>",                               "Save a read-only copy of the gradebook to <path>, for `query` to answer from"},
+        {"archive",     "<path>",                               "Save a compact copy of the gradebook to <path>, for keeping or sending; `load` reads it"},
         {"index",       "",                                     "List all courses and students in the GradeBook"},
-        {"courses",     "",                                     "List all courses"},
-        {"course",      "show|add|rm <id>",                     "show, add, or remove a course specified by <id>"},
-        {"students",    "",                                     "List all students"},
+        {"stats",       "[path ...]",                           "Summarize grades and students over this gradebook and those saved at each path"},
+        {"courses",     "[top|bottom <k>]",                     "List all courses, or the k with the highest or lowest averages"},
+        {"courses",     "correlate [<k>]",                      "List the k pairs of courses whose students' averages correlate most"},
+        {"course",      "show|stats|add|rm <id>",               "show, summarize, add, or remove a course specified by <id>"},
+        {"course",      "policy <id> [<policy>|none]",          "show, set, or clear the grading policy of course <id>"},
+        {"course",      "scores <id>",                          "list students of course <id> with their scores by its policy"},
+        {"course",      "curve <id> <curve>",                   "offset <n>, scale <f>, clamp <lo> <hi>, or map <g>=<g> ... every grade of <id>"},
+        {"course",      "common|except <id> <other>",           "list students of <id> who take, or do not take, course <other>"},
+        {"students",    "[top|bottom <k>]",                     "List all students, or the k with the highest or lowest averages"},
         {"student",     "show|add|rm <id>",                     "show, add, or remove a student specified by <id>"},
         {"enroll",      "add|rm <sid> <cid>",                   "add/remove (enroll/disenroll) a student, <sid>, in a course <cid>"},
         {"grade",       "add|rm <sid> <cid> <grade|index>",     "add/remove <grade/index> for student <sid>, in course <cid>."}
@@ -119,6 +143,42 @@ ShellReturn Command_save(char* args, GradeBook* gradeBook) {
     }
 }
 
+ShellReturn Command_export(char* args, GradeBook* gradeBook) {
+
+    char* path = strtok(NULL, " ");
+
+    if(!path) {
+        printf("Please specify a path to export to\n");
+        return SR_FAILURE;
+    }
+
+    if(writeGradeBook(path, gradeBook, &GradeBook_encodeMapped) != SR_SUCCESS) {
+        printf("Unable to export gradebook to %s\n", path);
+        return SR_FAILURE;
+    }
+
+    printf("Exported gradebook to %s\n", path);
+    return SR_SUCCESS;
+}
+
+ShellReturn Command_archive(char* args, GradeBook* gradeBook) {
+
+    char* path = strtok(NULL, " ");
+
+    if(!path) {
+        printf("Please specify a path to archive to\n");
+        return SR_FAILURE;
+    }
+
+    if(writeGradeBook(path, gradeBook, &GradeBook_encodeCompact) != SR_SUCCESS) {
+        printf("Unable to archive gradebook to %s\n", path);
+        return SR_FAILURE;
+    }
+
+    printf("Archived gradebook to %s\n", path);
+    return SR_SUCCESS;
+}
+
 ShellReturn Command_unknown(char* args, GradeBook* gradeBook) {
     printf("Unknown command. See `help` for more information.\n");
     return SR_FAILURE;
@@ -133,6 +193,7 @@ ShellReturn Command_unknown(char* args, GradeBook* gradeBook) {
 ShellReturn Command_courseList(char* args, GradeBook* gradeBook);
 ShellReturn Command_studentList(char* args, GradeBook* gradeBook);
 ShellReturn Command_index(char* args, GradeBook* gradeBook);
+ShellReturn Command_stats(char* args, GradeBook* gradeBook);
 ShellReturn Command_student(char* args, GradeBook* gradeBook);
 ShellReturn Command_course(char* args, GradeBook* gradeBook);
 ShellReturn Command_enroll(char* args, GradeBook* gradeBook);
@@ -150,7 +211,10 @@ const struct A_CommandAssocation {
     {"exit",                &Command_exit},
     {"load",                &Command_load},
     {"save",                &Command_save},
+    {"export",              &Command_export},
+    {"archive",             &Command_archive},
     {"index",               &Command_index},
+    {"stats",               &Command_stats},
     {"students",            &Command_studentList},
     {"student",             &Command_student},
     {"courses",             &Command_courseList},
@@ -184,6 +248,7 @@ int Option_runShellUI(int argCount, char** args) {
     char* fileName = args[2];
 
     GradeBook book = {};
+    GradeBook_init(&book);
 
 //    if(access(fileName, F_OK|W_OK|R_OK) == 0) {
 //        openGradeBook(fileName, &book);
@@ -222,6 +287,7 @@ int Option_runShellUI(int argCount, char** args) {
             case SR_EXIT:
                 printf("Goodbye!\n");
                 saveGradeBook(fileName, &book);
+                GradeBook_close(&book);
                 return 0;
             case SR_FAILURE:
                 printf("The command returned an error value\n");
@@ -241,10 +307,60 @@ int Option_runShellUI(int argCount, char** args) {
             default:
                 break;
         }
+
+        if(!GradeBook_checkInvariants(&book)) {
+            printf("(!) The GradeBook is inconsistent, see debug output\n");
+        }
     } while(true);
 
 }
 
+/*
+ * Answer `student show <id>` from the records of that student and its courses, when `path` is in the sectioned format
+ * (see GradeBookFile_open). Returns false, having done nothing, for any other command or file, which is then read
+ * whole.
+ */
+static bool showStudentRecords(char* path, const char* commandText, ShellReturn* result) {
+
+    char text[strlen(commandText) + 1];
+    strcpy(text, commandText);
+
+    char* command   = strtok(text, " ");
+    char* action    = strtok(NULL, " ");
+    char* idText    = strtok(NULL, " ");
+    char* end       = NULL;
+    long studentId  = idText ? strtol(idText, &end, 10) : -1;
+
+    if(!command || strcmp(command, "student") != 0 || !action || strcmp(action, "show") != 0
+       || !idText || *end || studentId < 0 || studentId > UINT32_MAX) {
+        return false;
+    }
+
+    GradeBookFile file;
+
+    if(GradeBookFile_open(&file, path) != SUCCESS) return false;
+
+    GradeBook book = {};
+    GradeBook_init(&book);
+
+    // A student that is not in the file leaves the book empty, for Command_student to say so
+    SerializationStatus status = GradeBookFile_loadStudent(&file, (uint32_t) studentId, &book);
+    GradeBookFile_close(&file);
+
+    if(status == SUCCESS || status == ILLEGAL_STUDENT_ID) {
+        char arguments[strlen(idText) + sizeof("show ")];
+        sprintf(arguments, "show %s", idText);
+
+        *result = Command_student(arguments, &book);
+    } else {
+        *result = SR_FAILURE;
+    }
+
+    GradeBook_close(&book);
+
+    return true;
+}
+
 int Option_runShellCmd(int argCount, char** args) {
 
     char* allArgs = Array_toString(args + 2, argCount - 2, sizeof(char*), ", ", &str2str);
@@ -257,27 +373,40 @@ int Option_runShellCmd(int argCount, char** args) {
         return 1;
     }
 
-    char* fileName = args[2];
+    char* fileName      = args[2];
+    char* commandText   = args[3];
+    ShellReturn result;
 
-    GradeBook book = {};
+    if(!showStudentRecords(fileName, commandText, &result)) {
+        GradeBook book = {};
+        GradeBook_init(&book);
 
-    if(access(fileName, F_OK|W_OK|R_OK) == 0) {
-        openGradeBook(fileName, &book);
-    } else if(access(fileName, W_OK|R_OK) == 0) {
-        saveGradeBook(fileName, &book);
-    } else {
-        printf("You do not have permission to access or create the file %s\n", fileName);
-        printf("Please use a different file\n");
-        return 1;
-    }
+        if(access(fileName, F_OK|W_OK|R_OK) == 0) {
+            openGradeBook(fileName, &book);
+        } else if(access(fileName, W_OK|R_OK) == 0) {
+            saveGradeBook(fileName, &book);
+        } else {
+            printf("You do not have permission to access or create the file %s\n", fileName);
+            printf("Please use a different file\n");
+            GradeBook_close(&book);
+            return 1;
+        }
+
+        size textLength = strlen(commandText);
+        char* command   = strtok(commandText, " ");
 
-    char* commandText = args[3];
+        ShellCommand userCommand = lookupCommand(command);
 
-    char* command = strtok(commandText, " ");
+        // Run the command with the characters following it, as the interactive shell does
+        char* arguments = command && strlen(command) < textLength ? command + strlen(command) + 1
+                                                                  : commandText + textLength;
 
-    ShellCommand userCommand = lookupCommand(command);
+        result = userCommand(arguments, &book);
+
+        GradeBook_close(&book);
+    }
 
-    switch(userCommand(command, &book)){
+    switch(result){
         case SR_FAILURE:
             printf("The command returned an error value\n");
             return 1;
@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../models/models.h"
+
+/*
+ * Times loading N students in random ID order, one at a time with GradeBook_addStudent and in one call to
+ * GradeBook_bulkAddStudents. Built with _GB_WIDE_IDS so that N may exceed 255.
+ */
+
+const size maxStudents = 100000;
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void checkOrder(GradeBook* book, size expected) {
+    if(book->studentsCount != expected) {
+        fprintf(stderr, "expected %lu students, found %lu\n", expected, book->studentsCount);
+        exit(1);
+    }
+
+    for(size idx = 1; idx < book->studentsCount; ++idx) {
+        if(GradeBook_studentAt(book, idx - 1)->studentId >= GradeBook_studentAt(book, idx)->studentId) {
+            fprintf(stderr, "students out of order at %lu\n", idx);
+            exit(1);
+        }
+    }
+}
+
+int main() {
+
+    Student* students   = calloc(maxStudents, sizeof(Student));
+    char (*names)[16]   = calloc(maxStudents, sizeof(*names));
+
+    srand(1040);
+
+    for(size idx = 0; idx < maxStudents; ++idx) {
+        snprintf(names[idx], sizeof(names[idx]), "Student %lu", idx);
+        students[idx].studentId     = (identifier) (idx * 7 + 1);
+        students[idx].studentName   = names[idx];
+    }
+
+    // Fisher-Yates, so that inserts land all over the order index
+    for(size idx = maxStudents - 1; idx > 0; --idx) {
+        size other      = (size) rand() % (idx + 1);
+        Student swap    = students[idx];
+        students[idx]   = students[other];
+        students[other] = swap;
+    }
+
+    printf("%10s %14s %14s\n", "students", "single ns/op", "bulk ns/op");
+
+    for(size count = maxStudents / 8; count <= maxStudents; count *= 2) {
+        GradeBook book;
+        double start, single, bulk;
+
+        GradeBook_init(&book);
+        start = now();
+        for(size idx = 0; idx < count; ++idx) GradeBook_addStudent(&book, students[idx]);
+        single = now() - start;
+        checkOrder(&book, count);
+        GradeBook_close(&book);
+
+        GradeBook_init(&book);
+        start = now();
+        GradeBook_bulkAddStudents(&book, students, count);
+        bulk = now() - start;
+        checkOrder(&book, count);
+        GradeBook_close(&book);
+
+        // Two interleaved batches exercise the merge, and repeating a batch must add nothing
+        GradeBook_init(&book);
+        GradeBook_bulkAddStudents(&book, students, count / 2);
+        GradeBook_bulkAddStudents(&book, students + count / 2, count - count / 2);
+        GradeBook_bulkAddStudents(&book, students, count);
+        checkOrder(&book, count);
+        GradeBook_close(&book);
+
+        printf("%10lu %14.1f %14.1f\n", count, single * 1e9 / count, bulk * 1e9 / count);
+    }
+
+    free(students);
+    free(names);
+
+    return 0;
+}
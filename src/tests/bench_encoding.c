@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../models/models.h"
+#include "../models/model_io.h"
+#include "../models/grade_kernels.h"
+
+/*
+ * Times writing and reading a large synthetic GradeBook in the standard and the compact encodings (see model_io.c),
+ * and compares their sizes; then times unpacking packed grades with each set of kernels the CPU supports. Built with
+ * _GB_WIDE_IDS.
+ */
+
+const size nStudents        = 20000;
+const size nCourses         = 500;
+const size coursesPerStudent = 5;
+const size nUnpackGroups    = 1 << 20;
+const size nUnpackRounds    = 20;
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static size countGrades(GradeBook* book) {
+
+    size nGrades = 0;
+
+    for(size idx = 0; idx < book->studentsCount; ++idx) {
+        Student* student = GradeBook_studentAt(book, idx);
+
+        for(size course = 0; course < Student_coursesCount(student); ++course) {
+            nGrades += Student_enrollmentAt(book, student, course)->grades.count;
+        }
+    }
+
+    return nGrades;
+}
+
+static int benchEncoding(GradeBook* book, const char* name, SerializationStatus (*encode)(GradeBook*, SerialSink*),
+                         size nGrades) {
+
+    SerialBuffer buffer;
+    SerialSink sink;
+
+    SerialBuffer_init(&buffer);
+    SerialSink_initBuffer(&sink, &buffer);
+
+    double start = now();
+
+    if(encode(book, &sink) != SUCCESS) {
+        printf("%s: encoding failed\n", name);
+        return 1;
+    }
+
+    double encoded = now() - start;
+
+    GradeBook decoded;
+    GradeBook_init(&decoded);
+
+    start = now();
+
+    if(GradeBook_deserialize(buffer.data, buffer.count, &decoded) != SUCCESS) {
+        printf("%s: decoding failed\n", name);
+        return 1;
+    }
+
+    double elapsed = now() - start;
+
+    if(decoded.studentsCount != book->studentsCount || decoded.coursesCount != book->coursesCount
+       || countGrades(&decoded) != nGrades) {
+        printf("%s: the decoded GradeBook does not match\n", name);
+        return 1;
+    }
+
+    printf("%-9s %9lu bytes (%.2f per grade), encoded at %7.1f MB/s, decoded at %7.1f MB/s, %6.1f ns per grade\n",
+           name, buffer.count, (double) buffer.count / nGrades, buffer.count / encoded / 1e6,
+           buffer.count / elapsed / 1e6, elapsed * 1e9 / nGrades);
+
+    GradeBook_close(&decoded);
+    SerialBuffer_free(&buffer);
+
+    return 0;
+}
+
+int main() {
+
+    GradeBook book;
+    GradeBook_init(&book);
+    srand(1040);
+
+    for(size idx = 0; idx < nCourses; ++idx) {
+        char name[16];
+        Course course = { .courseId = (identifier) (idx + 1), .courseName = name };
+        snprintf(name, sizeof(name), "Course %lu", idx);
+        GradeBook_addCourse(&book, course);
+    }
+
+    Student* students   = calloc(nStudents, sizeof(Student));
+    char (*names)[16]   = calloc(nStudents, sizeof(*names));
+
+    for(size idx = 0; idx < nStudents; ++idx) {
+        snprintf(names[idx], sizeof(names[idx]), "Student %lu", idx);
+        students[idx].studentId     = (identifier) (idx * 3 + 1);
+        students[idx].studentName   = names[idx];
+    }
+
+    GradeBook_bulkAddStudents(&book, students, nStudents);
+
+    for(size idx = 0; idx < nStudents; ++idx) {
+        Student* student = GradeBook_studentAt(&book, idx);
+
+        for(size course = 0; course < coursesPerStudent; ++course) {
+            Course_addStudent(&book, GradeBook_courseAt(&book, (size) rand() % nCourses), student);
+        }
+    }
+
+    // Grades go in once every enrollment has been made, as each new enrollment means re-indexing transcripts
+    for(size idx = 0; idx < nStudents; ++idx) {
+        Student* student = GradeBook_studentAt(&book, idx);
+
+        for(size course = 0; course < Student_coursesCount(student); ++course) {
+            StudentEnrollment* enrollment = Student_enrollmentAt(&book, student, course);
+            size nGrades                  = 8 + (size) rand() % 9;
+
+            for(size gradeIdx = 0; gradeIdx < nGrades; ++gradeIdx) {
+                GradeBook_addGrade(&book, enrollment, (grade) (rand() % 101));
+            }
+        }
+    }
+
+    size nGrades = countGrades(&book);
+    printf("%lu students, %lu courses, %lu grades\n", book.studentsCount, book.coursesCount, nGrades);
+
+    if(benchEncoding(&book, "standard", &GradeBook_encode, nGrades) != 0
+       || benchEncoding(&book, "compact", &GradeBook_encodeCompact, nGrades) != 0) {
+        return 1;
+    }
+
+    // Unpack: the same packed run, decoded by each set of kernels
+    byte* packed    = malloc(nUnpackGroups * 7);
+    grade* expected = malloc(nUnpackGroups * 8);
+    grade* grades   = malloc(nUnpackGroups * 8);
+
+    for(size idx = 0; idx < nUnpackGroups * 7; ++idx) packed[idx] = (byte) rand();
+
+    const GradeKernels* sets[GradeKernels_MAX_SETS];
+    size nSets = GradeKernels_supported(sets);
+
+    sets[0]->unpack(packed, expected, nUnpackGroups);
+
+    for(size setIdx = 0; setIdx < nSets; ++setIdx) {
+        double start = now();
+
+        for(size round = 0; round < nUnpackRounds; ++round) sets[setIdx]->unpack(packed, grades, nUnpackGroups);
+
+        double elapsed = now() - start;
+
+        if(memcmp(grades, expected, nUnpackGroups * 8) != 0) {
+            printf("unpack (%s) does not match the scalar kernels\n", sets[setIdx]->name);
+            return 1;
+        }
+
+        printf("unpack %-6s %6.3f ns per grade\n", sets[setIdx]->name,
+               elapsed * 1e9 / (nUnpackRounds * nUnpackGroups * 8));
+    }
+
+    free(grades);
+    free(expected);
+    free(packed);
+    free(names);
+    free(students);
+    GradeBook_close(&book);
+
+    return 0;
+}
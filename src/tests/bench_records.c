@@ -0,0 +1,234 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../models/models.h"
+#include "../models/grade_report.h"
+#include "../models/grade_sketch.h"
+#include "../models/course_correlation.h"
+#include "../grading.h"
+
+/*
+ * Times the operations that walk many Student and Course records over a large synthetic GradeBook: sorting copies of
+ * the student records by ID, looking students up by ID, averaging every course, gathering a GradeReport and a
+ * GradeSketch, correlating every pair of courses, ranking students by average, counting the students that pairs of
+ * courses have in common, scoring every enrollment by a grading policy, and curving every course. Built with
+ * _GB_WIDE_IDS.
+ */
+
+const size nStudents        = 200000;
+const size nCourses         = 2000;
+const size coursesPerStudent = 5;
+const size gradesPerCourse  = 8;
+const size nLookups         = 2000000;
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main() {
+
+    GradeBook book;
+    GradeBook_init(&book);
+    srand(1040);
+
+    for(size idx = 0; idx < nCourses; ++idx) {
+        char name[16];
+        Course course = { .courseId = (identifier) (idx + 1), .courseName = name };
+        snprintf(name, sizeof(name), "Course %lu", idx);
+        GradeBook_addCourse(&book, course);
+    }
+
+    Student* students   = calloc(nStudents, sizeof(Student));
+    char (*names)[16]   = calloc(nStudents, sizeof(*names));
+
+    for(size idx = 0; idx < nStudents; ++idx) {
+        snprintf(names[idx], sizeof(names[idx]), "Student %lu", idx);
+        students[idx].studentId     = (identifier) (idx * 3 + 1);
+        students[idx].studentName   = names[idx];
+    }
+
+    GradeBook_bulkAddStudents(&book, students, nStudents);
+
+    for(size idx = 0; idx < nStudents; ++idx) {
+        Student* student = GradeBook_studentAt(&book, idx);
+
+        for(size course = 0; course < coursesPerStudent; ++course) {
+            Course_addStudent(&book, GradeBook_courseAt(&book, (size) rand() % nCourses), student);
+        }
+    }
+
+    // Grades go in once every enrollment has been made, as each new enrollment means re-indexing transcripts
+    for(size idx = 0; idx < nStudents; ++idx) {
+        Student* student = GradeBook_studentAt(&book, idx);
+
+        for(size course = 0; course < Student_coursesCount(student); ++course) {
+            StudentEnrollment* enrollment = Student_enrollmentAt(&book, student, course);
+            for(size gradeIdx = 0; gradeIdx < gradesPerCourse; ++gradeIdx) {
+                Enrollment_addGrade(&book, enrollment, (grade) (rand() % 101));
+            }
+        }
+    }
+
+    printf("sizeof(Student) = %lu, sizeof(Course) = %lu\n", sizeof(Student), sizeof(Course));
+
+    // Sort: shuffled copies of every student record, by ID
+    for(size idx = 0; idx < nStudents; ++idx) students[idx] = *GradeBook_studentAt(&book, idx);
+
+    for(size idx = nStudents - 1; idx > 0; --idx) {
+        size other      = (size) rand() % (idx + 1);
+        Student swap    = students[idx];
+        students[idx]   = students[other];
+        students[other] = swap;
+    }
+
+    double start = now();
+    qsort(students, nStudents, sizeof(Student), &Student_compareById);
+    printf("sort     %8.1f ns/student\n", (now() - start) * 1e9 / nStudents);
+
+    // Lookup: random ID's, reading a field of each record found
+    size found = 0;
+    start = now();
+    for(size idx = 0; idx < nLookups; ++idx) {
+        Student* student = GradeBook_findStudent(&book, (identifier) (((size) rand() % nStudents) * 3 + 1));
+        found += student ? Student_coursesCount(student) : 0;
+    }
+    printf("lookup   %8.1f ns/lookup (%lu)\n", (now() - start) * 1e9 / nLookups, found);
+
+    // Course_averageGrade over every course
+    float total = 0;
+    start = now();
+    for(size idx = 0; idx < nCourses; ++idx) total += Course_averageGrade(&book, GradeBook_courseAt(&book, idx));
+    printf("average  %8.1f ns/enrollment (%.2f)\n",
+            (now() - start) * 1e9 / (nStudents * coursesPerStudent), total / nCourses);
+
+    // GradeReport_build over every grade, on one worker and then on every core
+    GradeReport report;
+    GradeReport_init(&report);
+
+    start = now();
+    GradeReport_build(&report, &book, NULL);
+    double serial = now() - start;
+
+    WorkerPool workers;
+    WorkerPool_init(&workers, 0);
+
+    start = now();
+    GradeReport_build(&report, &book, &workers);
+    double parallel = now() - start;
+
+    printf("report   %8.1f ms serial, %8.1f ms on %lu workers (%lu grades)\n",
+            serial * 1e3, parallel * 1e3, WorkerPool_workersCount(&workers), report.grades.count);
+
+    WorkerPool_free(&workers);
+    GradeReport_free(&report);
+
+    // A sketch of the whole book, which reads histograms and the enrollment table rather than grades
+    GradeSketch sketch;
+    GradeSketch_init(&sketch);
+
+    start = now();
+    GradeSketch_addBook(&sketch, &book);
+
+    printf("sketch   %8.1f ms (%lu grades, about %.0f students)\n", (now() - start) * 1e3, sketch.grades.count,
+           DistinctSketch_estimate(&sketch.students));
+
+    GradeSketch_free(&sketch);
+
+    // Correlation of every pair of courses over the students they share
+    CourseCorrelation matrix;
+
+    start = now();
+
+    if(CourseCorrelation_build(&matrix, &book)) {
+        printf("correlate %7.1f ms (%lu pairs of courses, %s)\n", (now() - start) * 1e3,
+               matrix.coursesCount * (matrix.coursesCount + 1) / 2, CorrelationKernels_select()->name);
+        CourseCorrelation_free(&matrix);
+    }
+
+    // Top 50 students: a cold partial sort, the query that builds the rank index, and a query of the live index
+    RankEntry top[50];
+    const char* rankings[] = { "cold", "build", "live" };
+
+    for(size query = 0; query < 3; ++query) {
+        start = now();
+        GradeBook_rankStudents(&book, 50, true, top);
+        printf("rank     %8.1f us %s (%.2f)\n", (now() - start) * 1e6, rankings[query], top[0].key);
+    }
+
+    // Students in common to pairs of courses: the query that builds the roster sets, then queries of the live sets
+    start = now();
+    size common = Course_commonStudentsCount(&book, GradeBook_courseAt(&book, 0), GradeBook_courseAt(&book, 1));
+    printf("sets     %8.1f ms build (%lu)\n", (now() - start) * 1e3, common);
+
+    start = now();
+    common = 0;
+
+    for(size idx = 0; idx < nCourses; ++idx) {
+        common += Course_commonStudentsCount(&book, GradeBook_courseAt(&book, idx),
+                                             GradeBook_courseAt(&book, (idx * 7 + 1) % nCourses));
+    }
+
+    printf("sets     %8.1f ns/pair (%lu)\n", (now() - start) * 1e9 / nCourses, common);
+
+    // Every course graded by one policy: a course's roster at a time, then an enrollment at a time
+    GradingPlan plan;
+    GradingPlan_compile("homework 5 drop 1, exams 3 weight 2 cap 95", &plan);
+
+    size maxRoster = 0;
+
+    for(size idx = 0; idx < nCourses; ++idx) {
+        Course* course = GradeBook_courseAt(&book, idx);
+        Course_setPolicy(&book, course, &plan);
+        if(Course_studentsCount(course) > maxRoster) maxRoster = Course_studentsCount(course);
+    }
+
+    float* scores = calloc(maxRoster, sizeof(float));
+    double batchTotal = 0, singleTotal = 0;
+    size nScored = 0;
+
+    GradeBook_settle(&book);
+    start = now();
+
+    for(size idx = 0; idx < nCourses; ++idx) {
+        size nRoster = Course_policyScores(&book, GradeBook_courseAt(&book, idx), scores);
+        for(size row = 0; row < nRoster; ++row) batchTotal += scores[row];
+        nScored += nRoster;
+    }
+
+    double batched = now() - start;
+    start = now();
+
+    for(size idx = 0; idx < nCourses; ++idx) {
+        Course* course = GradeBook_courseAt(&book, idx);
+
+        for(size row = 0; row < Course_studentsCount(course); ++row) {
+            singleTotal += Enrollment_policyScore(&book, Course_enrollmentAt(&book, course, row));
+        }
+    }
+
+    printf("policy   %8.1f ns/enrollment batched, %8.1f ns/enrollment one at a time (%.2f, %.2f)\n",
+           batched * 1e9 / nScored, (now() - start) * 1e9 / nScored, batchTotal / nScored, singleTotal / nScored);
+
+    // Every course curved up and back down again, a roster at a time
+    GradeCurve up = { .kind = CURVE_OFFSET, .offset = 5 }, down = { .kind = CURVE_OFFSET, .offset = -5 };
+    size nCurved = 0;
+
+    start = now();
+
+    for(size idx = 0; idx < nCourses; ++idx) {
+        nCurved += GradeBook_curveCourse(&book, GradeBook_courseAt(&book, idx), &up);
+        nCurved += GradeBook_curveCourse(&book, GradeBook_courseAt(&book, idx), &down);
+    }
+
+    printf("curve    %8.1f ns/grade (%s)\n", (now() - start) * 1e9 / nCurved, GradeKernels_select()->name);
+
+    free(scores);
+    free(students);
+    free(names);
+    GradeBook_close(&book);
+
+    return 0;
+}
@@ -0,0 +1,389 @@
+#include <assert.h>
+#include <string.h>
+#include <math.h>
+#include "../models/grade_kernels.h"
+#include "../models/slot_set.h"
+#include "../models/grading_plan.h"
+#include "../models/course_correlation.h"
+#include "../grading.h"
+
+/*
+ * Longest run tested. Every length up to it is tried, at every offset in to a vector, so that each tail is covered.
+ */
+const size maxRun       = 300;
+const size maxOffset    = 32;
+
+void t_checkRun(const GradeKernels* reference, const GradeKernels* kernels, const grade* grades, size count) {
+
+    GradeSummary expected   = reference->summarize(grades, count);
+    GradeSummary actual     = kernels->summarize(grades, count);
+
+    assert(kernels->sum(grades, count) == expected.sum);
+    assert(kernels->smallest(grades, count) == expected.smallest);
+    assert(kernels->largest(grades, count) == expected.largest);
+
+    assert(actual.sum == expected.sum && actual.count == count);
+    assert(actual.smallest == expected.smallest && actual.largest == expected.largest);
+}
+
+/*
+ * A curve leaves every grade of a run as its table says, and every grade around the run as it was
+ */
+void t_checkCurve(const GradeKernels* kernels, const GradeCurve* curve, const grade* grades, size count) {
+
+    grade table[256];
+    grade curved[maxRun + 2];
+
+    GradeCurve_table(curve, table);
+
+    curved[0] = curved[count + 1] = 0x5A;
+    memcpy(&curved[1], grades, count);
+
+    kernels->curve(curve, &curved[1], count);
+
+    assert(curved[0] == 0x5A && curved[count + 1] == 0x5A);
+    for(size idx = 0; idx < count; ++idx) assert(curved[idx + 1] == table[grades[idx]]);
+}
+
+/*
+ * Slots used by the slot set checks: three blocks, the middle one dense enough to become a bitmap
+ */
+const uint32_t slotSpan = 3 << 16;
+
+void t_checkSlotSets(const SlotSet* a, const SlotSet* b, const bool* inA, const bool* inB) {
+
+    static uint32_t slots[3 << 16];
+    size expectedBoth = 0, expectedOnly = 0;
+
+    for(uint32_t slot = 0; slot < slotSpan; ++slot) {
+        assert(SlotSet_contains(a, slot) == inA[slot]);
+        expectedBoth += inA[slot] && inB[slot];
+        expectedOnly += inA[slot] && !inB[slot];
+    }
+
+    assert(SlotSet_intersectionCount(a, b) == expectedBoth);
+
+    size nBoth = SlotSet_intersection(a, b, slots);
+    assert(nBoth == expectedBoth);
+    for(size idx = 0; idx < nBoth; ++idx) assert(inA[slots[idx]] && inB[slots[idx]] && (idx == 0 || slots[idx - 1] < slots[idx]));
+
+    size nOnly = SlotSet_difference(a, b, slots);
+    assert(nOnly == expectedOnly);
+    for(size idx = 0; idx < nOnly; ++idx) assert(inA[slots[idx]] && !inB[slots[idx]] && (idx == 0 || slots[idx - 1] < slots[idx]));
+}
+
+bool t_samePlan(const GradingPlan* a, const GradingPlan* b) {
+    if(a->categoriesCount != b->categoriesCount || a->width != b->width) return false;
+
+    for(uint32_t category = 0; category < a->categoriesCount; ++category) {
+        if(a->first[category] != b->first[category] || a->count[category] != b->count[category]
+           || a->dropped[category] != b->dropped[category] || a->weight[category] != b->weight[category]
+           || a->cap[category] != b->cap[category] || strcmp(a->names[category], b->names[category]) != 0) return false;
+    }
+
+    return true;
+}
+
+int main() {
+
+    setbuf(stdout, NULL);
+
+    const GradeKernels* sets[GradeKernels_MAX_SETS];
+    size nSets = GradeKernels_supported(sets);
+
+    assert(strcmp(sets[0]->name, "scalar") == 0);
+    assert(GradeKernels_select() == sets[nSets - 1]);
+
+    grade grades[maxRun + maxOffset];
+
+    srand(1040);
+
+    for(size idx = 0; idx < NMEMBERS(grades, grade); ++idx) grades[idx] = (grade) rand();
+
+    // The bounds of a run are often at its very ends, where a tail is handled
+    grades[maxOffset] = 0x00;
+    grades[maxOffset + 1] = 0xFF;
+
+    // Each kind of curve, at and past the ends of its range
+    GradeCurve curves[] = {
+            { .kind = CURVE_OFFSET, .offset = 0 },
+            { .kind = CURVE_OFFSET, .offset = 41 },
+            { .kind = CURVE_OFFSET, .offset = -37 },
+            { .kind = CURVE_OFFSET, .offset = 255 },
+            { .kind = CURVE_OFFSET, .offset = -255 },
+            { .kind = CURVE_SCALE, .scale = 0 },
+            { .kind = CURVE_SCALE, .scale = 128 },
+            { .kind = CURVE_SCALE, .scale = 256 },
+            { .kind = CURVE_SCALE, .scale = 301 },
+            { .kind = CURVE_SCALE, .scale = UINT16_MAX },
+            { .kind = CURVE_CLAMP, .low = 40, .high = 200 },
+            { .kind = CURVE_CLAMP, .low = 0, .high = 0 },
+            { .kind = CURVE_MAP }
+    };
+    size nCurves = NMEMBERS(curves, GradeCurve);
+
+    for(size value = 0; value < 256; ++value) curves[nCurves - 1].table[value] = (grade) rand();
+
+    // The scalar kernel is the definition of each curve
+    grade table[256];
+    GradeCurve_table(&curves[1], table);
+    assert(table[0] == 41 && table[200] == 241 && table[214] == 255 && table[255] == 255);
+    GradeCurve_table(&curves[2], table);
+    assert(table[0] == 0 && table[37] == 0 && table[100] == 63);
+    GradeCurve_table(&curves[6], table);
+    assert(table[1] == 1 && table[3] == 2 && table[100] == 50);
+    GradeCurve_table(&curves[8], table);
+    assert(table[100] == 118 && table[216] == 254 && table[217] == 255 && table[255] == 255);
+    GradeCurve_table(&curves[10], table);
+    assert(table[0] == 40 && table[40] == 40 && table[100] == 100 && table[201] == 200);
+
+    for(size set = 0; set < nSets; ++set) {
+        printf("Checking %s kernels\n", sets[set]->name);
+
+        for(size offset = 0; offset < maxOffset; ++offset) {
+            for(size count = 0; count <= maxRun; ++count) {
+                t_checkRun(sets[0], sets[set], &grades[offset], count);
+            }
+        }
+
+        for(size curve = 0; curve < nCurves; ++curve) {
+            for(size offset = 0; offset < maxOffset; ++offset) {
+                for(size count = 0; count <= maxRun; ++count) {
+                    t_checkCurve(sets[set], &curves[curve], &grades[offset], count);
+                }
+            }
+        }
+
+        // Sums must not overflow on long runs of top grades
+        grade top[4096];
+        memset(top, 0xFF, sizeof(top));
+        assert(sets[set]->sum(top, NMEMBERS(top, grade)) == 0xFF * (long) NMEMBERS(top, grade));
+
+        // Unpacking reads only the bytes of the groups asked for, each copied to a block just that long, and writes
+        // only their grades
+        for(size groups = 0; groups <= 40; ++groups) {
+            byte* packed = malloc(groups * 7 + 1);
+            grade expectedGrades[8 * 40], actualGrades[8 * 40 + 1];
+
+            for(size idx = 0; idx < groups * 7; ++idx) packed[idx] = (byte) rand();
+
+            actualGrades[groups * 8] = 0x5A;
+            sets[0]->unpack(packed, expectedGrades, groups);
+            sets[set]->unpack(packed, actualGrades, groups);
+
+            assert(memcmp(expectedGrades, actualGrades, groups * 8) == 0 && actualGrades[groups * 8] == 0x5A);
+            free(packed);
+        }
+    }
+
+    // Grade i of a packed group is bits 7i to 7i + 6 of its little-endian bytes
+    const grade ungrouped[8] = {1, 2, 3, 4, 5, 6, 7, 127};
+    uint64_t packedBits = 0;
+    byte group[7];
+    grade unpacked[8];
+
+    for(size idx = 0; idx < 8; ++idx) packedBits |= (uint64_t) ungrouped[idx] << (7 * idx);
+    for(size idx = 0; idx < 7; ++idx) group[idx] = (byte) (packedBits >> (8 * idx));
+
+    sets[0]->unpack(group, unpacked, 1);
+    assert(memcmp(unpacked, ungrouped, 8) == 0);
+
+    // Every set of bitmap kernels agrees with the scalar set, over whole and partial vectors
+    const SlotSetKernels* slotSets[SlotSetKernels_MAX_SETS];
+    size nSlotSets = SlotSetKernels_supported(slotSets);
+
+    assert(strcmp(slotSets[0]->name, "scalar") == 0);
+    assert(SlotSetKernels_select() == slotSets[nSlotSets - 1]);
+
+    uint64_t left[64], right[64], expected[64], actual[64];
+
+    for(size idx = 0; idx < 64; ++idx) {
+        left[idx]   = ((uint64_t) rand() << 33) ^ ((uint64_t) rand() << 11) ^ (uint64_t) rand();
+        right[idx]  = ((uint64_t) rand() << 33) ^ ((uint64_t) rand() << 11) ^ (uint64_t) rand();
+    }
+
+    left[0] = right[0] = ~(uint64_t) 0;
+
+    for(size set = 0; set < nSlotSets; ++set) {
+        printf("Checking %s slot set kernels\n", slotSets[set]->name);
+
+        for(size words = 0; words <= 64; ++words) {
+            size count = slotSets[0]->and(expected, left, right, words);
+            assert(slotSets[set]->andCount(left, right, words) == count);
+            assert(slotSets[set]->and(actual, left, right, words) == count);
+            assert(memcmp(actual, expected, words * sizeof(uint64_t)) == 0);
+
+            count = slotSets[0]->andNot(expected, left, right, words);
+            assert(slotSets[set]->andNot(actual, left, right, words) == count);
+            assert(memcmp(actual, expected, words * sizeof(uint64_t)) == 0);
+        }
+    }
+
+    // Slot sets agree with a plain array of flags as blocks fill up, turn in to bitmaps, and thin out in to arrays again
+    static bool inA[3 << 16], inB[3 << 16];
+    SlotSet a = {}, b = {};
+    Pool pool;
+    Pool_init(&pool);
+
+    for(uint32_t slot = 0; slot < slotSpan; ++slot) {
+        // The first block stays sparse, the second is dense in both sets, the third is dense in `a` alone
+        bool dense = slot >> 16 == 1 || (slot >> 16 == 2 && rand() % 2);
+
+        if(dense ? rand() % 3 != 0 : rand() % 50 == 0) inA[slot] = SlotSet_add(&pool, &a, slot);
+        if(dense && slot >> 16 == 1 ? rand() % 2 == 0 : rand() % 40 == 0) inB[slot] = SlotSet_add(&pool, &b, slot);
+    }
+
+    assert(SlotSet_add(&pool, &a, 1 << 16 | 7) != inA[1 << 16 | 7]);
+    inA[1 << 16 | 7] = true;
+
+    t_checkSlotSets(&a, &b, inA, inB);
+    t_checkSlotSets(&b, &a, inB, inA);
+
+    for(uint32_t slot = 0; slot < slotSpan; ++slot) {
+        if(inA[slot] && rand() % 16 != 0) {
+            assert(SlotSet_remove(&pool, &a, slot));
+            inA[slot] = false;
+        }
+    }
+
+    assert(!SlotSet_remove(&pool, &a, slotSpan + 1));
+
+    t_checkSlotSets(&a, &b, inA, inB);
+    t_checkSlotSets(&b, &a, inB, inA);
+
+    SlotSet_free(&pool, &a);
+    SlotSet_free(&pool, &b);
+    assert(a.count == 0 && a.blocksCount == 0);
+    Pool_free(&pool);
+
+    // Grading policies compile once, and the plan scores a batch exactly as it scores each enrollment alone
+    GradingPlan plan, reparsed;
+    char policy[255];
+
+    assert(GradingPlan_compile("hw 4 weight 3 drop 1, exam 1 cap 90", &plan) == PLAN_COMPILED);
+    assert(plan.categoriesCount == 2 && plan.width == 5 && plan.first[1] == 4 && plan.dropped[0] == 1);
+    assert(GradingPlan_format(&plan, policy, sizeof(policy)) && strcmp(policy, "hw 4 weight 3 drop 1, exam 1 cap 90") == 0);
+    assert(!GradingPlan_format(&plan, policy, 8));
+
+    grade termGrades[] = { 50, 100, 80, 60, 100, 70 };
+
+    assert(GradingPlan_score(&plan, termGrades, 6) == (240.0f + 90.0f) / 4);
+    assert(GradingPlan_score(&plan, termGrades, 2) == 100.0f);
+    assert(GradingPlan_score(&plan, termGrades, 0) == 0.0f);
+
+    const char* badPolicies[][2] = {
+            { "",                       "syntax" },
+            { "hw",                     "syntax" },
+            { "hw 3,",                  "syntax" },
+            { "hw 3 curve 2",           "syntax" },
+            { "hw 2.5",                 "syntax" },
+            { "3 4",                    "syntax" },
+            { "hw 0",                   "value" },
+            { "hw 3 drop 3",            "value" },
+            { "hw 3 weight 0",          "value" },
+            { "hw 3 cap 256",           "value" },
+            { "hw 257",                 "large" },
+            { "hw 20 drop 9",           "large" },
+            { "a 1, b 1, c 1, d 1, e 1, f 1, g 1, h 1, i 1", "large" }
+    };
+
+    for(size idx = 0; idx < NMEMBERS(badPolicies, badPolicies[0]); ++idx) {
+        GradingPlanStatus expectedStatus = badPolicies[idx][1][0] == 's' ? PLAN_BAD_SYNTAX
+                                           : badPolicies[idx][1][0] == 'v' ? PLAN_BAD_VALUE : PLAN_TOO_LARGE;
+        assert(GradingPlan_compile(badPolicies[idx][0], &plan) == expectedStatus);
+    }
+
+    // The plan is left as it was by a policy that does not compile
+    assert(plan.categoriesCount == 2);
+
+    assert(GradingPlan_compile(" quizzes 7 drop 3 cap 80 , labs 5 weight 2.5 drop 1,final 2 weight 4 ", &plan) == PLAN_COMPILED);
+    assert(GradingPlan_format(&plan, policy, sizeof(policy)));
+    assert(GradingPlan_compile(policy, &reparsed) == PLAN_COMPILED && t_samePlan(&plan, &reparsed));
+
+    // More rows than a tile, with every length of log from none to past the plan's width
+    const size planRows = GradingPlan_TILE_ROWS * 2 + 37;
+    static uint16_t planColumns[16 * (GradingPlan_TILE_ROWS * 2 + 37)];
+    static grade planLogs[GradingPlan_TILE_ROWS * 2 + 37][16];
+    float planScores[GradingPlan_TILE_ROWS * 2 + 37];
+
+    assert(plan.width <= 16);
+
+    for(size row = 0; row < planRows; ++row) {
+        size logLength = row % (plan.width + 2);
+
+        for(size position = 0; position < plan.width; ++position) {
+            planLogs[row][position] = (grade) rand();
+            planColumns[position * planRows + row] = position < logLength ? planLogs[row][position] : GradingPlan_MISSING;
+        }
+    }
+
+    GradingPlan_evaluate(&plan, planColumns, planRows, planScores);
+
+    for(size row = 0; row < planRows; ++row) {
+        size logLength = row % (plan.width + 2);
+        assert(planScores[row] == GradingPlan_score(&plan, planLogs[row], logLength < plan.width ? logLength : plan.width));
+    }
+
+    // Every set of correlation kernels sums every pair of panel columns as a plain double loop does, with and without a
+    // last column left over from the pairs, and across more than one block of columns
+    const CorrelationKernels* correlationSets[CorrelationKernels_MAX_SETS];
+    size nCorrelationSets = CorrelationKernels_supported(correlationSets);
+
+    assert(strcmp(correlationSets[0]->name, "scalar") == 0);
+    assert(CorrelationKernels_select() == correlationSets[nCorrelationSets - 1]);
+
+    const size maxColumns = 37;
+    static float panelAverages[37 * CourseCorrelation_TILE_ROWS], panelPresent[37 * CourseCorrelation_TILE_ROWS];
+    static float panelSums[4][37 * 37];
+
+    for(size cell = 0; cell < maxColumns * CourseCorrelation_TILE_ROWS; ++cell) {
+        panelPresent[cell]  = rand() % 3 != 0;
+        panelAverages[cell] = panelPresent[cell] ? (float) (rand() % 2001 - 1000) / 10 : 0;
+    }
+
+    for(size set = 0; set < nCorrelationSets; ++set) {
+        printf("Checking %s correlation kernels\n", correlationSets[set]->name);
+
+        for(size columns = 1; columns <= maxColumns; columns += 3) {
+            correlationSets[set]->panel(panelAverages, panelPresent, columns,
+                                        panelSums[0], panelSums[1], panelSums[2], panelSums[3]);
+
+            for(size a = 0; a < columns; ++a) {
+                for(size b = 0; b < columns; ++b) {
+                    double expected[4] = {};
+
+                    for(size row = 0; row < CourseCorrelation_TILE_ROWS; ++row) {
+                        double averageA = panelAverages[a * CourseCorrelation_TILE_ROWS + row];
+                        double averageB = panelAverages[b * CourseCorrelation_TILE_ROWS + row];
+                        double presentA = panelPresent[a * CourseCorrelation_TILE_ROWS + row];
+                        double presentB = panelPresent[b * CourseCorrelation_TILE_ROWS + row];
+
+                        expected[0] += presentA * presentB;
+                        expected[1] += averageA * presentB;
+                        expected[2] += averageA * averageA * presentB;
+                        expected[3] += averageA * averageB;
+                    }
+
+                    assert(panelSums[0][a * columns + b] == expected[0]);
+
+                    for(size sum = 1; sum < 4; ++sum) {
+                        assert(fabs(panelSums[sum][a * columns + b] - expected[sum]) <= 1e-4 * (fabs(expected[2]) + 1));
+                    }
+                }
+            }
+        }
+    }
+
+    // The array helpers read each grade once, starting with the first
+    grade few[] = { 5, 3, 9 };
+
+    assert(GradeArray_smallest(few, 3) == 3);
+    assert(GradeArray_largest(few, 3) == 9);
+    assert(GradeArray_sum(few, 3) == 17);
+    assert(GradeArray_smallest(few, 0) == MAX_GRADE && GradeArray_largest(few, 0) == MIN_GRADE);
+
+    GradeSummary summary = GradeArray_summarize(few, 3);
+    assert(summary.sum == 17 && summary.count == 3 && summary.smallest == 3 && summary.largest == 9);
+
+    return 0;
+}
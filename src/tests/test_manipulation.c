@@ -1,7 +1,12 @@
 #include <assert.h>
 #include <string.h>
+#include <math.h>
 #include "../models/model_io.h"
+#include "../models/grade_report.h"
+#include "../models/grade_sketch.h"
+#include "../models/course_correlation.h"
 #include "../shell/model_display.h"
+#include "../grading.h"
 #include "../tui.h"
 
 const byte nStudents    = 18;
@@ -11,43 +16,150 @@ const char* fileName    = "test_manip_index.gb";
 SerializationStatus t_openGradeBook(char* path, GradeBook* destination) {
 
     FILE* fptr  = fopen(path, "r");
-    long flen   = fsize(fptr);
+    SerialSource source;
+    SerialSource_initFile(&source, fptr);
 
-    byte buffer[flen];
-    fread(buffer, sizeof(byte), flen, fptr);
+    SerializationStatus stat = GradeBook_decode(&source, destination);
     fclose(fptr);
 
-    return GradeBook_deserialize(buffer, destination);
+    return stat;
 }
 
 SerializationStatus t_saveGradeBook(char* path, GradeBook* source) {
 
-    const size flen = sizeOfGradeBook(source);
-    byte buffer[flen];
-
-    SerializationStatus stat = GradeBook_serialize(source, buffer);
-
     FILE* fptr  = fopen(path, "w");
-    fwrite(buffer, sizeof(byte), flen, fptr);
+    SerialSink sink;
+    SerialSink_initFile(&sink, fptr);
+
+    SerializationStatus stat = GradeBook_encode(source, &sink);
     fclose(fptr);
 
     return stat;
 }
 
+bool t_sameSummary(GradeSummary a, GradeSummary b) {
+    return a.sum == b.sum && a.count == b.count && a.smallest == b.smallest && a.largest == b.largest;
+}
+
+/*
+ * Check the roster set queries between every pair of courses against the enrollment table
+ */
+void t_checkRosterSets(GradeBook* book) {
+    for(size idxA = 0; idxA < book->coursesCount; ++idxA) {
+        for(size idxB = 0; idxB < book->coursesCount; ++idxB) {
+            Course* a = GradeBook_courseAt(book, idxA);
+            Course* b = GradeBook_courseAt(book, idxB);
+
+            Student* common[Course_studentsCount(a) + 1];
+            Student* exclusive[Course_studentsCount(a) + 1];
+
+            size nCommon    = Course_commonStudents(book, a, b, common);
+            size nExclusive = Course_exclusiveStudents(book, a, b, exclusive);
+
+            assert(Course_commonStudentsCount(book, a, b) == nCommon);
+            assert(nCommon + nExclusive == Course_studentsCount(a));
+
+            for(size idx = 0; idx < nCommon; ++idx) {
+                assert(idx == 0 || common[idx - 1]->studentId < common[idx]->studentId);
+                assert(GradeBook_findEnrollment(book, common[idx], a) && GradeBook_findEnrollment(book, common[idx], b));
+            }
+
+            for(size idx = 0; idx < nExclusive; ++idx) {
+                assert(idx == 0 || exclusive[idx - 1]->studentId < exclusive[idx]->studentId);
+                assert(GradeBook_findEnrollment(book, exclusive[idx], a) && !GradeBook_findEnrollment(book, exclusive[idx], b));
+            }
+        }
+    }
+}
+
+/*
+ * Check every pair of the correlation matrix against the averages of the students the two courses share, compared a
+ * student at a time
+ */
+void t_checkCorrelation(GradeBook* book) {
+    CourseCorrelation matrix;
+    assert(CourseCorrelation_build(&matrix, book) && matrix.coursesCount == book->coursesCount);
+
+    for(size idxA = 0; idxA < book->coursesCount; ++idxA) {
+        for(size idxB = idxA; idxB < book->coursesCount; ++idxB) {
+            Course* a = GradeBook_courseAt(book, idxA);
+            Course* b = GradeBook_courseAt(book, idxB);
+            double sumA = 0, sumB = 0, squaresA = 0, squaresB = 0, products = 0;
+            size shared = 0;
+
+            for(size idx = 0; idx < book->studentsCount; ++idx) {
+                Student* student            = GradeBook_studentAt(book, idx);
+                StudentEnrollment* inA      = GradeBook_findEnrollment(book, student, a);
+                StudentEnrollment* inB      = GradeBook_findEnrollment(book, student, b);
+
+                if(!inA || !inB || inA->summary.count == 0 || inB->summary.count == 0) continue;
+
+                double averageA = Enrollment_average(book, inA), averageB = Enrollment_average(book, inB);
+
+                ++shared;
+                sumA        += averageA;
+                sumB        += averageB;
+                squaresA    += averageA * averageA;
+                squaresB    += averageB * averageB;
+                products    += averageA * averageB;
+            }
+
+            const CoursePair* pair = CourseCorrelation_pair(&matrix, idxB, idxA);
+            assert(matrix.courseIds[idxA] == a->courseId && pair->shared == shared);
+
+            if(shared < 2) {
+                assert(pair->covariance == 0 && isnan(pair->correlation));
+                continue;
+            }
+
+            double covariance   = (products - sumA * sumB / shared) / (shared - 1);
+            double varianceA    = (squaresA - sumA * sumA / shared) / (shared - 1);
+            double varianceB    = (squaresB - sumB * sumB / shared) / (shared - 1);
+
+            assert(fabs(pair->covariance - covariance) < 1e-3 * (1 + fabs(covariance)));
+
+            if(varianceA > 1e-6 && varianceB > 1e-6) {
+                assert(fabs(pair->correlation - covariance / sqrt(varianceA * varianceB)) < 1e-4);
+            }
+        }
+    }
+
+    CoursePairPosition strongest[8];
+    size nStrongest = CourseCorrelation_strongest(&matrix, 8, strongest);
+
+    for(size idx = 0; idx < nStrongest; ++idx) {
+        assert(strongest[idx].first < strongest[idx].second);
+        assert(idx == 0 || fabs(CourseCorrelation_pair(&matrix, strongest[idx - 1].first, strongest[idx - 1].second)->correlation)
+                           >= fabs(CourseCorrelation_pair(&matrix, strongest[idx].first, strongest[idx].second)->correlation));
+    }
+
+    CourseCorrelation_free(&matrix);
+}
+
+bool t_sameRanking(const RankEntry* a, const RankEntry* b, size count) {
+    for(size idx = 0; idx < count; ++idx) {
+        if(a[idx].key != b[idx].key || a[idx].id != b[idx].id || a[idx].slot != b[idx].slot) return false;
+    }
+    return true;
+}
+
 int main() {
 
     setbuf(stdout, NULL);
 
     GradeBook   index = {};
+    GradeBook_init(&index);
 
     for(byte idx = 0; idx < nCourses; ++idx) {
 
+        char courseName[255];
+
         Course course = {
                 .courseId   = idx,
-                .courseName = "TESTCR #%02u"
+                .courseName = courseName
         };
 
-        sprintf(course.courseName, course.courseName, course.courseId);
+        sprintf(courseName, "TESTCR #%02u", course.courseId);
 
         GradeBook_addCourse(&index, course);
     }
@@ -65,7 +177,7 @@ int main() {
 
         for(byte studentOffset = 0; studentOffset < (nStudents / nCourses); ++studentOffset) {
             byte start = courseIdx * (nStudents / nCourses);
-            Course_addStudent(&index.courses[courseIdx], &index.students[start + studentOffset]);
+            Course_addStudent(&index, GradeBook_courseAt(&index, courseIdx), GradeBook_studentAt(&index, start + studentOffset));
         }
 
     }
@@ -82,6 +194,7 @@ int main() {
     //------------------------------------------------------------------------------------------------------------------
 
     GradeBook anotherIndex = {};
+    GradeBook_init(&anotherIndex);
 
     switch(t_openGradeBook(fileName, &anotherIndex)){
         case SUCCESS:
@@ -90,7 +203,7 @@ int main() {
             return 1;
     }
 
-    char* idStudents[anotherIndex.coursesCount][GradeBook_STUDENT_COLUMN_COUNT];
+    char* idStudents[anotherIndex.studentsCount][GradeBook_STUDENT_COLUMN_COUNT];
 
     Table_allocStrings(anotherIndex.studentsCount, GradeBook_STUDENT_COLUMN_COUNT, idStudents, 255);
 
@@ -99,6 +212,15 @@ int main() {
     GradeBook_studentsTable(&anotherIndex, idStudents);
     Table_printRows(stdout, GradeBook_STUDENT_COLUMN_COUNT, anotherIndex.studentsCount, GradeBook_STUDENT_TABLE_COLUMNS, idStudents);
 
+    // A clone must be unaffected by removals from the original, and its handles must resolve within itself
+
+    GradeBook snapshot;
+    assert(GradeBook_clone(&snapshot, &anotherIndex));
+
+    Course* snapshotCourse = GradeBook_findCourse(&snapshot, 1);
+    assert(GradeBook_resolveStudent(&snapshot, Course_enrollmentAt(&snapshot, snapshotCourse, 0)->student)
+           == GradeBook_findStudent(&snapshot, 6));
+
     //
 
     assert(GradeBook_removeStudent(&anotherIndex, &(Student){.studentId =  9}));
@@ -107,6 +229,426 @@ int main() {
 
     //
 
+    assert(GradeBook_checkInvariants(&anotherIndex));
+    assert(GradeBook_checkInvariants(&snapshot));
+    assert(GradeBook_findStudent(&snapshot, 9) && GradeBook_findStudent(&snapshot, 13));
+    assert(snapshot.studentsCount == anotherIndex.studentsCount + 3);
+    GradeBook_close(&snapshot);
+
+    // Once grade entry has warmed the pool up, giving and taking back grades must not call malloc
+
+    StudentEnrollment* enrollment = Course_enrollmentAt(&anotherIndex, GradeBook_findCourse(&anotherIndex, 0), 0);
+
+    for(size idx = 0; idx < 100; ++idx) Enrollment_addGrade(&anotherIndex, enrollment, (grade) idx);
+    while(enrollment->grades.count > 0) Enrollment_removeGrade(&anotherIndex, enrollment, 0);
+
+    size systemAllocations = anotherIndex.pool.stats.systemAllocations;
+
+    for(size round = 0; round < 50; ++round) {
+        for(size idx = 0; idx < 100; ++idx) Enrollment_addGrade(&anotherIndex, enrollment, (grade) idx);
+        while(enrollment->grades.count > 0) Enrollment_removeGrade(&anotherIndex, enrollment, enrollment->grades.count - 1);
+    }
+
+    assert(anotherIndex.pool.stats.systemAllocations == systemAllocations);
+    assert(GradeBook_checkInvariants(&anotherIndex));
+
+    // Running totals follow grades and enrollments, and averages are read from them
+
+    Course* graded = GradeBook_findCourse(&anotherIndex, 0);
+    StudentEnrollment* first    = Course_enrollmentAt(&anotherIndex, graded, 0);
+    StudentEnrollment* second   = Course_enrollmentAt(&anotherIndex, graded, 1);
+
+    Enrollment_addGrade(&anotherIndex, first, 60);
+    Enrollment_addGrade(&anotherIndex, first, 100);
+    Enrollment_addGrade(&anotherIndex, second, 90);
+    Enrollment_addGrade(&anotherIndex, second, 20);
+
+    GradeSummary courseSummary = Course_gradeSummary(&anotherIndex, graded);
+    assert(courseSummary.sum == 270 && courseSummary.count == 4);
+    assert(courseSummary.smallest == 20 && courseSummary.largest == 100);
+    assert(Course_averageGrade(&anotherIndex, graded) == (80.0f + 55.0f) / Course_studentsCount(graded));
+    assert(Enrollment_average(&anotherIndex, first) == 80.0f);
+
+    GradeDistribution distribution;
+    Course_gradeDistribution(&anotherIndex, graded, &distribution);
+    assert(distribution.count == 4 && GradeDistribution_median(&distribution) == 75.0);
+    assert(GradeDistribution_percentile(&distribution, 25) == 20 && GradeDistribution_percentile(&distribution, 100) == 100);
+    assert(GradeDistribution_mode(&distribution) == 20 && GradeDistribution_mean(&distribution) == 67.5);
+    assert(GradeDistribution_percentileRank(&distribution, 80) == 50.0);
+
+    // Histograms widen once a grade is given more than 255 times
+    for(size idx = 0; idx < 300; ++idx) Enrollment_addGrade(&anotherIndex, first, 70);
+    Course_gradeDistribution(&anotherIndex, graded, &distribution);
+    assert(distribution.counts[70] == 300 && GradeDistribution_mode(&distribution) == 70);
+    assert(GradeBook_checkInvariants(&anotherIndex));
+    while(first->grades.count > 2) Enrollment_removeGrade(&anotherIndex, first, 2);
+
+    assert(Enrollment_removeGrade(&anotherIndex, second, 1));
+    assert(graded->aggregate.boundsStale);
+    assert(GradeBook_checkInvariants(&anotherIndex));
+    assert(Course_gradeSummary(&anotherIndex, graded).smallest == 60 && !graded->aggregate.boundsStale);
+
+    Student* firstStudent = GradeBook_resolveStudent(&anotherIndex, first->student);
+    assert(Student_averageGrade(&anotherIndex, firstStudent) == 80.0f / Student_coursesCount(firstStudent));
+
+    assert(Course_remStudent(&anotherIndex, graded, firstStudent));
+    assert(Course_gradeSummary(&anotherIndex, graded).sum == 90 && Course_gradeSummary(&anotherIndex, graded).largest == 90);
+    assert(Student_gradeSummary(&anotherIndex, firstStudent).count == 0);
+    assert(GradeBook_checkInvariants(&anotherIndex));
+
+    // A transaction applies its changes in queue order, or not at all
+
+    GradeBook batch;
+    assert(GradeBook_clone(&batch, &anotherIndex));
+
+    size batchStudents = batch.studentsCount;
+
+    assert(GradeBook_begin(&batch));
+    assert(!GradeBook_begin(&batch));
+
+    for(byte idx = 40; idx > 20; --idx) {
+        GradeBook_queueAddStudent(&batch, (Student){ .studentId = idx, .studentName = "BATCH" });
+        GradeBook_queueEnroll(&batch, idx, 2);
+        GradeBook_queueGrade(&batch, idx, 2, idx);
+    }
+
+    GradeBook_queueAddCourse(&batch, (Course){ .courseId = 7, .courseName = "BATCHCR" });
+    GradeBook_queueEnroll(&batch, 0, 7);
+    GradeBook_queueRemoveStudent(&batch, 0);
+    GradeBook_queueAddStudent(&batch, (Student){ .studentId = 0 });
+    GradeBook_queueEnroll(&batch, 0, 7);
+    GradeBook_queueRemoveStudent(&batch, 30);
+    GradeBook_queueRemoveCourse(&batch, 1);
+
+    assert(GradeBook_commit(&batch) == TXN_COMMITTED);
+    assert(GradeBook_checkInvariants(&batch));
+    assert(batch.studentsCount == batchStudents + 19);
+    assert(!GradeBook_findCourse(&batch, 1) && !GradeBook_findStudent(&batch, 30));
+    assert(GradeBook_findCourse(&batch, 7)->studentsCount == 1);
+    assert(Student_coursesCount(GradeBook_findStudent(&batch, 0)) == 1);
+    assert(GradeBook_findEnrollment(&batch, GradeBook_findStudent(&batch, 21), GradeBook_findCourse(&batch, 2))
+                   ->grades.count == 1);
+
+    size batchCourses = batch.coursesCount;
+    batchStudents = batch.studentsCount;
+
+    assert(GradeBook_begin(&batch));
+    GradeBook_queueRemoveStudent(&batch, 21);
+    GradeBook_queueAddStudent(&batch, (Student){ .studentId = 50 });
+    GradeBook_queueGrade(&batch, 21, 2, 100);
+
+    assert(GradeBook_commit(&batch) == TXN_MISSING_STUDENT);
+    assert(batch.transaction.failedAt == 2);
+    assert(GradeBook_findStudent(&batch, 21) && !GradeBook_findStudent(&batch, 50));
+    assert(batch.coursesCount == batchCourses && batch.studentsCount == batchStudents);
+    assert(GradeBook_checkInvariants(&batch));
+    assert(GradeBook_commit(&batch) == TXN_NOT_OPEN);
+
+    // A report gathered by several threads agrees with the running totals, and with one gathered by a single thread
+
+    WorkerPool workers;
+    WorkerPool_init(&workers, 4);
+    assert(WorkerPool_workersCount(&workers) == 4);
+
+    GradeReport report, serialReport;
+    GradeReport_init(&report);
+    GradeReport_init(&serialReport);
+
+    GradeReport_build(&report, &batch, &workers);
+    GradeReport_build(&report, &batch, &workers);
+    GradeReport_build(&serialReport, &batch, NULL);
+
+    assert(report.coursesCount == batch.coursesCount && report.studentsCount == batch.studentsCount);
+
+    for(size idx = 0; idx < report.coursesCount; ++idx) {
+        Course* course = GradeBook_courseAt(&batch, idx);
+        GradeSummary expected = Course_gradeSummary(&batch, course);
+        Course_gradeDistribution(&batch, course, &distribution);
+
+        assert(report.courses[idx].id == course->courseId);
+        assert(t_sameSummary(report.courses[idx].grades, expected));
+        assert(report.courses[idx].average == Course_averageGrade(&batch, course));
+        assert(memcmp(&report.courseDistributions[idx], &distribution, sizeof(distribution)) == 0);
+    }
+
+    for(size idx = 0; idx < report.studentsCount; ++idx) {
+        Student* student = GradeBook_studentAt(&batch, idx);
+
+        assert(report.students[idx].id == student->studentId);
+        assert(t_sameSummary(report.students[idx].grades, Student_gradeSummary(&batch, student)));
+        assert(report.students[idx].enrollmentsCount == Student_coursesCount(student));
+        assert(report.students[idx].average == serialReport.students[idx].average);
+    }
+
+    assert(report.grades.count == report.distribution.count && report.grades.sum == serialReport.grades.sum);
+
+    GradeReport_free(&report);
+    GradeReport_free(&serialReport);
+    WorkerPool_free(&workers);
+
+    // Rankings: the first query sorts, the second builds the index, which then follows every change
+
+    RankEntry ranked[64], expected[64];
+
+    for(size idx = 0; idx < batch.studentsCount; ++idx) {
+        Student* student = GradeBook_studentAt(&batch, idx);
+        if(Student_coursesCount(student) == 0) continue;
+
+        Enrollment_addGrade(&batch, Student_enrollmentAt(&batch, student, 0), (grade) (idx * 37 % 101));
+    }
+
+    size nRanked = GradeBook_rankStudents(&batch, 5, true, ranked);
+    assert(nRanked == 5 && !RankIndex_isLive(&batch.studentRanks));
+
+    for(size idx = 1; idx < nRanked; ++idx) assert(ranked[idx - 1].key >= ranked[idx].key);
+
+    assert(GradeBook_rankStudents(&batch, 5, true, expected) == 5 && RankIndex_isLive(&batch.studentRanks));
+    assert(t_sameRanking(ranked, expected, 5));
+    assert(GradeBook_rankCourses(&batch, 64, false, ranked) == batch.coursesCount);
+    assert(GradeBook_rankCourses(&batch, 64, false, ranked) == batch.coursesCount);
+    assert(RankIndex_isLive(&batch.courseRanks));
+
+    GradeBook_rankStudents(&batch, 1, false, ranked);
+    Student* trailer = GradeBook_findStudent(&batch, ranked[0].id);
+
+    for(size idx = 0; idx < 20; ++idx) Enrollment_addGrade(&batch, Student_enrollmentAt(&batch, trailer, 0), 250);
+    assert(GradeBook_rankStudents(&batch, 1, true, ranked) == 1 && ranked[0].id == trailer->studentId);
+
+    GradeBook_removeStudent(&batch, trailer);
+    Course_remStudentIndex(&batch, GradeBook_courseAt(&batch, 0), 0);
+    GradeBook_addStudent(&batch, (Student){ .studentId = 99 });
+    assert(GradeBook_checkInvariants(&batch));
+
+    GradeBook cold;
+    assert(GradeBook_clone(&cold, &batch));
+
+    for(size k = 0; k <= batch.studentsCount + 1 && k < 64; k += 3) {
+        for(int highest = 0; highest < 2; ++highest) {
+            nRanked = GradeBook_rankStudents(&batch, k, highest, ranked);
+            assert(nRanked == (k < batch.studentsCount ? k : batch.studentsCount));
+
+            cold.studentRanks.coldQueries = 0;
+            assert(GradeBook_rankStudents(&cold, k, highest, expected) == nRanked);
+            assert(t_sameRanking(ranked, expected, nRanked));
+        }
+    }
+
+    assert(!RankIndex_isLive(&cold.studentRanks));
+    GradeBook_close(&cold);
+
+    // Roster sets are built by the first set query, then follow every enrollment
+
+    assert(!batch.courseMembers);
+    t_checkRosterSets(&batch);
+    assert(batch.courseMembers);
+
+    Course* firstCourse = GradeBook_courseAt(&batch, 0);
+    Course* lastCourse  = GradeBook_courseAt(&batch, batch.coursesCount - 1);
+
+    for(size idx = 0; idx < batch.studentsCount; idx += 2) {
+        Student* student = GradeBook_studentAt(&batch, idx);
+        Course_addStudent(&batch, firstCourse, student);
+        Course_remStudent(&batch, lastCourse, student);
+    }
+
+    GradeBook_removeStudentIndex(&batch, 1);
+    assert(GradeBook_checkInvariants(&batch));
+    t_checkRosterSets(&batch);
+
+    GradeBook_removeCourse(&batch, lastCourse);
+    GradeBook_addCourse(&batch, (Course){ .courseId = 200, .courseName = "Reused" });
+    Course_addStudent(&batch, GradeBook_findCourse(&batch, 200), GradeBook_studentAt(&batch, 0));
+    assert(GradeBook_checkInvariants(&batch));
+    assert(Course_studentsCount(GradeBook_findCourse(&batch, 200)) == 1);
+    t_checkRosterSets(&batch);
+
+    // A course with a policy scores its whole roster at once, as each enrollment would be scored alone
+
+    Course* policied = GradeBook_findCourse(&batch, 200);
+    GradingPlan plan;
+
+    assert(!Course_policy(&batch, policied));
+    assert(GradingPlan_compile("homework 3 drop 1, exams 2 weight 2 cap 90", &plan) == PLAN_COMPILED);
+
+    for(size idx = 0; idx < batch.studentsCount; ++idx) {
+        Student* student = GradeBook_studentAt(&batch, idx);
+        Course_addStudent(&batch, policied, student);
+
+        StudentEnrollment* enrollment = GradeBook_findEnrollment(&batch, student, policied);
+        for(size given = 0; given < idx % 8; ++given) Enrollment_addGrade(&batch, enrollment, (grade) (idx * 13 + given * 29));
+    }
+
+    size nPolicied = Course_studentsCount(policied);
+    float scores[nPolicied];
+
+    assert(Course_policyScores(&batch, policied, scores) == nPolicied);
+    for(size idx = 0; idx < nPolicied; ++idx) {
+        assert(scores[idx] == Enrollment_average(&batch, Course_enrollmentAt(&batch, policied, idx)));
+    }
+
+    Course_setPolicy(&batch, policied, &plan);
+    assert(Course_policy(&batch, policied) && Course_policy(&batch, policied)->width == 5);
+    assert(Course_policyScores(&batch, policied, scores) == nPolicied);
+
+    for(size idx = 0; idx < nPolicied; ++idx) {
+        assert(scores[idx] == Enrollment_policyScore(&batch, Course_enrollmentAt(&batch, policied, idx)));
+    }
+
+    StudentEnrollment* scored = Course_enrollmentAt(&batch, policied, 0);
+    while(scored->grades.count > 0) Enrollment_removeGrade(&batch, scored, 0);
+    while(scored->grades.count < 5) Enrollment_addGrade(&batch, scored, 100);
+    Enrollment_removeGrade(&batch, scored, 0);
+    Enrollment_addGrade(&batch, scored, 40);
+
+    // Homework 100, 100, 100; exams 100, 40: (100 + 2 * 70) / 3
+    assert(Enrollment_policyScore(&batch, scored) == 80.0f);
+
+    GradeBook policyCopy;
+    assert(GradeBook_clone(&policyCopy, &batch));
+    assert(Course_policy(&policyCopy, GradeBook_findCourse(&policyCopy, 200)));
+    GradeBook_close(&policyCopy);
+
+    // A course that takes the slot of one with a policy is graded by plain average
+    GradeBook_removeCourse(&batch, policied);
+    GradeBook_addCourse(&batch, (Course){ .courseId = 201, .courseName = "Unpolicied" });
+    assert(!Course_policy(&batch, GradeBook_findCourse(&batch, 201)));
+
+    Course_setPolicy(&batch, GradeBook_findCourse(&batch, 201), &plan);
+    Course_setPolicy(&batch, GradeBook_findCourse(&batch, 201), NULL);
+    assert(!Course_policy(&batch, GradeBook_findCourse(&batch, 201)));
+    assert(GradeBook_checkInvariants(&batch));
+
+    // A curve rewrites every grade of a course in one pass, and its totals, histograms and ranks follow
+
+    Course* curved = GradeBook_findCourse(&batch, 201);
+
+    for(size idx = 0; idx < batch.studentsCount; ++idx) {
+        Student* student = GradeBook_studentAt(&batch, idx);
+        Course_addStudent(&batch, curved, student);
+
+        StudentEnrollment* enrollment = GradeBook_findEnrollment(&batch, student, curved);
+        for(size given = 0; given < 150; ++given) Enrollment_addGrade(&batch, enrollment, (grade) (idx * 7 + given * 3));
+    }
+
+    GradeBook_rankStudents(&batch, 1, true, ranked);
+    GradeBook_rankCourses(&batch, 1, true, ranked);
+
+    GradeCurve offset = { .kind = CURVE_OFFSET, .offset = 30 };
+    StudentEnrollment* watched  = Course_enrollmentAt(&batch, curved, 1);
+    grade before                = GradeLog_at(&batch.gradeChunks, &watched->grades, 149);
+    size nCurved                = GradeBook_curveCourse(&batch, curved, &offset);
+
+    assert(nCurved == 150 * Course_studentsCount(curved));
+    assert(GradeLog_at(&batch.gradeChunks, &watched->grades, 149) == (before > 225 ? 255 : before + 30));
+    assert(GradeBook_checkInvariants(&batch));
+
+    // Narrow histograms that a curve piles more than 255 grades in to one bucket of are widened
+    GradeCurve clamp = { .kind = CURVE_CLAMP, .low = 200, .high = 200 };
+    GradeBook_curveCourse(&batch, curved, &clamp);
+    Course_gradeDistribution(&batch, curved, &distribution);
+    assert(distribution.counts[200] == nCurved && Course_gradeSummary(&batch, curved).smallest == 200);
+    assert(Course_averageGrade(&batch, curved) == 200.0f);
+    assert(GradeBook_checkInvariants(&batch));
+
+    GradeCurve map = { .kind = CURVE_MAP };
+    for(size value = 0; value < 256; ++value) map.table[value] = (grade) (255 - value);
+    GradeBook_curveCourse(&batch, curved, &map);
+    assert(Course_gradeSummary(&batch, curved).largest == 55);
+    assert(GradeBook_checkInvariants(&batch));
+
+    GradeBook_removeCourse(&batch, curved);
+    assert(GradeBook_checkInvariants(&batch));
+
+    // Correlations follow the shared students of each pair, in a book whose students take most courses, and in one
+    // where each takes a few of many
+    t_checkCorrelation(&batch);
+
+    GradeBook sparse;
+    GradeBook_init(&sparse);
+
+    for(size idx = 0; idx < 120; ++idx) GradeBook_addCourse(&sparse, (Course){ .courseId = (identifier) idx, .courseName = "Sparse" });
+    for(size idx = 0; idx < 250; ++idx) GradeBook_addStudent(&sparse, (Student){ .studentId = (identifier) idx, .studentName = "Sparse" });
+
+    for(size idx = 0; idx < 250; ++idx) {
+        Student* student = GradeBook_studentAt(&sparse, idx);
+
+        for(size taken = 0; taken < 3; ++taken) {
+            Course* course = GradeBook_courseAt(&sparse, (idx * 7 + taken * 13) % 12 + (idx % 10) * 12);
+            Course_addStudent(&sparse, course, student);
+
+            // Leave some enrollments without grades, which take no part
+            if((idx + taken) % 5 == 0) continue;
+
+            StudentEnrollment* enrollment = GradeBook_findEnrollment(&sparse, student, course);
+            Enrollment_addGrade(&sparse, enrollment, (grade) ((idx * 31 + taken * 17) % 101));
+            Enrollment_addGrade(&sparse, enrollment, (grade) ((idx * 11) % 97));
+        }
+    }
+
+    t_checkCorrelation(&sparse);
+    GradeBook_close(&sparse);
+
+    // Sketches: grade distributions are exact, and distinct students are counted within a few percent
+
+    DistinctSketch halves[2] = {}, whole = {};
+
+    for(uint64_t value = 0; value < 100000; ++value) {
+        DistinctSketch_add(&halves[value % 2], value);
+        DistinctSketch_add(&whole, value);
+        DistinctSketch_add(&whole, value / 2);
+    }
+
+    assert(fabs(DistinctSketch_estimate(&whole) - 100000) < 5000);
+    assert(DistinctSketch_estimate(&(DistinctSketch){}) == 0);
+
+    DistinctSketch_merge(&halves[0], &halves[1]);
+    assert(memcmp(&halves[0], &whole, sizeof(whole)) == 0);
+
+    GradeSketch sketch, shard;
+    GradeSketch_init(&sketch);
+    GradeSketch_init(&shard);
+
+    GradeSketch_addBook(&sketch, &batch);
+    assert(sketch.coursesCount == batch.coursesCount && sketch.booksCount == 1);
+    size nEnrolled = 0;
+    for(size idx = 0; idx < batch.studentsCount; ++idx) nEnrolled += Student_coursesCount(GradeBook_studentAt(&batch, idx)) > 0;
+    assert(fabs(DistinctSketch_estimate(&sketch.students) - (double) nEnrolled) < 1);
+
+    for(size idx = 0; idx < batch.coursesCount; ++idx) {
+        Course* course                  = GradeBook_courseAt(&batch, idx);
+        const CourseSketch* sketched    = GradeSketch_findCourse(&sketch, course->courseId);
+        GradeDistribution distribution;
+
+        Course_gradeDistribution(&batch, course, &distribution);
+        assert(sketched && memcmp(&sketched->grades, &distribution, sizeof(distribution)) == 0);
+        assert(fabs(DistinctSketch_estimate(&sketched->students) - (double) Course_studentsCount(course)) < 1);
+    }
+
+    // Sketches of separate books merge in to the sketch of all of them, counting a shared student once
+    GradeSketch other;
+    GradeSketch_init(&other);
+    GradeSketch_addBook(&other, &anotherIndex);
+
+    GradeSketch_addBook(&shard, &batch);
+    GradeSketch_merge(&shard, &other);
+    GradeSketch_merge(&shard, &sketch);
+
+    DistinctSketch students = sketch.students;
+    DistinctSketch_merge(&students, &other.students);
+
+    assert(shard.booksCount == 3 && shard.enrollmentsCount == 2 * sketch.enrollmentsCount + other.enrollmentsCount);
+    assert(shard.grades.count == 2 * sketch.grades.count + other.grades.count);
+    assert(memcmp(&shard.students, &students, sizeof(students)) == 0);
+
+    GradeSketch_free(&other);
+
+    for(size idx = 1; idx < shard.coursesCount; ++idx) assert(shard.courses[idx - 1].courseId < shard.courses[idx].courseId);
+
+    GradeSketch_free(&shard);
+    GradeSketch_free(&sketch);
+
+    GradeBook_close(&batch);
+
     printf("\n\nPost-remove, pre-save\n\n");
 
     GradeBook_studentsTable(&anotherIndex, idStudents);
@@ -133,5 +675,8 @@ int main() {
 
     Table_unallocStrings(anotherIndex.studentsCount, GradeBook_STUDENT_COLUMN_COUNT, idStudents);
 
+    GradeBook_close(&index);
+    GradeBook_close(&anotherIndex);
+
     return 0;
 }
\ No newline at end of file
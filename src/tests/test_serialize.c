@@ -1,4 +1,9 @@
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include "../models/model_io.h"
+#include "../models/gradebook_map.h"
+#include "../grading.h"
 
 const byte nStudents    = 100;
 const byte nCourses     = 25;
@@ -11,17 +16,20 @@ int main() {
     printf("Initializing GradeBook\n");
 
     GradeBook   index = {};
+    GradeBook_init(&index);
 
     printf("Creating %u courses:\n", nCourses);
 
     for(byte idx = 0; idx < nCourses; ++idx) {
 
+        char courseName[255];
+
         Course course = {
                 .courseId   = idx,
-                .courseName = "TESTCR #%02u"
+                .courseName = courseName
         };
 
-        sprintf(course.courseName, course.courseName, course.courseId);
+        sprintf(courseName, "TESTCR #%02u", course.courseId);
 
         GradeBook_addCourse(&index, course);
     }
@@ -30,11 +38,14 @@ int main() {
 
     for(byte idx = 0; idx < nStudents; ++idx) {
 
+        char studentName[255];
+
         Student student = {
                 .studentId      = idx,
+                .studentName    = studentName
         };
 
-        sprintf(student.studentName, "Test Student #%02u", student.studentId);
+        sprintf(studentName, "Test Student #%02u", student.studentId);
 
         GradeBook_addStudent(&index, student);
     }
@@ -42,20 +53,36 @@ int main() {
     printf("Associate students and courses\n");
 
     for(byte courseIdx = 0; courseIdx < nCourses; ++courseIdx) {
-        char* courseName = Course_toString(&index.courses[courseIdx]);
+        char* courseName = Course_toString(GradeBook_courseAt(&index, courseIdx));
 
         printf("Associations for %s:\n\n", courseName);
 
         for(byte studentOffset = 0; studentOffset < (nStudents / nCourses); ++studentOffset) {
             printf("-> Adding student %u of %u\n", studentOffset + 1, (nStudents / nCourses));
             byte start = courseIdx * (nStudents / nCourses);
-            Course_addStudent(&index.courses[courseIdx], &index.students[start + studentOffset]);
+            Course_addStudent(&index, GradeBook_courseAt(&index, courseIdx), GradeBook_studentAt(&index, start + studentOffset));
         }
 
         printf("-> Done: %s\n\n", courseName);
         free(courseName);
     }
 
+    printf("Grading students\n");
+
+    // One log long enough to run past the buffer of a sink, which is then written around it
+    for(byte courseIdx = 0; courseIdx < nCourses; ++courseIdx) {
+        Course* course = GradeBook_courseAt(&index, courseIdx);
+
+        for(size studentIdx = 0; studentIdx < Course_studentsCount(course); ++studentIdx) {
+            StudentEnrollment* enrollment = Course_enrollmentAt(&index, course, studentIdx);
+            size nGrades = (courseIdx == 0 && studentIdx == 0) ? 3 * SerialSink_BUFFER_BYTES : studentIdx * 3;
+
+            for(size gradeIdx = 0; gradeIdx < nGrades; ++gradeIdx) {
+                GradeBook_addGrade(&index, enrollment, (grade) (gradeIdx * 7 + courseIdx));
+            }
+        }
+    }
+
     printf("Opening file %s\n", fileName);
 
     FILE* writePtr = fopen(fileName, "w");
@@ -89,66 +116,489 @@ int main() {
      */
     fclose(writePtr);
 
+    // Test Sinks ------------------------------------------------------------------------------------------------------
+
+    printf("Encoding in to a growable buffer, a file descriptor, and a buffer one byte short\n");
+
+    SerialBuffer grown;
+    SerialSink sink;
+
+    SerialBuffer_init(&grown);
+    SerialSink_initBuffer(&sink, &grown);
+
+    if(GradeBook_encode(&index, &sink) != SUCCESS || sink.written != gbSize || grown.count != gbSize
+       || memcmp(grown.data, gbSerial, gbSize) != 0) {
+        printf("Encoding in to a growable buffer did not give the serialized bytes\n");
+        return 1;
+    }
+
+    SerialBuffer_free(&grown);
+
+    const char* fdFileName  = "serial_gradebook_fd.gb";
+    int fd                  = open(fdFileName, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    SerialSink_initFd(&sink, fd);
+    SerializationStatus fdStatus = GradeBook_encode(&index, &sink);
+    close(fd);
+
+    FILE* fdPtr = fopen(fdFileName, "r");
+    byte fdSerial[gbSize];
+
+    if(fdStatus != SUCCESS || (size) fsize(fdPtr) != gbSize || fread(fdSerial, sizeof(byte), gbSize, fdPtr) != gbSize
+       || memcmp(fdSerial, gbSerial, gbSize) != 0) {
+        printf("Encoding in to a file descriptor did not give the serialized bytes\n");
+        return 1;
+    }
+
+    fclose(fdPtr);
+
+    SerialBuffer_wrap(&grown, fdSerial, gbSize - 1);
+    SerialSink_initBuffer(&sink, &grown);
+
+    if(GradeBook_encode(&index, &sink) != FAILURE) {
+        printf("Encoding in to a buffer too short for the GradeBook did not fail\n");
+        return 1;
+    }
+
     // Test Deserialization --------------------------------------------------------------------------------------------
 
     printf("Testing GradeBook deserialization\n");
 
     GradeBook anotherIndex = {};
+    GradeBook_init(&anotherIndex);
 
-    FILE* readPtr = fopen(fileName, "r");
-    size fSize = (size) fsize(readPtr);
+    int readFd = open(fileName, O_RDONLY);
 
-    byte gbReadIn[fSize];
+    SerialSource source;
+    SerialSource_initFd(&source, readFd);
 
-    fread(gbReadIn, fSize, sizeof(byte), readPtr);
+    printf("Opened %s. Calling deserializer\n", fileName);
 
-    printf("Read %lu bytes. Calling deserializer\n", fSize);
+    SerializationStatus readStatus = GradeBook_decode(&source, &anotherIndex);
+    close(readFd);
 
-    switch(GradeBook_deserialize(gbReadIn, &anotherIndex)) {
+    switch(readStatus) {
         case SUCCESS:
             printf("Success!\n");
             break;
         case ILLEGAL_COURSE_ID:
         case ILLEGAL_STUDENT_ID:
             printf("Invalid reference (see output). File not written\n");
-            fclose(readPtr);
             return 1;
         case BAD_MAGIC:
             printf("Invalid magic number sequence.\n");
-            fclose(readPtr);
             return 1;
         case SHORT_BUFFER:
         case FAILURE:
             printf("Other failure encountered. File not written\n");
-            fclose(readPtr);
             return 1;
     }
 
+    // What was read back must encode to the same bytes
+    SerialBuffer_init(&grown);
+    SerialSink_initBuffer(&sink, &grown);
+
+    if(GradeBook_encode(&anotherIndex, &sink) != SUCCESS || grown.count != gbSize
+       || memcmp(grown.data, gbSerial, gbSize) != 0) {
+        printf("The GradeBook read back did not encode to the serialized bytes\n");
+        return 1;
+    }
+
+    SerialBuffer_free(&grown);
+
+    // Test Truncation -------------------------------------------------------------------------------------------------
+
+    printf("Deserializing every %lu'th prefix, and the last few, of the serialized bytes\n", gbSize / 64 + 1);
+
+    GradeBook truncated = {};
+    GradeBook_init(&truncated);
+
+    for(size length = 0; length < gbSize; length += (length + 16 < gbSize) ? gbSize / 64 + 1 : 1) {
+        if(GradeBook_deserialize(gbSerial, length, &truncated) != SHORT_BUFFER
+           || truncated.coursesCount != 0 || truncated.studentsCount != 0) {
+            printf("Deserializing the first %lu of %lu bytes did not fail cleanly\n", length, gbSize);
+            return 1;
+        }
+    }
+
+    if(GradeBook_deserialize(gbSerial, gbSize, &truncated) != SUCCESS
+       || truncated.coursesCount != index.coursesCount || truncated.studentsCount != index.studentsCount) {
+        printf("Deserializing the whole of the serialized bytes failed\n");
+        return 1;
+    }
+
+    memcpy(fdSerial, gbSerial, gbSize);
+    fdSerial[3] = 0x02;
+
+    if(GradeBook_deserialize(fdSerial, gbSize, &truncated) != BAD_MAGIC || truncated.coursesCount != 0) {
+        printf("Deserializing bytes with an unknown magic did not fail cleanly\n");
+        return 1;
+    }
+
+    GradeBook_close(&truncated);
+
+    // Test Mapped Layout ----------------------------------------------------------------------------------------------
+
+    printf("Exporting the GradeBook in the mapped layout, and reading it in place\n");
+
+    // Give one student a transcript of several courses, so that transcripts are read across rosters
+    Student* transcribed = GradeBook_studentAt(&index, 0);
+
+    for(byte courseIdx = 1; courseIdx < 5; ++courseIdx) {
+        Course* course = GradeBook_courseAt(&index, courseIdx);
+        Course_addStudent(&index, course, transcribed);
+        GradeBook_addGrade(&index, GradeBook_findEnrollment(&index, transcribed, course), (grade) (courseIdx * 11));
+    }
+
+    const char* mappedFileName = "serial_gradebook_mapped.gb";
+    FILE* mappedPtr = fopen(mappedFileName, "w");
+
+    SerialSink_initFile(&sink, mappedPtr);
+    SerializationStatus mappedStatus = GradeBook_encodeMapped(&index, &sink);
+    fclose(mappedPtr);
+
+    GradeBookMap map;
+
+    if(mappedStatus != SUCCESS || GradeBookMap_open(&map, mappedFileName) != SUCCESS
+       || map.coursesCount != index.coursesCount || map.studentsCount != index.studentsCount) {
+        printf("The mapped GradeBook could not be written and opened\n");
+        return 1;
+    }
+
+    for(size courseIdx = 0; courseIdx < index.coursesCount; ++courseIdx) {
+        Course* course              = GradeBook_courseAt(&index, courseIdx);
+        const MappedCourse* mapped  = GradeBookMap_findCourse(&map, course->courseId);
+
+        if(!mapped || strcmp(GradeBookMap_courseName(&map, mapped), course->courseName) != 0
+           || mapped->studentsCount != Course_studentsCount(course)
+           || MappedCourse_average(mapped) != Course_averageGrade(&index, course)) {
+            printf("Mapped course %u does not match the GradeBook\n", course->courseId);
+            return 1;
+        }
+
+        for(size studentIdx = 0; studentIdx < Course_studentsCount(course); ++studentIdx) {
+            StudentEnrollment* enrollment           = Course_enrollmentAt(&index, course, studentIdx);
+            const MappedEnrollment* mappedEnrollment = GradeBookMap_rosterAt(&map, mapped, studentIdx);
+            const MappedStudent* mappedStudent      = GradeBookMap_enrollmentStudent(&map, mappedEnrollment);
+            const grade* mappedGrades               = GradeBookMap_grades(&map, mappedEnrollment);
+
+            grade grades[enrollment->grades.count ? enrollment->grades.count : 1];
+            Enrollment_copyGrades(&index, enrollment, grades);
+
+            if(mappedStudent->studentId != GradeBook_resolveStudent(&index, enrollment->student)->studentId
+               || mappedEnrollment->gradesCount != enrollment->grades.count
+               || memcmp(mappedGrades, grades, enrollment->grades.count) != 0
+               || MappedEnrollment_average(mappedEnrollment) != Enrollment_average(&index, enrollment)) {
+                printf("Mapped roster of course %u does not match the GradeBook at %lu\n", course->courseId, studentIdx);
+                return 1;
+            }
+        }
+    }
+
+    for(size studentIdx = 0; studentIdx < index.studentsCount; ++studentIdx) {
+        Student* student            = GradeBook_studentAt(&index, studentIdx);
+        const MappedStudent* mapped = GradeBookMap_findStudent(&map, student->studentId);
+
+        if(!mapped || strcmp(GradeBookMap_studentName(&map, mapped), student->studentName) != 0
+           || mapped->coursesCount != Student_coursesCount(student)
+           || MappedStudent_average(mapped) != Student_averageGrade(&index, student)) {
+            printf("Mapped student %u does not match the GradeBook\n", student->studentId);
+            return 1;
+        }
+
+        for(size courseIdx = 0; courseIdx < Student_coursesCount(student); ++courseIdx) {
+            StudentEnrollment* enrollment               = Student_enrollmentAt(&index, student, courseIdx);
+            const MappedEnrollment* mappedEnrollment    = GradeBookMap_transcriptAt(&map, mapped, courseIdx);
+
+            if(!mappedEnrollment || GradeBookMap_enrollmentStudent(&map, mappedEnrollment) != mapped
+               || GradeBookMap_enrollmentCourse(&map, mappedEnrollment)->courseId
+                  != GradeBook_resolveCourse(&index, enrollment->course)->courseId) {
+                printf("Mapped transcript of student %u does not match the GradeBook at %lu\n", student->studentId,
+                       courseIdx);
+                return 1;
+            }
+        }
+    }
+
+    if(GradeBookMap_findCourse(&map, nCourses) || GradeBookMap_findStudent(&map, nStudents)) {
+        printf("The mapped GradeBook found records that it does not hold\n");
+        return 1;
+    }
+
+    // A table of contents that runs past the end, or a section that does, is refused before any record is read
+    GradeBookMap truncatedMap;
+
+    if(GradeBookMap_wrap(&truncatedMap, map.data, 40) != SHORT_BUFFER
+       || GradeBookMap_wrap(&truncatedMap, map.data, map.length - 1) != SHORT_BUFFER
+       || GradeBookMap_wrap(&truncatedMap, gbSerial, gbSize) != BAD_MAGIC
+       || GradeBookMap_wrap(&truncatedMap, map.data, map.length) != SUCCESS) {
+        printf("A truncated, or foreign, mapped GradeBook was not refused\n");
+        return 1;
+    }
+
+    GradeBookMap_close(&truncatedMap);
+    GradeBookMap_close(&map);
+
+    // Test Sectioned Files -------------------------------------------------------------------------------------------
+
+    printf("Saving a grading policy, and reading one student at a time from the sections of the GradeBook\n");
+
+    GradingPlan plan;
+    char policyText[256], readPolicyText[256];
+
+    Course* graded = GradeBook_courseAt(&index, 2);
+
+    GradingPlan_compile("homework 5 drop 1, exams 3 weight 2 cap 95", &plan);
+    Course_setPolicy(&index, graded, &plan);
+    GradingPlan_format(&plan, policyText, sizeof(policyText));
+
+    const char* sectionedFileName = "serial_gradebook_sections.gb";
+    FILE* sectionedPtr = fopen(sectionedFileName, "w");
+
+    SerialSink_initFile(&sink, sectionedPtr);
+    SerializationStatus sectionedStatus = GradeBook_encode(&index, &sink);
+    fclose(sectionedPtr);
+
+    GradeBook sectioned = {};
+    GradeBook_init(&sectioned);
+
+    readFd = open(sectionedFileName, O_RDONLY);
+    SerialSource_initFd(&source, readFd);
+
+    if(sectionedStatus != SUCCESS || sink.written != sizeOfGradeBook(&index)
+       || GradeBook_decode(&source, &sectioned) != SUCCESS) {
+        printf("The GradeBook could not be written with a policy, and read back\n");
+        return 1;
+    }
+
+    close(readFd);
+
+    const GradingPlan* readPlan = Course_policy(&sectioned, GradeBook_findCourse(&sectioned, graded->courseId));
+
+    if(!readPlan || !GradingPlan_format(readPlan, readPolicyText, sizeof(readPolicyText))
+       || strcmp(policyText, readPolicyText) != 0
+       || Course_policy(&sectioned, GradeBook_findCourse(&sectioned, 3)) != NULL) {
+        printf("The grading policy was not read back as it was written\n");
+        return 1;
+    }
+
+    GradeBook_close(&sectioned);
+
+    // Student 0 is in courses 0 to 4, and is read with those courses alone
+    GradeBookFile file;
+    GradeBook loaded = {};
+    GradeBook_init(&loaded);
+
+    if(GradeBookFile_open(&file, sectionedFileName) != SUCCESS
+       || GradeBookFile_loadStudent(&file, transcribed->studentId, &loaded) != SUCCESS
+       || loaded.studentsCount != 1 || loaded.coursesCount != Student_coursesCount(transcribed)) {
+        printf("Student %u could not be read by itself\n", transcribed->studentId);
+        return 1;
+    }
+
+    Student* loadedStudent = GradeBook_findStudent(&loaded, transcribed->studentId);
+
+    for(size courseIdx = 0; courseIdx < Student_coursesCount(transcribed); ++courseIdx) {
+        StudentEnrollment* enrollment       = Student_enrollmentAt(&index, transcribed, courseIdx);
+        StudentEnrollment* loadedEnrollment = Student_enrollmentAt(&loaded, loadedStudent, courseIdx);
+        Course* course                      = GradeBook_resolveCourse(&index, enrollment->course);
+        Course* loadedCourse                = GradeBook_resolveCourse(&loaded, loadedEnrollment->course);
+
+        grade grades[enrollment->grades.count ? enrollment->grades.count : 1];
+        grade loadedGrades[loadedEnrollment->grades.count ? loadedEnrollment->grades.count : 1];
+        Enrollment_copyGrades(&index, enrollment, grades);
+        Enrollment_copyGrades(&loaded, loadedEnrollment, loadedGrades);
+
+        if(loadedCourse->courseId != course->courseId || strcmp(loadedCourse->courseName, course->courseName) != 0
+           || loadedEnrollment->grades.count != enrollment->grades.count
+           || memcmp(loadedGrades, grades, enrollment->grades.count) != 0) {
+            printf("Student %u was read with a transcript that does not match at %lu\n", transcribed->studentId,
+                   courseIdx);
+            return 1;
+        }
+    }
+
+    if(GradeBookFile_loadStudent(&file, nStudents, &loaded) != ILLEGAL_STUDENT_ID || loaded.coursesCount != 0) {
+        printf("A student that is not in the file was read\n");
+        return 1;
+    }
+
+    GradeBookFile_close(&file);
+    GradeBook_close(&loaded);
+
+    if(GradeBookFile_open(&file, mappedFileName) != BAD_MAGIC) {
+        printf("A GradeBook that is not sectioned was opened for reading by record\n");
+        return 1;
+    }
+
+    // Files written before the sectioned format are still read
+    const byte version1[] = {
+        0x01, 0xD5, 0xC0, 0x01,                                 // magic
+        0x01, 0x05, 0x01, 0x09,                                 // course 5, and student 9
+        0x01, 0x09, 0x05, 0x04, 'M', 'a', 't', 'h',             // course 5, with student 9
+        0x01, 0x05, 0x02, 0x50, 0x5A, 0x09, 0x03, 'B', 'o', 'b' // student 9, with grades 80 and 90 in course 5
+    };
+
+    GradeBook old = {};
+    GradeBook_init(&old);
+
+    if(GradeBook_deserialize(version1, sizeof(version1), &old) != SUCCESS || old.coursesCount != 1
+       || old.studentsCount != 1 || strcmp(GradeBook_findCourse(&old, 5)->courseName, "Math") != 0
+       || Course_studentsCount(GradeBook_findCourse(&old, 5)) != 1
+       || Student_averageGrade(&old, GradeBook_findStudent(&old, 9)) != 85) {
+        printf("A version 1 GradeBook was not read\n");
+        return 1;
+    }
+
+    GradeBook_close(&old);
+
+    // Test Compact Files ----------------------------------------------------------------------------------------------
+
+    printf("Archiving the GradeBook compactly, and reading it back\n");
+
+    SerialBuffer standard, compact, reencoded;
+
+    SerialBuffer_init(&standard);
+    SerialBuffer_init(&compact);
+    SerialBuffer_init(&reencoded);
+
+    SerialSink_initBuffer(&sink, &standard);
+    GradeBook_encode(&index, &sink);
+    SerialSink_initBuffer(&sink, &compact);
+
+    if(GradeBook_encodeCompact(&index, &sink) != SUCCESS || compact.count >= standard.count) {
+        printf("The compact GradeBook, of %lu bytes, is no smaller than the %lu of the standard one\n", compact.count,
+               standard.count);
+        return 1;
+    }
+
+    // Grades of course 0 run past 0x7F, so both packed and raw runs are read back
+    GradeBook archived = {};
+    GradeBook_init(&archived);
+
+    if(GradeBook_deserialize(compact.data, compact.count, &archived) != SUCCESS) {
+        printf("The compact GradeBook could not be read\n");
+        return 1;
+    }
+
+    SerialSink_initBuffer(&sink, &reencoded);
+    GradeBook_encode(&archived, &sink);
+
+    if(reencoded.count != standard.count || memcmp(reencoded.data, standard.data, standard.count) != 0) {
+        printf("The compact GradeBook was not read back as it was written\n");
+        return 1;
+    }
+
+    reencoded.count = 0;
+    SerialSink_initBuffer(&sink, &reencoded);
+    GradeBook_encodeCompact(&archived, &sink);
+
+    if(reencoded.count != compact.count || memcmp(reencoded.data, compact.data, compact.count) != 0) {
+        printf("The compact GradeBook was not written again the same\n");
+        return 1;
+    }
+
+    GradeBook_close(&archived);
+
+    // A varint that does not end within 10 bytes, or whose value is wider than 64 bits, is not well formed, where an
+    // archive cut short is merely short
+    byte malformed[compact.count];
+    uint64_t coursesOffset = 0;
+
+    for(size sectionIdx = 0; sectionIdx < compact.data[6]; ++sectionIdx) {
+        const byte* entry   = &compact.data[8 + sectionIdx * 20];
+        uint64_t offset     = 0;
+
+        for(size idx = 0; idx < 8; ++idx) offset = offset << 8 | entry[4 + idx];
+
+        if(entry[3] == SECTION_COURSES) coursesOffset = offset;
+    }
+
+    // The roster of the first course begins with its length, which is made 10 bytes that all go on, then 9 that go on
+    // to a tenth holding bit 64
+    const byte lastBytes[] = {0xFF, 0x02};
+
+    for(size lastIdx = 0; lastIdx < NMEMBERS(lastBytes, byte); ++lastIdx) {
+        byte lastByte = lastBytes[lastIdx];
+
+        memcpy(malformed, compact.data, compact.count);
+        memset(&malformed[coursesOffset], 0xFF, 9);
+        malformed[coursesOffset + 9] = lastByte;
+
+        GradeBook_init(&archived);
+
+        if(GradeBook_deserialize(malformed, compact.count, &archived) != FAILURE) {
+            printf("An archive with an over-long varint, ending in %02x, was not found malformed\n", lastByte);
+            return 1;
+        }
+
+        GradeBook_close(&archived);
+    }
+
+    GradeBook_init(&archived);
+
+    if(GradeBook_deserialize(compact.data, compact.count - 1, &archived) != SHORT_BUFFER) {
+        printf("An archive cut short was not found short\n");
+        return 1;
+    }
+
+    GradeBook_close(&archived);
+
+    const char* compactFileName = "serial_gradebook_compact.gb";
+    FILE* compactPtr = fopen(compactFileName, "w");
+    fwrite(compact.data, 1, compact.count, compactPtr);
+    fclose(compactPtr);
+
+    GradeBook_init(&loaded);
+
+    if(GradeBookFile_open(&file, compactFileName) != SUCCESS
+       || GradeBookFile_loadStudent(&file, transcribed->studentId, &loaded) != SUCCESS
+       || loaded.coursesCount != Student_coursesCount(transcribed)
+       || Student_averageGrade(&loaded, GradeBook_findStudent(&loaded, transcribed->studentId))
+          != Student_averageGrade(&index, transcribed)) {
+        printf("Student %u could not be read by itself from the compact GradeBook\n", transcribed->studentId);
+        return 1;
+    }
+
+    GradeBookFile_close(&file);
+    GradeBook_close(&loaded);
+
+    SerialBuffer_free(&standard);
+    SerialBuffer_free(&compact);
+    SerialBuffer_free(&reencoded);
+
     printf("Read %s \n", GradeBook_toString(&anotherIndex));
 
     for(byte courseIdx = 0; courseIdx < anotherIndex.coursesCount; ++courseIdx) {
-        char* courseName = Course_toString(&anotherIndex.courses[courseIdx]);
+        Course* course = GradeBook_courseAt(&anotherIndex, courseIdx);
+        char* courseName = Course_toString(course);
         printf("-> %s\n", courseName);
         free(courseName);
-        size nStudents = Course_studentsCount(&anotherIndex.courses[courseIdx]);
+        size nStudents = Course_studentsCount(course);
         for(byte studentIdx = 0; studentIdx < nStudents; ++studentIdx) {
-            char* studentName = Student_toString(anotherIndex.courses[courseIdx].students[studentIdx]);
+            StudentEnrollment* enrollment = Course_enrollmentAt(&anotherIndex, course, studentIdx);
+            char* studentName = Student_toString(GradeBook_resolveStudent(&anotherIndex, enrollment->student));
             printf("----> %s\n", studentName);
             free(studentName);
         }
     }
 
     for(byte studentIdx = 0; studentIdx < anotherIndex.studentsCount; ++ studentIdx) {
-        char* studentName = Student_toString(&anotherIndex.students[studentIdx]);
+        Student* student = GradeBook_studentAt(&anotherIndex, studentIdx);
+        char* studentName = Student_toString(student);
         printf("-> %s\n", studentName);
         free(studentName);
-        size nCourses = Student_coursesCount(&anotherIndex.students[studentIdx]);
+        size nCourses = Student_coursesCount(student);
         for(byte courseIdx = 0; courseIdx < nCourses; ++courseIdx) {
-            char* courseName = Course_toString(anotherIndex.students[studentIdx].courses[courseIdx].course);
+            StudentEnrollment* enrollment = Student_enrollmentAt(&anotherIndex, student, courseIdx);
+            char* courseName = Course_toString(GradeBook_resolveCourse(&anotherIndex, enrollment->course));
             printf("----> %s\n", courseName);
             free(courseName);
         }
     }
 
+    GradeBook_close(&index);
+    GradeBook_close(&anotherIndex);
+
     return 0;
 }
\ No newline at end of file
@@ -115,7 +115,7 @@ void String_alignInSpace(const char* string, const size width, Align alignment,
 
     char filler[shift];
     memset(filler, ' ', shift - 1);
-    filler[shift] = 0x00;
+    filler[shift - 1] = 0x00;
 
     snprintf(destination, width, "%s%s",
             (alignment == RIGHT ? filler : string), (alignment == RIGHT ? string : filler));
@@ -162,7 +162,7 @@ void Table_printRows(FILE* stream, size nColumns, size nRows, const char* column
     // Format header ---------------------------------------------------------------------------------------------------
 
     for(size idx = 0; idx < nColumns; ++idx) {
-        char colBuff[columnWidth[idx]];
+        char colBuff[columnWidth[idx] + 1];
         String_alignInSpace(columns[idx], columnWidth[idx], LEFT, colBuff);
         fputs(colBuff, stream);
     }
@@ -178,7 +178,7 @@ void Table_printRows(FILE* stream, size nColumns, size nRows, const char* column
 
     for(size rowIdx = 0; rowIdx < nRows; ++rowIdx) {
         for(size colIdx = 0; colIdx < nColumns; ++colIdx) {
-            char colBuff[columnWidth[colIdx]];
+            char colBuff[columnWidth[colIdx] + 1];
             String_alignInSpace(rows[rowIdx][colIdx], columnWidth[colIdx], LEFT, colBuff);
             fputs(colBuff, stream);
         }
@@ -40,7 +40,7 @@ size PtrArray_CountSane(void** array, size nMembers) {
         }
     }
 
-    return 0;
+    return nMembers;
 }
 
 bool Array_Contains(const void* array, const void* subject, size nMembers, size memberSize, int (* comparator)(void const*, void const*)) {